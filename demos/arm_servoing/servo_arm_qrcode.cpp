@@ -24,7 +24,6 @@
 #include <visp/vpFeatureBuilder.h>
 #include <visp/vpXmlParserCamera.h>
 #include <visp/vpXmlParserHomogeneousMatrix.h>
-#include <visp/vpPlot.h>
 #include <visp/vpPoint.h>
 
 
@@ -34,6 +33,7 @@
 
 #include <vpQRCodeTracker.h>
 #include <vpServoArm.h>
+#include <vpTelemetryRecorder.h>
 #include <vpRomeoTkConfig.h>
 
 
@@ -69,8 +69,7 @@ void printPose(const std::string &text, const vpHomogeneousMatrix &cMo)
 int main(int argc, const char* argv[])
 {
   std::string opt_ip = "198.18.0.1";;
-  bool opt_plotter_arm = false;
-  bool opt_plotter_qrcode_pose = false;
+  std::string opt_telemetry;
   bool opt_learn = false;
 
   std::string learned_filename = "learned_cdMo.xml";
@@ -81,12 +80,12 @@ int main(int argc, const char* argv[])
       opt_ip = argv[i+1];
     else if (std::string(argv[i]) == "--learn")
       opt_learn = true;
-    else if (std::string(argv[i]) == "--plot-arm")
-      opt_plotter_arm = true;
-    else if (std::string(argv[i]) == "--plot-qrcode-pose")
-      opt_plotter_qrcode_pose = true;
+    else if (std::string(argv[i]) == "--telemetry")
+      opt_telemetry = argv[i+1];
     else if (std::string(argv[i]) == "--help") {
-      std::cout << "Usage: " << argv[0] << "[--ip <robot address>] [--learn] [--plot-arm] [--plot-qrcode-pose] [--help]" << std::endl;
+      std::cout << "Usage: " << argv[0] << "[--ip <robot address>] [--learn] [--telemetry <file>] [--help]" << std::endl;
+      std::cout << "  --telemetry records the error, the joint velocities, the qrcode pose and the loop time." << std::endl;
+      std::cout << "  Plot or export the file with telemetry_export." << std::endl;
       return 0;
     }
   }
@@ -166,36 +165,14 @@ int main(int argc, const char* argv[])
   vpMouseButton::vpMouseButtonType button;
   unsigned long loop_iter = 0;
 
-  // Plotter
-  vpPlot *plotter_arm;
-  if (opt_plotter_arm) {
-    plotter_arm = new vpPlot(2, I.getHeight()*2, I.getWidth()*2, I.display->getWindowXPosition()+I.getWidth()+80, I.display->getWindowYPosition(), "Visual servoing");
-    plotter_arm->initGraph(0, 6); // visual features
-    plotter_arm->initGraph(1, q_dot_larm.size()); // d_dot
-    plotter_arm->setTitle(0, "Visual features error");
-    plotter_arm->setTitle(1, "joint velocities");
-    plotter_arm->setLegend(0, 0, "tx");
-    plotter_arm->setLegend(0, 1, "ty");
-    plotter_arm->setLegend(0, 2, "tz");
-    plotter_arm->setLegend(0, 3, "tux");
-    plotter_arm->setLegend(0, 4, "tuy");
-    plotter_arm->setLegend(0, 5, "tuz");
-
-  }
-  vpPlot *plotter_qrcode_pose;
-  if (opt_plotter_qrcode_pose) {
-    plotter_qrcode_pose = new vpPlot(2, I.getHeight()*2, I.getWidth()*2, I.display->getWindowXPosition()+I.getWidth()+90, I.display->getWindowYPosition()+10, "Qrcode pose");
-    plotter_qrcode_pose->initGraph(0, 3); // translations
-    plotter_qrcode_pose->initGraph(1, 3); // rotations
-    plotter_qrcode_pose->setTitle(0, "Pose translation");
-    plotter_qrcode_pose->setTitle(1, "Pose theta u");
-    plotter_qrcode_pose->setLegend(0, 0, "tx");
-    plotter_qrcode_pose->setLegend(0, 1, "ty");
-    plotter_qrcode_pose->setLegend(0, 2, "tz");
-    plotter_qrcode_pose->setLegend(1, 0, "tux");
-    plotter_qrcode_pose->setLegend(1, 1, "tuy");
-    plotter_qrcode_pose->setLegend(1, 2, "tuz");
-  }
+  // Telemetry (see telemetry_export to plot the records)
+  vpTelemetryRecorder telemetry;
+  unsigned int ch_error = telemetry.addChannel("error", 6);
+  unsigned int ch_q_dot = telemetry.addChannel("q_dot", q_dot_larm.size());
+  unsigned int ch_cMo_qrcode = telemetry.addChannel("cMo_qrcode", 6);
+  unsigned int ch_loop_time = telemetry.addChannel("loop_time");
+  if (! opt_telemetry.empty())
+    telemetry.open(opt_telemetry, 10*60*15); // 10 minutes at 15 Hz
 
   vpHomogeneousMatrix cdMo_learned;
 
@@ -314,22 +291,15 @@ int main(int argc, const char* argv[])
     }
 
     double loop_time = vpTime::measureTimeMs() - loop_time_start;
-    if (opt_plotter_arm && ! opt_learn) {
-      plotter_arm->plot(0, loop_iter, servo_larm.m_task.getError());
-      plotter_arm->plot(1, loop_iter, q_dot_larm);
-    }
-    if (opt_plotter_qrcode_pose && status_qrcode_tracker) {
-      vpPoseVector p(cMo_qrcode);
-      vpColVector cto(3);
-      vpColVector cthetauo(3);
-      for(size_t i=0; i<3; i++) {
-        cto[i] = p[i];
-        cthetauo[i] = vpMath::deg(p[i+3]);
-      }
-
-      plotter_qrcode_pose->plot(0, loop_iter, cto);
-      plotter_qrcode_pose->plot(1, loop_iter, cthetauo);
+    telemetry.beginRecord(loop_time_start / 1000.);
+    if (! opt_learn) {
+      telemetry.record(ch_error, servo_larm.m_task.getError());
+      telemetry.record(ch_q_dot, q_dot_larm);
     }
+    if (status_qrcode_tracker)
+      telemetry.record(ch_cMo_qrcode, cMo_qrcode);
+    telemetry.record(ch_loop_time, loop_time);
+    telemetry.endRecord();
 #endif
 
     vpDisplay::flush(I) ;
@@ -338,10 +308,7 @@ int main(int argc, const char* argv[])
     loop_iter ++;
   }
 
-  if (opt_plotter_arm)
-    delete plotter_arm;
-  if (opt_plotter_qrcode_pose)
-    delete plotter_qrcode_pose;
+  telemetry.close();
 
   return 0;
 }
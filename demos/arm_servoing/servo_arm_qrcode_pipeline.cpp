@@ -0,0 +1,217 @@
+/**
+ *
+ * Position based visual servoing of the arm with a qrcode attached to the hand,
+ * using a staged perception pipeline: the capture, the qrcode tracking, the control
+ * and the display run concurrently and exchange the frames through drop-oldest queues,
+ * while the control law runs in the scheduler thread at a fixed rate (default 100 Hz).
+ * The desired position should first be learned with servo_arm_qrcode_scheduler --learn.
+ *
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// ViSP includes.
+#include <visp/vpDisplayX.h>
+#include <visp/vpImage.h>
+#include <visp/vpIoTools.h>
+#include <visp/vpXmlParserHomogeneousMatrix.h>
+
+#include <visp_naoqi/vpNaoqiGrabber.h>
+#include <visp_naoqi/vpNaoqiRobot.h>
+#include <visp_naoqi/vpNaoqiConfig.h>
+
+#include <vpPerceptionStages.h>
+#include <vpPipeline.h>
+#include <vpQRCodeTracker.h>
+#include <vpServoArm.h>
+#include <vpServoArmScheduler.h>
+#include <vpRomeoTkConfig.h>
+
+
+/*!
+  Display the frames at the end of the pipeline. The display is created by the pipeline thread, and the stage
+  should have its own thread since all the X11 calls have to be done by the same thread.
+ */
+class vpDisplayStage : public vpPipelineSink<vpPerceptionFrame>
+{
+protected:
+  vpDisplayX m_display;
+  vpCameraParameters m_cam;
+  vpHomogeneousMatrix m_cdMo;
+  vpServoArmScheduler &m_scheduler;
+  volatile bool m_quit;
+
+public:
+  vpDisplayStage(const vpCameraParameters &cam, const vpHomogeneousMatrix &cdMo, vpServoArmScheduler &scheduler)
+    : vpPipelineSink<vpPerceptionFrame>("display"), m_display(), m_cam(cam), m_cdMo(cdMo),
+      m_scheduler(scheduler), m_quit(false) {}
+
+  bool isQuitRequested() const {return m_quit;}
+
+protected:
+  void process(vpPerceptionFrame &frame)
+  {
+    // Render the image of the queued frame without copying it, by attaching the display to it
+    vpImage<unsigned char> &I = frame.I;
+    if (! m_display.isInitialised()) {
+      m_display.init(I);
+      vpDisplay::setTitle(I, "Camera view");
+    }
+    else
+      I.display = &m_display;
+    vpDisplay::display(I);
+
+    if (frame.found) {
+      vpDisplay::displayFrame(I, frame.cMo, m_cam, 0.04, vpColor::none, 3);
+      vpDisplay::displayFrame(I, m_cdMo, m_cam, 0.025, vpColor::none, 2);
+    }
+
+    std::stringstream ss;
+    ss << "Frame " << frame.index << ", control: " << m_scheduler.getRate() << " Hz, loop "
+       << m_scheduler.getLoopTime() << " ms, " << m_scheduler.getNbOverruns() << " overruns";
+    vpDisplay::displayText(I, 10, 10, ss.str(), vpColor::red);
+    vpDisplay::displayText(I, vpImagePoint(I.getHeight() - 10, 10), "Click to quit", vpColor::red);
+    vpDisplay::flush(I);
+
+    if (vpDisplay::getClick(I, false))
+      m_quit = true;
+  }
+};
+
+
+int main(int argc, const char* argv[])
+{
+  std::string opt_ip = "198.18.0.1";
+  bool opt_right_arm = false;
+  double opt_rate = 100.;
+  unsigned int opt_pool_size = 1;
+
+  for (unsigned int i=0; i<argc; i++) {
+    if (std::string(argv[i]) == "--ip")
+      opt_ip = argv[i+1];
+    else if (std::string(argv[i]) == "--rarm")
+      opt_right_arm = true;
+    else if (std::string(argv[i]) == "--rate")
+      opt_rate = atof(argv[i+1]);
+    else if (std::string(argv[i]) == "--pool")
+      opt_pool_size = atoi(argv[i+1]);
+    else if (std::string(argv[i]) == "--help") {
+      std::cout << "Usage: " << argv[0] << "[--ip <robot address>] [--rarm] [--rate <control rate in Hz>] "
+                << "[--pool <number of worker threads>] [--help]" << std::endl;
+      return 0;
+    }
+  }
+
+  std::string suffix = opt_right_arm ? "_r" : "_l";
+  std::string chain_name = opt_right_arm ? "RArm" : "LArm";
+  std::string learned_filename = "learned_cdMo.xml";
+  std::string learned_transform_name = "cdMo" + suffix;
+
+  if (! vpIoTools::checkFilename(learned_filename)) {
+    std::cout << "\nError: You should first learn the desired position using servo_arm_qrcode_scheduler --learn." << std::endl;
+    return 0;
+  }
+
+  try {
+    /** Open the grabber for the acquisition of the images from the robot*/
+    vpNaoqiGrabber g;
+    g.setFramerate(15);
+    g.setCamera(0);
+    if (! opt_ip.empty())
+      g.setRobotIp(opt_ip);
+    g.open();
+
+    vpCameraParameters cam = g.getCameraParameters(vpCameraParameters::perspectiveProjWithoutDistortion);
+
+    /** Create a new istance NaoqiRobot*/
+    vpNaoqiRobot robot;
+    if (! opt_ip.empty())
+      robot.setRobotIp(opt_ip);
+    robot.open();
+
+    // Initialize the qrcode tracker
+    vpQRCodeTracker qrcode_tracker;
+    qrcode_tracker.setCameraParameters(cam);
+    qrcode_tracker.setQRCodeSize(0.045);
+    qrcode_tracker.setMessage(opt_right_arm ? "romeo_right_arm" : "romeo_left_arm");
+
+    // Constant transformation Target Frame to Arm end-effector (WristPitch)
+    vpHomogeneousMatrix oMe_Arm;
+    std::string filename_transform = std::string(ROMEOTK_DATA_FOLDER) + "/transformation.xml";
+    std::string name_transform = "qrcode_M_e_" + chain_name;
+    vpXmlParserHomogeneousMatrix pm; // Create a XML parser
+    if (pm.parse(oMe_Arm, filename_transform, name_transform) != vpXmlParserHomogeneousMatrix::SEQUENCE_OK) {
+      std::cout << "Cannot found the homogeneous matrix named " << name_transform << "." << std::endl;
+      return 0;
+    }
+
+    vpHomogeneousMatrix cdMo_learned;
+    if (pm.parse(cdMo_learned, learned_filename, learned_transform_name) != vpXmlParserHomogeneousMatrix::SEQUENCE_OK) {
+      std::cout << "Cannot found the homogeneous matrix named " << learned_transform_name<< "." << std::endl;
+      return 0;
+    }
+
+    std::vector<std::string> jointNames_arm =  robot.getBodyNames(chain_name);
+    jointNames_arm.pop_back(); // Delete last joints LHand, that we don't consider in the servo
+    robot.setStiffness(jointNames_arm, 1.f);
+
+    // Arm servo running in the control thread
+    vpServoArm servo_arm;
+    servo_arm.setRealTime(true, jointNames_arm.size());
+    servo_arm.setLambda(vpAdaptiveGain(0.8, 0.06, 8));
+
+    vpServoArmScheduler scheduler(robot, servo_arm, chain_name, jointNames_arm, opt_rate);
+    scheduler.set_cVe(vpVelocityTwistMatrix(oMe_Arm));
+
+    // Pipeline: capture -> tracking -> control -> display
+    vpPerceptionFrame frame;
+    frame.I.resize(g.getHeight(), g.getWidth());
+
+    vpPipelineQueue<vpPerceptionFrame> captured(1), tracked(1), displayed(1);
+    captured.init(frame);
+    tracked.init(frame);
+    displayed.init(frame);
+
+    vpCaptureStage<vpNaoqiGrabber> capture(g);
+    vpTrackerStage<vpQRCodeTracker> tracking(qrcode_tracker);
+    vpServoArmStage control(scheduler, cdMo_learned);
+    vpDisplayStage display(cam, cdMo_learned, scheduler);
+    capture.setOutput(captured);
+    tracking.setInput(captured);
+    tracking.setOutput(tracked);
+    control.setInput(tracked);
+    control.setOutput(displayed);
+    display.setInput(displayed);
+
+    vpPipeline pipeline;
+    pipeline.setPoolSize(opt_pool_size);
+    pipeline.addStage(capture);
+    pipeline.addStage(tracking);
+    pipeline.addStage(control, vpPipeline::workerPool);
+    pipeline.addStage(display); // Own thread, X11 is not called from several threads
+
+    scheduler.start();
+    pipeline.start();
+
+    while (pipeline.isRunning() && ! display.isQuitRequested())
+      vpTime::wait(50);
+
+    pipeline.stop();
+    scheduler.stop();
+
+    pipeline.printSummary(std::cout);
+    std::cout << "Dropped frames: capture " << captured.getNbDropped() << "/" << captured.getNbPushed()
+              << ", tracking " << tracked.getNbDropped() << "/" << tracked.getNbPushed()
+              << ", control " << displayed.getNbDropped() << "/" << displayed.getNbPushed() << std::endl;
+  }
+  catch(vpException &e) {
+    std::cout << e.getMessage() << std::endl;
+  }
+  catch (const AL::ALError& e) {
+    std::cerr << "Caught exception " << e.what() << std::endl;
+  }
+
+  return 0;
+}
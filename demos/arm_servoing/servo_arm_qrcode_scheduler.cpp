@@ -0,0 +1,176 @@
+/**
+ *
+ * Position based visual servoing of the arm with a qrcode attached to the hand.
+ * The control law runs in its own thread at a fixed rate (default 100 Hz) while the
+ * main thread acquires the images at 15 fps and publishes the pose of the qrcode.
+ *
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// ViSP includes.
+#include <visp/vpDisplayX.h>
+#include <visp/vpImage.h>
+#include <visp/vpIoTools.h>
+#include <visp/vpXmlParserHomogeneousMatrix.h>
+
+#include <visp_naoqi/vpNaoqiGrabber.h>
+#include <visp_naoqi/vpNaoqiRobot.h>
+#include <visp_naoqi/vpNaoqiConfig.h>
+
+#include <vpQRCodeTracker.h>
+#include <vpServoArm.h>
+#include <vpServoArmScheduler.h>
+#include <vpRomeoTkConfig.h>
+
+
+int main(int argc, const char* argv[])
+{
+  std::string opt_ip = "198.18.0.1";
+  bool opt_learn = false;
+  bool opt_right_arm = false;
+  double opt_rate = 100.;
+
+  for (unsigned int i=0; i<argc; i++) {
+    if (std::string(argv[i]) == "--ip")
+      opt_ip = argv[i+1];
+    else if (std::string(argv[i]) == "--learn")
+      opt_learn = true;
+    else if (std::string(argv[i]) == "--rarm")
+      opt_right_arm = true;
+    else if (std::string(argv[i]) == "--rate")
+      opt_rate = atof(argv[i+1]);
+    else if (std::string(argv[i]) == "--help") {
+      std::cout << "Usage: " << argv[0] << "[--ip <robot address>] [--learn] [--rarm] [--rate <control rate in Hz>] [--help]" << std::endl;
+      return 0;
+    }
+  }
+
+  std::string suffix = opt_right_arm ? "_r" : "_l";
+  std::string chain_name = opt_right_arm ? "RArm" : "LArm";
+  std::string learned_filename = "learned_cdMo.xml";
+  std::string learned_transform_name = "cdMo" + suffix;
+
+  // Check if the desired position was learned
+  if (!opt_learn) {
+    if (! vpIoTools::checkFilename(learned_filename)) {
+      std::cout << "\nError: You should first learn the desired position using [--learn] option." << std::endl;
+      std::cout << "\nRun: \"" << argv[0] << " --help\" to get all the options.\n" <<  std::endl;
+      return 0;
+    }
+  }
+
+  try {
+    /** Open the grabber for the acquisition of the images from the robot*/
+    vpNaoqiGrabber g;
+    g.setFramerate(15);
+    g.setCamera(0);
+    if (! opt_ip.empty())
+      g.setRobotIp(opt_ip);
+    g.open();
+
+    vpCameraParameters cam = g.getCameraParameters(vpCameraParameters::perspectiveProjWithoutDistortion);
+
+    /** Create a new istance NaoqiRobot*/
+    vpNaoqiRobot robot;
+    if (! opt_ip.empty())
+      robot.setRobotIp(opt_ip);
+    robot.open();
+
+    vpImage<unsigned char> I(g.getHeight(), g.getWidth());
+    vpDisplayX d(I);
+    vpDisplay::setTitle(I, "Camera view");
+
+    // Initialize the qrcode tracker
+    vpQRCodeTracker qrcode_tracker;
+    qrcode_tracker.setCameraParameters(cam);
+    qrcode_tracker.setQRCodeSize(0.045);
+    qrcode_tracker.setMessage(opt_right_arm ? "romeo_right_arm" : "romeo_left_arm");
+
+    // Constant transformation Target Frame to Arm end-effector (WristPitch)
+    vpHomogeneousMatrix oMe_Arm;
+    std::string filename_transform = std::string(ROMEOTK_DATA_FOLDER) + "/transformation.xml";
+    std::string name_transform = "qrcode_M_e_" + chain_name;
+    vpXmlParserHomogeneousMatrix pm; // Create a XML parser
+    if (pm.parse(oMe_Arm, filename_transform, name_transform) != vpXmlParserHomogeneousMatrix::SEQUENCE_OK) {
+      std::cout << "Cannot found the homogeneous matrix named " << name_transform << "." << std::endl;
+      return 0;
+    }
+
+    vpHomogeneousMatrix cdMo_learned;
+    if (! opt_learn) {
+      if (pm.parse(cdMo_learned, learned_filename, learned_transform_name) != vpXmlParserHomogeneousMatrix::SEQUENCE_OK) {
+        std::cout << "Cannot found the homogeneous matrix named " << learned_transform_name<< "." << std::endl;
+        return 0;
+      }
+    }
+
+    std::vector<std::string> jointNames_arm =  robot.getBodyNames(chain_name);
+    jointNames_arm.pop_back(); // Delete last joints LHand, that we don't consider in the servo
+    robot.setStiffness(jointNames_arm, 1.f);
+
+    // Arm servo running in the control thread
+    vpServoArm servo_arm;
+    servo_arm.setRealTime(true, jointNames_arm.size());
+    servo_arm.setLambda(vpAdaptiveGain(0.8, 0.06, 8));
+
+    vpServoArmScheduler scheduler(robot, servo_arm, chain_name, jointNames_arm, opt_rate);
+    scheduler.set_cVe(vpVelocityTwistMatrix(oMe_Arm));
+    if (! opt_learn)
+      scheduler.start();
+
+    vpMouseButton::vpMouseButtonType button;
+
+    while(1) {
+      double t = vpTime::measureTimeSecond();
+      g.acquire(I);
+      vpDisplay::display(I);
+
+      vpDisplay::displayText(I, vpImagePoint(I.getHeight() - 10, 10), "Right click to quit", vpColor::red);
+      bool click_done = vpDisplay::getClick(I, button, false);
+
+      if (qrcode_tracker.track(I)) {
+        vpHomogeneousMatrix cMo_qrcode = qrcode_tracker.get_cMo();
+        vpDisplay::displayFrame(I, cMo_qrcode, cam, 0.04, vpColor::none, 3);
+        vpDisplay::displayPolygon(I, qrcode_tracker.getCorners(), vpColor::green, 2);
+
+        if (opt_learn) {
+          vpDisplay::displayText(I, 10, 10, "Left click to learn desired position", vpColor::red);
+          if (click_done && button == vpMouseButton::button1) {
+            if (pm.save(cMo_qrcode, learned_filename, learned_transform_name) != vpXmlParserHomogeneousMatrix::SEQUENCE_OK)
+              std::cout << "Cannot save the homogeneous matrix cdMo" << std::endl;
+            break;
+          }
+        }
+        else {
+          scheduler.publishPose(cdMo_learned.inverse() * cMo_qrcode, t);
+          vpDisplay::displayFrame(I, cdMo_learned, cam, 0.025, vpColor::none, 2);
+        }
+      }
+
+      if (! opt_learn) {
+        std::stringstream ss;
+        ss << "Control: " << scheduler.getRate() << " Hz, loop " << scheduler.getLoopTime() << " ms, "
+           << scheduler.getNbOverruns() << " overruns";
+        vpDisplay::displayText(I, 10, 10, ss.str(), vpColor::red);
+      }
+
+      vpDisplay::flush(I);
+
+      if (click_done && button == vpMouseButton::button3) // Quit the loop
+        break;
+    }
+
+    scheduler.stop();
+  }
+  catch(vpException &e) {
+    std::cout << e.getMessage() << std::endl;
+  }
+  catch (const AL::ALError& e) {
+    std::cerr << "Caught exception " << e.what() << std::endl;
+  }
+
+  return 0;
+}
@@ -11,6 +11,7 @@
 
 #include <vpServoHead.h>
 #include <vpFaceTrackerOkao.h>
+#include <vpTripleBuffer.h>
 
 // ViSP includes.
 #include <visp/vpDisplayX.h>
@@ -64,16 +65,11 @@ std::string opt_ip = "198.18.0.1";
 vpImagePoint s_head_cog_des;
 vpImagePoint s_head_cog_cur;
 vpRect s_face_bbox;
-#if defined(VISP_HAVE_V4L2)
-vpImage<unsigned char> s_frame;
-#elif defined(VISP_HAVE_OPENCV)
-cv::Mat s_frame;
-#endif
+vpTripleBuffer< vpImage<unsigned char> > s_display_frames; // Latest frame, exchanged without lock nor copy
 double s_face_size;
 double s_distance_servo;
 
 vpMutex s_mutex_capture;
-vpMutex s_mutex_frame;
 vpMutex s_mutex_face;
 vpMutex s_mutex_cogs;
 vpMutex s_mutex_distance;
@@ -102,8 +98,9 @@ vpThread::Return captureFunction(vpThread::Args args)
   vpImage<unsigned char> frame_;
   bool stop_capture_ = false;
 
-  //Get a first frame
+  //Get a first frame, used to preallocate the frame buffers
   g.acquire(frame_);
+  s_display_frames.init(frame_);
   {
     vpMutex::vpScopedLock lock(s_mutex_cogs);
     s_head_cog_des.set_uv(frame_.getWidth()/2, frame_.getHeight()/2);
@@ -111,8 +108,9 @@ vpThread::Return captureFunction(vpThread::Args args)
   }
 
   while (!stop_capture_) {
-    // Capture in progress
-    g.acquire(frame_);
+    // Capture in progress, directly in the buffer of the display thread
+    g.acquire(s_display_frames.getWriteBuffer());
+    s_display_frames.publish();
 
     // Update shared data
     {
@@ -121,7 +119,6 @@ vpThread::Return captureFunction(vpThread::Args args)
         stop_capture_ = true;
       else
         s_capture_state = capture_started;
-      s_frame = frame_;
     }
   }
 
@@ -140,7 +137,6 @@ vpThread::Return displayFunction(vpThread::Args args)
 
   t_CaptureState capture_state_;
   bool face_available_ = false;
-  vpImage<unsigned char> frame_;
   bool display_initialized_ = false;
   double distance;
   vpImagePoint head_cog_des_;
@@ -182,11 +178,10 @@ vpThread::Return displayFunction(vpThread::Args args)
 
     // Check if a new frame is available
     if (capture_state_ == capture_started) {
-      // Get the frame
-      {
-        vpMutex::vpScopedLock lock(s_mutex_frame);
-        frame_ = s_frame;
-      }
+      // Render the latest frame straight from the read buffer, without copying it. Without new frame the
+      // read buffer still holds the previous one.
+      s_display_frames.update();
+      vpImage<unsigned char> &frame_ = s_display_frames.getReadBuffer();
 
       // Check if we need to initialize the display with the first frame
       if (! display_initialized_) {
@@ -199,6 +194,12 @@ vpThread::Return displayFunction(vpThread::Args args)
         display_initialized_ = true;
 #endif
       }
+#if defined(VISP_HAVE_X11) || defined(VISP_HAVE_GDI)
+      else {
+        // Attach the display to the buffer: only the display pointer of the image is set, not its pixels
+        frame_.display = d_;
+      }
+#endif
 
       // Display the image
       vpDisplay::display(frame_);
@@ -362,8 +363,6 @@ vpThread::Return servoHeadFunction(vpThread::Args args)
     robot.setRobotIp(opt_ip);
   robot.open();
 
-  vpImage<unsigned char> frame_;
-
   //Get the intrinsic and extrinsic parameters of the camera used
   vpHomogeneousMatrix eMc;
   vpCameraParameters cam;
@@ -474,12 +473,6 @@ vpThread::Return servoHeadFunction(vpThread::Args args)
       vpTime::sleepMs(5);
     }
 
-    //Get a frame
-    {
-      vpMutex::vpScopedLock lock(s_mutex_frame);
-      frame_ = s_frame;
-    }
-
     vpColVector q_dot_head;
     vpColVector q_dot_tot;
     vpColVector q;
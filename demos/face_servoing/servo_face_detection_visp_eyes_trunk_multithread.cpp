@@ -31,6 +31,7 @@
 
 #include <vpFaceTracker.h>
 #include <vpServoHead.h>
+#include <vpBroadcastBuffer.h>
 
 #include <opencv2/highgui/highgui.hpp>
 
@@ -52,8 +53,6 @@
  */
 
 // Shared vars
-unsigned int s_frame_index = 0;
-bool s_frame_available = false;
 bool s_face_available = false;
 bool s_end = false;
 bool opt_Reye = false;
@@ -61,13 +60,12 @@ bool opt_language_english = false;
 std::string opt_ip = "198.18.0.1";
 vpImagePoint s_head_cog_des;
 vpImagePoint s_head_cog_cur;
+unsigned int s_frame_width = 0; // Set once the first frame is captured
 vpRect s_face_bbox;
-#if defined(VISP_HAVE_V4L2)
-vpImage<unsigned char> s_frame;
-#elif defined(VISP_HAVE_OPENCV)
-cv::Mat s_frame;
-#endif
-vpMutex s_mutex_frame;
+// Latest frame, exchanged without lock nor copy and read by both the detection and the display threads
+const unsigned int s_detection_consumer = 0;
+const unsigned int s_display_consumer = 1;
+vpBroadcastBuffer< vpImage<unsigned char> > s_frames(2);
 vpMutex s_mutex_face;
 vpMutex s_mutex_cogs;
 vpMutex s_mutex_end;
@@ -85,24 +83,21 @@ vpThread::Return captureFunction(vpThread::Args args)
   vpImage<unsigned char> frame_;
   bool end = false;
 
-  //Get a first frame
+  //Get a first frame, used to preallocate the frame buffers
   g.acquire(frame_);
+  s_frames.init(frame_);
   {
     vpMutex::vpScopedLock lock(s_mutex_cogs);
     s_head_cog_des.set_uv(frame_.getWidth()/2, frame_.getHeight()/2);
+    s_frame_width = frame_.getWidth();
   }
 
   while (1) {
-    // Capture in progress
-    g.acquire(frame_);
+    // Capture in progress, directly in the buffer shared by the detection and display threads
+    g.acquire(s_frames.getWriteBuffer());
 
     // Update shared data
-    {
-      vpMutex::vpScopedLock lock(s_mutex_frame);
-      s_frame_available = true;
-      s_frame_index ++;
-      s_frame = frame_;
-    }
+    s_frames.publish();
 
     {
       vpMutex::vpScopedLock lock(s_mutex_end);
@@ -126,11 +121,8 @@ vpThread::Return displayFunction(vpThread::Args args)
   (void)args; // Avoid warning: unused parameter args
 
   bool end=false;
-  bool frame_available_ = false;
   bool face_available_ = false;
   std::vector<vpImagePoint> display_cogs_;
-  vpImage<unsigned char> frame_;
-  unsigned int frame_prev_index_ = 0, frame_index_;
   bool display_initialized_ = false;
   vpImagePoint head_cog_cur_;
   vpImagePoint head_cog_des_;
@@ -142,20 +134,10 @@ vpThread::Return displayFunction(vpThread::Args args)
 #endif
 
   do {
-    {
-      vpMutex::vpScopedLock lock(s_mutex_frame);
-      frame_available_ = s_frame_available;
-      frame_index_ = s_frame_index;
-      s_frame_available = false;
-    }
-
     // Check if a new frame is available
-    if (frame_available_ && frame_index_ > frame_prev_index_) {
-      // Get the frame
-      {
-        vpMutex::vpScopedLock lock(s_mutex_frame);
-        frame_ = s_frame;
-      }
+    if (s_frames.update(s_display_consumer)) {
+      // Render the latest frame straight from the shared buffer, without copying it
+      vpImage<unsigned char> &frame_ = s_frames.getReadBuffer(s_display_consumer);
 
       // Check if we need to initialize the display with the first frame
       if (! display_initialized_) {
@@ -168,6 +150,12 @@ vpThread::Return displayFunction(vpThread::Args args)
         display_initialized_ = true;
 #endif
       }
+#if defined(VISP_HAVE_X11) || defined(VISP_HAVE_GDI)
+      else {
+        // Attach the display to the buffer: only the display pointer of the image is set, not its pixels
+        frame_.display = d_;
+      }
+#endif
 
       // Display the image
       vpDisplay::display(frame_);
@@ -209,9 +197,6 @@ vpThread::Return displayFunction(vpThread::Args args)
           end=s_end;
         }
       }
-
-      // Update the previous frame index for next iteration
-      frame_prev_index_ = frame_index_;
     }
     else {
       vpTime::wait(2); // Sleep 2ms
@@ -234,27 +219,11 @@ vpThread::Return detectionFunction(vpThread::Args args)
   face_detector_.setFaceCascade(opt_face_cascade_name);
 
   bool end = false;
-  bool frame_available_=false;
-  unsigned int frame_prev_index_ = 0, frame_index_;
-  vpImage<unsigned char> frame_;
   do {
-    {
-      vpMutex::vpScopedLock lock(s_mutex_frame);
-      frame_available_ = s_frame_available;
-      frame_index_ = s_frame_index;
-    }
-
     // Check if a new frame is available
-    if (frame_available_ && frame_index_ > frame_prev_index_) {
-      // Backup the frame
-      {
-        vpMutex::vpScopedLock lock(s_mutex_frame);
-        frame_ = s_frame;
-      }
-
-
-      // Detect faces
-      bool face_found_ = face_detector_.track(frame_);
+    if (s_frames.update(s_detection_consumer)) {
+      // Detect faces in the latest frame, without copying it
+      bool face_found_ = face_detector_.track(s_frames.getReadBuffer(s_detection_consumer));
       if (face_found_) {
         {
           vpMutex::vpScopedLock lock(s_mutex_face);
@@ -269,10 +238,6 @@ vpThread::Return detectionFunction(vpThread::Args args)
           s_face_available = false;
         }
       }
-
-      // Update the previous frame index for next iteration
-      frame_prev_index_ = frame_index_;
-
     }
     else {
       vpTime::wait(2); // Sleep 2ms
@@ -297,8 +262,6 @@ vpThread::Return servoHeadComFunction(vpThread::Args args)
     robot.setRobotIp(opt_ip);
   robot.open();
 
-  vpImage<unsigned char> frame_;
-
   //Get the intrinsic and extrinsic parameters of the camera used
   vpHomogeneousMatrix eMc;
   vpCameraParameters cam;
@@ -397,7 +360,7 @@ vpThread::Return servoHeadComFunction(vpThread::Args args)
     servo_head.setLambda(lambda);
 
     double servo_time_init = 0;
-    bool frame_available_ = false;
+    unsigned int frame_width_ = 0;
 
 
     vpImagePoint head_cog_cur;
@@ -407,27 +370,16 @@ vpThread::Return servoHeadComFunction(vpThread::Args args)
     while(1)
     {
       {
-        vpMutex::vpScopedLock lock(s_mutex_frame);
-        frame_available_ = s_frame_available;
+        vpMutex::vpScopedLock lock(s_mutex_cogs);
+        frame_width_ = s_frame_width;
+        head_cog_des = s_head_cog_des;
       }
       // Check if a frame is available
-      if (frame_available_)
-      {
-        {
-          vpMutex::vpScopedLock lock(s_mutex_cogs);
-          head_cog_des = s_head_cog_des;
-        }
+      if (frame_width_)
        break;
-      }
       vpTime::sleepMs(5);
     }
 
-    //Get a frame
-    {
-      vpMutex::vpScopedLock lock(s_mutex_frame);
-      frame_ = s_frame;
-    }
-
     vpColVector q_dot_head;
     vpColVector q_dot_tot;
     vpColVector q;
@@ -502,7 +454,7 @@ vpThread::Return servoHeadComFunction(vpThread::Args args)
         // Compute the distance in pixel between the target and the center of the image
         double distance = vpImagePoint::distance(head_cog_cur, head_cog_des);
 
-        if (distance < 0.03*frame_.getWidth() && speech) { // 3 % of the image witdh
+        if (distance < 0.03*frame_width_ && speech) { // 3 % of the image witdh
           // Call the say method
           static bool firstTime = true;
           if (firstTime) {
@@ -512,7 +464,7 @@ vpThread::Return servoHeadComFunction(vpThread::Args args)
           speech = false;
 
         }
-        else if (distance > 0.20*frame_.getWidth()) // 20 % of the image witdh
+        else if (distance > 0.20*frame_width_) // 20 % of the image witdh
           speech = true;
 
       }
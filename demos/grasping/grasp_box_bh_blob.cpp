@@ -22,7 +22,6 @@
 #include <visp/vpFeatureBuilder.h>
 #include <visp/vpXmlParserCamera.h>
 #include <visp/vpXmlParserHomogeneousMatrix.h>
-#include <visp/vpPlot.h>
 #include <visp/vpPoint.h>
 
 
@@ -41,8 +40,10 @@
 #include <vpCartesianDisplacement.h>
 #include <vpRomeoTkConfig.h>
 #include <vpColorDetection.h>
+#include <vpConfigCache.h>
 #include <vpJointLimitAvoidance.h>
 #include <vpBlobsTargetTracker.h>
+#include <vpTelemetryRecorder.h>
 
 
 
@@ -254,7 +255,7 @@ void moveLArmToRestPosition(const vpNaoqiRobot &robot,  const std::string chain_
   return;
 }
 
-bool learnDesiredLHandOpenLoopPosition(const vpNaoqiRobot &robot, const vpHomogeneousMatrix &cMo,
+bool learnDesiredLHandOpenLoopPosition(const vpNaoqiRobot &robot, vpConfigCache &config, const vpHomogeneousMatrix &cMo,
                                        const vpHomogeneousMatrix &eMc, const std::string &out_filename,
                                        const std::string &transform_name, vpHomogeneousMatrix &oMh_sens, const bool r_eye, const std::string chain_name)
 {
@@ -278,9 +279,7 @@ bool learnDesiredLHandOpenLoopPosition(const vpNaoqiRobot &robot, const vpHomoge
 
   //std::cout << "Learned target offset oMh_sens:" << std::endl << oMh_sens <<std::endl ;
 
-  vpXmlParserHomogeneousMatrix p_; // Create a XML parser
-
-  if (p_.save(oMh_sens, out_filename, transform_name) != vpXmlParserHomogeneousMatrix::SEQUENCE_OK)
+  if (! config.saveTransform(out_filename, transform_name, oMh_sens))
   {
     std::cout << "Cannot save the Homogeneous matrix" << std::endl;
     return false;
@@ -288,15 +287,13 @@ bool learnDesiredLHandOpenLoopPosition(const vpNaoqiRobot &robot, const vpHomoge
   return true;
 }
 
-bool learnDesiredLHandGraspingPosition(const vpNaoqiRobot &robot, const vpHomogeneousMatrix &cMo_teabox,
+bool learnDesiredLHandGraspingPosition(const vpNaoqiRobot &robot, vpConfigCache &config, const vpHomogeneousMatrix &cMo_teabox,
                                        const vpHomogeneousMatrix &cMo_hand, const std::string &out_filename,
                                        const std::string &transform_name, vpHomogeneousMatrix &oMh_grasp)
 {
   oMh_grasp = cMo_teabox.inverse()*cMo_hand;
 
-  vpXmlParserHomogeneousMatrix p_; // Create a XML parser
-
-  if (p_.save(oMh_grasp, out_filename, transform_name) != vpXmlParserHomogeneousMatrix::SEQUENCE_OK)
+  if (! config.saveTransform(out_filename, transform_name, oMh_grasp))
   {
     std::cout << "Cannot save the Homogeneous matrix" << std::endl;
     return false;
@@ -305,19 +302,15 @@ bool learnDesiredLHandGraspingPosition(const vpNaoqiRobot &robot, const vpHomoge
 }
 
 
-vpHomogeneousMatrix getOpenLoopDesiredPose(const vpNaoqiRobot &robot, const vpHomogeneousMatrix &cMo,
+vpHomogeneousMatrix getOpenLoopDesiredPose(const vpNaoqiRobot &robot, vpConfigCache &config, const vpHomogeneousMatrix &cMo,
                                            const vpHomogeneousMatrix &eMc, const std::string &in_filename, const std::string &transform_name, const bool r_eye, const std::string chain_name)
 {
 
   // Load transformation between teabox and desired position of the hand (from sensors) to initializate the tracker
   vpHomogeneousMatrix oMe_hand;
 
-  vpXmlParserHomogeneousMatrix pm; // Create a XML parser
-
-  //  char filename_[FILENAME_MAX];
-  //  sprintf(filename_, "%s", VISP_NAOQI_GENERAL_M_FILE);
-
-  if (pm.parse(oMe_hand, in_filename, transform_name) != vpXmlParserHomogeneousMatrix::SEQUENCE_OK) {
+  // The pose was cached at startup: the XML file is not parsed again here
+  if (! config.getTransform(in_filename, transform_name, oMe_hand)) {
     std::cout << "Cannot found the Homogeneous matrix named " << transform_name<< "." << std::endl;
     exit(0);
   }
@@ -396,9 +389,8 @@ int main(int argc, const char* argv[])
 
   bool opt_learn_open_loop_position = false;
   bool opt_learn_grasp_position = false;
-  bool opt_plotter_time = false;
-  bool opt_plotter_arm = false;
-  bool opt_plotter_qrcode_pose = false;
+  std::string opt_telemetry;
+  std::string opt_config_cache;
   bool opt_interaction = true;
   bool opt_language_english = true;
   bool opt_record_video = false;
@@ -406,9 +398,6 @@ int main(int argc, const char* argv[])
   bool opt_no_color_tracking = false;
   bool opt_add_noise = false;
   bool opt_Reye = false;
-  bool opt_plotter_q = false;
-  bool opt_plotter_q_sec_arm = false;
-  bool opt_plotter_error = false;
   bool opt_right_arm = false;
 
   // Learning folder in /tmp/$USERNAME
@@ -454,18 +443,10 @@ int main(int argc, const char* argv[])
       opt_no_color_tracking = true;
     else if (std::string(argv[i]) == "--add_noise")
       opt_add_noise = true;
-    else if (std::string(argv[i]) == "--plot-time")
-      opt_plotter_time = true;
-    else if (std::string(argv[i]) == "--plot-arm")
-      opt_plotter_arm = true;
-    else if (std::string(argv[i]) == "--plot-qrcode-pose")
-      opt_plotter_qrcode_pose = true;
-    else if (std::string(argv[i]) == "--plot-q")
-      opt_plotter_q = true;
-    else if (std::string(argv[i]) == "--plot-q2-joint-avoidance")
-      opt_plotter_q_sec_arm = true;
-    else if (std::string(argv[i]) == "--plot-error")
-      opt_plotter_error = true;
+    else if (std::string(argv[i]) == "--telemetry")
+      opt_telemetry = std::string(argv[i+1]);
+    else if (std::string(argv[i]) == "--config-cache")
+      opt_config_cache = std::string(argv[i+1]);
     else if (std::string(argv[i]) == "--no-interaction")
       opt_interaction = false;
     else if (std::string(argv[i]) == "--fr")
@@ -481,7 +462,7 @@ int main(int argc, const char* argv[])
     else if (std::string(argv[i]) == "--help") {
       std::cout << "Usage: " << argv[0] << "[--ip <robot address>] [--box-name] [--opt_no_color_tracking]" << std::endl;
       std::cout << "       [--haar <haarcascade xml filename>] [--no-interaction] [--learn-open-loop-position] " << std::endl;
-      std::cout << "       [--learn-grasp-position] [--plot-time] [--plot-arm] [--plot-qrcode-pose] [--plot-q] "<< std::endl;
+      std::cout << "       [--learn-grasp-position] [--telemetry <file>] [--config-cache <file>] "<< std::endl;
       std::cout << "  add  [--rarm] tu use the right arm, nothing to use the left "<< std::endl;
       std::cout << "       [--data-folder] [--learn-detection-box] [--Reye] "<< std::endl;
       std::cout << "       [--fr] [--opt-record-video] [--help]" << std::endl;
@@ -732,16 +713,25 @@ int main(int argc, const char* argv[])
   std::string name_oMh_open_loop =  "oMh_open_loop_" + camera_name; // Offset position Hand w.r.t the object (Open loop)
   std::string name_oMh_grasp =  "oMh_close_loop_"+ camera_name; // Offset position Hand w.r.t the object to grasp it (Close loop)
 
+  // Binary cache of the XML transformations, so that they are only parsed when the XML files change
+  if (opt_config_cache.empty())
+    opt_config_cache = learning_folder + "/romeo_tk_config_cache.bin";
+  vpConfigCache config;
+  config.load(opt_config_cache);
+
   vpHomogeneousMatrix oMh_Tea_Box_grasp;
   if (! opt_learn_grasp_position && !opt_learn_open_loop_position && !opt_learning_detection) {
-    vpXmlParserHomogeneousMatrix pm; // Create a XML parser
-
-    if (pm.parse(oMh_Tea_Box_grasp, learned_oMh_path + "/" + learned_oMh_filename, name_oMh_grasp) != vpXmlParserHomogeneousMatrix::SEQUENCE_OK) {
+    if (! config.getTransform(learned_oMh_path + "/" + learned_oMh_filename, name_oMh_grasp, oMh_Tea_Box_grasp)) {
       std::cout << "Cannot found the homogeneous matrix named " << name_oMh_grasp<< "." << std::endl;
       return 0;
     }
     else
       std::cout << "Homogeneous matrix " << name_oMh_grasp <<": " << std::endl << oMh_Tea_Box_grasp << std::endl;
+
+    // Cache the open loop pose used by getOpenLoopDesiredPose() when the grasping starts
+    vpHomogeneousMatrix oMh_open_loop;
+    if (! config.getTransform(learned_oMh_path + "/" + learned_oMh_filename, name_oMh_open_loop, oMh_open_loop))
+      std::cout << "Cannot found the homogeneous matrix named " << name_oMh_open_loop << "." << std::endl;
   }
 
 
@@ -750,15 +740,18 @@ int main(int argc, const char* argv[])
 
   std::string filename_transform = std::string(ROMEOTK_DATA_FOLDER) + "/transformation.xml";
   std::string name_transform = "qrcode_M_e_" + chain_name;
-  vpXmlParserHomogeneousMatrix pm; // Create a XML parser
 
-  if (pm.parse(hMe_Arm, filename_transform, name_transform) != vpXmlParserHomogeneousMatrix::SEQUENCE_OK) {
+  if (! config.getTransform(filename_transform, name_transform, hMe_Arm)) {
     std::cout << "Cannot found the homogeneous matrix named " << name_transform << "." << std::endl;
     return 0;
   }
   else
     std::cout << "Homogeneous matrix " << name_transform <<": " << std::endl << hMe_Arm << std::endl;
 
+  std::cout << "Configuration: " << config.getNbLoaded() << " value(s) read from " << opt_config_cache << ", "
+            << config.getNbParsed() << " parsed from XML" << std::endl;
+  config.save();
+
   // Create twist matrix from target Frame to Arm end-effector (WristPitch)
   vpVelocityTwistMatrix hVe_Arm(hMe_Arm);
 
@@ -797,7 +790,7 @@ int main(int argc, const char* argv[])
   double cond = 0.0;
 
   // Initalization data for the joint avoidance limit
-  //Vector data for plotting
+  // Normalized joint positions and limits of the joint 1 for the telemetry
   vpColVector data(13);
 
   // Initialize the joint avoidance scheme from the joint limits
@@ -860,144 +853,17 @@ int main(int argc, const char* argv[])
   vpMouseButton::vpMouseButtonType button;
   unsigned long loop_iter = 0;
 
-  // Plotter
-  vpPlot *plotter_arm;
-  if (opt_plotter_arm) {
-    plotter_arm = new vpPlot(2, I.getHeight()*2, I.getWidth()*2, I.display->getWindowXPosition()+I.getWidth()+80, I.display->getWindowYPosition(), "Loop time");
-    plotter_arm->initGraph(0, 6); // visual features
-    plotter_arm->initGraph(1, q_dot_larm.size()); // d_dot
-    plotter_arm->setTitle(0, "Visual features error");
-    plotter_arm->setTitle(1, "joint velocities");
-
-    plotter_arm->setLegend(0, 0, "tx");
-    plotter_arm->setLegend(0, 1, "ty");
-    plotter_arm->setLegend(0, 2, "tz");
-    plotter_arm->setLegend(1, 0, "tux");
-    plotter_arm->setLegend(1, 1, "tuy");
-    plotter_arm->setLegend(1, 2, "tuz");
-
-    plotter_arm->setLegend(1, 0, "LshouderPitch");
-    plotter_arm->setLegend(1, 1, "LShoulderYaw");
-    plotter_arm->setLegend(1, 2, "LElbowRoll");
-    plotter_arm->setLegend(1, 3, "LElbowYaw");
-    plotter_arm->setLegend(1, 4, "LWristRoll");
-    plotter_arm->setLegend(1, 5, "LWristYaw");
-    plotter_arm->setLegend(1, 6, "LWristPitch");
-
-
-  }
-  vpPlot *plotter_qrcode_pose;
-  if (opt_plotter_qrcode_pose) {
-    plotter_qrcode_pose = new vpPlot(2, I.getHeight()*2, I.getWidth()*2, I.display->getWindowXPosition()+I.getWidth()+90, I.display->getWindowYPosition()+10, "Qrcode pose");
-    plotter_qrcode_pose->initGraph(0, 3); // translations
-    plotter_qrcode_pose->initGraph(1, 3); // rotations
-    plotter_qrcode_pose->setTitle(0, "Pose translation");
-    plotter_qrcode_pose->setTitle(1, "Pose theta u");
-    plotter_qrcode_pose->setLegend(0, 0, "tx");
-    plotter_qrcode_pose->setLegend(0, 1, "ty");
-    plotter_qrcode_pose->setLegend(0, 2, "tz");
-    plotter_qrcode_pose->setLegend(1, 0, "tux");
-    plotter_qrcode_pose->setLegend(1, 1, "tuy");
-    plotter_qrcode_pose->setLegend(1, 2, "tuz");
-  }
-
-
-  vpPlot *plotter_q;
-  if (opt_plotter_q) {
-
-    plotter_q = new vpPlot(1, I.getHeight()*2, I.getWidth()*2, I.display->getWindowXPosition()+I.getWidth()+100, I.display->getWindowYPosition()+60, "Values of q and limits");
-    plotter_q->initGraph(0, 13);
-
-    plotter_q->setTitle(0, "Q1 values");
-
-    plotter_q->setLegend(0, 0, "LshouderPitch");
-    plotter_q->setLegend(0, 1, "LShoulderYaw");
-    plotter_q->setLegend(0, 2, "LElbowRoll");
-    plotter_q->setLegend(0, 3, "LElbowYaw");
-    plotter_q->setLegend(0, 4, "LWristRoll");
-    plotter_q->setLegend(0, 5, "LWristYaw");
-    plotter_q->setLegend(0, 6, "LWristPitch");
-
-    plotter_q->setLegend(0, 7, "Low Limits");
-    plotter_q->setLegend(0, 8, "Upper Limits");
-    plotter_q->setLegend(0, 9, "l0 min");
-    plotter_q->setLegend(0, 10, "l0 max");
-    plotter_q->setLegend(0, 11, "l1 min");
-    plotter_q->setLegend(0, 12, "l1 max");
-
-    plotter_q->setColor(0, 7,vpColor::darkRed);
-    plotter_q->setThickness(0, 7,2);
-    plotter_q->setColor(0, 9,vpColor::darkRed);
-    plotter_q->setThickness(0, 9,2);
-    plotter_q->setColor(0, 11,vpColor::darkRed);
-    plotter_q->setThickness(0, 11,2);
-
-    plotter_q->setColor(0, 8,vpColor::darkRed);
-    plotter_q->setThickness(0, 8,2);
-    plotter_q->setColor(0, 10,vpColor::darkRed);
-    plotter_q->setThickness(0, 10,2);
-    plotter_q->setColor(0, 12,vpColor::darkRed);
-    plotter_q->setThickness(0, 12,2);
-
-  }
-
-  vpPlot *plotter_q_sec_arm;
-  if (opt_plotter_q_sec_arm) {
-    plotter_q_sec_arm = new vpPlot(2, I.getHeight()*2, I.getWidth()*2, I.display->getWindowXPosition()+I.getWidth()+100, I.display->getWindowYPosition()+30, "Secondary Task");
-    plotter_q_sec_arm->initGraph(0, 7); // translations
-    plotter_q_sec_arm->initGraph(1, 7); // rotations
-
-    plotter_q_sec_arm->setTitle(0, "Q2 values");
-    plotter_q_sec_arm->setTitle(1, "Q tot values");
-
-    plotter_q_sec_arm->setLegend(0, 0, "LshouderPitch");
-    plotter_q_sec_arm->setLegend(0, 1, "LShoulderYaw");
-    plotter_q_sec_arm->setLegend(0, 2, "LElbowRoll");
-    plotter_q_sec_arm->setLegend(0, 3, "LElbowYaw");
-    plotter_q_sec_arm->setLegend(0, 4, "LWristRoll");
-    plotter_q_sec_arm->setLegend(0, 5, "LWristYaw");
-    plotter_q_sec_arm->setLegend(0, 6, "LWristPitch");
-
-    plotter_q_sec_arm->setLegend(1, 0, "LshouderPitch");
-    plotter_q_sec_arm->setLegend(1, 1, "LShoulderYaw");
-    plotter_q_sec_arm->setLegend(1, 2, "LElbowRoll");
-    plotter_q_sec_arm->setLegend(1, 3, "LElbowYaw");
-    plotter_q_sec_arm->setLegend(1, 4, "LWristRoll");
-    plotter_q_sec_arm->setLegend(1, 5, "LWristYaw");
-    plotter_q_sec_arm->setLegend(1, 6, "LWristPitch");
-
-  }
-
-
-  vpPlot *plotter_cond;
-  if (0) {
-    plotter_cond = new vpPlot(1, I.getHeight(), I.getWidth()*2, I.display->getWindowXPosition()+I.getWidth()+90, I.display->getWindowYPosition()+10, "Loop time");
-    plotter_cond->initGraph(0, 1);
-  }
-
-
-  vpPlot *plotter_time;
-  if (opt_plotter_time) {
-    plotter_time = new vpPlot(1, I.getHeight(), I.getWidth()*2, I.display->getWindowXPosition()+I.getWidth()+90, I.display->getWindowYPosition()+10, "Loop time");
-    plotter_time->initGraph(0, 1);
-  }
-
-  vpPlot *plotter_error;
-  if (opt_plotter_error) {
-    plotter_error = new vpPlot(2, I.getHeight()*2, I.getWidth()*2, I.display->getWindowXPosition()+I.getWidth()+90, I.display->getWindowYPosition(), "Visual servoing");
-    plotter_error->initGraph(0, 3); // Translation
-    plotter_error->initGraph(1, 3); // Rotation
-    plotter_error->setTitle(0, "Translation Error");
-    plotter_error->setTitle(1, "Rotation Error");
-    plotter_error->setLegend(0, 0, "tx");
-    plotter_error->setLegend(0, 1, "ty");
-    plotter_error->setLegend(0, 2, "tz");
-    plotter_error->setLegend(1, 0, "tux");
-    plotter_error->setLegend(1, 1, "tuy");
-    plotter_error->setLegend(1, 2, "tuz");
-  }
-
-
+  // Telemetry, recorded at the loop rate (see telemetry_export to plot the records)
+  vpTelemetryRecorder telemetry;
+  unsigned int ch_loop_time = telemetry.addChannel("loop_time");
+  unsigned int ch_cMo_hand = telemetry.addChannel("cMo_hand", 6);
+  unsigned int ch_error = telemetry.addChannel("error", 6);
+  unsigned int ch_q_dot = telemetry.addChannel("q_dot", numArmJoints);
+  unsigned int ch_q2_dot = telemetry.addChannel("q2_dot", numArmJoints);
+  unsigned int ch_q = telemetry.addChannel("q", numArmJoints);
+  unsigned int ch_q_normalized = telemetry.addChannel("q_normalized_limits", data.size());
+  if (! opt_telemetry.empty())
+    telemetry.open(opt_telemetry, 10*60*30); // 10 minutes at 30 Hz
 
 
   //Create directory
@@ -1015,6 +881,7 @@ int main(int argc, const char* argv[])
 
   while(1) {
     double loop_time_start = vpTime::measureTimeMs();
+    telemetry.beginRecord(loop_time_start / 1000.);
     //std::cout << "Loop iteration: " << loop_iter << std::endl;
 
     g.acquire(cvI);
@@ -1320,18 +1187,8 @@ int main(int argc, const char* argv[])
         // vpDisplay::displayPolygon(I, qrcode_tracker.getCorners(), vpColor::green, 2);
       }
 
-      if (opt_plotter_qrcode_pose && status_hand_tracker) {
-        vpPoseVector p(cMo_hand);
-        vpColVector cto(3);
-        vpColVector cthetauo(3);
-        for(size_t i=0; i<3; i++) {
-          cto[i] = p[i];
-          cthetauo[i] = vpMath::deg(p[i+3]);
-        }
-
-        plotter_qrcode_pose->plot(0, loop_iter, cto);
-        plotter_qrcode_pose->plot(1, loop_iter, cthetauo);
-      }
+      if (status_hand_tracker)
+        telemetry.record(ch_cMo_hand, cMo_hand);
 
     }
 
@@ -1457,9 +1314,10 @@ int main(int argc, const char* argv[])
       vpDisplay::displayText(I, vpImagePoint(25,10), "and left click to learn the pose", vpColor::red);
       if (click_done && button == vpMouseButton::button1) {
         vpHomogeneousMatrix teaboxMh_offset;
-        if (learnDesiredLHandOpenLoopPosition(robot, cMo_teabox, eMc, learning_folder + "/" + learned_oMh_filename, name_oMh_open_loop, teaboxMh_offset, opt_Reye, chain_name)) {
+        if (learnDesiredLHandOpenLoopPosition(robot, config, cMo_teabox, eMc, learning_folder + "/" + learned_oMh_filename, name_oMh_open_loop, teaboxMh_offset, opt_Reye, chain_name)) {
           printPose("The learned open loop pose: ", teaboxMh_offset);
           std::cout << "is saved in " << learning_folder + "/" + learned_oMh_filename << std::endl;
+          config.save();
           return 0;
         }
       }
@@ -1470,9 +1328,10 @@ int main(int argc, const char* argv[])
       vpDisplay::displayText(I, vpImagePoint(25,10), "and left click to learn the pose", vpColor::red);
       if (click_done && button == vpMouseButton::button1) {
         vpHomogeneousMatrix teaboxMh_grasp;
-        if (learnDesiredLHandGraspingPosition(robot, cMo_teabox, cMo_hand, learning_folder + "/" + learned_oMh_filename, name_oMh_grasp, teaboxMh_grasp)) {
+        if (learnDesiredLHandGraspingPosition(robot, config, cMo_teabox, cMo_hand, learning_folder + "/" + learned_oMh_filename, name_oMh_grasp, teaboxMh_grasp)) {
           printPose("The learned grasping pose: ", teaboxMh_grasp);
           std::cout << "is saved in " << learning_folder + "/" + learned_oMh_filename << std::endl;
+          config.save();
           return 0;
         }
       }
@@ -1530,7 +1389,7 @@ int main(int argc, const char* argv[])
         else
           tts.post.say(" \\rspd=90\\ \\emph=2\\ Ok. J'essaye de la prendre  \\eos=1\\ " );
 
-        vpHomogeneousMatrix handMbox_desired = getOpenLoopDesiredPose(robot, cMo_teabox, eMc, learned_oMh_path + "/" + learned_oMh_filename, name_oMh_open_loop, opt_Reye, chain_name);
+        vpHomogeneousMatrix handMbox_desired = getOpenLoopDesiredPose(robot, config, cMo_teabox, eMc, learned_oMh_path + "/" + learned_oMh_filename, name_oMh_open_loop, opt_Reye, chain_name);
         std::vector<float> handMbox_desired_;
         handMbox_desired.convert(handMbox_desired_);
 
@@ -1758,27 +1617,9 @@ int main(int argc, const char* argv[])
 
           robot.setVelocity(joint_names_arm_head,q_dot_arm_head);
 
-          double t1 = vpTime::measureTimeSecond() - servo_arm_time_init;
-
-          if (opt_plotter_arm) {
-            plotter_arm->plot(0, t1, servo_arm->m_task.getError());
-            plotter_arm->plot(1, t1, q_dot_larm);
-          }
-
-
-          if (opt_plotter_q_sec_arm)
-          {
-            plotter_q_sec_arm->plot(0,t1,q2_dot);
-            plotter_q_sec_arm->plot(1,t1,q_dot_larm + q2_dot);
-          }
-
-          if (opt_plotter_error)
-          {
-            vpColVector error = servo_arm->m_task.getError();
-
-            plotter_error->plot(0, t1, error.extract(0,3));
-            plotter_error->plot(1, t1, error.extract(3,3));
-          }
+          telemetry.record(ch_error, servo_arm->m_task.getError());
+          telemetry.record(ch_q_dot, q_dot_larm);
+          telemetry.record(ch_q2_dot, q2_dot);
 
 
           if (cpt_iter_servo_grasp > 100) {
@@ -1828,14 +1669,6 @@ int main(int argc, const char* argv[])
     if (state_teabox_tracker == TakeTea)
     {
 
-      if (opt_plotter_error)
-      {
-        plotter_error->saveData(0, "error_translation.dat");
-        plotter_error->saveData(1, "error_orientation.dat");
-      }
-      if (opt_plotter_arm)
-        plotter_arm->saveData(1, "qdot.dat");
-
 
       typedef enum {
         CloseHand,
@@ -2406,11 +2239,7 @@ int main(int argc, const char* argv[])
       break;
     }
 
-    double loop_time = vpTime::measureTimeMs() - loop_time_start;
-    if (opt_plotter_time)
-      plotter_time->plot(0, 0, loop_iter, loop_time);
-
-    if (opt_plotter_q )
+    if (telemetry.isOpened())
     {
 
       // q normalized between (entre -1 et 1)
@@ -2436,26 +2265,16 @@ int main(int argc, const char* argv[])
       data[numArmJoints+4] =  2*(tQmin_l1 - Qmiddle[joint])/(jointMax[joint] - jointMin[joint]);
       data[numArmJoints+5] =  2*(tQmax_l1 - Qmiddle[joint])/(jointMax[joint] - jointMin[joint]);
 
-      plotter_q->plot(0,0,loop_iter,data[0]);
-      plotter_q->plot(0,1,loop_iter,data[1]);
-      plotter_q->plot(0,2,loop_iter,data[2]);
-      plotter_q->plot(0,3,loop_iter,data[3]);
-      plotter_q->plot(0,4,loop_iter,data[4]);
-      plotter_q->plot(0,5,loop_iter,data[5]);
-      plotter_q->plot(0,6,loop_iter,data[6]);
-
-      plotter_q->plot(0,7,loop_iter,data[7]);
-      plotter_q->plot(0,8,loop_iter,data[8]);
-
-      plotter_q->plot(0,9,loop_iter,data[9]);
-      plotter_q->plot(0,10,loop_iter,data[10]);
-      plotter_q->plot(0,11,loop_iter,data[11]);
-      plotter_q->plot(0,12,loop_iter,data[12]);
+      telemetry.record(ch_q, q);
+      telemetry.record(ch_q_normalized, data);
 
     }
 
     vpDisplay::flush(I) ;
 
+    telemetry.record(ch_loop_time, vpTime::measureTimeMs() - loop_time_start);
+    telemetry.endRecord();
+
     //std::cout << "Loop time: " << vpTime::measureTimeMs() - loop_time_start << std::endl;
     loop_iter ++;
   }
@@ -2463,20 +2282,7 @@ int main(int argc, const char* argv[])
   if (opt_interaction)
     delete face_tracker;
 
-  if (opt_plotter_time)
-    delete plotter_time;
-
-  if (opt_plotter_arm)
-    delete plotter_arm;
-
-  if (opt_plotter_qrcode_pose)
-    delete plotter_qrcode_pose;
-
-  if (opt_plotter_q)
-    delete plotter_q;
-
-  if (opt_plotter_q_sec_arm)
-    delete plotter_q_sec_arm;
+  telemetry.close();
 
   if (servo_arm)
     delete servo_arm;
@@ -1375,7 +1375,7 @@ int main(int argc, const char* argv[])
           //plotter_cond->plot(0, 0, loop_iter, cond);
 
           // Compute joint limit avoidance
-          q2_dot = computeQdotLimitAvoidance(task_error, taskJac, taskJacPseudoInv, jointMin, jointMax, q, q_dot_larm, ro, ro1, q_l0_min, q_l0_max, q_l1_min, q_l1_max );
+          vpJointLimitAvoidance<7>::computeQdotLimitAvoidance(task_error, taskJac, taskJacPseudoInv, jointMin, jointMax, q, q_dot_larm, ro, ro1, q_l0_min, q_l0_max, q_l1_min, q_l1_max, q2_dot);
 
           //q_dot_head = q_dot_head;
 
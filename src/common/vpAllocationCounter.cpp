@@ -0,0 +1,52 @@
+#include <vpAllocationCounter.h>
+
+#if defined(_MSC_VER)
+#  define VP_THREAD_LOCAL __declspec(thread)
+#else
+#  define VP_THREAD_LOCAL __thread
+#endif
+
+namespace {
+  // Plain thread local integers: they are usable from operator new before and after any constructor runs
+  VP_THREAD_LOCAL unsigned long s_nb_allocations = 0;
+  VP_THREAD_LOCAL unsigned long s_nb_deallocations = 0;
+  VP_THREAD_LOCAL unsigned long s_nb_bytes = 0;
+  VP_THREAD_LOCAL unsigned long s_nb_external_allocations = 0;
+  VP_THREAD_LOCAL unsigned int s_external_depth = 0; // Number of nested vpExternalScope
+  bool s_installed = false;
+}
+
+unsigned long vpAllocationCounter::getNbAllocations() {return s_nb_allocations;}
+unsigned long vpAllocationCounter::getNbBytes() {return s_nb_bytes;}
+unsigned long vpAllocationCounter::getNbDeallocations() {return s_nb_deallocations;}
+unsigned long vpAllocationCounter::getNbExternalAllocations() {return s_nb_external_allocations;}
+bool vpAllocationCounter::isInstalled() {return s_installed;}
+
+void vpAllocationCounter::allocated(size_t size)
+{
+  s_nb_allocations ++;
+  s_nb_bytes += (unsigned long)size;
+  if (s_external_depth > 0)
+    s_nb_external_allocations ++;
+}
+
+void vpAllocationCounter::deallocated()
+{
+  s_nb_deallocations ++;
+}
+
+bool vpAllocationCounter::install()
+{
+  s_installed = true;
+  return true;
+}
+
+void vpAllocationCounter::enterExternal()
+{
+  s_external_depth ++;
+}
+
+void vpAllocationCounter::leaveExternal()
+{
+  s_external_depth --;
+}
@@ -0,0 +1,99 @@
+#ifndef __vpAllocationCounter_h__
+#define __vpAllocationCounter_h__
+
+#include <stddef.h>
+
+/*!
+  Per-thread count of the heap allocations, to measure the allocations done by track() or
+  computeControlLaw() and push them toward zero.
+
+  Counting is opt-in: the counters only move in a program that includes vpAllocationHooks.h
+  in one of its source files, which replaces the global operator new and operator delete.
+  The library itself never replaces them.
+
+  The library marks its calls to third-party code (ViSP, OpenCV, zbar) in the hot paths with a vpExternalScope,
+  so that the allocations of romeo_tk itself, that it can remove, are told apart from the ones of the libraries
+  it calls.
+
+  \code
+  #include <vpAllocationHooks.h> // In one source file of the program only
+
+  vpAllocationCounter::vpScope scope;
+  qrcode_tracker.track(I);
+  std::cout << scope.getNbAllocations() << " allocations, " << scope.getNbExternalAllocations()
+            << " by third-party libraries, " << scope.getNbBytes() << " bytes" << std::endl;
+  \endcode
+ */
+class vpAllocationCounter
+{
+public:
+  /*!
+    Counts of the calling thread since the creation of the scope or the last reset().
+   */
+  class vpScope
+  {
+  protected:
+    unsigned long m_nb_allocations;
+    unsigned long m_nb_external_allocations;
+    unsigned long m_nb_deallocations;
+    unsigned long m_nb_bytes;
+
+  public:
+    vpScope() {reset();}
+
+    unsigned long getNbAllocations() const {return vpAllocationCounter::getNbAllocations() - m_nb_allocations;}
+    unsigned long getNbBytes() const {return vpAllocationCounter::getNbBytes() - m_nb_bytes;}
+    unsigned long getNbDeallocations() const {return vpAllocationCounter::getNbDeallocations() - m_nb_deallocations;}
+    //! Allocations done by third-party code, within a vpExternalScope. They are included in getNbAllocations().
+    unsigned long getNbExternalAllocations() const
+    {
+      return vpAllocationCounter::getNbExternalAllocations() - m_nb_external_allocations;
+    }
+    //! Allocations done by romeo_tk itself, outside any vpExternalScope.
+    unsigned long getNbOwnAllocations() const {return getNbAllocations() - getNbExternalAllocations();}
+    //! Allocations not released yet. Grows if the code leaks or keeps growing a container.
+    long getNbLive() const {return (long)getNbAllocations() - (long)getNbDeallocations();}
+
+    void reset()
+    {
+      m_nb_allocations = vpAllocationCounter::getNbAllocations();
+      m_nb_external_allocations = vpAllocationCounter::getNbExternalAllocations();
+      m_nb_deallocations = vpAllocationCounter::getNbDeallocations();
+      m_nb_bytes = vpAllocationCounter::getNbBytes();
+    }
+  };
+
+  /*!
+    Mark the allocations of the calling thread as done by third-party code while the scope is alive.
+    Scopes can be nested. Costs one thread local increment, even when the hooks are not installed.
+   */
+  class vpExternalScope
+  {
+  public:
+    vpExternalScope() {vpAllocationCounter::enterExternal();}
+    ~vpExternalScope() {vpAllocationCounter::leaveExternal();}
+
+  private:
+    vpExternalScope(const vpExternalScope &);
+    vpExternalScope &operator=(const vpExternalScope &);
+  };
+
+  static unsigned long getNbAllocations();
+  static unsigned long getNbBytes();
+  static unsigned long getNbDeallocations();
+  static unsigned long getNbExternalAllocations();
+
+  //! True if the program includes vpAllocationHooks.h, so that allocations are counted.
+  static bool isInstalled();
+
+  // Called by the hooks of vpAllocationHooks.h
+  static void allocated(size_t size);
+  static void deallocated();
+  static bool install();
+
+  // Called by vpExternalScope
+  static void enterExternal();
+  static void leaveExternal();
+};
+
+#endif
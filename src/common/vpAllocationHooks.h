@@ -0,0 +1,68 @@
+#ifndef __vpAllocationHooks_h__
+#define __vpAllocationHooks_h__
+
+/*!
+  \file vpAllocationHooks.h
+  Replace the global operator new and operator delete to count the allocations with vpAllocationCounter.
+  Include this file in exactly one source file of a test or benchmark program, never in the library.
+ */
+
+#include <stdlib.h>
+
+#include <new>
+
+#include <vpAllocationCounter.h>
+
+static bool s_allocation_hooks_installed = vpAllocationCounter::install();
+
+void *operator new(size_t size) throw(std::bad_alloc)
+{
+  void *p = malloc(size ? size : 1);
+  if (p == NULL)
+    throw std::bad_alloc();
+  vpAllocationCounter::allocated(size);
+  return p;
+}
+
+void *operator new[](size_t size) throw(std::bad_alloc)
+{
+  return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) throw()
+{
+  void *p = malloc(size ? size : 1);
+  if (p != NULL)
+    vpAllocationCounter::allocated(size);
+  return p;
+}
+
+void *operator new[](size_t size, const std::nothrow_t &nt) throw()
+{
+  return operator new(size, nt);
+}
+
+void operator delete(void *p) throw()
+{
+  if (p == NULL)
+    return;
+  vpAllocationCounter::deallocated();
+  free(p);
+}
+
+void operator delete[](void *p) throw()
+{
+  operator delete(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) throw()
+{
+  operator delete(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) throw()
+{
+  operator delete(p);
+}
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef __vpAtomic_h__
+#define __vpAtomic_h__
+
+#if defined(_WIN32)
+#  include <windows.h>
+#endif
+
+/*!
+  Atomic operations on a long shared between threads, used by the lock-free buffers of romeo_tk.
+  All the operations are full memory barriers.
+ */
+namespace vpAtomic
+{
+  //! Atomically add \e value to \e *ptr and return the previous value.
+  inline long fetchAndAdd(volatile long *ptr, long value)
+  {
+#if defined(_WIN32)
+    return InterlockedExchangeAdd(ptr, value);
+#else
+    return __sync_fetch_and_add(ptr, value);
+#endif
+  }
+
+  //! Atomically replace \e *ptr by \e value and return the previous value.
+  inline long exchange(volatile long *ptr, long value)
+  {
+#if defined(_WIN32)
+    return InterlockedExchange(ptr, value);
+#else
+    long old;
+    do {
+      old = *ptr;
+    } while (! __sync_bool_compare_and_swap(ptr, old, value));
+    return old;
+#endif
+  }
+
+  //! Atomically set \e *ptr to \e value if it is equal to \e expected. Return true if it was set.
+  inline bool compareAndSwap(volatile long *ptr, long expected, long value)
+  {
+#if defined(_WIN32)
+    return InterlockedCompareExchange(ptr, value, expected) == expected;
+#else
+    return __sync_bool_compare_and_swap(ptr, expected, value);
+#endif
+  }
+
+  //! Read \e *ptr after all the previous memory accesses.
+  inline long load(volatile long *ptr)
+  {
+    return fetchAndAdd(ptr, 0);
+  }
+
+  //! Set \e *ptr to \e value after all the previous memory accesses.
+  inline void store(volatile long *ptr, long value)
+  {
+    exchange(ptr, value);
+  }
+}
+
+#endif
@@ -0,0 +1,97 @@
+#include <visp/vpException.h>
+#include <visp/vpTime.h>
+
+#include <vpAudioCapture.h>
+
+/*!
+  Create a capture of \e nb_channels channels at \e sample_rate Hz returning frames of \e frame_length samples
+  every \e hop samples. The ring buffer holds at least \e buffer_duration seconds.
+ */
+vpAudioCapture::vpAudioCapture(unsigned int nb_channels, double sample_rate, unsigned int frame_length,
+                               unsigned int hop, double buffer_duration)
+  : m_ring(nb_channels, (unsigned int)(sample_rate * buffer_duration) + frame_length), m_sample_rate(sample_rate),
+    m_frame_length(frame_length), m_hop(hop), m_frame((size_t)nb_channels * frame_length, 0.f),
+    m_channels(nb_channels), m_frame_start(0), m_nb_frames(0), m_nb_xruns(0), m_recorder(NULL)
+{
+  if (sample_rate <= 0)
+    throw vpException(vpException::badValue, "Sample rate of %f Hz", sample_rate);
+  if (frame_length == 0 || hop == 0 || hop > frame_length)
+    throw vpException(vpException::badValue, "Hop of %d samples for a frame of %d samples", hop, frame_length);
+  for (unsigned int c=0; c < nb_channels; c++)
+    m_channels[c] = &m_frame[0] + (size_t)c * frame_length;
+}
+
+/*!
+  Consumer side: wait for the next frame, getFrameLength() samples starting getHop() samples after the previous one.
+  \param timeout_ms : Maximum waiting time in ms, 0 to return immediately.
+  \return false if the frame is not complete after \e timeout_ms.
+ */
+bool vpAudioCapture::acquire(double timeout_ms)
+{
+  double t_start = vpTime::measureTimeMs();
+  for (;;) {
+    unsigned long frame_start = m_ring.getNbRead();
+    if (m_ring.read(&m_channels[0], m_frame_length, m_hop)) {
+      m_frame_start = frame_start;
+      m_nb_frames ++;
+      return true;
+    }
+    if (vpTime::measureTimeMs() - t_start >= timeout_ms)
+      return false;
+    vpTime::wait(1);
+  }
+}
+
+/*!
+  Time in s of the first sample of the current frame since the start of the stream. Frames dropped because the
+  ring buffer was full are not counted.
+ */
+double vpAudioCapture::getTime() const
+{
+  return m_frame_start / m_sample_rate;
+}
+
+/*!
+  Forget the captured samples. Should not be called while the stream runs.
+ */
+void vpAudioCapture::reset()
+{
+  m_ring.init(m_ring.getNbChannels(), m_ring.getCapacity());
+  m_frame_start = 0;
+  m_nb_frames = 0;
+  m_nb_xruns = 0;
+}
+
+/*!
+  RtAudioCallback for a stream opened with RTAUDIO_FLOAT32 interleaved input, the vpAudioCapture being the user data.
+ */
+int vpAudioCapture::callbackFloat32(void * /* output */, void *input, unsigned int nb_frames, double /* stream_time */,
+                                    unsigned int status, void *capture)
+{
+  vpAudioCapture *self = (vpAudioCapture *)capture;
+  if (status != 0)
+    self->m_nb_xruns ++;
+  if (input != NULL) {
+    self->m_ring.write((const float *)input, nb_frames);
+    if (self->m_recorder != NULL)
+      self->m_recorder->write((const float *)input, nb_frames);
+  }
+  return 0;
+}
+
+/*!
+  RtAudioCallback for a stream opened with RTAUDIO_SINT16 interleaved input, the vpAudioCapture being the user data.
+ */
+int vpAudioCapture::callbackInt16(void * /* output */, void *input, unsigned int nb_frames, double /* stream_time */,
+                                  unsigned int status, void *capture)
+{
+  vpAudioCapture *self = (vpAudioCapture *)capture;
+  if (status != 0)
+    self->m_nb_xruns ++;
+  if (input != NULL) {
+    self->m_ring.writeInt16((const short *)input, nb_frames);
+    if (self->m_recorder != NULL)
+      self->m_recorder->writeInt16((const short *)input, nb_frames);
+  }
+  return 0;
+}
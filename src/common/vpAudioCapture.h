@@ -0,0 +1,89 @@
+#ifndef __vpAudioCapture_h__
+#define __vpAudioCapture_h__
+
+#include <vector>
+
+#include <vpAudioRecorder.h>
+#include <vpAudioRingBuffer.h>
+
+/*!
+  Continuous audio capture: the sound card callback fills a vpAudioRingBuffer, and the processing thread
+  pulls overlapping frames of fixed length every hop.
+
+  The callbacks have the signature of RtAudioCallback, so that the class can be given to RtAudio::openStream()
+  without romeo_tk depending on RtAudio. They never block nor allocate, which avoids the overflows of the
+  sound card (xruns) while the processing runs; if the processing is too slow, the frames that do not fit in
+  the ring buffer are dropped and counted instead.
+
+  \code
+  vpAudioCapture capture(2, 48000, 512, 256);
+  RtAudio audio;
+  RtAudio::StreamParameters parameters;
+  parameters.deviceId = ...;
+  parameters.nChannels = capture.getNbChannels();
+  unsigned int buffer_frames = 256;
+  audio.openStream(NULL, &parameters, RTAUDIO_SINT16, 48000, &buffer_frames, &vpAudioCapture::callbackInt16, &capture);
+  audio.startStream();
+  while (...) {
+    if (! capture.acquire(100))
+      continue;
+    left.push(capture.getChannel(0) + capture.getFrameLength() - capture.getHop(), capture.getHop());
+    ...
+  }
+  \endcode
+ */
+class vpAudioCapture
+{
+protected:
+  vpAudioRingBuffer m_ring;
+  double m_sample_rate;
+  unsigned int m_frame_length;
+  unsigned int m_hop;
+  std::vector<float> m_frame;       // Planar samples of the current frame
+  std::vector<float *> m_channels;
+  unsigned long m_frame_start;      // Index in the stream of the first frame of the current frame
+  unsigned long m_nb_frames;
+  volatile unsigned long m_nb_xruns;
+  vpAudioRecorder *m_recorder;      // Also receives the frames of the callbacks if not NULL
+
+public:
+  vpAudioCapture(unsigned int nb_channels=2, double sample_rate=48000., unsigned int frame_length=512,
+                 unsigned int hop=256, double buffer_duration=1.);
+  virtual ~vpAudioCapture() {}
+
+  bool acquire(double timeout_ms=1000.);
+
+  //! Samples of channel \e c of the current frame, getFrameLength() contiguous values in [-1, 1].
+  const float *getChannel(unsigned int c) const {return m_channels[c];}
+  //! Pointers on the samples of each channel of the current frame.
+  const float *const *getChannels() const {return &m_channels[0];}
+  unsigned int getFrameLength() const {return m_frame_length;}
+  unsigned int getHop() const {return m_hop;}
+  unsigned int getNbChannels() const {return m_ring.getNbChannels();}
+  //! Number of frames returned by acquire().
+  unsigned long getNbFrames() const {return m_nb_frames;}
+  //! Number of samples per channel waiting in the ring buffer. Grows if the processing is too slow.
+  unsigned int getNbPending() const {return m_ring.getNbAvailable();}
+  //! Number of callbacks that reported an input overflow of the sound card.
+  unsigned long getNbXruns() const {return m_nb_xruns;}
+  const vpAudioRingBuffer &getRingBuffer() const {return m_ring;}
+  vpAudioRingBuffer &getRingBuffer() {return m_ring;}
+  double getSampleRate() const {return m_sample_rate;}
+  double getTime() const;
+
+  void reset();
+
+  //! Also give the captured frames to \e recorder, or to no recorder if NULL. Should be set before the stream starts.
+  void setRecorder(vpAudioRecorder *recorder) {m_recorder = recorder;}
+
+  static int callbackFloat32(void *output, void *input, unsigned int nb_frames, double stream_time,
+                             unsigned int status, void *capture);
+  static int callbackInt16(void *output, void *input, unsigned int nb_frames, double stream_time,
+                           unsigned int status, void *capture);
+
+private:
+  vpAudioCapture(const vpAudioCapture &);
+  vpAudioCapture &operator=(const vpAudioCapture &);
+};
+
+#endif
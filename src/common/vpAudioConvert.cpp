@@ -0,0 +1,155 @@
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#elif defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+
+#include <vpAudioConvert.h>
+
+namespace {
+
+// Frames [first, nb_frames) of channels [first_channel, nb_channels), one sample at a time
+template <class T>
+void toPlanar(const T *interleaved, unsigned int nb_channels, unsigned int first_channel, unsigned int first,
+              unsigned int nb_frames, float *planar, size_t planar_stride, float scale)
+{
+  for (unsigned int c=first_channel; c < nb_channels; c++) {
+    float *dst = planar + c * planar_stride;
+    const T *src = interleaved + c;
+    for (unsigned int i=first; i < nb_frames; i++)
+      dst[i] = scale * src[(size_t)i * nb_channels];
+  }
+}
+
+#if defined(__SSE2__)
+
+inline __m128 load4(const float *p)
+{
+  return _mm_loadu_ps(p);
+}
+
+inline __m128 load4(const short *p)
+{
+  __m128i v = _mm_loadl_epi64((const __m128i *)p);
+  return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+}
+
+// Stereo frames [0, nb_frames) with nb_frames multiple of 4: L0 R0 L1 R1 | L2 R2 L3 R3 -> L0 L1 L2 L3, R0 R1 R2 R3
+template <class T>
+unsigned int stereoToPlanar(const T *interleaved, unsigned int nb_frames, float *left, float *right, float scale)
+{
+  unsigned int i = 0;
+  const __m128 s = _mm_set1_ps(scale);
+  for (; i + 4 <= nb_frames; i += 4) {
+    __m128 a = load4(interleaved + 2*i);
+    __m128 b = load4(interleaved + 2*i + 4);
+    _mm_storeu_ps(left + i, _mm_mul_ps(s, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))));
+    _mm_storeu_ps(right + i, _mm_mul_ps(s, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))));
+  }
+  return i;
+}
+
+// Channels [c, c+4) of frames [0, nb_frames) by 4 x 4 transposes
+template <class T>
+unsigned int quadToPlanar(const T *interleaved, unsigned int nb_channels, unsigned int c, unsigned int nb_frames,
+                          float *planar, size_t planar_stride, float scale)
+{
+  unsigned int i = 0;
+  const __m128 s = _mm_set1_ps(scale);
+  float *dst0 = planar + c * planar_stride;
+  float *dst1 = dst0 + planar_stride;
+  float *dst2 = dst1 + planar_stride;
+  float *dst3 = dst2 + planar_stride;
+  for (; i + 4 <= nb_frames; i += 4) {
+    const T *src = interleaved + (size_t)i * nb_channels + c;
+    __m128 r0 = load4(src);
+    __m128 r1 = load4(src + nb_channels);
+    __m128 r2 = load4(src + 2 * nb_channels);
+    __m128 r3 = load4(src + 3 * nb_channels);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(dst0 + i, _mm_mul_ps(s, r0));
+    _mm_storeu_ps(dst1 + i, _mm_mul_ps(s, r1));
+    _mm_storeu_ps(dst2 + i, _mm_mul_ps(s, r2));
+    _mm_storeu_ps(dst3 + i, _mm_mul_ps(s, r3));
+  }
+  return i;
+}
+
+#endif
+
+#if defined(__AVX2__)
+
+// Stereo int16 frames by 8: two lanes of L R pairs, deinterleaved per lane then reordered across lanes
+unsigned int stereoInt16ToPlanarAvx2(const short *interleaved, unsigned int nb_frames, float *left, float *right,
+                                     float scale)
+{
+  unsigned int i = 0;
+  const __m256 s = _mm256_set1_ps(scale);
+  for (; i + 8 <= nb_frames; i += 8) {
+    __m128i v0 = _mm_loadu_si128((const __m128i *)(interleaved + 2*i));
+    __m128i v1 = _mm_loadu_si128((const __m128i *)(interleaved + 2*i + 8));
+    __m256 a = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(v0)); // L0 R0 L1 R1 | L2 R2 L3 R3
+    __m256 b = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(v1)); // L4 R4 L5 R5 | L6 R6 L7 R7
+    __m256 l = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)); // L0 L1 L4 L5 | L2 L3 L6 L7
+    __m256 r = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    l = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(l), _MM_SHUFFLE(3, 1, 2, 0)));
+    r = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(r), _MM_SHUFFLE(3, 1, 2, 0)));
+    _mm256_storeu_ps(left + i, _mm256_mul_ps(s, l));
+    _mm256_storeu_ps(right + i, _mm256_mul_ps(s, r));
+  }
+  return i;
+}
+
+#endif
+
+template <class T>
+void interleavedToPlanar(const T *interleaved, unsigned int nb_channels, unsigned int nb_frames,
+                         float *planar, size_t planar_stride, float scale)
+{
+#if defined(__SSE2__)
+  if (nb_channels == 2) {
+    unsigned int done = stereoToPlanar(interleaved, nb_frames, planar, planar + planar_stride, scale);
+    toPlanar(interleaved, 2, 0, done, nb_frames, planar, planar_stride, scale);
+    return;
+  }
+  unsigned int c = 0;
+  for (; c + 4 <= nb_channels; c += 4) {
+    unsigned int done = quadToPlanar(interleaved, nb_channels, c, nb_frames, planar, planar_stride, scale);
+    // Tail frames of these 4 channels
+    for (unsigned int k=c; k < c + 4; k++)
+      for (unsigned int i=done; i < nb_frames; i++)
+        planar[k * planar_stride + i] = scale * interleaved[(size_t)i * nb_channels + k];
+  }
+  toPlanar(interleaved, nb_channels, c, 0, nb_frames, planar, planar_stride, scale);
+#else
+  toPlanar(interleaved, nb_channels, 0, 0, nb_frames, planar, planar_stride, scale);
+#endif
+}
+
+}
+
+/*!
+  Convert \e nb_frames interleaved float frames of \e nb_channels channels to planar samples multiplied by \e scale.
+ */
+void vpAudioConvert::floatToPlanar(const float *interleaved, unsigned int nb_channels, unsigned int nb_frames,
+                                   float *planar, size_t planar_stride, float scale)
+{
+  interleavedToPlanar(interleaved, nb_channels, nb_frames, planar, planar_stride, scale);
+}
+
+/*!
+  Convert \e nb_frames interleaved signed 16 bits frames of \e nb_channels channels, like the RTAUDIO_SINT16
+  buffers of the sound card, to planar float samples multiplied by \e scale, by default in [-1, 1[.
+ */
+void vpAudioConvert::int16ToPlanar(const short *interleaved, unsigned int nb_channels, unsigned int nb_frames,
+                                   float *planar, size_t planar_stride, float scale)
+{
+#if defined(__AVX2__)
+  if (nb_channels == 2) {
+    unsigned int done = stereoInt16ToPlanarAvx2(interleaved, nb_frames, planar, planar + planar_stride, scale);
+    interleavedToPlanar(interleaved + 2 * (size_t)done, 2, nb_frames - done, planar + done, planar_stride, scale);
+    return;
+  }
+#endif
+  interleavedToPlanar(interleaved, nb_channels, nb_frames, planar, planar_stride, scale);
+}
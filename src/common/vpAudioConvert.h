@@ -0,0 +1,24 @@
+#ifndef __vpAudioConvert_h__
+#define __vpAudioConvert_h__
+
+#include <stddef.h>
+
+/*!
+  Conversion of the interleaved buffers of the sound card to planar float samples, used by vpAudioRingBuffer
+  in the capture callback.
+
+  Channel c of frame i of the interleaved buffer goes to planar[c * planar_stride + i], scaled. The stereo
+  buffers of the Romeo microphones are deinterleaved 4 frames at a time with SSE2 shuffles (8 with AVX2 when
+  the library is built with -mavx2), and the 4 channels of Pepper, or any group of 4 channels of a larger
+  array, with a 4 x 4 SSE2 transpose. The remaining channels and frames are converted one by one.
+ */
+class vpAudioConvert
+{
+public:
+  static void floatToPlanar(const float *interleaved, unsigned int nb_channels, unsigned int nb_frames,
+                            float *planar, size_t planar_stride, float scale=1.f);
+  static void int16ToPlanar(const short *interleaved, unsigned int nb_channels, unsigned int nb_frames,
+                            float *planar, size_t planar_stride, float scale=1.f/32768.f);
+};
+
+#endif
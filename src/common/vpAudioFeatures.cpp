@@ -0,0 +1,200 @@
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#if defined(__AVX__)
+#  include <immintrin.h>
+#elif defined(__SSE__)
+#  include <xmmintrin.h>
+#endif
+
+#include <visp/vpException.h>
+
+#include <vpAudioFeatures.h>
+
+/*!
+  Create an estimator of the short-time energy and zero-crossing rate over frames of \e wlen samples
+  every \e hop samples. At 48 kHz the default 512 / 256 gives a frame of 10.7 ms every 5.3 ms.
+ */
+vpAudioFeatures::vpAudioFeatures(unsigned int wlen, unsigned int hop, window_t window)
+  : m_wlen(0), m_hop(0), m_window_type(window), m_w2(), m_w2_cumsum(), m_frame(), m_fill(0),
+    m_energy(0), m_zcr(0), m_total_energy(0), m_nb_frames(0)
+{
+  init(wlen, hop, window);
+}
+
+/*!
+  Change the frame length, the hop and the window. All the memory used by push() is allocated here.
+  \param wlen : Length of a frame in samples, at least 2.
+  \param hop : Number of samples between two frames, between 1 and \e wlen.
+  \param window : Window applied on the frames.
+ */
+void vpAudioFeatures::init(unsigned int wlen, unsigned int hop, window_t window)
+{
+  if (wlen < 2)
+    throw vpException(vpException::badValue, "Audio frame of %d samples", wlen);
+  if (hop == 0 || hop > wlen)
+    throw vpException(vpException::badValue, "Hop of %d samples for a frame of %d samples", hop, wlen);
+
+  m_wlen = wlen;
+  m_hop = hop;
+  m_window_type = window;
+  m_w2.resize(wlen);
+  m_w2_cumsum.resize(wlen);
+  m_frame.assign(wlen, 0.f);
+
+  double cumsum = 0;
+  for (unsigned int j=0; j < wlen; j++) {
+    double c = cos(2. * M_PI * j / (wlen - 1.));
+    double w = 1.;
+    if (window == hamming)
+      w = 0.54 - 0.46 * c;
+    else if (window == hann)
+      w = 0.5 - 0.5 * c;
+    m_w2[j] = (float)(w * w);
+    cumsum += w * w;
+    m_w2_cumsum[j] = cumsum;
+  }
+  reset();
+}
+
+/*!
+  Forget the pending samples, the last features and the total energy.
+ */
+void vpAudioFeatures::reset()
+{
+  m_fill = 0;
+  m_energy = 0;
+  m_zcr = 0;
+  m_total_energy = 0;
+  m_nb_frames = 0;
+}
+
+/*!
+  Add \e n samples of the channel and compute the features of every frame completed by them.
+  \param samples : First sample of the channel.
+  \param n : Number of samples.
+  \param stride : Distance between two samples of the channel, the number of channels of an interleaved buffer.
+  \return Number of frames completed. getEnergy() and getZeroCrossingRate() are the ones of the last of them.
+ */
+unsigned int vpAudioFeatures::push(const float *samples, unsigned int n, unsigned int stride)
+{
+  unsigned int nb_frames = 0;
+  unsigned int i = 0;
+  while (i < n) {
+    unsigned int k = std::min(n - i, m_wlen - m_fill);
+    float *dst = &m_frame[0] + m_fill;
+    const float *src = samples + (size_t)i * stride;
+    if (stride == 1)
+      memcpy(dst, src, k * sizeof(float));
+    else
+      for (unsigned int j=0; j < k; j++)
+        dst[j] = src[(size_t)j * stride];
+    m_fill += k;
+    i += k;
+
+    if (m_fill == m_wlen) {
+      processFrame();
+      nb_frames ++;
+      memmove(&m_frame[0], &m_frame[0] + m_hop, (m_wlen - m_hop) * sizeof(float));
+      m_fill = m_wlen - m_hop;
+    }
+  }
+  return nb_frames;
+}
+
+void vpAudioFeatures::processFrame()
+{
+  m_energy = energy(&m_frame[0]);
+  m_zcr = zeroCrossingRate(&m_frame[0]);
+  m_total_energy += m_energy;
+  m_nb_frames ++;
+}
+
+/*!
+  Energy sum(w[j]^2 x[j]^2) of a frame of getWindowLength() contiguous samples.
+ */
+float vpAudioFeatures::energy(const float *frame) const
+{
+  return dotSquare(&m_w2[0], frame, m_wlen);
+}
+
+/*!
+  Proportion of consecutive samples of a frame of getWindowLength() contiguous samples that have a different
+  sign, a sample being positive if it is > 0 like in the audio tests.
+ */
+float vpAudioFeatures::zeroCrossingRate(const float *frame) const
+{
+  return (float)zeroCrossings(frame, m_wlen) / (m_wlen - 1);
+}
+
+/*!
+  Sum of the short-time energies of \e signal evaluated at every sample, the window starting on the sample and
+  the signal being 0 after its end. Each sample x[i] contributes x[i]^2 times the sum of the first min(i+1, wlen)
+  squared window coefficients, which gives the sum in O(N) instead of O(N.wlen).
+ */
+double vpAudioFeatures::totalEnergy(const float *signal, unsigned int n) const
+{
+  double sum = 0;
+  unsigned int head = std::min(n, m_wlen - 1);
+  for (unsigned int i=0; i < head; i++)
+    sum += (double)signal[i] * signal[i] * m_w2_cumsum[i];
+  double tail = 0;
+  for (unsigned int i=head; i < n; i++)
+    tail += (double)signal[i] * signal[i];
+  return sum + tail * m_w2_cumsum[m_wlen - 1];
+}
+
+/*!
+  Compute sum(w[i] x[i]^2) over \e n samples, 8 or 4 samples at a time when AVX or SSE are available.
+ */
+float vpAudioFeatures::dotSquare(const float *w, const float *x, unsigned int n)
+{
+  unsigned int i = 0;
+  float sum = 0;
+#if defined(__AVX__)
+  __m256 acc = _mm256_setzero_ps();
+  for (; i + 8 <= n; i += 8) {
+    __m256 xi = _mm256_loadu_ps(x + i);
+    acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(w + i), _mm256_mul_ps(xi, xi)));
+  }
+  float partial[8];
+  _mm256_storeu_ps(partial, acc);
+  for (unsigned int k=0; k < 8; k++)
+    sum += partial[k];
+#elif defined(__SSE__)
+  __m128 acc = _mm_setzero_ps();
+  for (; i + 4 <= n; i += 4) {
+    __m128 xi = _mm_loadu_ps(x + i);
+    acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(w + i), _mm_mul_ps(xi, xi)));
+  }
+  float partial[4];
+  _mm_storeu_ps(partial, acc);
+  sum = (partial[0] + partial[1]) + (partial[2] + partial[3]);
+#endif
+  for (; i < n; i++)
+    sum += w[i] * x[i] * x[i];
+  return sum;
+}
+
+/*!
+  Number of sign changes between consecutive samples of \e x.
+ */
+unsigned int vpAudioFeatures::zeroCrossings(const float *x, unsigned int n)
+{
+  unsigned int count = 0;
+  unsigned int i = 1;
+#if defined(__AVX__) || defined(__SSE__)
+  static const unsigned char nb_bits[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+  const __m128 zero = _mm_setzero_ps();
+  for (; i + 4 <= n; i += 4) {
+    int positive = _mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(x + i), zero));
+    int previous = _mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(x + i - 1), zero));
+    count += nb_bits[positive ^ previous];
+  }
+#endif
+  for (; i < n; i++)
+    if ((x[i] > 0) != (x[i-1] > 0))
+      count ++;
+  return count;
+}
@@ -0,0 +1,82 @@
+#ifndef __vpAudioFeatures_h__
+#define __vpAudioFeatures_h__
+
+#include <vector>
+
+/*!
+  Streaming short-time energy and zero-crossing rate of one audio channel.
+
+  The samples are pushed as they come from the sound card. Each time \e hop new samples are available,
+  the last \e wlen samples form a frame whose energy sum(w[j]^2 x[j]^2) and zero-crossing rate are
+  computed. The squared window is tabulated once in init(), the energy of a frame is a SIMD dot product
+  (SSE, or AVX when the library is built with -mavx), and push() never allocates, so that the features
+  can be computed continuously at 48 kHz.
+
+  totalEnergy() gives in O(N) the sum of the short-time energies evaluated at every sample of a finished
+  recording, that the audio tests used to compute in O(N.wlen).
+
+  \code
+  vpAudioFeatures left(512, 256), right(512, 256);
+  while (...) {
+    // interleaved stereo buffer of n frames
+    left.push(buffer, n, 2);
+    right.push(buffer + 1, n, 2);
+    if (left.getNbFrames() && right.getNbFrames())
+      ratio = right.getEnergy() / left.getEnergy();
+  }
+  \endcode
+ */
+class vpAudioFeatures
+{
+public:
+  typedef enum {
+    rectangular,
+    hamming,
+    hann
+  } window_t;
+
+protected:
+  unsigned int m_wlen;
+  unsigned int m_hop;
+  window_t m_window_type;
+  std::vector<float> m_w2;        // Squared window
+  std::vector<double> m_w2_cumsum; // m_w2_cumsum[j] = sum of m_w2[0..j]
+  std::vector<float> m_frame;     // Last samples, the oldest first
+  unsigned int m_fill;            // Number of samples in m_frame
+  float m_energy;
+  float m_zcr;
+  double m_total_energy;
+  unsigned int m_nb_frames;
+
+public:
+  vpAudioFeatures(unsigned int wlen=512, unsigned int hop=256, window_t window=hamming);
+  virtual ~vpAudioFeatures() {}
+
+  float energy(const float *frame) const;
+  //! Energy of the last complete frame.
+  float getEnergy() const {return m_energy;}
+  //! Number of frames processed since the last reset().
+  unsigned int getNbFrames() const {return m_nb_frames;}
+  unsigned int getHop() const {return m_hop;}
+  //! Sum of the energies of the frames processed since the last reset().
+  double getTotalEnergy() const {return m_total_energy;}
+  const std::vector<float> &getSquaredWindow() const {return m_w2;}
+  unsigned int getWindowLength() const {return m_wlen;}
+  //! Zero-crossing rate of the last complete frame, between 0 and 1.
+  float getZeroCrossingRate() const {return m_zcr;}
+
+  void init(unsigned int wlen, unsigned int hop, window_t window=hamming);
+  unsigned int push(const float *samples, unsigned int n, unsigned int stride=1);
+  void reset();
+
+  double totalEnergy(const float *signal, unsigned int n) const;
+  float zeroCrossingRate(const float *frame) const;
+
+  static float dotSquare(const float *w, const float *x, unsigned int n);
+  static unsigned int zeroCrossings(const float *x, unsigned int n);
+
+protected:
+  void processFrame();
+};
+
+#endif
@@ -0,0 +1,257 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <iostream>
+
+#include <visp/vpException.h>
+#include <visp/vpTime.h>
+
+#include <vpAudioRecorder.h>
+
+namespace {
+  void put16(unsigned char *p, uint16_t v) {memcpy(p, &v, sizeof(v));}
+  void put32(unsigned char *p, uint32_t v) {memcpy(p, &v, sizeof(v));}
+
+  // Write all the bytes, retrying after partial writes and signals
+  bool writeAll(int fd, const void *data, size_t size)
+  {
+    const char *ptr = (const char *)data;
+    while (size > 0) {
+      ssize_t n = ::write(fd, ptr, size);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        return false;
+      ptr += n;
+      size -= (size_t)n;
+    }
+    return true;
+  }
+}
+
+vpAudioRecorder::vpAudioRecorder()
+  : m_ring(1, 1), m_filename(), m_format(raw), m_sample_rate(0), m_block_frames(0), m_fd(-1), m_nb_frames(0),
+    m_block(), m_channels(), m_interleaved(), m_thread(NULL), m_stop_requested(false), m_io_error(false),
+    m_file_full(false)
+{
+}
+
+vpAudioRecorder::~vpAudioRecorder()
+{
+  try {
+    close();
+  }
+  catch (const vpException &e) {
+    std::cerr << e.getMessage() << std::endl;
+  }
+}
+
+/*!
+  Create the file and start the writing thread. Should be called before the producer starts.
+  \param filename : Name of the file.
+  \param nb_channels : Number of channels of the stream.
+  \param sample_rate : Sample rate of the stream in Hz.
+  \param format : Format of the file.
+  \param buffer_duration : Duration in s of the ring buffer, that absorbs the latency of the disk.
+  \param block_frames : Number of frames written at once.
+ */
+void vpAudioRecorder::open(const std::string &filename, unsigned int nb_channels, double sample_rate,
+                           format_t format, double buffer_duration, unsigned int block_frames)
+{
+  close();
+  if (sample_rate <= 0 || block_frames == 0)
+    throw vpException(vpException::badValue, "Audio recording at %f Hz by blocks of %d frames",
+                      sample_rate, block_frames);
+
+  m_ring.init(nb_channels, std::max((unsigned int)(sample_rate * buffer_duration), 2 * block_frames));
+  m_fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (m_fd < 0)
+    throw vpException(vpException::ioError, "Cannot create audio file %s: %s", filename.c_str(), strerror(errno));
+
+  m_filename = filename;
+  m_format = format;
+  m_sample_rate = sample_rate;
+  m_block_frames = block_frames;
+  m_nb_frames = 0;
+  m_block.assign((size_t)nb_channels * block_frames, 0.f);
+  m_channels.resize(nb_channels);
+  for (unsigned int c=0; c < nb_channels; c++)
+    m_channels[c] = &m_block[0] + (size_t)c * block_frames;
+  m_interleaved.resize(format == wav ? (size_t)nb_channels * block_frames : 0);
+  m_io_error = false;
+  m_file_full = false;
+  m_stop_requested = false;
+
+  writeHeader();
+  if (m_io_error) {
+    ::close(m_fd);
+    m_fd = -1;
+    throw vpException(vpException::ioError, "Cannot write audio file %s: %s", filename.c_str(), strerror(errno));
+  }
+  m_thread = new vpThread(writerLoop, (vpThread::Args)this);
+}
+
+/*!
+  Write the frames still in the ring buffer, stop the writing thread and close the file. Should be called once
+  the producer stopped.
+ */
+void vpAudioRecorder::close()
+{
+  if (m_thread == NULL)
+    return;
+  m_stop_requested = true;
+  __sync_synchronize();
+  m_thread->join();
+  delete m_thread;
+  m_thread = NULL;
+
+  writeHeader();
+  ::close(m_fd);
+  m_fd = -1;
+  if (m_io_error)
+    throw vpException(vpException::ioError, "Cannot write audio file %s", m_filename.c_str());
+  if (m_file_full)
+    throw vpException(vpException::ioError, "Audio file %s stopped at the 4 GiB limit of the WAVE format after %lu "
+                      "frames, use the raw format", m_filename.c_str(), (unsigned long)m_nb_frames);
+}
+
+vpThread::Return vpAudioRecorder::writerLoop(vpThread::Args args)
+{
+  vpAudioRecorder *recorder = (vpAudioRecorder *)args;
+  recorder->run();
+  return 0;
+}
+
+void vpAudioRecorder::run()
+{
+  while (! m_io_error && ! m_file_full) {
+    bool stop_requested = m_stop_requested;
+    __sync_synchronize(); // Frames written before the stop request are seen below
+    unsigned int n = std::min(m_ring.getNbAvailable(), m_block_frames);
+    if (n == m_block_frames || (stop_requested && n > 0))
+      writeBlock(n);
+    else if (stop_requested)
+      break;
+    else
+      vpTime::wait(5);
+  }
+}
+
+/*!
+  Pull \e nb_frames frames from the ring buffer and append them to the file. A WAVE file stops at its
+  maximal size: the frames that do not fit are left in the ring buffer.
+ */
+void vpAudioRecorder::writeBlock(unsigned int nb_frames)
+{
+  if (m_format == wav) {
+    uint64_t nb_max = getWavMaxFrames(m_ring.getNbChannels()) - m_nb_frames;
+    if (nb_frames >= nb_max) {
+      nb_frames = (unsigned int)nb_max;
+      m_file_full = true;
+      if (nb_frames == 0)
+        return;
+    }
+  }
+  m_ring.read(&m_channels[0], nb_frames, nb_frames);
+  unsigned int nb_channels = m_ring.getNbChannels();
+  bool ok;
+  if (m_format == raw) {
+    if (nb_frames < m_block_frames)
+      for (unsigned int c=0; c < nb_channels; c++)
+        memset(m_channels[c] + nb_frames, 0, (m_block_frames - nb_frames) * sizeof(float));
+    ok = writeAll(m_fd, &m_block[0], m_block.size() * sizeof(float));
+  }
+  else {
+    for (unsigned int c=0; c < nb_channels; c++)
+      for (unsigned int i=0; i < nb_frames; i++)
+        m_interleaved[(size_t)i * nb_channels + c] = m_channels[c][i];
+    ok = writeAll(m_fd, &m_interleaved[0], (size_t)nb_frames * nb_channels * sizeof(float));
+  }
+  if (! ok) {
+    m_io_error = true;
+    return;
+  }
+  m_nb_frames += nb_frames;
+  writeHeader();
+}
+
+/*!
+  Write or update the header with the current number of frames, without moving the file offset.
+ */
+void vpAudioRecorder::writeHeader()
+{
+  unsigned int nb_channels = m_ring.getNbChannels();
+  ssize_t size;
+  if (m_format == raw) {
+    vpHeader header = getRawHeader(nb_channels, m_sample_rate, m_block_frames, m_nb_frames);
+    size = sizeof(header);
+    if (pwrite(m_fd, &header, sizeof(header), 0) != size)
+      m_io_error = true;
+  }
+  else {
+    unsigned char header[wavHeaderSize];
+    getWavHeader(nb_channels, m_sample_rate, m_nb_frames, header);
+    size = wavHeaderSize;
+    if (pwrite(m_fd, header, wavHeaderSize, 0) != size)
+      m_io_error = true;
+  }
+  if (m_nb_frames == 0 && lseek(m_fd, size, SEEK_SET) < 0)
+    m_io_error = true;
+}
+
+/*!
+  Header of a raw file of \e nb_frames frames.
+ */
+vpAudioRecorder::vpHeader vpAudioRecorder::getRawHeader(unsigned int nb_channels, double sample_rate,
+                                                        unsigned int block_frames, uint64_t nb_frames)
+{
+  vpHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, "RTKAUD", 6);
+  header.version = version;
+  header.nb_channels = nb_channels;
+  header.sample_rate = sample_rate;
+  header.block_frames = block_frames;
+  header.header_size = sizeof(vpHeader);
+  header.nb_frames = nb_frames;
+  return header;
+}
+
+/*!
+  Header of a float32 WAVE file of \e nb_frames frames, in \e header of wavHeaderSize bytes.
+  Throw a vpException if the file would be larger than 4 GiB, that the 32 bits sizes of the header cannot hold.
+ */
+void vpAudioRecorder::getWavHeader(unsigned int nb_channels, double sample_rate, uint64_t nb_frames,
+                                   unsigned char *header)
+{
+  if (nb_frames > getWavMaxFrames(nb_channels))
+    throw vpException(vpException::badValue, "A WAVE file cannot hold %lu frames of %d channels",
+                      (unsigned long)nb_frames, nb_channels);
+  uint32_t data_size = (uint32_t)(nb_frames * nb_channels * sizeof(float));
+  uint32_t rate = (uint32_t)(sample_rate + 0.5);
+  memcpy(header, "RIFF", 4);
+  put32(header + 4, 36 + data_size);
+  memcpy(header + 8, "WAVEfmt ", 8);
+  put32(header + 16, 16);
+  put16(header + 20, 3); // WAVE_FORMAT_IEEE_FLOAT
+  put16(header + 22, (uint16_t)nb_channels);
+  put32(header + 24, rate);
+  put32(header + 28, rate * nb_channels * (uint32_t)sizeof(float));
+  put16(header + 32, (uint16_t)(nb_channels * sizeof(float)));
+  put16(header + 34, 32);
+  memcpy(header + 36, "data", 4);
+  put32(header + 40, data_size);
+}
+
+/*!
+  Maximal number of frames of a float32 WAVE file of \e nb_channels channels, so that the size of the file
+  fits in the 32 bits of its header.
+ */
+uint64_t vpAudioRecorder::getWavMaxFrames(unsigned int nb_channels)
+{
+  return ((uint64_t)0xffffffffu - (wavHeaderSize - 8)) / ((uint64_t)std::max(nb_channels, 1u) * sizeof(float));
+}
@@ -0,0 +1,131 @@
+#ifndef __vpAudioRecorder_h__
+#define __vpAudioRecorder_h__
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <visp3/core/vpThread.h>
+
+#include <vpAudioRingBuffer.h>
+
+/*!
+  Record an audio stream to a binary file from a background thread, instead of dumping whole recordings as
+  text with writemat() at the end of the audio tests.
+
+  The sound card callback, usually the one of a vpAudioCapture given to vpAudioCapture::setRecorder(), pushes
+  the frames in a vpAudioRingBuffer of the recorder without blocking. The writing thread pulls them by blocks
+  and writes them with a single system call per block. Two formats are available:
+  - raw: float32 planar blocks after a small header, read back by vpAudioRecording without any conversion;
+  - wav: float32 interleaved WAVE file, that audio editors and scripts can open.
+
+  The number of frames is updated in the header after each block, so that the file stays readable if the
+  program crashes. Frames that do not fit in the ring buffer because the disk is too slow are dropped and
+  counted.
+
+  The sizes of a WAVE file are 32 bits: the recording stops once the file reaches 4 GiB (about 3 hours of
+  2 channels at 48 kHz), and close() then throws an exception. Long recordings should use the raw format.
+
+  The raw file starts with a header:
+  - "RTKAUD" followed by two null characters and the format version (uint32);
+  - number of channels (uint32), sample rate in Hz (double);
+  - number of frames per block and header size in bytes (uint32);
+  - number of frames (uint64).
+
+  Each block then holds the samples of each channel one after the other. The last block is padded with zeros.
+  Values are written in the native byte order.
+
+  \code
+  vpAudioCapture capture(2, 48000, 1024, 512);
+  vpAudioRecorder recorder;
+  recorder.open("speech.raw", 2, 48000);
+  capture.setRecorder(&recorder);
+  ... // start the RtAudio stream with vpAudioCapture::callbackInt16
+  ... // stop the stream
+  recorder.close();
+  \endcode
+ */
+class vpAudioRecorder
+{
+public:
+  static const unsigned int version = 1;
+  static const unsigned int wavHeaderSize = 44;
+
+  typedef enum {
+    raw,
+    wav
+  } format_t;
+
+  //! Header of a raw audio file.
+  struct vpHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t nb_channels;
+    double sample_rate;
+    uint32_t block_frames;
+    uint32_t header_size;
+    uint64_t nb_frames;
+  };
+
+protected:
+  vpAudioRingBuffer m_ring;
+  std::string m_filename;
+  format_t m_format;
+  double m_sample_rate;
+  unsigned int m_block_frames;
+  int m_fd;
+  uint64_t m_nb_frames;
+  std::vector<float> m_block;       // Planar samples of the block being written
+  std::vector<float *> m_channels;
+  std::vector<float> m_interleaved; // Block interleaved for the wav format
+  vpThread *m_thread;
+  volatile bool m_stop_requested;
+  volatile bool m_io_error;
+  volatile bool m_file_full;        // The WAVE file reached its maximal size
+
+public:
+  vpAudioRecorder();
+  virtual ~vpAudioRecorder();
+
+  void close();
+
+  static vpHeader getRawHeader(unsigned int nb_channels, double sample_rate, unsigned int block_frames,
+                               uint64_t nb_frames);
+  static void getWavHeader(unsigned int nb_channels, double sample_rate, uint64_t nb_frames, unsigned char *header);
+  static uint64_t getWavMaxFrames(unsigned int nb_channels);
+
+  std::string getFilename() const {return m_filename;}
+  format_t getFormat() const {return m_format;}
+  unsigned int getNbChannels() const {return m_ring.getNbChannels();}
+  //! Number of frames dropped because the writing thread was late.
+  unsigned long getNbDropped() const {return m_ring.getNbDropped();}
+  //! Number of frames written in the file.
+  unsigned long getNbFrames() const {return (unsigned long)m_nb_frames;}
+  double getSampleRate() const {return m_sample_rate;}
+
+  bool isOpened() const {return m_thread != NULL;}
+
+  void open(const std::string &filename, unsigned int nb_channels, double sample_rate,
+            format_t format=vpAudioRecorder::raw, double buffer_duration=2., unsigned int block_frames=4096);
+
+  //! Producer side: append interleaved float frames, see vpAudioRingBuffer::write().
+  unsigned int write(const float *interleaved, unsigned int nb_frames) {return m_ring.write(interleaved, nb_frames);}
+  //! Producer side: append interleaved int16 frames, see vpAudioRingBuffer::writeInt16().
+  unsigned int writeInt16(const short *interleaved, unsigned int nb_frames)
+  {
+    return m_ring.writeInt16(interleaved, nb_frames);
+  }
+
+protected:
+  void run();
+  void writeBlock(unsigned int nb_frames);
+  void writeHeader();
+  static vpThread::Return writerLoop(vpThread::Args args);
+
+private:
+  vpAudioRecorder(const vpAudioRecorder &);
+  vpAudioRecorder &operator=(const vpAudioRecorder &);
+};
+
+#endif
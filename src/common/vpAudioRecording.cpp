@@ -0,0 +1,180 @@
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <fstream>
+
+#include <visp/vpException.h>
+
+#include <vpAudioConvert.h>
+#include <vpAudioRecording.h>
+
+namespace {
+  uint16_t get16(const unsigned char *p) {uint16_t v; memcpy(&v, p, sizeof(v)); return v;}
+  uint32_t get32(const unsigned char *p) {uint32_t v; memcpy(&v, p, sizeof(v)); return v;}
+}
+
+vpAudioRecording::vpAudioRecording()
+  : m_nb_channels(0), m_nb_frames(0), m_sample_rate(0), m_samples()
+{
+}
+
+/*!
+  Allocate a recording of \e nb_frames frames of \e nb_channels channels, set to zero.
+ */
+void vpAudioRecording::init(unsigned int nb_channels, unsigned long nb_frames, double sample_rate)
+{
+  m_nb_channels = nb_channels;
+  m_nb_frames = nb_frames;
+  m_sample_rate = sample_rate;
+  m_samples.assign((size_t)nb_channels * nb_frames + 1, 0.f); // +1 so that getChannel() is valid when empty
+}
+
+/*!
+  Load a raw file written by vpAudioRecorder or a WAVE file, recognized by their first bytes.
+ */
+void vpAudioRecording::open(const std::string &filename)
+{
+  std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+  if (! file.is_open())
+    throw vpException(vpException::ioError, "Cannot open audio file %s", filename.c_str());
+  char magic[8];
+  file.read(magic, sizeof(magic));
+  if (! file.good())
+    throw vpException(vpException::ioError, "Audio file %s is too short", filename.c_str());
+  file.seekg(0);
+  if (memcmp(magic, "RTKAUD", 6) == 0)
+    openRaw(file, filename);
+  else if (memcmp(magic, "RIFF", 4) == 0)
+    openWav(file, filename);
+  else
+    throw vpException(vpException::ioError, "%s is not a raw or WAVE audio file", filename.c_str());
+}
+
+void vpAudioRecording::openRaw(std::ifstream &file, const std::string &filename)
+{
+  vpAudioRecorder::vpHeader header;
+  file.read((char *)&header, sizeof(header));
+  if (! file.good())
+    throw vpException(vpException::ioError, "Cannot read the header of %s", filename.c_str());
+  if (header.version != vpAudioRecorder::version)
+    throw vpException(vpException::ioError, "Unsupported audio file version %d", header.version);
+  if (header.nb_channels == 0 || header.block_frames == 0)
+    throw vpException(vpException::ioError, "Invalid audio file %s", filename.c_str());
+
+  init(header.nb_channels, (unsigned long)header.nb_frames, header.sample_rate);
+  file.seekg(header.header_size);
+  // Each channel of a block is contiguous in the file and in memory
+  for (unsigned long first=0; first < m_nb_frames; first += header.block_frames) {
+    unsigned long n = std::min((unsigned long)header.block_frames, m_nb_frames - first);
+    for (unsigned int c=0; c < m_nb_channels; c++) {
+      file.read((char *)(getChannel(c) + first), n * sizeof(float));
+      if (n < header.block_frames)
+        file.seekg((header.block_frames - n) * sizeof(float), std::ios::cur);
+    }
+    if (! file.good())
+      throw vpException(vpException::ioError, "Audio file %s is truncated", filename.c_str());
+  }
+}
+
+void vpAudioRecording::openWav(std::ifstream &file, const std::string &filename)
+{
+  file.seekg(0, std::ios::end);
+  std::streamoff file_size = file.tellg();
+  file.seekg(0);
+
+  unsigned char riff[12];
+  file.read((char *)riff, sizeof(riff));
+  if (! file.good() || memcmp(riff + 8, "WAVE", 4) != 0)
+    throw vpException(vpException::ioError, "%s is not a WAVE file", filename.c_str());
+
+  unsigned int format = 0, nb_channels = 0, bits = 0;
+  double sample_rate = 0;
+  unsigned char chunk[8];
+  for (;;) {
+    file.read((char *)chunk, sizeof(chunk));
+    if (! file.good())
+      throw vpException(vpException::ioError, "No data in WAVE file %s", filename.c_str());
+    uint32_t size = get32(chunk + 4);
+    if (memcmp(chunk, "fmt ", 4) == 0) {
+      unsigned char fmt[40];
+      memset(fmt, 0, sizeof(fmt));
+      file.read((char *)fmt, std::min(size, (uint32_t)sizeof(fmt)));
+      format = get16(fmt);
+      nb_channels = get16(fmt + 2);
+      sample_rate = get32(fmt + 4);
+      bits = get16(fmt + 14);
+      if (format == 0xFFFE) // WAVE_FORMAT_EXTENSIBLE: the format starts the sub-format GUID
+        format = get16(fmt + 24);
+      file.seekg(size - std::min(size, (uint32_t)sizeof(fmt)) + (size & 1), std::ios::cur);
+    }
+    else if (memcmp(chunk, "data", 4) == 0) {
+      break;
+    }
+    else {
+      file.seekg(size + (size & 1), std::ios::cur);
+    }
+  }
+  if (nb_channels == 0 || ! ((format == 1 && bits == 16) || (format == 3 && bits == 32)))
+    throw vpException(vpException::ioError, "WAVE file %s is not 16 bits PCM nor 32 bits float", filename.c_str());
+
+  // The size of the data is wrong if the recording program crashed: trust the size of the file
+  uint32_t data_size = get32(chunk + 4);
+  std::streamoff remaining = file_size - file.tellg();
+  if (data_size == 0 || (std::streamoff)data_size > remaining)
+    data_size = (uint32_t)remaining;
+  unsigned int frame_size = nb_channels * bits / 8;
+  init(nb_channels, data_size / frame_size, sample_rate);
+
+  std::vector<char> data((size_t)m_nb_frames * frame_size + 1);
+  file.read(&data[0], (std::streamsize)m_nb_frames * frame_size);
+  if (! file.good())
+    throw vpException(vpException::ioError, "Cannot read WAVE file %s", filename.c_str());
+  if (format == 1)
+    vpAudioConvert::int16ToPlanar((const short *)&data[0], nb_channels, m_nb_frames, getChannel(0), m_nb_frames);
+  else
+    vpAudioConvert::floatToPlanar((const float *)&data[0], nb_channels, m_nb_frames, getChannel(0), m_nb_frames);
+}
+
+/*!
+  Write the recording in a raw file that open() and the tools read back, or in a 32 bits float WAVE file.
+ */
+void vpAudioRecording::save(const std::string &filename, vpAudioRecorder::format_t format,
+                            unsigned int block_frames) const
+{
+  if (format == vpAudioRecorder::wav && m_nb_frames > vpAudioRecorder::getWavMaxFrames(m_nb_channels))
+    throw vpException(vpException::badValue, "Audio file %s: a WAVE file cannot hold %lu frames, use the raw format",
+                      filename.c_str(), m_nb_frames);
+
+  std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (! file.is_open())
+    throw vpException(vpException::ioError, "Cannot create audio file %s", filename.c_str());
+
+  if (format == vpAudioRecorder::raw) {
+    if (block_frames == 0)
+      block_frames = 4096;
+    vpAudioRecorder::vpHeader header = vpAudioRecorder::getRawHeader(m_nb_channels, m_sample_rate, block_frames,
+                                                                      m_nb_frames);
+    file.write((const char *)&header, sizeof(header));
+    std::vector<float> padding(block_frames, 0.f);
+    for (unsigned long first=0; first < m_nb_frames; first += block_frames) {
+      unsigned long n = std::min((unsigned long)block_frames, m_nb_frames - first);
+      for (unsigned int c=0; c < m_nb_channels; c++) {
+        file.write((const char *)(getChannel(c) + first), n * sizeof(float));
+        file.write((const char *)&padding[0], (block_frames - n) * sizeof(float));
+      }
+    }
+  }
+  else {
+    unsigned char header[vpAudioRecorder::wavHeaderSize];
+    vpAudioRecorder::getWavHeader(m_nb_channels, m_sample_rate, m_nb_frames, header);
+    file.write((const char *)header, sizeof(header));
+    std::vector<float> interleaved((size_t)m_nb_channels * m_nb_frames + 1);
+    for (unsigned int c=0; c < m_nb_channels; c++)
+      for (unsigned long i=0; i < m_nb_frames; i++)
+        interleaved[i * m_nb_channels + c] = getChannel(c)[i];
+    file.write((const char *)&interleaved[0], (std::streamsize)(m_nb_channels * m_nb_frames * sizeof(float)));
+  }
+  if (! file.good())
+    throw vpException(vpException::ioError, "Cannot write audio file %s", filename.c_str());
+}
@@ -0,0 +1,58 @@
+#ifndef __vpAudioRecording_h__
+#define __vpAudioRecording_h__
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <vpAudioRecorder.h>
+
+/*!
+  Audio recording loaded in memory as planar float samples, from a raw file written by vpAudioRecorder or from
+  a WAVE file (16 bits PCM or 32 bits float). A raw file is read with one system call per block and no
+  conversion, which loads minutes of 48 kHz audio in milliseconds. save() writes the samples back in one of
+  the formats of vpAudioRecorder, for example after converting an old text dump.
+
+  \code
+  vpAudioRecording recording;
+  recording.open("speech.raw");
+  vpSoundLocalization localization(recording.getSampleRate(), 1024);
+  for (unsigned long i=0; i + 1024 <= recording.getNbFrames(); i += 512)
+    if (localization.process(recording.getChannel(0) + i, recording.getChannel(1) + i))
+      std::cout << localization.getAzimuth() << std::endl;
+  \endcode
+ */
+class vpAudioRecording
+{
+protected:
+  unsigned int m_nb_channels;
+  unsigned long m_nb_frames;
+  double m_sample_rate;
+  std::vector<float> m_samples;   // Channel c starts at m_samples[c * m_nb_frames]
+
+public:
+  vpAudioRecording();
+  virtual ~vpAudioRecording() {}
+
+  //! Samples of channel \e c, getNbFrames() contiguous values.
+  const float *getChannel(unsigned int c) const {return &m_samples[0] + (size_t)c * m_nb_frames;}
+  float *getChannel(unsigned int c) {return &m_samples[0] + (size_t)c * m_nb_frames;}
+  //! Duration in s.
+  double getDuration() const {return m_sample_rate > 0 ? m_nb_frames / m_sample_rate : 0.;}
+  unsigned int getNbChannels() const {return m_nb_channels;}
+  unsigned long getNbFrames() const {return m_nb_frames;}
+  double getSampleRate() const {return m_sample_rate;}
+
+  void init(unsigned int nb_channels, unsigned long nb_frames, double sample_rate);
+
+  void open(const std::string &filename);
+
+  void save(const std::string &filename, vpAudioRecorder::format_t format=vpAudioRecorder::raw,
+            unsigned int block_frames=4096) const;
+
+protected:
+  void openRaw(std::ifstream &file, const std::string &filename);
+  void openWav(std::ifstream &file, const std::string &filename);
+};
+
+#endif
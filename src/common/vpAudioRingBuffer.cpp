@@ -0,0 +1,146 @@
+#include <string.h>
+#include <algorithm>
+
+#include <visp/vpException.h>
+
+#include <vpAudioConvert.h>
+#include <vpAudioRingBuffer.h>
+
+/*!
+  Create a ring buffer of at least \e capacity frames of \e nb_channels samples.
+  The default capacity holds 1.3 s at 48 kHz.
+ */
+vpAudioRingBuffer::vpAudioRingBuffer(unsigned int nb_channels, unsigned int capacity)
+  : m_nb_channels(0), m_capacity(0), m_mask(0), m_data(), m_write(0), m_read(0), m_nb_dropped(0)
+{
+  init(nb_channels, capacity);
+}
+
+/*!
+  Allocate the buffer and empty it. Should not be called while the producer or the consumer runs.
+ */
+void vpAudioRingBuffer::init(unsigned int nb_channels, unsigned int capacity)
+{
+  if (nb_channels == 0 || capacity == 0 || capacity > (1u << 30))
+    throw vpException(vpException::badValue, "Audio ring buffer of %d frames of %d channels", capacity, nb_channels);
+  m_capacity = 1;
+  while (m_capacity < capacity)
+    m_capacity <<= 1;
+  m_mask = m_capacity - 1;
+  m_nb_channels = nb_channels;
+  m_data.assign((size_t)m_capacity * nb_channels, 0.f);
+  m_write = 0;
+  m_read = 0;
+  m_nb_dropped = 0;
+  __sync_synchronize();
+}
+
+/*!
+  Consumer side: number of frames that can be read.
+ */
+unsigned int vpAudioRingBuffer::getNbAvailable() const
+{
+  unsigned long write = m_write;
+  __sync_synchronize();
+  return (unsigned int)(write - m_read);
+}
+
+/*!
+  Producer side: number of frames that can be written without dropping any.
+ */
+unsigned int vpAudioRingBuffer::getNbFree() const
+{
+  unsigned long read = m_read;
+  __sync_synchronize();
+  return m_capacity - (unsigned int)(m_write - read);
+}
+
+/*!
+  Consumer side: copy the \e nb_frames oldest frames in \e channels, then consume the first \e advance of them.
+  Reading frames of the window length and advancing by the hop gives overlapping frames.
+  \param channels : One array of at least \e nb_frames samples per channel.
+  \param nb_frames : Number of frames to copy.
+  \param advance : Number of frames to consume, at most \e nb_frames.
+  \return false if less than \e nb_frames frames are available, in which case nothing is read.
+ */
+bool vpAudioRingBuffer::read(float *const *channels, unsigned int nb_frames, unsigned int advance)
+{
+  if (getNbAvailable() < nb_frames)
+    return false;
+  unsigned int pos = (unsigned int)(m_read & m_mask);
+  unsigned int n1 = std::min(nb_frames, m_capacity - pos);
+  for (unsigned int c=0; c < m_nb_channels; c++) {
+    const float *src = &m_data[0] + (size_t)c * m_capacity;
+    memcpy(channels[c], src + pos, n1 * sizeof(float));
+    memcpy(channels[c] + n1, src, (nb_frames - n1) * sizeof(float));
+  }
+  __sync_synchronize(); // The copies are done before the producer can overwrite the frames
+  m_read += std::min(advance, nb_frames);
+  return true;
+}
+
+/*!
+  Consumer side: drop the \e nb_frames oldest frames, for example to catch up after a long processing.
+  \return false if less than \e nb_frames frames are available, in which case nothing is dropped.
+ */
+bool vpAudioRingBuffer::skip(unsigned int nb_frames)
+{
+  if (getNbAvailable() < nb_frames)
+    return false;
+  __sync_synchronize();
+  m_read += nb_frames;
+  return true;
+}
+
+/*!
+  Producer side: number of the \e nb_frames frames that fit in the buffer. The others are counted as dropped.
+ */
+unsigned int vpAudioRingBuffer::reserve(unsigned int nb_frames)
+{
+  unsigned int n = std::min(nb_frames, getNbFree());
+  if (n < nb_frames)
+    m_nb_dropped += nb_frames - n;
+  return n;
+}
+
+/*!
+  Producer side: make the \e nb_frames frames written after the previous ones visible to the consumer.
+ */
+void vpAudioRingBuffer::publish(unsigned int nb_frames)
+{
+  __sync_synchronize(); // The samples are written before the consumer can see them
+  m_write += nb_frames;
+}
+
+/*!
+  Producer side: append interleaved float frames. Never blocks nor allocates.
+  \return Number of frames written, less than \e nb_frames if the buffer was full.
+ */
+unsigned int vpAudioRingBuffer::write(const float *interleaved, unsigned int nb_frames)
+{
+  unsigned int n = reserve(nb_frames);
+  unsigned int pos = (unsigned int)(m_write & m_mask);
+  unsigned int n1 = std::min(n, m_capacity - pos);
+  vpAudioConvert::floatToPlanar(interleaved, m_nb_channels, n1, &m_data[0] + pos, m_capacity);
+  vpAudioConvert::floatToPlanar(interleaved + (size_t)n1 * m_nb_channels, m_nb_channels, n - n1,
+                                &m_data[0], m_capacity);
+  publish(n);
+  return n;
+}
+
+/*!
+  Producer side: append interleaved signed 16 bits frames, like the RTAUDIO_SINT16 buffers of the sound card,
+  scaled to [-1, 1[. Never blocks nor allocates.
+  \return Number of frames written, less than \e nb_frames if the buffer was full.
+ */
+unsigned int vpAudioRingBuffer::writeInt16(const short *interleaved, unsigned int nb_frames)
+{
+  unsigned int n = reserve(nb_frames);
+  unsigned int pos = (unsigned int)(m_write & m_mask);
+  unsigned int n1 = std::min(n, m_capacity - pos);
+  vpAudioConvert::int16ToPlanar(interleaved, m_nb_channels, n1, &m_data[0] + pos, m_capacity);
+  vpAudioConvert::int16ToPlanar(interleaved + (size_t)n1 * m_nb_channels, m_nb_channels, n - n1,
+                                &m_data[0], m_capacity);
+  publish(n);
+  return n;
+}
@@ -0,0 +1,61 @@
+#ifndef __vpAudioRingBuffer_h__
+#define __vpAudioRingBuffer_h__
+
+#include <vector>
+
+/*!
+  Lock-free ring buffer of multichannel audio frames between one producer, the sound card callback, and one
+  consumer, the processing thread.
+
+  The samples are stored planar, one contiguous ring per channel, so that the consumer gets each channel as a
+  contiguous array ready for vpAudioFeatures or an FFT. The producer converts the interleaved buffers of the
+  sound card while writing. Both sides only exchange two frame counters with memory barriers: the producer
+  never blocks nor allocates, and when the consumer is too late the newest frames that do not fit are dropped
+  and counted.
+
+  The capacity is rounded up to a power of two frames and allocated by the constructor or init().
+ */
+class vpAudioRingBuffer
+{
+protected:
+  unsigned int m_nb_channels;
+  unsigned int m_capacity;
+  unsigned int m_mask;
+  std::vector<float> m_data;        // Channel c starts at m_data[c * m_capacity]
+  volatile unsigned long m_write;   // Number of frames written, updated by the producer
+  volatile unsigned long m_read;    // Number of frames consumed, updated by the consumer
+  volatile unsigned long m_nb_dropped;
+
+public:
+  vpAudioRingBuffer(unsigned int nb_channels=2, unsigned int capacity=65536);
+  virtual ~vpAudioRingBuffer() {}
+
+  unsigned int getCapacity() const {return m_capacity;}
+  unsigned int getNbAvailable() const;
+  //! Number of frames dropped by the producer because the buffer was full.
+  unsigned long getNbDropped() const {return m_nb_dropped;}
+  unsigned int getNbChannels() const {return m_nb_channels;}
+  unsigned int getNbFree() const;
+  //! Number of frames consumed since init().
+  unsigned long getNbRead() const {return m_read;}
+  //! Number of frames written since init().
+  unsigned long getNbWritten() const {return m_write;}
+
+  void init(unsigned int nb_channels, unsigned int capacity);
+
+  bool read(float *const *channels, unsigned int nb_frames, unsigned int advance);
+  bool skip(unsigned int nb_frames);
+
+  unsigned int write(const float *interleaved, unsigned int nb_frames);
+  unsigned int writeInt16(const short *interleaved, unsigned int nb_frames);
+
+protected:
+  unsigned int reserve(unsigned int nb_frames);
+  void publish(unsigned int nb_frames);
+
+private:
+  vpAudioRingBuffer(const vpAudioRingBuffer &);
+  vpAudioRingBuffer &operator=(const vpAudioRingBuffer &);
+};
+
+#endif
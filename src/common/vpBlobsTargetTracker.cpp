@@ -1,13 +1,18 @@
 
+#include <algorithm>
+
+#include <vpAllocationCounter.h>
 #include <vpBlobsTargetTracker.h>
 #include <visp/vpDisplay.h>
-#include <map>
 
 
 vpBlobsTargetTracker::vpBlobsTargetTracker()
-  : m_colBlob(),  m_state(detection), m_target_found(false), m_P(), m_force_detection(false), m_name("target_blob"),
-    m_blob_list(), m_cog(0,0), m_initPose(true), m_numBlobs(4), m_manual_blob_init(false), m_left_hand_target(true),
-    m_grayLevelMinBlob(0), m_grayLevelMaxBlob(50), m_full_manual(false)
+  : m_colBlob(),  m_state(detection), m_target_found(false), m_P(), m_pose_vvs(), m_force_detection(false),
+    m_name("target_blob"), m_blob_list(), m_cog(0,0), m_initPose(true), m_numBlobs(4), m_manual_blob_init(false),
+    m_left_hand_target(true),
+    m_grayLevelMinBlob(0), m_grayLevelMaxBlob(50), m_full_manual(false),
+    m_profiler("vpBlobsTargetTracker"), m_frame_timestamp(0), m_timestamp(0), m_overlay(),
+    m_blobs_by_angle(), m_poly_vert()
 {
 
   //m_colBlob = new vpColorDetection;
@@ -34,13 +39,16 @@ vpImagePoint vpBlobsTargetTracker::getCog()
 
 bool vpBlobsTargetTracker::track(const cv::Mat &cvI, const vpImage<unsigned char> &I )
 {
+  m_overlay.clear();
 
   if (m_state == detection || m_force_detection) {
     //std::cout << "STATE: DETECTION "<< std::endl;
 
     bool obj_found = false;
-    if (!m_manual_blob_init && !m_full_manual)
+    if (!m_manual_blob_init && !m_full_manual) {
+      vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::detect);
       obj_found = m_colBlob.detect(cvI);
+    }
     // Delete previuos list of blobs
     m_blob_list.clear();
     m_blob_list.resize(4);
@@ -81,9 +89,11 @@ bool vpBlobsTargetTracker::track(const cv::Mat &cvI, const vpImage<unsigned char
         else {
 
           // std::cout << "TARGET FOUND" << std::endl;
+          vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::init);
 
           vpDot2 blob;
-          blob.setGraphics(true);
+          // Dots draw themselves while tracking, only allowed when we draw immediately or when the user has to click
+          blob.setGraphics(m_manual_blob_init || m_overlay.getMode() == vpOverlay::immediate);
           blob.setGraphicsThickness(1);
           blob.setEllipsoidShapePrecision(0.9);
           if (m_manual_blob_init)
@@ -96,7 +106,7 @@ bool vpBlobsTargetTracker::track(const cv::Mat &cvI, const vpImage<unsigned char
           else
           {
             vpImagePoint cog = m_colBlob.getCog(0);
-            vpDisplay::displayCross(I,cog,10, vpColor::red,2 );
+            m_overlay.displayCross(I,cog,10, vpColor::red,2 );
             blob.initTracking(I,cog);
           }
           blob.track(I);
@@ -179,15 +189,21 @@ bool vpBlobsTargetTracker::track(const cv::Mat &cvI, const vpImage<unsigned char
     // std::cout << "STATE: TRACKING "<< std::endl;
     try {
 
-      m_cog.set_uv(0.0,0.0);
-      for(std::list<vpDot2>::iterator it = m_blob_list.begin(); it != m_blob_list.end(); ++it)
       {
-        it->track(I);
-        m_cog += it->getCog();
-      }
+        vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::track);
+        m_cog.set_uv(0.0,0.0);
+        for(std::list<vpDot2>::iterator it = m_blob_list.begin(); it != m_blob_list.end(); ++it)
+        {
+          {
+            vpAllocationCounter::vpExternalScope visp;
+            it->track(I);
+          }
+          m_cog += it->getCog();
+        }
 
 
-      m_cog /= m_blob_list.size();
+        m_cog /= m_blob_list.size();
+      }
 
       // Display the ACTUAL center of gravity of the object
       //vpDisplay::displayCross(I,cog_tot,10, vpColor::blue,2 );
@@ -196,52 +212,60 @@ bool vpBlobsTargetTracker::track(const cv::Mat &cvI, const vpImage<unsigned char
 
 
 
-      // Now we create a map of VpPoint in order to order the points
-
-      std::map< double,vpImagePoint> poly_verteces;
+      // Now we order the points by their angle around the cog. The vectors keep their capacity from one frame
+      // to the other, and like in a std::map, a blob with the same angle than a previous one is ignored
+      vpStageProfiler::vpScopedTimer timer_match(m_profiler, vpStageProfiler::match);
 
-      double theta;
+      m_blobs_by_angle.clear();
       for(std::list<vpDot2>::iterator it=m_blob_list.begin(); it != m_blob_list.end(); ++it)
       {
         // Get the cog of the blob
         vpImagePoint cog = it->getCog();
-
-        theta = atan2(cog.get_v() - m_cog.get_v(), cog.get_u() - m_cog.get_u());
-        // Insert the vertexes in the map (ordered)
-        poly_verteces.insert ( std::pair<double,vpImagePoint>(theta,cog) );
-
+        double theta = atan2(cog.get_v() - m_cog.get_v(), cog.get_u() - m_cog.get_u());
+
+        // Insertion sort, the target has only a few blobs
+        size_t pos = m_blobs_by_angle.size();
+        while (pos > 0 && m_blobs_by_angle[pos-1].first > theta)
+          pos --;
+        if (pos > 0 && m_blobs_by_angle[pos-1].first == theta)
+          continue;
+        m_blobs_by_angle.insert(m_blobs_by_angle.begin() + pos, std::pair<double, vpImagePoint>(theta, cog));
       }
 
       // Now we create a Vector containing the ordered vertexes
 
-      std::vector<vpImagePoint> poly_vert;
+      std::vector<vpImagePoint> &poly_vert = m_poly_vert;
+      poly_vert.clear();
       int index_first= 0;
-      unsigned int count = 0;
 
-      for( std::map<double,vpImagePoint>::iterator it = poly_verteces.begin();  it!=poly_verteces.end(); ++it )
+      for(size_t k = 0; k < m_blobs_by_angle.size(); k++)
       {
-
-        poly_vert.push_back( it->second );
-        if (m_blob_list.front().getCog() == it->second )
-          index_first = count;
-        count++;
-
+        poly_vert.push_back( m_blobs_by_angle[k].second );
+        if (m_blob_list.front().getCog() == m_blobs_by_angle[k].second )
+          index_first = (int)k;
       }
 
       std::rotate(poly_vert.begin(), poly_vert.begin() + index_first, poly_vert.end());
+      timer_match.stop();
       //std::cout << "---------------------------------------" << std::endl;
-      for(unsigned int j = 0; j<poly_vert.size();j++)
+      if (! m_overlay.isHeadless())
       {
-        std::ostringstream s;
-        s << j;
-        vpDisplay::displayText(I, poly_vert[j], s.str(), vpColor::green);
-        //std::cout << "Cog blob " << j << " :" << poly_vert[j] << std::endl;
+        for(unsigned int j = 0; j<poly_vert.size();j++)
+        {
+          std::ostringstream s;
+          s << j;
+          m_overlay.displayText(I, poly_vert[j], s.str(), vpColor::green);
+          //std::cout << "Cog blob " << j << " :" << poly_vert[j] << std::endl;
+        }
+      }
+      {
+        vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::pose);
+        computePose(m_P, poly_vert, m_cam, m_initPose, m_cMo);
       }
-      computePose(m_P, poly_vert, m_cam, m_initPose, m_cMo);
-
 
 
 
+      vpStageProfiler::vpScopedTimer timer_validate(m_profiler, vpStageProfiler::validate);
       bool duplicate = false;
       for(unsigned int i = 0; i < poly_vert.size()-1; i++)
       {
@@ -288,6 +312,9 @@ bool vpBlobsTargetTracker::track(const cv::Mat &cvI, const vpImage<unsigned char
       m_target_found = false;
     }
   }
+  if (m_target_found)
+    m_timestamp = m_frame_timestamp;
+
   return m_target_found;
 }
 
@@ -346,30 +373,39 @@ bool vpBlobsTargetTracker::track(const cv::Mat &cvI, const vpImage<unsigned char
 //  return corners_ordered;
 //}
 
+/*!
+  Compute the pose from the ordered blobs. Once initialized, the pose of the previous frame is refined
+  with vpPoseVirtualVS, that does not allocate.
+ */
 void vpBlobsTargetTracker::computePose(std::vector<vpPoint> &point, const std::vector<vpImagePoint> &corners,
                                        const vpCameraParameters &cam, bool &init, vpHomogeneousMatrix &cMo)
 {
-  vpPose pose;
   double x=0, y=0;
   for (unsigned int i=0; i < point.size(); i ++) {
     vpPixelMeterConversion::convertPoint(cam, corners[i], x, y);
     point[i].set_x(x);
     point[i].set_y(y);
-    pose.addPoint(point[i]);
   }
 
-  if (init) {
-    vpHomogeneousMatrix cMo_dementhon, cMo_lagrange;
-    pose.computePose(vpPose::DEMENTHON_VIRTUAL_VS, cMo_dementhon);
-    double residual_dementhon = pose.computeResidual(cMo_dementhon);
-    pose.computePose(vpPose::LAGRANGE_VIRTUAL_VS, cMo_lagrange);
-    double residual_lagrange = pose.computeResidual(cMo_lagrange);
-    if (residual_dementhon < residual_lagrange)
-      cMo = cMo_dementhon;
-    else
-      cMo = cMo_lagrange;
+  if (! init) {
+    m_pose_vvs.computePose(point, cMo);
+    return;
   }
 
+  vpPose pose;
+  for (unsigned int i=0; i < point.size(); i ++)
+    pose.addPoint(point[i]);
+
+  vpHomogeneousMatrix cMo_dementhon, cMo_lagrange;
+  pose.computePose(vpPose::DEMENTHON_VIRTUAL_VS, cMo_dementhon);
+  double residual_dementhon = pose.computeResidual(cMo_dementhon);
+  pose.computePose(vpPose::LAGRANGE_VIRTUAL_VS, cMo_lagrange);
+  double residual_lagrange = pose.computeResidual(cMo_lagrange);
+  if (residual_dementhon < residual_lagrange)
+    cMo = cMo_dementhon;
+  else
+    cMo = cMo_lagrange;
+
   pose.computePose(vpPose::VIRTUAL_VS, cMo) ;
   init = false;
 }
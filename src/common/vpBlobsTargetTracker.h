@@ -8,6 +8,10 @@
 
 
 #include <vpColorDetection.h>
+#include <vpOverlay.h>
+#include <vpPoseVirtualVS.h>
+#include <vpStageProfiler.h>
+
 class vpBlobsTargetTracker
 {
 public:
@@ -30,6 +34,7 @@ protected:
   std::vector<vpPoint> m_P; // Points of the target
   vpCameraParameters m_cam;
   vpHomogeneousMatrix m_cMo;
+  vpPoseVirtualVS m_pose_vvs; // Pose refinement while tracking, without allocation
   bool m_force_detection;
   std::string m_name;
   std::list<vpDot2> m_blob_list; // blob_list contains the list of the blobs that are detected in the image
@@ -41,6 +46,12 @@ protected:
   unsigned int m_grayLevelMaxBlob;
   unsigned int m_grayLevelMinBlob;
   bool m_full_manual;
+  vpStageProfiler m_profiler;
+  double m_frame_timestamp; // Capture time of the image given to the next track()
+  double m_timestamp; // Capture time of the image of the last successful track()
+  vpOverlay m_overlay;
+  std::vector< std::pair<double, vpImagePoint> > m_blobs_by_angle; // Blobs sorted by angle around the cog
+  std::vector<vpImagePoint> m_poly_vert; // Ordered vertexes of the target
 
 public:
 
@@ -60,6 +71,9 @@ public:
 
   unsigned int getGrayLevelMinBlob() const {return m_grayLevelMinBlob;}
   unsigned int getGrayLevelMaxBlob() const {return m_grayLevelMaxBlob;}
+  vpOverlay &getOverlay() {return m_overlay;}
+  vpStageProfiler &getProfiler() {return m_profiler;}
+  double getTimestamp() const {return m_timestamp;}
 
   void setCameraParameters(const vpCameraParameters &cam) { m_cam = cam; }
 
@@ -104,6 +118,7 @@ public:
     m_colBlob.setMaxAndMinObjectArea(area_min, area_max);
   }
 
+  void setTimestamp(double timestamp) {m_frame_timestamp = timestamp;}
   void setGrayLevelMinBlob(const unsigned int & valueMin)  { m_grayLevelMinBlob = valueMin; }
   void setGrayLevelMaxBlob(const unsigned int & valueMax)  { m_grayLevelMaxBlob = valueMax; }
 
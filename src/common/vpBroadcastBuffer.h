@@ -0,0 +1,141 @@
+#ifndef __vpBroadcastBuffer_h__
+#define __vpBroadcastBuffer_h__
+
+#include <vector>
+
+#include <vpAtomic.h>
+
+/*!
+  Lock-free exchange of the latest value between one producer thread and several consumer threads, that all
+  read the same buffer. This is the vpTripleBuffer of several consumers.
+
+  nb_consumers + 2 preallocated buffers are used: the producer fills its write buffer and publishes it as
+  the latest value, and each consumer holds the buffer it reads. A buffer is only reused by the producer once
+  it is neither the latest value nor held by a consumer, which a reference count per buffer tells. Publishing
+  and updating only exchange indexes and counters with atomic operations, so the producer never blocks, no
+  value is copied, and each consumer gets the newest value when it calls update(). Values published while a
+  consumer was busy are dropped for this consumer.
+
+  \code
+  vpBroadcastBuffer< vpImage<unsigned char> > frames(2); // Detection (0) and display (1) threads
+
+  // Capture thread
+  g.acquire(frame);
+  frames.init(frame); // Preallocate the buffers before the first publish()
+  while (! end) {
+    g.acquire(frames.getWriteBuffer());
+    frames.publish();
+  }
+
+  // Detection thread
+  while (! end) {
+    if (frames.update(0))
+      face_tracker.track(frames.getReadBuffer(0));
+    else
+      vpTime::wait(2);
+  }
+  \endcode
+
+  A consumer should not modify the content of its read buffer, since the other consumers may read it at the
+  same time.
+ */
+template <class T> class vpBroadcastBuffer
+{
+protected:
+  std::vector<T> m_buffers;
+  std::vector<unsigned long> m_sequence;
+  std::vector<long> m_readers;   // Number of consumers holding each buffer, updated atomically
+  volatile long m_latest;        // Index of the latest published buffer, -1 before the first publish()
+  unsigned int m_write;          // Index of the write buffer, owned by the producer
+  std::vector<long> m_read;      // Index of the read buffer of each consumer, owned by the consumer, -1 if none
+  unsigned long m_nb_published;
+
+public:
+  vpBroadcastBuffer(unsigned int nb_consumers)
+    : m_buffers(nb_consumers + 2), m_sequence(nb_consumers + 2, 0), m_readers(nb_consumers + 2, 0), m_latest(-1),
+      m_write(0), m_read(nb_consumers, -1), m_nb_published(0)
+  {
+  }
+  virtual ~vpBroadcastBuffer() {}
+
+  unsigned int getNbConsumers() const {return (unsigned int)m_read.size();}
+  //! Number of values published by the producer. Should only be called by the producer.
+  unsigned long getNbPublished() const {return m_nb_published;}
+  //! Latest value obtained by update(\e consumer). Should only be called by this consumer.
+  const T &getReadBuffer(unsigned int consumer) const {return m_buffers[m_read[consumer] < 0 ? 0 : m_read[consumer]];}
+  /*!
+    Latest value obtained by update(\e consumer). Should only be called by this consumer, that may only modify
+    members the other consumers and the producer do not use, like the display attached to an image.
+   */
+  T &getReadBuffer(unsigned int consumer) {return m_buffers[m_read[consumer] < 0 ? 0 : m_read[consumer]];}
+  //! Sequence number of the read buffer of \e consumer, 0 if no value was read yet.
+  unsigned long getReadSequence(unsigned int consumer) const
+  {
+    return m_read[consumer] < 0 ? 0 : m_sequence[m_read[consumer]];
+  }
+  //! Buffer to fill before publish(). Should only be called by the producer.
+  T &getWriteBuffer() {return m_buffers[m_write];}
+
+  /*!
+    Initialize all the buffers with a copy of \e value, to preallocate them.
+    Should be called by the producer before its first publish().
+   */
+  void init(const T &value)
+  {
+    for (unsigned int i=0; i < m_buffers.size(); i++)
+      m_buffers[i] = value;
+  }
+
+  /*!
+    Publish the write buffer as the latest value. The producer gets as new write buffer one that no
+    consumer holds.
+   */
+  void publish()
+  {
+    m_sequence[m_write] = ++m_nb_published;
+    vpAtomic::store(&m_latest, (long)m_write);
+
+    // Each consumer holds at most one buffer that is not the latest one, so one of the
+    // nb_consumers + 2 buffers is free
+    for (unsigned int i=0; i < m_buffers.size(); i++) {
+      if ((long)i != m_latest && vpAtomic::load(&m_readers[i]) == 0) {
+        m_write = i;
+        return;
+      }
+    }
+  }
+
+  /*!
+    Get the latest published value in the read buffer of \e consumer, and release its previous read buffer.
+    \return true if a new value is available, false if the read buffer is still the latest value.
+   */
+  bool update(unsigned int consumer)
+  {
+    long latest = vpAtomic::load(&m_latest);
+    if (latest < 0 || latest == m_read[consumer])
+      return false;
+
+    if (m_read[consumer] >= 0) {
+      vpAtomic::fetchAndAdd(&m_readers[m_read[consumer]], -1);
+      m_read[consumer] = -1;
+    }
+    // The buffer is held once the counter is incremented, if it is still the latest one at that time.
+    // Otherwise the producer may already write it, and the new latest one is tried.
+    while (1) {
+      vpAtomic::fetchAndAdd(&m_readers[latest], 1);
+      long current = vpAtomic::load(&m_latest);
+      if (current == latest)
+        break;
+      vpAtomic::fetchAndAdd(&m_readers[latest], -1);
+      latest = current;
+    }
+    m_read[consumer] = latest;
+    return true;
+  }
+
+private:
+  vpBroadcastBuffer(const vpBroadcastBuffer &);
+  vpBroadcastBuffer &operator=(const vpBroadcastBuffer &);
+};
+
+#endif
@@ -1,10 +1,23 @@
 #include <vpCartesianDisplacement.h>
 
 
+/*!
+  By default the velocity is the least-squares solution oJo^+ v without damping nor reuse of the
+  factorization, that gives the same joint velocities than the SVD pseudo-inverse without allocating
+  memory. When oJo is singular or nearly singular, the factorization fails and the SVD pseudo-inverse,
+  that discards the small singular values, is used as before.
+
+  Use getSolver() to opt in for a damping that keeps the velocities bounded near the singular
+  configurations and for the reuse of the factorization, for example:
+  \code
+  vpCartesianDisplacement moveCartesian;
+  moveCartesian.getSolver().setAdaptiveDamping(0.05, 1e-3);
+  moveCartesian.getSolver().setReuseTolerance(1e-4);
+  \endcode
+ */
 vpCartesianDisplacement::vpCartesianDisplacement()
-  : m_init_done(false)
+  : m_init_done(false), m_eJe(), m_oJo(), m_solver(0.)
 {
-
 }
 
 vpCartesianDisplacement::~vpCartesianDisplacement()
@@ -12,7 +25,14 @@ vpCartesianDisplacement::~vpCartesianDisplacement()
 
 }
 
-bool vpCartesianDisplacement::computeVelocity(const vpNaoqiRobot &robot, const vpColVector &cart_delta_pos,
+bool vpCartesianDisplacement::computeVelocity(vpNaoqiRobot &robot, const vpColVector &cart_delta_pos,
+                                              double delta_t, const std::string &chain_name, const vpMatrix &oVe)
+{
+  vpNaoqiRobotBackend backend(robot);
+  return computeVelocity(backend, cart_delta_pos, delta_t, chain_name, oVe);
+}
+
+bool vpCartesianDisplacement::computeVelocity(const vpRobotBackend &robot, const vpColVector &cart_delta_pos,
                                               double delta_t, const std::string &chain_name, const vpMatrix &oVe)
 {
   if (! m_init_done) {
@@ -40,9 +60,22 @@ bool vpCartesianDisplacement::computeVelocity(const vpNaoqiRobot &robot, const v
   }
 
   if (vpTime::measureTimeSecond() < m_t_initial + m_delta_t) {
-    vpMatrix oJo = oVe * robot.get_eJe(m_chain_name);
+    robot.get_eJe(m_chain_name, m_eJe);
+
+    // oJo = oVe * eJe in the preallocated workspace
+    if (m_oJo.getRows() != oVe.getRows() || m_oJo.getCols() != m_eJe.getCols())
+      m_oJo.resize(oVe.getRows(), m_eJe.getCols(), false);
+    for (unsigned int i=0; i < oVe.getRows(); i++) {
+      for (unsigned int j=0; j < m_eJe.getCols(); j++) {
+        double sum = 0.;
+        for (unsigned int k=0; k < oVe.getCols(); k++)
+          sum += oVe[i][k] * m_eJe[k][j];
+        m_oJo[i][j] = sum;
+      }
+    }
 
-    m_q_dot = oJo.pseudoInverse() * m_v_o;
+    if (! m_solver.solve(m_oJo, m_v_o, m_q_dot))
+      m_q_dot = m_oJo.pseudoInverse() * m_v_o; // Nearly singular oJo without damping
 
     return true;
   }
@@ -4,6 +4,9 @@
 #include <visp/vpExponentialMap.h>
 #include <visp_naoqi/vpNaoqiRobot.h>
 
+#include <vpDampedLeastSquares.h>
+#include <vpRobotBackend.h>
+
 class vpCartesianDisplacement
 {
 protected:
@@ -14,15 +17,21 @@ protected:
   std::string m_chain_name;
   std::vector<std::string> m_joint_names;
   vpColVector m_q_dot;
+  vpMatrix m_eJe;
+  vpMatrix m_oJo;                  // Jacobian expressed in the object frame
+  vpDampedLeastSquares m_solver;   // Least-squares solver used instead of the SVD pseudo-inverse
 
 public:
   vpCartesianDisplacement();
   ~vpCartesianDisplacement();
-  bool computeVelocity(const vpNaoqiRobot &robot, const vpColVector &cart_delta_pos,
+  bool computeVelocity(vpNaoqiRobot &robot, const vpColVector &cart_delta_pos,
+                       double delta_t, const std::string &chain_name, const vpMatrix &oVe);
+  bool computeVelocity(const vpRobotBackend &robot, const vpColVector &cart_delta_pos,
                        double delta_t, const std::string &chain_name, const vpMatrix &oVe);
 
   vpColVector getJointVelocity() const {return m_q_dot;}
   std::vector<std::string> getJointNames() const {return m_joint_names;}
+  vpDampedLeastSquares &getSolver() {return m_solver;}
 };
 
 #endif
@@ -36,6 +36,9 @@
  *
  *****************************************************************************/
 
+#include <stdio.h>
+
+#include <vpAllocationCounter.h>
 #include <vpColorDetection.h>
 #include <fstream>
 
@@ -46,9 +49,15 @@
 vpColorDetection::vpColorDetection() :
     m_init_learning(0), m_learning_phase(0) ,m_min_obj_area(400), m_max_obj_area(100000),
     m_max_objs_num(10), m_name("object"), m_objects(), m_trackbarWindowName("Trackbars"),
-    m_T(), m_levelMorphOps(true),m_geometricShape(), m_shapeRecognition(false)
+    m_T(), m_HSV(), m_contours_input(), m_erode_element(), m_dilate_element(), m_contours(), m_hierarchy(),
+    m_approx(), m_cosines(),
+    m_levelMorphOps(true),m_geometricShape(), m_shapeRecognition(false), m_frame_timestamp(0), m_timestamp(0)
 
 {
+    m_erode_element = getStructuringElement( cv::MORPH_RECT,cv::Size(3,3)); //3
+    //dilate with larger element so make sure object is nicely visible
+    m_dilate_element = getStructuringElement( cv::MORPH_RECT,cv::Size(8,8)); //8
+
     m_H_min = 0;
     m_H_max = 255;
     m_S_min = 0;
@@ -134,15 +143,12 @@ void vpColorDetection::createTrackbars(){
 */
 void vpColorDetection::morphOps(cv::Mat &T){
 
-    cv::Mat erodeElement = getStructuringElement( cv::MORPH_RECT,cv::Size(3,3)); //3
-    //dilate with larger element so make sure object is nicely visible
-    cv::Mat dilateElement = getStructuringElement( cv::MORPH_RECT,cv::Size(8,8)); //8
     if(m_levelMorphOps)
-        cv::erode(T,T,erodeElement);
-    cv::erode(T,T,erodeElement);
+        cv::erode(T,T,m_erode_element);
+    cv::erode(T,T,m_erode_element);
     if(m_levelMorphOps)
-        cv::dilate(T,T,dilateElement);
-    cv::dilate(T,T,dilateElement);
+        cv::dilate(T,T,m_dilate_element);
+    cv::dilate(T,T,m_dilate_element);
 
 }
 
@@ -156,6 +162,8 @@ void vpColorDetection::morphOps(cv::Mat &T){
    If a object is found the functions getBBox(), getCog() return some information about the location of the object.
 
    The largest object is always available using getBBox(0) or getCog(0).
+
+   The intermediate images are members, so that they are only allocated for the first image or when the image size changes.
  */
 
 bool vpColorDetection::detect(const cv::Mat &I)
@@ -163,20 +171,23 @@ bool vpColorDetection::detect(const cv::Mat &I)
 {
     bool detected = false;
 
-    cv::Mat HSV;
-    cv::Mat T; //Treshold
-    cv::cvtColor(I,HSV,cv::COLOR_BGR2HSV);
-    cv::inRange(HSV,cv::Scalar(m_H_min,m_S_min,m_V_min),cv::Scalar(m_H_max,m_S_max,m_V_max),T);
-    if (m_learning_phase)
-        cv::imshow("Range",T);
-    morphOps(T);
-    detected = trackFilteredObject(T);
+    {
+        vpAllocationCounter::vpExternalScope opencv;
+        cv::cvtColor(I,m_HSV,cv::COLOR_BGR2HSV);
+        cv::inRange(m_HSV,cv::Scalar(m_H_min,m_S_min,m_V_min),cv::Scalar(m_H_max,m_S_max,m_V_max),m_T);
+        if (m_learning_phase)
+            cv::imshow("Range",m_T);
+        morphOps(m_T);
+    }
+    detected = trackFilteredObject(m_T);
     if (m_learning_phase)
     {
         //cv::imshow("Original",I);
-        cv::imshow("HSV Image",HSV);
-        cv::imshow("Treshold",T);
+        cv::imshow("HSV Image",m_HSV);
+        cv::imshow("Treshold",m_T);
     }
+    if (detected)
+        m_timestamp = m_frame_timestamp;
     return detected;
 }
 
@@ -190,7 +201,6 @@ bool vpColorDetection::detect(const cv::Mat &I)
 bool vpColorDetection::trackFilteredObject(cv::Mat threshold)
 {
     m_nb_objects = 0;
-    m_polygon.clear();
     m_objects.clear();
 
     //cv::Mat drawing = cv::Mat::zeros( I.size(), CV_8UC3 );
@@ -198,13 +208,15 @@ bool vpColorDetection::trackFilteredObject(cv::Mat threshold)
 
     int x = 0;
     int y = 0;
-    cv::Mat temp;
-    threshold.copyTo(temp);
     //these two vectors needed for output of findContours
-    std::vector< std::vector<cv::Point> > contours;
-    std::vector<cv::Vec4i> hierarchy;
-    //find contours of filtered image using openCV findContours function
-    cv::findContours(temp, contours, hierarchy, CV_RETR_CCOMP, CV_CHAIN_APPROX_SIMPLE );
+    std::vector< std::vector<cv::Point> > &contours = m_contours;
+    std::vector<cv::Vec4i> &hierarchy = m_hierarchy;
+    {
+        vpAllocationCounter::vpExternalScope opencv;
+        threshold.copyTo(m_contours_input);
+        //find contours of filtered image using openCV findContours function
+        cv::findContours(m_contours_input, contours, hierarchy, CV_RETR_CCOMP, CV_CHAIN_APPROX_SIMPLE );
+    }
     //use moments method to find our filtered object
     bool objectFound = false;
     if (hierarchy.size() > 0)
@@ -217,7 +229,11 @@ bool vpColorDetection::trackFilteredObject(cv::Mat threshold)
 
             for (int index = 0; index >= 0; index = hierarchy[index][0])
             {
-                cv::Moments moment = cv::moments((cv::Mat)contours[index]);
+                cv::Moments moment;
+                {
+                    vpAllocationCounter::vpExternalScope opencv;
+                    moment = cv::moments((cv::Mat)contours[index]);
+                }
                 double area = moment.m00;
 
                 //if the area is less than m_min_obj_area then it is probably just noise
@@ -240,16 +256,24 @@ bool vpColorDetection::trackFilteredObject(cv::Mat threshold)
                     // cv::Rect rect = cv::boundingRect(contours[index]);
                     //cv::rectangle(I, cv::Point(rect.x, rect.y),cv::Point(rect.x+rect.width, rect.y+rect.height),cv::Scalar(0, 0, 255, 0),2, 8, 0);
                     //--m_objects.push_back(rect);
-                    object.rect =  cv::boundingRect(contours[index]);
+                    {
+                        vpAllocationCounter::vpExternalScope opencv;
+                        object.rect =  cv::boundingRect(contours[index]);
+                    }
                     //object.type = found_objects::Unknown;
 
                     if (m_shapeRecognition)
                     {
-                        std::vector<cv::Point> approx;
-                        // Approximate contour with accuracy proportional to the contour perimeter
-                        cv::approxPolyDP(cv::Mat(contours[index]), approx, cv::arcLength(cv::Mat(contours[index]), true) * 0.02, true);
+                        std::vector<cv::Point> &approx = m_approx;
+                        bool convex;
+                        {
+                            vpAllocationCounter::vpExternalScope opencv;
+                            // Approximate contour with accuracy proportional to the contour perimeter
+                            cv::approxPolyDP(cv::Mat(contours[index]), approx, cv::arcLength(cv::Mat(contours[index]), true) * 0.02, true);
+                            convex = cv::isContourConvex(approx);
+                        }
 
-                        if (!cv::isContourConvex(approx))
+                        if (!convex)
                         {
                             object.type = found_objects::Concave;
                         }
@@ -263,7 +287,8 @@ bool vpColorDetection::trackFilteredObject(cv::Mat threshold)
                             int vtc = approx.size();
 
                             // Get the cosines of all corners
-                            std::vector<double> cos;
+                            std::vector<double> &cos = m_cosines;
+                            cos.clear();
                             for (int j = 2; j < vtc+1; j++)
                                 cos.push_back(angle(approx[j%vtc], approx[j-2], approx[j-1]));
 
@@ -306,6 +331,10 @@ bool vpColorDetection::trackFilteredObject(cv::Mat threshold)
 
     }
 
+    // Reuse the strings and polygons of the previous image
+    m_message.resize(m_objects.size());
+    m_polygon.resize(m_objects.size());
+
     if (m_nb_objects > 0)
     {
         objectFound = true;
@@ -316,25 +345,29 @@ bool vpColorDetection::trackFilteredObject(cv::Mat threshold)
 
         for( size_t i = 0; i < m_objects.size(); i++ )
         {
-            std::cout << m_objects[i].type << std::endl;
-            std::ostringstream message;
-            message << m_name << " " << int(i);
+            // The message is rebuilt in the string of the previous image, that keeps its capacity
+            std::string &message = m_message[i];
+            char index[16];
+            sprintf(index, " %d", int(i));
+            message.assign(m_name.data(), m_name.size());
+            message += index;
             if (m_shapeRecognition)
-                message <<"_" << getGeometricShapeString(m_objects[i].type);
-            m_message.push_back( message.str() );
+            {
+                message += "_";
+                message += getGeometricShapeString(m_objects[i].type);
+            }
 
-            std::vector<vpImagePoint> polygon;
+            std::vector<vpImagePoint> &polygon = m_polygon[i];
             double x = m_objects[i].rect.tl().x;
             double y = m_objects[i].rect.tl().y;
             double w = m_objects[i].rect.size().width;
             double h = m_objects[i].rect.size().height;
 
-            polygon.push_back(vpImagePoint(y  , x  ));
-            polygon.push_back(vpImagePoint(y+h, x  ));
-            polygon.push_back(vpImagePoint(y+h, x+w));
-            polygon.push_back(vpImagePoint(y  , x+w));
-
-            m_polygon.push_back(polygon);
+            polygon.resize(4);
+            polygon[0].set_ij(y  , x  );
+            polygon[1].set_ij(y+h, x  );
+            polygon[2].set_ij(y+h, x+w);
+            polygon[3].set_ij(y  , x+w);
         }
 
     }
@@ -455,7 +488,7 @@ double vpColorDetection::angle(cv::Point pt1, cv::Point pt2, cv::Point pt0)
 }
 
 
-std::string vpColorDetection::getGeometricShapeString(found_objects::GeometricShape shape)
+const char *vpColorDetection::getGeometricShapeString(found_objects::GeometricShape shape)
 {
     switch( shape )
     {
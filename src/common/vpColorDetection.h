@@ -110,11 +110,21 @@ protected:
 
   const std::string m_trackbarWindowName; //!< Name of the trackbar window in opencv
   cv::Mat m_T; //!< OpenCV image used as input for the object detection.
+  cv::Mat m_HSV; //!< Input image converted in HSV.
+  cv::Mat m_contours_input; //!< Copy of the threshold image modified by cv::findContours().
+  cv::Mat m_erode_element; //!< Structuring element of the erosion.
+  cv::Mat m_dilate_element; //!< Structuring element of the dilation.
+  std::vector< std::vector<cv::Point> > m_contours; //!< Contours of the threshold image.
+  std::vector<cv::Vec4i> m_hierarchy; //!< Hierarchy of the contours.
+  std::vector<cv::Point> m_approx; //!< Polygonal approximation of a contour, for the shape recognition.
+  std::vector<double> m_cosines; //!< Cosines of the corners of a polygon, for the shape recognition.
 
   bool m_levelMorphOps;
   //GeometricShape m_geometricShape; //!< Indicate the geometricShape of the object
   std::vector <found_objects::GeometricShape> m_geometricShape;
   bool m_shapeRecognition; //!< If true the geometric shape recognition is activated
+  double m_frame_timestamp; //!< Capture time of the image given to the next detect()
+  double m_timestamp; //!< Capture time of the image of the last successful detect()
 
 
 
@@ -124,7 +134,7 @@ protected:
   void morphOps(cv::Mat &T);
   bool trackFilteredObject(cv::Mat threshold);
   std::string intToString(int number);
-  std::string getGeometricShapeString(found_objects::GeometricShape shape);
+  const char *getGeometricShapeString(found_objects::GeometricShape shape);
 
 public:
 
@@ -137,10 +147,12 @@ public:
 
   std::string getName(){return m_name;}
   std::vector<int> getValueHSV();
+  double getTimestamp() const {return m_timestamp;}
 
   bool learningColor(const cv::Mat &I);
   bool loadHSV(const std::string &filename);
   bool saveHSV(const std::string &filename);
+  void setTimestamp(double timestamp) {m_frame_timestamp = timestamp;}
   void setShapeRecognition(const bool &enable){m_shapeRecognition = enable;}
   //void setGeometricShape(const GeometricShape &shape)  { m_geometricShape = shape; }
   void setLevelMorphOps(const bool level){m_levelMorphOps = level;}
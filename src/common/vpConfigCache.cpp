@@ -0,0 +1,312 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+#include <visp/vpXmlParserCamera.h>
+#include <visp/vpXmlParserHomogeneousMatrix.h>
+
+#include <vpConfigCache.h>
+
+namespace {
+  const char s_magic[8] = "RTKCFG";
+
+  //! FNV-1a hash used to detect a truncated or corrupted cache file.
+  uint32_t checksum(const unsigned char *data, size_t size)
+  {
+    uint32_t h = 2166136261u;
+    for (size_t i=0; i < size; i++) {
+      h ^= data[i];
+      h *= 16777619u;
+    }
+    return h;
+  }
+
+  //! 64 bits FNV-1a hash used to detect a change of the content of an XML file.
+  uint64_t hash64(const unsigned char *data, size_t size)
+  {
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i=0; i < size; i++) {
+      h ^= data[i];
+      h *= 1099511628211ULL;
+    }
+    return h;
+  }
+
+  void write(std::vector<unsigned char> &buffer, const void *data, size_t size)
+  {
+    const unsigned char *p = (const unsigned char *)data;
+    buffer.insert(buffer.end(), p, p + size);
+  }
+
+  void writeString(std::vector<unsigned char> &buffer, const std::string &s)
+  {
+    uint32_t length = (uint32_t)s.size();
+    write(buffer, &length, sizeof(length));
+    write(buffer, s.data(), s.size());
+  }
+
+  bool read(const std::vector<unsigned char> &buffer, size_t &offset, void *data, size_t size)
+  {
+    if (offset + size > buffer.size())
+      return false;
+    memcpy(data, &buffer[offset], size);
+    offset += size;
+    return true;
+  }
+
+  bool readString(const std::vector<unsigned char> &buffer, size_t &offset, std::string &s)
+  {
+    uint32_t length;
+    if (! read(buffer, offset, &length, sizeof(length)) || offset + length > buffer.size())
+      return false;
+    s.assign((const char *)&buffer[0] + offset, length);
+    offset += length;
+    return true;
+  }
+}
+
+vpConfigCache::vpConfigCache()
+  : m_filename(), m_entries(), m_hashes(), m_modified(false), m_nb_loaded(0), m_nb_parsed(0)
+{
+}
+
+/*!
+  Read the binary cache file. Values whose XML file changed since they were cached are discarded, and
+  parsed again when requested.
+  \return false if the cache file does not exist or is not valid. The cache is then empty, but can be used
+  and saved anyway.
+ */
+bool vpConfigCache::load(const std::string &filename)
+{
+  m_filename = filename;
+  m_entries.clear();
+  m_nb_loaded = 0;
+  m_modified = true;
+
+  std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+  if (! file.is_open())
+    return false;
+  std::vector<unsigned char> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+  uint32_t sum;
+  if (buffer.size() < sizeof(s_magic) + 2*sizeof(uint32_t) + sizeof(sum))
+    return false;
+  size_t size = buffer.size() - sizeof(sum);
+  memcpy(&sum, &buffer[size], sizeof(sum));
+  if (sum != checksum(&buffer[0], size) || memcmp(&buffer[0], s_magic, sizeof(s_magic)) != 0) {
+    std::cout << "Ignore the corrupted configuration cache " << filename << std::endl;
+    return false;
+  }
+  buffer.resize(size);
+
+  size_t offset = sizeof(s_magic);
+  uint32_t header[2]; // Version and number of entries
+  read(buffer, offset, header, sizeof(header));
+  if (header[0] != version)
+    return false;
+
+  std::map<std::string, vpEntry> entries;
+  for (uint32_t i=0; i < header[1]; i++) {
+    std::string key;
+    vpEntry entry;
+    if (! readString(buffer, offset, key) || ! readString(buffer, offset, entry.filename)
+        || ! read(buffer, offset, &entry.hash, sizeof(entry.hash))
+        || ! read(buffer, offset, entry.values, sizeof(entry.values)))
+      return false;
+    entries[key] = entry;
+  }
+
+  // Only keep the values of the XML files that did not change
+  for (std::map<std::string, vpEntry>::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+    uint64_t hash;
+    if (getHash(it->second.filename, hash) && hash == it->second.hash)
+      m_entries.insert(*it);
+  }
+  m_nb_loaded = (unsigned int)m_entries.size();
+  m_modified = (m_entries.size() != entries.size());
+  return true;
+}
+
+/*!
+  Write the binary cache file if values were parsed since load().
+  \return false if the file cannot be written.
+ */
+bool vpConfigCache::save()
+{
+  if (! m_modified || m_filename.empty())
+    return true;
+
+  std::vector<unsigned char> buffer;
+  write(buffer, s_magic, sizeof(s_magic));
+  uint32_t header[2] = {version, (uint32_t)m_entries.size()};
+  write(buffer, header, sizeof(header));
+  for (std::map<std::string, vpEntry>::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it) {
+    writeString(buffer, it->first);
+    writeString(buffer, it->second.filename);
+    write(buffer, &it->second.hash, sizeof(it->second.hash));
+    write(buffer, it->second.values, sizeof(it->second.values));
+  }
+  uint32_t sum = checksum(&buffer[0], buffer.size());
+  write(buffer, &sum, sizeof(sum));
+
+  // Write a temporary file first, so that a crash never leaves a partial cache
+  std::string tmp_filename = m_filename + ".tmp";
+  std::ofstream file(tmp_filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (! file.is_open()) {
+    std::cout << "Cannot write the configuration cache " << tmp_filename << std::endl;
+    return false;
+  }
+  file.write((const char *)&buffer[0], buffer.size());
+  file.close();
+  if (file.fail() || rename(tmp_filename.c_str(), m_filename.c_str()) != 0) {
+    std::cout << "Cannot write the configuration cache " << m_filename << std::endl;
+    return false;
+  }
+  m_modified = false;
+  return true;
+}
+
+/*!
+  Get the homogeneous matrix \e name of the XML file \e filename, parsing the file only if the value is
+  not cached yet.
+  \return false if the matrix cannot be found.
+ */
+bool vpConfigCache::getTransform(const std::string &filename, const std::string &name, vpHomogeneousMatrix &M)
+{
+  std::string key = getKey(transform, filename, name);
+  const vpEntry *entry = find(key);
+  if (entry == NULL) {
+    vpXmlParserHomogeneousMatrix parser;
+    if (parser.parse(M, filename, name) != vpXmlParserHomogeneousMatrix::SEQUENCE_OK)
+      return false;
+    m_nb_parsed ++;
+    double values[16];
+    for (unsigned int i=0; i < 4; i++)
+      for (unsigned int j=0; j < 4; j++)
+        values[4*i + j] = M[i][j];
+    store(key, filename, values, 16);
+    return true;
+  }
+
+  for (unsigned int i=0; i < 4; i++)
+    for (unsigned int j=0; j < 4; j++)
+      M[i][j] = entry->values[4*i + j];
+  return true;
+}
+
+/*!
+  Get the parameters of the camera \e camera_name of the XML file \e filename, parsing the file only if
+  the value is not cached yet. See vpXmlParserCamera::parse() for the parameters.
+  \return false if the parameters cannot be found.
+ */
+bool vpConfigCache::getCameraParameters(const std::string &filename, const std::string &camera_name, unsigned int width, unsigned int height,
+                                        const vpCameraParameters::vpCameraParametersProjType &projection, vpCameraParameters &cam)
+{
+  std::ostringstream name;
+  name << camera_name << " " << width << "x" << height << " " << (int)projection;
+  std::string key = getKey(camera, filename, name.str());
+  const vpEntry *entry = find(key);
+  if (entry == NULL) {
+    vpXmlParserCamera parser;
+    if (parser.parse(cam, filename.c_str(), camera_name, projection, width, height) != vpXmlParserCamera::SEQUENCE_OK)
+      return false;
+    m_nb_parsed ++;
+    double values[6] = {cam.get_px(), cam.get_py(), cam.get_u0(), cam.get_v0(), cam.get_kud(), cam.get_kdu()};
+    store(key, filename, values, 6);
+    return true;
+  }
+
+  const double *v = entry->values;
+  if (projection == vpCameraParameters::perspectiveProjWithDistortion)
+    cam.initPersProjWithDistortion(v[0], v[1], v[2], v[3], v[4], v[5]);
+  else
+    cam.initPersProjWithoutDistortion(v[0], v[1], v[2], v[3]);
+  return true;
+}
+
+/*!
+  Save the homogeneous matrix \e name in the XML file \e filename, and update the cache so that the new
+  value is returned by getTransform() without parsing the file again.
+ */
+bool vpConfigCache::saveTransform(const std::string &filename, const std::string &name, const vpHomogeneousMatrix &M)
+{
+  vpXmlParserHomogeneousMatrix parser;
+  if (parser.save(M, filename, name) != vpXmlParserHomogeneousMatrix::SEQUENCE_OK)
+    return false;
+
+  // The file changed: the other values it holds are still valid, only their hash has to be updated
+  m_hashes.erase(filename);
+  uint64_t hash;
+  if (! getHash(filename, hash))
+    return false;
+  for (std::map<std::string, vpEntry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it) {
+    if (it->second.filename == filename)
+      it->second.hash = hash;
+  }
+
+  double values[16];
+  for (unsigned int i=0; i < 4; i++)
+    for (unsigned int j=0; j < 4; j++)
+      values[4*i + j] = M[i][j];
+  store(getKey(transform, filename, name), filename, values, 16);
+  return true;
+}
+
+/*!
+  Return the cached value of \e key, or NULL if it is not cached or if its XML file changed.
+ */
+const vpConfigCache::vpEntry *vpConfigCache::find(const std::string &key)
+{
+  std::map<std::string, vpEntry>::const_iterator it = m_entries.find(key);
+  if (it == m_entries.end())
+    return NULL;
+  uint64_t hash;
+  if (! getHash(it->second.filename, hash) || hash != it->second.hash)
+    return NULL;
+  return &it->second;
+}
+
+std::string vpConfigCache::getKey(entry_t type, const std::string &filename, const std::string &name)
+{
+  std::string key(1, (char)('0' + type));
+  key += filename;
+  key += '\n';
+  key += name;
+  return key;
+}
+
+/*!
+  Get the hash of the content of \e filename. Each file is only read once, so that requesting a value
+  again does not access the file system. The XML files are small, reading them is much faster than parsing them.
+ */
+bool vpConfigCache::getHash(const std::string &filename, uint64_t &hash)
+{
+  std::map<std::string, uint64_t>::const_iterator it = m_hashes.find(filename);
+  if (it == m_hashes.end()) {
+    std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+    if (! file.is_open())
+      return false;
+    std::vector<unsigned char> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    uint64_t h = content.empty() ? hash64(NULL, 0) : hash64(&content[0], content.size());
+    it = m_hashes.insert(std::make_pair(filename, h)).first;
+  }
+  hash = it->second;
+  return true;
+}
+
+void vpConfigCache::store(const std::string &key, const std::string &filename, const double *values, unsigned int nb_values)
+{
+  vpEntry entry;
+  entry.filename = filename;
+  entry.hash = 0;
+  getHash(filename, entry.hash);
+  for (unsigned int i=0; i < 16; i++)
+    entry.values[i] = (i < nb_values) ? values[i] : 0.;
+  m_entries[key] = entry;
+  m_modified = true;
+}
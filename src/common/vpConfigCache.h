@@ -0,0 +1,82 @@
+#ifndef __vpConfigCache_h__
+#define __vpConfigCache_h__
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+
+#include <visp/vpCameraParameters.h>
+#include <visp/vpHomogeneousMatrix.h>
+
+/*!
+  Binary cache of the XML configuration files used by the demos: the homogeneous matrices of
+  transformation.xml and grasping_pose*.xml, and the camera parameters read with vpXmlParserCamera.
+
+  Each value is parsed from its XML file the first time it is requested, then kept in memory and
+  saved in a single binary cache file. The next runs load all the values from the cache without parsing
+  XML. A value is parsed again when the content of its XML file changed, which a 64 bits hash of the file
+  tells: unlike the modification time, that has a one second resolution on some file systems, it also
+  detects a file rewritten twice within the same second.
+
+  Values should be requested at startup, so that getting them again later, for example when the state
+  machine of a demo switches from learning to grasping, is only a lookup.
+
+  \code
+  vpConfigCache config;
+  config.load("/tmp/romeo_tk_config.bin");
+  vpHomogeneousMatrix hMe;
+  if (! config.getTransform(std::string(ROMEOTK_DATA_FOLDER) + "/transformation.xml", "qrcode_M_e_LArm", hMe))
+    return 0;
+  config.save(); // Only writes the cache if a value was parsed
+  \endcode
+ */
+class vpConfigCache
+{
+public:
+  static const unsigned int version = 2;
+
+protected:
+  typedef enum {
+    transform = 0,
+    camera = 1
+  } entry_t;
+
+  struct vpEntry {
+    std::string filename; // XML file the value comes from
+    uint64_t hash;        // Hash of the content of the XML file
+    double values[16]; // Homogeneous matrix row by row, or px, py, u0, v0, kud, kdu
+  };
+
+  std::string m_filename;
+  std::map<std::string, vpEntry> m_entries;
+  std::map<std::string, uint64_t> m_hashes; // Hashes of the XML files already read
+  bool m_modified;
+  unsigned int m_nb_loaded;
+  unsigned int m_nb_parsed;
+
+public:
+  vpConfigCache();
+  virtual ~vpConfigCache() {}
+
+  bool getCameraParameters(const std::string &filename, const std::string &camera_name, unsigned int width, unsigned int height,
+                           const vpCameraParameters::vpCameraParametersProjType &projection, vpCameraParameters &cam);
+  //! Number of values read from the binary cache by load().
+  unsigned int getNbLoaded() const {return m_nb_loaded;}
+  //! Number of values parsed from XML since the creation of the object.
+  unsigned int getNbParsed() const {return m_nb_parsed;}
+  bool getTransform(const std::string &filename, const std::string &name, vpHomogeneousMatrix &M);
+
+  bool load(const std::string &filename);
+
+  bool save();
+  bool saveTransform(const std::string &filename, const std::string &name, const vpHomogeneousMatrix &M);
+
+protected:
+  const vpEntry *find(const std::string &key);
+  static std::string getKey(entry_t type, const std::string &filename, const std::string &name);
+  bool getHash(const std::string &filename, uint64_t &hash);
+  void store(const std::string &key, const std::string &filename, const double *values, unsigned int nb_values);
+};
+
+#endif
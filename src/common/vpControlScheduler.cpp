@@ -0,0 +1,194 @@
+#include <iostream>
+
+#include <alerror/alerror.h>
+
+#include <visp/vpException.h>
+#include <visp/vpTime.h>
+
+#include <vpControlScheduler.h>
+
+
+/*!
+  Create a scheduler that controls the joints \e joint_names of the chain \e chain_name.
+  \param robot : Robot. It has to be opened.
+  \param chain_name : Name of the chain used to get the robot Jacobian.
+  \param joint_names : Controlled joints, in the order of the columns of the Jacobian.
+  \param rate : Control rate in Hz.
+ */
+vpControlScheduler::vpControlScheduler(vpNaoqiRobot &robot, const std::string &chain_name,
+                                       const std::vector<std::string> &joint_names, double rate)
+  : m_naoqi_backend(new vpNaoqiRobotBackend(robot)), m_robot(*m_naoqi_backend), m_joint_names(joint_names),
+    m_chain_name(chain_name), m_joint_map(),
+    m_period(1000. / rate), m_timeout(0.5), m_thread(NULL), m_mutex(), m_running(false),
+    m_stop_requested(false), m_nb_iterations(0), m_nb_overruns(0), m_loop_time(0),
+    m_history(joint_names.size()), m_q(joint_names.size()), m_q_dot(joint_names.size()), m_eJe_chain(), m_eJe(), m_moving(false)
+{
+}
+
+/*!
+  Create a scheduler that controls the joints \e joint_names of the chain \e chain_name of any robot backend,
+  for example a vpSimulatedRobot. The backend has to outlive the scheduler.
+ */
+vpControlScheduler::vpControlScheduler(vpRobotBackend &robot, const std::string &chain_name,
+                                       const std::vector<std::string> &joint_names, double rate)
+  : m_naoqi_backend(NULL), m_robot(robot), m_joint_names(joint_names), m_chain_name(chain_name), m_joint_map(),
+    m_period(1000. / rate), m_timeout(0.5), m_thread(NULL), m_mutex(), m_running(false),
+    m_stop_requested(false), m_nb_iterations(0), m_nb_overruns(0), m_loop_time(0),
+    m_history(joint_names.size()), m_q(joint_names.size()), m_q_dot(joint_names.size()), m_eJe_chain(), m_eJe(), m_moving(false)
+{
+}
+
+/*!
+  Destructor. Derived classes have to call stop() in their own destructor, since the control
+  thread calls computeVelocity().
+ */
+vpControlScheduler::~vpControlScheduler()
+{
+  stop();
+  delete m_naoqi_backend;
+}
+
+double vpControlScheduler::getLoopTime()
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  return m_loop_time;
+}
+
+unsigned long vpControlScheduler::getNbIterations()
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  return m_nb_iterations;
+}
+
+/*!
+  Return the number of iterations that lasted more than the control period.
+ */
+unsigned long vpControlScheduler::getNbOverruns()
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  return m_nb_overruns;
+}
+
+bool vpControlScheduler::isRunning()
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  return m_running;
+}
+
+/*!
+  Start the control thread. Does nothing if it is already running.
+ */
+void vpControlScheduler::start()
+{
+  if (m_thread != NULL)
+    return;
+
+  {
+    vpMutex::vpScopedLock lock(m_mutex);
+    m_stop_requested = false;
+    m_running = true;
+    m_history.clear();
+    m_nb_iterations = 0;
+    m_nb_overruns = 0;
+  }
+  m_thread = new vpThread(controlLoop, (vpThread::Args)this);
+}
+
+/*!
+  Stop the control thread and the controlled joints.
+ */
+void vpControlScheduler::stop()
+{
+  if (m_thread == NULL)
+    return;
+
+  {
+    vpMutex::vpScopedLock lock(m_mutex);
+    m_stop_requested = true;
+  }
+  m_thread->join();
+  delete m_thread;
+  m_thread = NULL;
+}
+
+/*!
+  Robot Jacobian of the controlled chain, mapped on the controlled joints if a joint mapping was set.
+  The matrices are members reused from one iteration to the other, so that the control thread does not
+  allocate memory once the first Jacobian was computed.
+ */
+const vpMatrix &vpControlScheduler::get_eJe()
+{
+  m_robot.get_eJe(m_chain_name, m_eJe_chain);
+  if (m_joint_map.getRows() == 0)
+    return m_eJe_chain;
+
+  if (m_joint_map.getRows() != m_eJe_chain.getCols())
+    throw vpException(vpException::dimensionError, "Joint mapping of %d rows for %d joints of %s",
+                      m_joint_map.getRows(), m_eJe_chain.getCols(), m_chain_name.c_str());
+  unsigned int n = m_joint_map.getCols();
+  if (m_eJe.getRows() != m_eJe_chain.getRows() || m_eJe.getCols() != n)
+    m_eJe.resize(m_eJe_chain.getRows(), n);
+  for (unsigned int i=0; i < m_eJe_chain.getRows(); i++)
+    for (unsigned int j=0; j < n; j++) {
+      double sum = 0;
+      for (unsigned int k=0; k < m_eJe_chain.getCols(); k++)
+        sum += m_eJe_chain[i][k] * m_joint_map[k][j];
+      m_eJe[i][j] = sum;
+    }
+  return m_eJe;
+}
+
+vpThread::Return vpControlScheduler::controlLoop(vpThread::Args args)
+{
+  vpControlScheduler *scheduler = (vpControlScheduler *)args;
+  scheduler->run();
+  return 0;
+}
+
+void vpControlScheduler::run()
+{
+  try {
+    while (1) {
+      {
+        vpMutex::vpScopedLock lock(m_mutex);
+        if (m_stop_requested)
+          break;
+      }
+
+      double t = vpTime::measureTimeMs();
+      m_q = m_robot.getPosition(m_joint_names);
+      m_history.add(t / 1000., m_q);
+
+      if (computeVelocity(t / 1000., m_q, m_q_dot)) {
+        m_robot.setVelocity(m_joint_names, m_q_dot);
+        m_moving = true;
+      }
+      else if (m_moving) {
+        m_robot.stop(m_joint_names);
+        m_moving = false;
+      }
+
+      double loop_time = vpTime::measureTimeMs() - t;
+      {
+        vpMutex::vpScopedLock lock(m_mutex);
+        m_loop_time = loop_time;
+        m_nb_iterations ++;
+        if (loop_time > m_period)
+          m_nb_overruns ++;
+      }
+      vpTime::wait(t, m_period);
+    }
+  }
+  catch(vpException &e) {
+    std::cout << "Control scheduler: " << e.getMessage() << std::endl;
+  }
+  catch (const AL::ALError& e) {
+    std::cerr << "Control scheduler: caught exception " << e.what() << std::endl;
+  }
+
+  m_robot.stop(m_joint_names);
+  m_moving = false;
+
+  vpMutex::vpScopedLock lock(m_mutex);
+  m_running = false;
+}
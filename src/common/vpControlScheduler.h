@@ -0,0 +1,104 @@
+#ifndef __vpControlScheduler_h__
+#define __vpControlScheduler_h__
+
+#include <string>
+#include <vector>
+
+#include <visp/vpColVector.h>
+#include <visp/vpMatrix.h>
+#include <visp3/core/vpMutex.h>
+#include <visp3/core/vpThread.h>
+
+#include <vpJointHistory.h>
+#include <vpRobotBackend.h>
+
+/*!
+  Run a joint velocity control law in its own thread at a fixed rate, independently of the camera frame rate.
+
+  At each period the control thread reads the joint positions, calls computeVelocity() and sends the
+  joint velocities to the robot. If computeVelocity() returns false (no recent measure of the target)
+  the joints are stopped. Perception threads provide their measures asynchronously through the
+  publish functions of the derived classes (see vpServoArmScheduler and vpServoHeadScheduler). The joint
+  positions read at each iteration are kept in a vpJointHistory, so that the last measure is advanced by the
+  joint displacement since the capture of its image.
+
+  \code
+  vpServoArm servo_arm;
+  servo_arm.setRealTime(true, joint_names.size());
+  vpServoArmScheduler scheduler(robot, servo_arm, "LArm", joint_names);
+  scheduler.set_cVe(oVe);
+  scheduler.start();
+  while (1) {
+    double t = vpTime::measureTimeSecond();
+    g.acquire(I);
+    if (qrcode_tracker.track(I))
+      scheduler.publishPose(cdMo.inverse() * qrcode_tracker.get_cMo(), t);
+  }
+  scheduler.stop();
+  \endcode
+ */
+class vpControlScheduler
+{
+protected:
+  vpNaoqiRobotBackend *m_naoqi_backend; // Created for the vpNaoqiRobot constructor, NULL otherwise
+  vpRobotBackend &m_robot;
+  std::vector<std::string> m_joint_names;
+  std::string m_chain_name;
+  vpMatrix m_joint_map;           // eJe = robot.get_eJe(m_chain_name) * m_joint_map when not empty
+  double m_period;                // Control period in ms
+  double m_timeout;               // Maximum age of a measure in s
+  vpThread *m_thread;
+  vpMutex m_mutex;                // Protects the data shared with the publishers
+  bool m_running;
+  bool m_stop_requested;
+  unsigned long m_nb_iterations;
+  unsigned long m_nb_overruns;
+  double m_loop_time;             // Duration of the last iteration in ms
+
+  // Used only by the control thread
+  vpJointHistory m_history;       // Joint positions read at each iteration
+  vpColVector m_q;
+  vpColVector m_q_dot;
+  vpMatrix m_eJe_chain;           // Jacobian of the chain given by the robot
+  vpMatrix m_eJe;                 // Jacobian of the controlled joints
+  bool m_moving;
+
+public:
+  vpControlScheduler(vpNaoqiRobot &robot, const std::string &chain_name,
+                     const std::vector<std::string> &joint_names, double rate=100.);
+  vpControlScheduler(vpRobotBackend &robot, const std::string &chain_name,
+                     const std::vector<std::string> &joint_names, double rate=100.);
+  virtual ~vpControlScheduler();
+
+  double getLoopTime();
+  unsigned long getNbIterations();
+  unsigned long getNbOverruns();
+  double getRate() const {return 1000. / m_period;}
+  double getTimeout() const {return m_timeout;}
+
+  bool isRunning();
+
+  void setJointMapping(const vpMatrix &map) {m_joint_map = map;}
+  void setRate(double rate) {m_period = 1000. / rate;}
+  void setTimeout(double timeout) {m_timeout = timeout;}
+
+  void start();
+  void stop();
+
+protected:
+  /*!
+    Compute the joint velocities to send to the robot. Called from the control thread.
+    \param t : Time in s of the joint positions \e q.
+    \param q : Current joint positions.
+    \param q_dot : Joint velocities to apply.
+    \return false if the joints should be stopped.
+   */
+  virtual bool computeVelocity(double t, const vpColVector &q, vpColVector &q_dot) = 0;
+  const vpMatrix &get_eJe();
+
+private:
+  static vpThread::Return controlLoop(vpThread::Args args);
+  void run();
+};
+
+#endif
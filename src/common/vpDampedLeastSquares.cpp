@@ -0,0 +1,186 @@
+#include <math.h>
+
+#include <vpDampedLeastSquares.h>
+
+namespace {
+  // Smallest pivot of the Cholesky factorization relative to the diagonal element, below which a row of J is
+  // considered as a combination of the previous ones. It is the square of the singular value threshold of
+  // vpMatrix::pseudoInverse().
+  const double pivotThreshold = 1e-12;
+}
+
+vpDampedLeastSquares::vpDampedLeastSquares(double mu)
+  : m_mu(mu), m_mu_max(0), m_w0(0), m_reuse_tolerance(0), m_rows(0), m_mu_applied(mu), m_manipulability(0),
+    m_factorized(false), m_reused(false), m_J()
+{
+}
+
+/*!
+  Enable the adaptive damping.
+  \param mu_max : Damping added when the manipulability is null. 0 disables the adaptive damping.
+  \param w0 : Manipulability sqrt(det(J J^T)) below which the damping is increased.
+ */
+void vpDampedLeastSquares::setAdaptiveDamping(double mu_max, double w0)
+{
+  m_mu_max = mu_max;
+  m_w0 = w0;
+  m_factorized = false;
+}
+
+/*!
+  Reuse the previous factorization when no element of the Jacobian changed by more than \e tolerance.
+  0 disables the reuse. The first call with a non null tolerance allocates a copy of the Jacobian.
+ */
+void vpDampedLeastSquares::setReuseTolerance(double tolerance)
+{
+  m_reuse_tolerance = tolerance;
+  m_factorized = false;
+}
+
+/*!
+  Compute the Cholesky factor of J J^T + mu2 I in m_A (lower triangular part) from m_JJt.
+  \return false if the matrix is not positive definite, or so close to singular that a pivot is only due to
+  rounding errors.
+ */
+bool vpDampedLeastSquares::cholesky(double mu2)
+{
+  unsigned int m = m_rows;
+  for (unsigned int i=0; i < m; i++) {
+    for (unsigned int j=0; j < i; j++)
+      m_A[i][j] = m_JJt[i][j];
+    m_A[i][i] = m_JJt[i][i] + mu2;
+  }
+
+  for (unsigned int j=0; j < m; j++) {
+    double d = m_A[j][j];
+    for (unsigned int k=0; k < j; k++)
+      d -= m_A[j][k] * m_A[j][k];
+    if (d <= pivotThreshold * (m_JJt[j][j] + mu2))
+      return false;
+    d = sqrt(d);
+    m_A[j][j] = d;
+    for (unsigned int i=j+1; i < m; i++) {
+      double sum = m_A[i][j];
+      for (unsigned int k=0; k < j; k++)
+        sum -= m_A[i][k] * m_A[j][k];
+      m_A[i][j] = sum / d;
+    }
+  }
+  return true;
+}
+
+/*!
+  Compute J J^T, choose the damping and factorize.
+  \return false if the matrix is not positive definite, which only happens when the damping is null and J is
+  singular or nearly singular.
+ */
+bool vpDampedLeastSquares::factorize(const vpMatrix &J)
+{
+  unsigned int m = J.getRows();
+  unsigned int n = J.getCols();
+
+  // J J^T, lower triangular part only
+  for (unsigned int i=0; i < m; i++) {
+    const double *Ji = J[i];
+    for (unsigned int j=0; j <= i; j++) {
+      const double *Jj = J[j];
+      double sum = 0.;
+      for (unsigned int k=0; k < n; k++)
+        sum += Ji[k] * Jj[k];
+      m_JJt[i][j] = sum;
+    }
+  }
+  m_rows = m;
+  m_factorized = false;
+
+  double mu2 = m_mu * m_mu;
+  bool status = cholesky(mu2);
+
+  // The manipulability is the product of the diagonal of the factor
+  m_manipulability = 0.;
+  if (status) {
+    m_manipulability = 1.;
+    for (unsigned int i=0; i < m; i++)
+      m_manipulability *= m_A[i][i];
+  }
+
+  if (m_mu_max > 0. && m_manipulability < m_w0) {
+    double r = m_manipulability / m_w0;
+    mu2 += m_mu_max * m_mu_max * (1. - r*r);
+    status = cholesky(mu2);
+  }
+  m_mu_applied = sqrt(mu2);
+
+  if (status && m_reuse_tolerance > 0.) {
+    if (m_J.getRows() != m || m_J.getCols() != n)
+      m_J.resize(m, n, false);
+    for (unsigned int i=0; i < m; i++)
+      for (unsigned int k=0; k < n; k++)
+        m_J[i][k] = J[i][k];
+  }
+  m_factorized = status;
+  return status;
+}
+
+/*!
+  Return true if the factorization of the previous call can be used for \e J.
+ */
+bool vpDampedLeastSquares::isReusable(const vpMatrix &J) const
+{
+  if (! m_factorized || m_reuse_tolerance <= 0. || J.getRows() != m_J.getRows() || J.getCols() != m_J.getCols())
+    return false;
+
+  for (unsigned int i=0; i < J.getRows(); i++) {
+    const double *Ji = J[i];
+    const double *Ji_prev = m_J[i];
+    for (unsigned int k=0; k < J.getCols(); k++)
+      if (fabs(Ji[k] - Ji_prev[k]) > m_reuse_tolerance)
+        return false;
+  }
+  return true;
+}
+
+/*!
+  Compute x = J^T (J J^T + mu^2 I)^-1 e.
+  \param J : Task Jacobian with at most 6 rows.
+  \param e : Task error of dimension J.getRows().
+  \param x : Solution of dimension J.getCols(). It is only resized (and thus allocated) if it does not have the right size.
+  \return true if the system could be solved, false otherwise (x is then set to zero).
+ */
+bool vpDampedLeastSquares::solve(const vpMatrix &J, const vpColVector &e, vpColVector &x)
+{
+  unsigned int m = J.getRows();
+  unsigned int n = J.getCols();
+  if (x.getRows() != n)
+    x.resize(n, false);
+
+  m_reused = (m <= maxRows && isReusable(J));
+  if (m > maxRows || e.getRows() != m || (! m_reused && ! factorize(J))) {
+    for (unsigned int k=0; k < n; k++)
+      x[k] = 0.;
+    return false;
+  }
+
+  // Forward substitution L z = e
+  for (unsigned int i=0; i < m; i++) {
+    double sum = e[i];
+    for (unsigned int k=0; k < i; k++)
+      sum -= m_A[i][k] * m_y[k];
+    m_y[i] = sum / m_A[i][i];
+  }
+  // Backward substitution L^T y = z
+  for (int i=(int)m-1; i >= 0; i--) {
+    double sum = m_y[i];
+    for (unsigned int k=i+1; k < m; k++)
+      sum -= m_A[k][i] * m_y[k];
+    m_y[i] = sum / m_A[i][i];
+  }
+  // x = J^T y
+  for (unsigned int k=0; k < n; k++) {
+    double sum = 0.;
+    for (unsigned int i=0; i < m; i++)
+      sum += J[i][k] * m_y[i];
+    x[k] = sum;
+  }
+  return true;
+}
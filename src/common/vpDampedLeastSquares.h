@@ -0,0 +1,64 @@
+#ifndef __vpDampedLeastSquares_h__
+#define __vpDampedLeastSquares_h__
+
+#include <visp/vpColVector.h>
+#include <visp/vpMatrix.h>
+
+/*!
+  Damped least-squares solver for small task Jacobians (at most 6 rows):
+
+  x = J^T (J J^T + mu^2 I)^-1 e
+
+  The m x m system is solved with a Cholesky factorization stored in a fixed size
+  array, so that solve() never allocates memory as long as \e x already has the right size.
+  With a small damping the solution is close to the one obtained with the SVD
+  based pseudo-inverse J^+ e, and stays bounded when J looses rank.
+
+  Two options reduce the cost or improve the behavior near singular configurations:
+  - setAdaptiveDamping(): the damping grows when the manipulability w = sqrt(det(J J^T))
+    goes below a threshold w0: mu^2 = mu_min^2 + mu_max^2 (1 - (w/w0)^2);
+  - setReuseTolerance(): the factorization of the previous call is reused as long as no element
+    of J changed by more than the tolerance, so that only the triangular solves are computed.
+ */
+class vpDampedLeastSquares
+{
+public:
+  static const unsigned int maxRows = 6;
+
+protected:
+  double m_mu;                     // Damping factor (minimal damping when the damping is adaptive)
+  double m_mu_max;                 // Maximal damping added near singularities, 0 to disable
+  double m_w0;                     // Manipulability threshold of the adaptive damping
+  double m_reuse_tolerance;        // 0 to always factorize
+  double m_JJt[maxRows][maxRows];  // J J^T
+  double m_A[maxRows][maxRows];    // Cholesky factor of J J^T + mu^2 I
+  double m_y[maxRows];
+  unsigned int m_rows;
+  double m_mu_applied;
+  double m_manipulability;
+  bool m_factorized;
+  bool m_reused;
+  vpMatrix m_J;                    // Jacobian of the last factorization, only used to reuse it
+
+public:
+  vpDampedLeastSquares(double mu=1e-4);
+  virtual ~vpDampedLeastSquares() {}
+
+  double getAppliedDamping() const {return m_mu_applied;}
+  double getDamping() const {return m_mu;}
+  double getManipulability() const {return m_manipulability;}
+  bool isFactorizationReused() const {return m_reused;}
+
+  void setAdaptiveDamping(double mu_max, double w0);
+  void setDamping(double mu) {m_mu = mu; m_factorized = false;}
+  void setReuseTolerance(double tolerance);
+
+  bool solve(const vpMatrix &J, const vpColVector &e, vpColVector &x);
+
+protected:
+  bool cholesky(double mu2);
+  bool factorize(const vpMatrix &J);
+  bool isReusable(const vpMatrix &J) const;
+};
+
+#endif
@@ -4,7 +4,7 @@
 
 vpFaceTracker::vpFaceTracker() : m_warp(), m_tracker(NULL), m_faces(), m_state(detection),
   m_face_cascade(), m_frame_gray(), m_zone_ref(), m_zone_cur(),
-  m_area_zone_ref(0), m_area_zone_cur(0), m_area_zone_prev(0), m_p()
+  m_area_zone_ref(0), m_area_zone_cur(0), m_area_zone_prev(0), m_p(), m_target(), m_frame_timestamp(0), m_timestamp(0)
 {
   m_tracker = new vpTemplateTrackerSSDInverseCompositional(&m_warp);
   m_tracker->setSampling(2,2);
@@ -124,6 +124,9 @@ bool vpFaceTracker::track(const vpImage<unsigned char> &I)
     }
   }
 
+  if (target_found)
+    m_timestamp = m_frame_timestamp;
+
   return target_found;
 }
 
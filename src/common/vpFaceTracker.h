@@ -28,6 +28,8 @@ protected:
   double m_area_zone_ref, m_area_zone_cur, m_area_zone_prev;
   vpColVector m_p;
   vpRect m_target;
+  double m_frame_timestamp; // Capture time of the image given to the next track()
+  double m_timestamp; // Capture time of the image of the last successful track()
 
 
 public:
@@ -35,7 +37,9 @@ public:
   ~vpFaceTracker();
 
   vpRect getFace() const { return m_target;}
+  double getTimestamp() const {return m_timestamp;}
   void setFaceCascade(const std::string &filename);
+  void setTimestamp(double timestamp) {m_frame_timestamp = timestamp;}
   bool track(const vpImage<unsigned char> &I);
 };
 
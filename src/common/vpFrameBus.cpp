@@ -0,0 +1,325 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <visp/vpConfig.h>
+#include <visp/vpException.h>
+#include <visp/vpTime.h>
+
+#include <vpFrameBus.h>
+
+namespace {
+  const unsigned int s_slot_header_size = 64;
+
+  unsigned int align64(size_t size)
+  {
+    return (unsigned int)((size + 63) & ~(size_t)63);
+  }
+}
+
+vpFrameBus::vpFrameBus()
+  : m_name(), m_map(NULL), m_map_size(0), m_owner(false), m_frame(0), m_frame_prev(0), m_timestamp(0),
+    m_nb_read(0), m_nb_skipped(0), m_nb_overwritten(0)
+{
+}
+
+vpFrameBus::~vpFrameBus()
+{
+  close();
+}
+
+/*!
+  Producer side: create the shared memory segment \e name (for example "/romeo_tk_frames") holding
+  \e nb_slots frames of \e width x \e height pixels with 1 (gray) or 3 (BGR) channels. The camera parameters
+  are stored for the consumers. An existing segment with the same name is replaced.
+ */
+void vpFrameBus::create(const std::string &name, unsigned int width, unsigned int height, unsigned int channels,
+                        unsigned int nb_slots, const vpCameraParameters &cam_without_distortion,
+                        const vpCameraParameters &cam_with_distortion)
+{
+  close();
+  if (channels != 1 && channels != 3)
+    throw vpException(vpException::badValue, "Frame bus images should have 1 or 3 channels, not %d", channels);
+  if (nb_slots < 2)
+    nb_slots = 2;
+
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd < 0)
+    throw vpException(vpException::ioError, "Cannot create shared memory %s: %s", name.c_str(), strerror(errno));
+
+  unsigned int slot_stride = s_slot_header_size + align64((size_t)width * height * channels);
+  m_map_size = getHeaderSize() + (size_t)nb_slots * slot_stride;
+  if (ftruncate(fd, (off_t)m_map_size) != 0) {
+    ::close(fd);
+    shm_unlink(name.c_str());
+    throw vpException(vpException::ioError, "Cannot allocate shared memory %s: %s", name.c_str(), strerror(errno));
+  }
+  void *map = mmap(NULL, m_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    throw vpException(vpException::ioError, "Cannot map shared memory %s: %s", name.c_str(), strerror(errno));
+  }
+  m_map = (unsigned char *)map;
+  m_name = name;
+  m_owner = true;
+  m_frame = 0;
+
+  // Touch all the pages now rather than when the first frames are written
+  memset(m_map, 0, m_map_size);
+
+  vpHeader *header = getHeader();
+  header->version = version;
+  header->width = width;
+  header->height = height;
+  header->channels = channels;
+  header->nb_slots = nb_slots;
+  header->slot_stride = slot_stride;
+  header->latest = 0;
+  header->pid = (int64_t)getpid();
+  const vpCameraParameters &c0 = cam_without_distortion;
+  const vpCameraParameters &c1 = cam_with_distortion;
+  double cam[10] = {c0.get_px(), c0.get_py(), c0.get_u0(), c0.get_v0(),
+                    c1.get_px(), c1.get_py(), c1.get_u0(), c1.get_v0(), c1.get_kud(), c1.get_kdu()};
+  memcpy(header->cam, cam, sizeof(cam));
+  heartbeat();
+  // The magic is written last, so that a consumer never accepts a partially initialized header
+  __sync_synchronize();
+  memcpy(header->magic, "RTKFRM", 6);
+}
+
+/*!
+  Consumer side: map the shared memory segment \e name created by the producer, for reading only.
+  Only the frames published after open() are read.
+ */
+void vpFrameBus::open(const std::string &name)
+{
+  close();
+
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0)
+    throw vpException(vpException::ioError, "Cannot open shared memory %s: %s", name.c_str(), strerror(errno));
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < getHeaderSize()) {
+    ::close(fd);
+    throw vpException(vpException::ioError, "Shared memory %s is not initialized", name.c_str());
+  }
+  void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED)
+    throw vpException(vpException::ioError, "Cannot map shared memory %s: %s", name.c_str(), strerror(errno));
+  m_map = (unsigned char *)map;
+  m_map_size = (size_t)st.st_size;
+  m_name = name;
+  m_owner = false;
+
+  const vpHeader *header = getHeader();
+  if (memcmp(header->magic, "RTKFRM", 6) != 0 || header->version != version
+      || m_map_size < getHeaderSize() + (size_t)header->nb_slots * header->slot_stride) {
+    close();
+    throw vpException(vpException::ioError, "Shared memory %s is not a compatible frame bus", name.c_str());
+  }
+  m_frame = 0;
+  m_frame_prev = header->latest;
+  m_nb_read = 0;
+  m_nb_skipped = 0;
+  m_nb_overwritten = 0;
+}
+
+/*!
+  Unmap the segment. The producer also removes it; consumers that already mapped it keep a valid
+  mapping, but get no new frame.
+ */
+void vpFrameBus::close()
+{
+  if (m_map == NULL)
+    return;
+  munmap(m_map, m_map_size);
+  if (m_owner)
+    shm_unlink(m_name.c_str());
+  m_map = NULL;
+  m_map_size = 0;
+  m_owner = false;
+}
+
+vpCameraParameters vpFrameBus::getCameraParameters(vpCameraParameters::vpCameraParametersProjType projModel) const
+{
+  const double *c = getHeader()->cam;
+  vpCameraParameters cam;
+  if (projModel == vpCameraParameters::perspectiveProjWithDistortion)
+    cam.initPersProjWithDistortion(c[4], c[5], c[6], c[7], c[8], c[9]);
+  else
+    cam.initPersProjWithoutDistortion(c[0], c[1], c[2], c[3]);
+  return cam;
+}
+
+unsigned int vpFrameBus::getHeaderSize()
+{
+  return align64(sizeof(vpHeader));
+}
+
+vpFrameBus::vpSlot *vpFrameBus::getSlot(uint32_t frame) const
+{
+  const vpHeader *header = getHeader();
+  return (vpSlot *)(m_map + getHeaderSize() + (size_t)((frame - 1) % header->nb_slots) * header->slot_stride);
+}
+
+unsigned char *vpFrameBus::getPixels(uint32_t frame) const
+{
+  return (unsigned char *)getSlot(frame) + s_slot_header_size;
+}
+
+/*!
+  Producer side: return a view on the slot of the next frame, to fill before endWrite(). The slot is
+  marked as being written, so that the consumers still reading the frame it held know it.
+ */
+cv::Mat vpFrameBus::beginWrite()
+{
+  const vpHeader *header = getHeader();
+  m_frame = header->latest + 1;
+  if (m_frame == 0) // Wrapped around: 0 is reserved for "no frame yet"
+    m_frame = 1;
+  vpSlot *slot = getSlot(m_frame);
+  slot->sequence = 2*m_frame - 1;
+  __sync_synchronize();
+  return cv::Mat((int)header->height, (int)header->width, CV_8UC((int)header->channels), getPixels(m_frame));
+}
+
+/*!
+  Producer side: publish the frame filled after beginWrite().
+ */
+void vpFrameBus::endWrite(double timestamp)
+{
+  vpHeader *header = getHeader();
+  vpSlot *slot = getSlot(m_frame);
+  slot->timestamp = timestamp;
+  __sync_synchronize();
+  slot->sequence = 2*m_frame;
+  __sync_synchronize();
+  header->latest = m_frame;
+  heartbeat();
+}
+
+/*!
+  Producer side: record that the producer is alive. Called by endWrite().
+ */
+void vpFrameBus::heartbeat()
+{
+  getHeader()->heartbeat = (int64_t)vpTime::measureTimeMicros();
+}
+
+/*!
+  Producer side: publish \e I, converted to the number of channels of the bus.
+  \exception vpException::dimensionError : \e I does not have the size of the bus.
+ */
+void vpFrameBus::write(const cv::Mat &I, double timestamp)
+{
+  // Otherwise the copy would reallocate the view instead of writing into the shared memory
+  if ((unsigned int)I.rows != getHeight() || (unsigned int)I.cols != getWidth())
+    throw vpException(vpException::dimensionError, "Cannot publish a %dx%d image on a %ux%u frame bus",
+                      I.cols, I.rows, getWidth(), getHeight());
+  if (I.depth() != CV_8U || (I.channels() != 1 && I.channels() != 3))
+    throw vpException(vpException::badValue, "Frame bus images should have 1 or 3 channels of 8 bits");
+
+  cv::Mat view = beginWrite();
+  if (I.channels() == view.channels())
+    I.copyTo(view);
+  else if (I.channels() == 3)
+    cv::cvtColor(I, view, CV_BGR2GRAY);
+  else
+    cv::cvtColor(I, view, CV_GRAY2BGR);
+  endWrite(timestamp);
+}
+
+void vpFrameBus::write(const vpImage<unsigned char> &I, double timestamp)
+{
+  write(cv::Mat((int)I.getHeight(), (int)I.getWidth(), CV_8UC1, I.bitmap), timestamp);
+}
+
+/*!
+  Consumer side: take the latest frame, available with getMat() or getImage() until endRead().
+  \param timeout_ms : Time to wait for a frame newer than the previous one. With 0, do not wait.
+  \return false if no new frame was published.
+ */
+bool vpFrameBus::beginRead(double timeout_ms)
+{
+  const vpHeader *header = getHeader();
+  double t_start = vpTime::measureTimeMs();
+  for (;;) {
+    uint32_t latest = header->latest;
+    if (latest != m_frame_prev && latest != 0) {
+      const vpSlot *slot = getSlot(latest);
+      __sync_synchronize();
+      if (slot->sequence == 2*latest) {
+        m_timestamp = slot->timestamp;
+        __sync_synchronize();
+        if (slot->sequence == 2*latest) {
+          if (m_frame_prev != 0 && latest > m_frame_prev + 1)
+            m_nb_skipped += latest - m_frame_prev - 1;
+          m_frame = latest;
+          m_frame_prev = latest;
+          return true;
+        }
+      }
+    }
+    if (vpTime::measureTimeMs() - t_start >= timeout_ms)
+      return false;
+    vpTime::wait(1);
+  }
+}
+
+/*!
+  Consumer side: release the frame obtained with beginRead().
+  \return false if the producer reused its slot while it was read, in which case the results computed
+  on the frame should be discarded.
+ */
+bool vpFrameBus::endRead()
+{
+  __sync_synchronize();
+  bool valid = (getSlot(m_frame)->sequence == 2*m_frame);
+  if (valid)
+    m_nb_read ++;
+  else
+    m_nb_overwritten ++;
+  return valid;
+}
+
+/*!
+  Consumer side: view on the pixels of the frame obtained with beginRead(). The view is read-only: writing
+  in it crashes the process.
+ */
+cv::Mat vpFrameBus::getMat() const
+{
+  const vpHeader *header = getHeader();
+  return cv::Mat((int)header->height, (int)header->width, CV_8UC((int)header->channels), getPixels(m_frame));
+}
+
+/*!
+  Consumer side: gray image of the frame obtained with beginRead(). With a gray bus and ViSP 3.1 or later,
+  \e I becomes a view on the shared memory, without copy, valid until the next beginRead(). Otherwise the
+  frame is copied, or converted from BGR, in \e I.
+ */
+void vpFrameBus::getImage(vpImage<unsigned char> &I) const
+{
+  const vpHeader *header = getHeader();
+#if VISP_VERSION_INT >= VP_VERSION_INT(3,1,0)
+  if (header->channels == 1) {
+    I.init(getPixels(m_frame), header->height, header->width, false);
+    return;
+  }
+#endif
+  if (I.getHeight() != header->height || I.getWidth() != header->width)
+    I.resize(header->height, header->width);
+  cv::Mat gray((int)header->height, (int)header->width, CV_8UC1, I.bitmap);
+  if (header->channels == 1)
+    getMat().copyTo(gray);
+  else
+    cv::cvtColor(getMat(), gray, CV_BGR2GRAY);
+}
@@ -0,0 +1,137 @@
+#ifndef __vpFrameBus_h__
+#define __vpFrameBus_h__
+
+#include <stdint.h>
+
+#include <string>
+
+#include <opencv2/core/core.hpp>
+
+#include <visp/vpCameraParameters.h>
+#include <visp/vpImage.h>
+
+/*!
+  Share the images of one camera between several processes through a ring of POSIX shared memory slots.
+
+  One producer (see the frame_bus_producer tool) acquires and converts each frame once, directly in a slot.
+  Any number of consumers map the segment read-only and process the latest frame in place through a cv::Mat
+  or vpImage view, without copy. Each slot has a sequence counter: it is odd while the producer writes the
+  slot, and the frame number times two once the frame is complete. The producer never waits for the
+  consumers; a consumer slower than the camera skips frames, and endRead() tells it if the producer reused
+  the slot while it was reading it, which can only happen when the processing of a frame lasts longer than
+  nb_slots - 1 frame periods.
+
+  The segment starts with a header of 192 bytes: "RTKFRM" followed by two null characters, then the format
+  version, width, height, number of channels, number of slots, slot stride, number of the latest frame (uint32),
+  the process id and the heartbeat of the producer in microseconds (int64), and the camera parameters
+  px, py, u0, v0 without distortion and px, py, u0, v0, kud, kdu with distortion (double). Each slot then has
+  a header of 64 bytes (sequence as uint32, capture timestamp in seconds as double) followed by the pixels,
+  row by row, in BGR order for color images.
+
+  \code
+  // Consumer
+  vpFrameBus bus;
+  bus.open("/romeo_tk_frames");
+  vpImage<unsigned char> I;
+  while (...) {
+    if (! bus.beginRead(100)) // Wait up to 100 ms for a new frame
+      continue;
+    bus.getImage(I);          // View on the shared memory, no copy
+    qrcode_tracker.setTimestamp(bus.getTimestamp());
+    bool found = qrcode_tracker.track(I);
+    if (! bus.endRead())
+      found = false;          // The frame was overwritten while it was processed
+  }
+  \endcode
+ */
+class vpFrameBus
+{
+public:
+  static const unsigned int version = 1;
+
+protected:
+  struct vpHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t channels;
+    uint32_t nb_slots;
+    uint32_t slot_stride;
+    volatile uint32_t latest;   // Number of the latest complete frame, 0 before the first one
+    uint32_t reserved;
+    int64_t pid;
+    volatile int64_t heartbeat;
+    double cam[10];
+  };
+
+  struct vpSlot {
+    volatile uint32_t sequence;
+    uint32_t reserved;
+    double timestamp;
+  };
+
+  std::string m_name;
+  unsigned char *m_map;
+  size_t m_map_size;
+  bool m_owner;               // true for the producer, that removes the segment on close()
+  uint32_t m_frame;           // Producer: number of the frame being written. Consumer: number of the frame being read
+  uint32_t m_frame_prev;      // Consumer: number of the previous frame read
+  double m_timestamp;
+  unsigned long m_nb_read;
+  unsigned long m_nb_skipped;
+  unsigned long m_nb_overwritten;
+
+public:
+  vpFrameBus();
+  virtual ~vpFrameBus();
+
+  void close();
+  void create(const std::string &name, unsigned int width, unsigned int height, unsigned int channels,
+              unsigned int nb_slots=4, const vpCameraParameters &cam_without_distortion=vpCameraParameters(),
+              const vpCameraParameters &cam_with_distortion=vpCameraParameters());
+  void open(const std::string &name);
+  bool isOpened() const {return m_map != NULL;}
+
+  vpCameraParameters getCameraParameters(vpCameraParameters::vpCameraParametersProjType projModel
+                                         = vpCameraParameters::perspectiveProjWithoutDistortion) const;
+  unsigned int getChannels() const {return getHeader()->channels;}
+  //! Time of the last frame or heartbeat() of the producer, in microseconds since the Epoch.
+  int64_t getHeartbeat() const {return getHeader()->heartbeat;}
+  unsigned int getHeight() const {return getHeader()->height;}
+  unsigned int getNbSlots() const {return getHeader()->nb_slots;}
+  unsigned int getWidth() const {return getHeader()->width;}
+
+  // Producer
+  cv::Mat beginWrite();
+  void endWrite(double timestamp);
+  void heartbeat();
+  void write(const cv::Mat &I, double timestamp);
+  void write(const vpImage<unsigned char> &I, double timestamp);
+
+  // Consumer
+  bool beginRead(double timeout_ms=0);
+  bool endRead();
+  unsigned long getFrameNumber() const {return m_frame;}
+  void getImage(vpImage<unsigned char> &I) const;
+  cv::Mat getMat() const;
+  //! Number of frames read by the consumer.
+  unsigned long getNbRead() const {return m_nb_read;}
+  //! Number of frames published by the producer but never read by the consumer, because it was busy.
+  unsigned long getNbSkipped() const {return m_nb_skipped;}
+  //! Number of frames reused by the producer while the consumer was reading them.
+  unsigned long getNbOverwritten() const {return m_nb_overwritten;}
+  double getTimestamp() const {return m_timestamp;}
+
+protected:
+  vpHeader *getHeader() const {return (vpHeader *)m_map;}
+  static unsigned int getHeaderSize();
+  vpSlot *getSlot(uint32_t frame) const;
+  unsigned char *getPixels(uint32_t frame) const;
+
+private:
+  vpFrameBus(const vpFrameBus &);
+  vpFrameBus &operator=(const vpFrameBus &);
+};
+
+#endif
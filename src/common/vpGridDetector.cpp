@@ -0,0 +1,339 @@
+#include <math.h>
+
+#include <algorithm>
+#include <fstream>
+#include <list>
+
+#include <visp/vpDot2.h>
+#include <visp/vpException.h>
+#include <visp/vpImageIo.h>
+#include <visp/vpMath.h>
+#include <visp/vpMeterPixelConversion.h>
+#include <visp/vpPixelMeterConversion.h>
+#include <visp/vpPose.h>
+#include <visp/vpRect.h>
+
+#include <vpGridDetector.h>
+#include <vpParallelFor.h>
+
+namespace {
+  struct vpBatch {
+    const vpGridDetector *detector;
+    const std::vector<std::string> *filenames;
+    const std::vector<vpImagePoint> *germs;
+    const vpCameraParameters *cam;
+    std::vector<vpGridDetector::vpDetection> *detections;
+  };
+
+  // Read an image and detect the grid, called by vpParallelFor from several threads
+  void detectImage(unsigned int index, void *data)
+  {
+    vpBatch *batch = (vpBatch *)data;
+    vpGridDetector::vpDetection &detection = (*batch->detections)[index];
+    vpImage<unsigned char> I;
+    try {
+      vpImageIo::read(I, (*batch->filenames)[index]);
+    }
+    catch(...) {
+      detection.valid = false;
+      detection.error = "cannot read the image";
+      return;
+    }
+    std::vector<vpImagePoint> germs;
+    if (! vpGridDetector::readGerms((*batch->filenames)[index] + ".txt", germs))
+      germs = *batch->germs;
+    batch->detector->detect(I, germs, *batch->cam, detection);
+  }
+}
+
+/*!
+  Detector with the reference dots of the Lagadic grid, whose dots are spaced by 6 cm: dot (3,3) of the plane
+  that contains the small dot, then dots (0,0) and (3,3) of the two other planes counter clockwise.
+ */
+vpGridDetector::vpGridDetector()
+  : m_grid(), m_pose_points(5), m_gray_precision(0.8), m_shape_precision(0.65), m_size_precision(0.5),
+    m_max_residual(2.), m_min_nb_dots(20), m_border(10), m_estimate_cam(true)
+{
+  double L = 0.06;
+  m_pose_points[0].setWorldCoordinates(3*L, 3*L, 0);
+  m_pose_points[1].setWorldCoordinates(L, 0, -L);
+  m_pose_points[2].setWorldCoordinates(3*L, 0, -3*L);
+  m_pose_points[3].setWorldCoordinates(0, L, -L);
+  m_pose_points[4].setWorldCoordinates(0, 3*L, -3*L);
+}
+
+/*!
+  Read the 3D coordinates of the dots from a grid file like mire3p.dat.
+ */
+void vpGridDetector::loadGrid(const std::string &filename)
+{
+  std::list<double> X, Y, Z;
+  unsigned int nb_points = 0;
+  if (vpCalibration::readGrid(filename.c_str(), nb_points, X, Y, Z) != 0)
+    throw vpException(vpException::ioError, "Cannot read calibration grid %s", filename.c_str());
+  m_grid.resize(nb_points);
+  std::list<double>::const_iterator x = X.begin(), y = Y.begin(), z = Z.begin();
+  for (unsigned int i=0; i < nb_points; i++, ++x, ++y, ++z)
+    m_grid[i].setWorldCoordinates(*x, *y, *z);
+}
+
+void vpGridDetector::setDotPrecision(double gray_level, double shape, double size)
+{
+  m_gray_precision = gray_level;
+  m_shape_precision = shape;
+  m_size_precision = size;
+}
+
+/*!
+  Germs of an image where the grid is at \e cMo: projection of the reference dots, see setPosePoints(). Used to
+  detect the grid in an image close to another one where it was found, without germs file.
+ */
+void vpGridDetector::projectPosePoints(const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam,
+                                       std::vector<vpImagePoint> &germs) const
+{
+  germs.resize(m_pose_points.size());
+  for (size_t i=0; i < m_pose_points.size(); i++) {
+    vpPoint P = m_pose_points[i];
+    P.track(cMo);
+    vpMeterPixelConversion::convertPoint(cam, P.get_x(), P.get_y(), germs[i]);
+  }
+}
+
+/*!
+  Read germs saved by saveGerms(): one line "u v" per reference dot.
+  \return false if the file does not exist.
+ */
+bool vpGridDetector::readGerms(const std::string &filename, std::vector<vpImagePoint> &germs)
+{
+  std::ifstream file(filename.c_str());
+  if (! file.is_open())
+    return false;
+  germs.clear();
+  double u, v;
+  while (file >> u >> v)
+    germs.push_back(vpImagePoint(v, u));
+  return true;
+}
+
+void vpGridDetector::saveGerms(const std::string &filename, const std::vector<vpImagePoint> &germs)
+{
+  std::ofstream file(filename.c_str());
+  if (! file.is_open())
+    throw vpException(vpException::ioError, "Cannot create %s", filename.c_str());
+  for (size_t i=0; i < germs.size(); i++)
+    file << germs[i].get_u() << " " << germs[i].get_v() << std::endl;
+}
+
+/*!
+  Pose \e cMo of the \e points seen at \e dots with the camera parameters \e cam. If \e init is true the
+  pose is initialized with the method of Dementhon, otherwise \e cMo is only refined.
+ */
+void vpGridDetector::computePose(const std::vector<vpPoint> &points, const std::vector<vpImagePoint> &dots,
+                                 const vpCameraParameters &cam, vpHomogeneousMatrix &cMo, bool init)
+{
+  vpPose pose;
+  for (size_t i=0; i < points.size(); i++) {
+    vpPoint P = points[i];
+    double x = 0, y = 0;
+    vpPixelMeterConversion::convertPoint(cam, dots[i], x, y);
+    P.set_x(x);
+    P.set_y(y);
+    pose.addPoint(P);
+  }
+  if (init)
+    pose.computePose(vpPose::DEMENTHON, cMo);
+  pose.computePose(vpPose::VIRTUAL_VS, cMo);
+}
+
+/*!
+  RMS in pixels of the distances between the \e dots and the projection of the \e points, the error of each
+  dot being returned in \e errors.
+ */
+double vpGridDetector::computeResidual(const std::vector<vpPoint> &points, const std::vector<vpImagePoint> &dots,
+                                       const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam,
+                                       std::vector<double> &errors)
+{
+  errors.resize(points.size());
+  double sum = 0;
+  for (size_t i=0; i < points.size(); i++) {
+    vpPoint P = points[i];
+    P.track(cMo);
+    vpImagePoint ip;
+    vpMeterPixelConversion::convertPoint(cam, P.get_x(), P.get_y(), ip);
+    errors[i] = vpImagePoint::distance(ip, dots[i]);
+    sum += errors[i] * errors[i];
+  }
+  return points.empty() ? 0. : sqrt(sum / points.size());
+}
+
+/*!
+  Detect the dots of the grid in \e I.
+  \param germs : Image positions of the reference dots, see setPosePoints().
+  \param cam : Initial camera parameters.
+  \return true if the image is accepted. Otherwise \e detection.error gives the reason.
+ */
+bool vpGridDetector::detect(const vpImage<unsigned char> &I, const std::vector<vpImagePoint> &germs,
+                            const vpCameraParameters &cam, vpDetection &detection) const
+{
+  detection.valid = false;
+  detection.error.clear();
+  detection.calib.clearPoint();
+  detection.nb_dots = 0;
+  detection.nb_outliers = 0;
+  detection.residual = 0;
+
+  if (germs.size() != m_pose_points.size()) {
+    detection.error = "wrong number of germs";
+    return false;
+  }
+
+  // Reference dots
+  double mean_surface = 0, dot_size = 0;
+  std::vector<vpImagePoint> germ_dots(germs.size());
+  vpCalibration calib;
+  for (size_t i=0; i < germs.size(); i++) {
+    vpDot2 d;
+    d.setGraphics(false);
+    d.setGrayLevelPrecision(m_gray_precision);
+    d.setEllipsoidShapePrecision(m_shape_precision);
+    d.setSizePrecision(m_size_precision);
+    try {
+      d.initTracking(I, germs[i]);
+      d.track(I);
+    }
+    catch (...) {
+      detection.error = "reference dot not found";
+      return false;
+    }
+    mean_surface += d.getArea();
+    dot_size += d.getWidth() + d.getHeight();
+    germ_dots[i] = d.getCog();
+    calib.addPoint(m_pose_points[i].get_oX(), m_pose_points[i].get_oY(), m_pose_points[i].get_oZ(), d.getCog());
+  }
+  mean_surface /= germs.size();
+  dot_size /= germs.size();
+
+  vpHomogeneousMatrix cMo;
+  vpCameraParameters cam_local = cam;
+  try {
+    computePose(m_pose_points, germ_dots, cam, cMo, true);
+    if (m_estimate_cam)
+      calib.computeCalibration(vpCalibration::CALIB_VIRTUAL_VS, cMo, cam_local, false);
+  }
+  catch (...) {
+    detection.error = "initial pose failed";
+    return false;
+  }
+
+  // All the dots of the grid, tracked from their projection
+  std::vector<vpPoint> points;
+  std::vector<vpImagePoint> dots;
+  double border = m_border;
+  for (size_t i=0; i < m_grid.size(); i++) {
+    vpPoint mP = m_grid[i];
+    mP.track(cMo);
+    vpImagePoint cog;
+    vpMeterPixelConversion::convertPoint(cam_local, mP.get_x(), mP.get_y(), cog);
+    if (cog.get_u() <= border || cog.get_u() >= I.getWidth() - border
+        || cog.get_v() <= border || cog.get_v() >= I.getHeight() - border)
+      continue;
+    vpDot2 md;
+    md.setGraphics(false);
+    md.setEllipsoidShapePrecision(m_shape_precision);
+    md.setSizePrecision(m_size_precision);
+    md.setGrayLevelPrecision(m_gray_precision);
+    try {
+      md.initTracking(I, cog, (unsigned int)dot_size);
+      md.track(I);
+    }
+    catch (...) {
+      continue;
+    }
+    vpRect bbox = md.getBBox();
+    vpImagePoint cogd = md.getCog();
+    double mean_size = (md.getWidth() + md.getHeight()) / 2;
+    if (bbox.getLeft() < border || bbox.getRight() > I.getWidth() - border
+        || bbox.getTop() < border || bbox.getBottom() > I.getHeight() - border
+        || vpMath::abs(cog.get_u() - cogd.get_u()) > 20 || vpMath::abs(cog.get_v() - cogd.get_v()) > 20
+        || md.getArea() < 0.5 * mean_surface || md.getArea() > 3 * mean_surface
+        || md.getWidth() > 1.5 * mean_size || md.getWidth() < 0.5 * mean_size
+        || md.getHeight() > 1.5 * mean_size || md.getHeight() < 0.5 * mean_size)
+      continue;
+    points.push_back(m_grid[i]);
+    dots.push_back(cogd);
+  }
+
+  // Refine on all the dots, then once more without the dots far above the RMS error
+  std::vector<double> errors;
+  for (unsigned int pass=0; pass < 2; pass++) {
+    if (points.size() < m_min_nb_dots || points.size() < 4) {
+      detection.error = "not enough dots";
+      return false;
+    }
+    try {
+      if (m_estimate_cam) {
+        vpCalibration full;
+        for (size_t i=0; i < points.size(); i++)
+          full.addPoint(points[i].get_oX(), points[i].get_oY(), points[i].get_oZ(), dots[i]);
+        full.computeCalibration(vpCalibration::CALIB_VIRTUAL_VS, cMo, cam_local, false);
+      }
+      else
+        computePose(points, dots, cam_local, cMo);
+    }
+    catch (...) {
+      detection.error = "pose refinement failed";
+      return false;
+    }
+    detection.residual = computeResidual(points, dots, cMo, cam_local, errors);
+    if (pass == 1)
+      break;
+
+    double max_error = std::max(3 * detection.residual, 1.);
+    size_t n = 0;
+    for (size_t i=0; i < points.size(); i++) {
+      if (errors[i] > max_error)
+        continue;
+      points[n] = points[i];
+      dots[n] = dots[i];
+      n ++;
+    }
+    detection.nb_outliers = (unsigned int)(points.size() - n);
+    points.resize(n);
+    dots.resize(n);
+  }
+
+  for (size_t i=0; i < points.size(); i++)
+    detection.calib.addPoint(points[i].get_oX(), points[i].get_oY(), points[i].get_oZ(), dots[i]);
+  detection.cMo = cMo;
+  detection.cam = cam_local;
+  detection.nb_dots = (unsigned int)points.size();
+  if (detection.residual > m_max_residual) {
+    detection.error = "residual too large";
+    return false;
+  }
+  detection.valid = true;
+  return true;
+}
+
+/*!
+  Detect the grid in a set of images read from \e filenames, in parallel with vpParallelFor.
+  \param germs : Image positions of the reference dots, used for the images without their own file
+  <image>.txt saved by saveGerms().
+  \param cam : Initial camera parameters.
+  \param threads : Number of threads, the number of cores if 0.
+  \param detections : Result of each image, rejected with the error "cannot read the image" if the image
+  cannot be read.
+ */
+void vpGridDetector::detect(const std::vector<std::string> &filenames, const std::vector<vpImagePoint> &germs,
+                            const vpCameraParameters &cam, unsigned int threads,
+                            std::vector<vpDetection> &detections) const
+{
+  detections.resize(filenames.size());
+  vpBatch batch;
+  batch.detector = this;
+  batch.filenames = &filenames;
+  batch.germs = &germs;
+  batch.cam = &cam;
+  batch.detections = &detections;
+  vpParallelFor::run((unsigned int)filenames.size(), detectImage, &batch, threads);
+}
@@ -0,0 +1,111 @@
+#ifndef __vpGridDetector_h__
+#define __vpGridDetector_h__
+
+#include <string>
+#include <vector>
+
+#include <visp/vpCalibration.h>
+#include <visp/vpCameraParameters.h>
+#include <visp/vpHomogeneousMatrix.h>
+#include <visp/vpImage.h>
+#include <visp/vpImagePoint.h>
+#include <visp/vpPoint.h>
+
+/*!
+  Detection of the dots of the 3D calibration grid of calibrate3dGrid-Lagadic in an image, without any display
+  nor click, so that the images of a calibration can be processed in parallel.
+
+  The operator clicks of calibrate3dGrid-Lagadic are replaced by germs: the approximate image positions of the
+  reference dots used to compute the initial pose (5 dots of the Lagadic grid by default, see setPosePoints()).
+  They can be saved by the interactive mode of the tool, written by hand once for a fixed setup, or come from
+  a previous detection. detect() then:
+  - tracks the reference dots with vpDot2 from their germs and computes the initial pose and camera parameters,
+  - projects all the dots of the grid and tracks them with the same tests as calibrate3dGrid-Lagadic on the
+    position, area and shape of the dots,
+  - refines the pose on all the dots, removes the dots whose reprojection error is far above the others and
+    rejects the image if the remaining RMS reprojection error or the number of dots is not acceptable.
+
+  detect() is const and only uses local objects, so that a single detector can be shared by several threads.
+  The overload on a list of image files runs the detection of all the images in parallel.
+
+  \code
+  vpGridDetector detector;
+  detector.loadGrid("mire3p.dat");
+  std::vector<vpImagePoint> germs;
+  vpGridDetector::readGerms("I0001.pgm.txt", germs);
+  vpGridDetector::vpDetection detection;
+  if (detector.detect(I, germs, cam, detection))
+    std::cout << detection.nb_dots << " dots, residual " << detection.residual << " px" << std::endl;
+  \endcode
+ */
+class vpGridDetector
+{
+public:
+  //! Result of detect().
+  struct vpDetection {
+    bool valid;
+    std::string error;              // Reason of the rejection if not valid
+    vpCalibration calib;            // Valid dots, for vpCalibration::computeCalibrationMulti()
+    vpHomogeneousMatrix cMo;        // Pose of the grid refined on all the valid dots
+    vpCameraParameters cam;         // Camera parameters estimated on this image only
+    unsigned int nb_dots;
+    unsigned int nb_outliers;       // Dots removed because of their reprojection error
+    double residual;                // RMS reprojection error in pixels
+  };
+
+protected:
+  std::vector<vpPoint> m_grid;
+  std::vector<vpPoint> m_pose_points;
+  double m_gray_precision;
+  double m_shape_precision;
+  double m_size_precision;
+  double m_max_residual;
+  unsigned int m_min_nb_dots;
+  unsigned int m_border;
+  bool m_estimate_cam;
+
+public:
+  vpGridDetector();
+  virtual ~vpGridDetector() {}
+
+  bool detect(const vpImage<unsigned char> &I, const std::vector<vpImagePoint> &germs, const vpCameraParameters &cam,
+              vpDetection &detection) const;
+  void detect(const std::vector<std::string> &filenames, const std::vector<vpImagePoint> &germs,
+              const vpCameraParameters &cam, unsigned int threads, std::vector<vpDetection> &detections) const;
+
+  const std::vector<vpPoint> &getGrid() const {return m_grid;}
+  double getMaxResidual() const {return m_max_residual;}
+  unsigned int getMinNbDots() const {return m_min_nb_dots;}
+  const std::vector<vpPoint> &getPosePoints() const {return m_pose_points;}
+
+  void loadGrid(const std::string &filename);
+  void projectPosePoints(const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam,
+                         std::vector<vpImagePoint> &germs) const;
+
+  static bool readGerms(const std::string &filename, std::vector<vpImagePoint> &germs);
+  static void saveGerms(const std::string &filename, const std::vector<vpImagePoint> &germs);
+
+  //! Dots closer than \e border pixels to the image border are not used.
+  void setBorder(unsigned int border) {m_border = border;}
+  /*!
+    If true (default), the camera parameters are estimated with the pose on each image like in
+    calibrate3dGrid-Lagadic. Otherwise only the pose is computed, with the camera parameters given to detect()
+    that may include distortion, as needed for hand-eye calibration.
+   */
+  void setCameraEstimation(bool estimate) {m_estimate_cam = estimate;}
+  void setDotPrecision(double gray_level, double shape, double size);
+  void setGrid(const std::vector<vpPoint> &grid) {m_grid = grid;}
+  //! Largest RMS reprojection error in pixels of an accepted image.
+  void setMaxResidual(double max_residual) {m_max_residual = max_residual;}
+  //! Smallest number of valid dots of an accepted image.
+  void setMinNbDots(unsigned int min_nb_dots) {m_min_nb_dots = min_nb_dots;}
+  void setPosePoints(const std::vector<vpPoint> &points) {m_pose_points = points;}
+
+  static void computePose(const std::vector<vpPoint> &points, const std::vector<vpImagePoint> &dots,
+                          const vpCameraParameters &cam, vpHomogeneousMatrix &cMo, bool init=false);
+  static double computeResidual(const std::vector<vpPoint> &points, const std::vector<vpImagePoint> &dots,
+                                const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam,
+                                std::vector<double> &errors);
+};
+
+#endif
@@ -0,0 +1,285 @@
+#include <math.h>
+
+#include <algorithm>
+
+#include <visp/vpException.h>
+#include <visp/vpExponentialMap.h>
+#include <visp/vpMatrix.h>
+#include <visp/vpRotationMatrix.h>
+#include <visp/vpThetaUVector.h>
+#include <visp/vpTranslationVector.h>
+
+#include <vpHandEyeSolver.h>
+
+namespace {
+  double median(std::vector<double> values)
+  {
+    std::vector<double>::iterator middle = values.begin() + values.size() / 2;
+    std::nth_element(values.begin(), middle, values.end());
+    return *middle;
+  }
+}
+
+vpHandEyeSolver::vpHandEyeSolver()
+  : m_tMe(), m_cMo(), m_used(), m_error_t(), m_error_r(), m_eMc(), m_tMo(), m_eMc_tsai(), m_outlier_factor(3.),
+    m_min_outlier_t(0.002), m_min_outlier_r(0.002), m_max_iter(50), m_nb_iter(0)
+{
+}
+
+/*!
+  Add the end-effector pose \e tMe given by the robot and the pose \e cMo of the grid seen by the camera at the
+  same time.
+ */
+void vpHandEyeSolver::addPair(const vpHomogeneousMatrix &tMe, const vpHomogeneousMatrix &cMo)
+{
+  m_tMe.push_back(tMe);
+  m_cMo.push_back(cMo);
+  m_used.push_back(true);
+  m_error_t.push_back(0.);
+  m_error_r.push_back(0.);
+}
+
+void vpHandEyeSolver::clear()
+{
+  m_tMe.clear();
+  m_cMo.clear();
+  m_used.clear();
+  m_error_t.clear();
+  m_error_r.clear();
+}
+
+unsigned int vpHandEyeSolver::getNbUsed() const
+{
+  return (unsigned int)std::count(m_used.begin(), m_used.end(), true);
+}
+
+/*!
+  A pair is rejected by solve() if its translation error is more than \e factor times the median error and
+  more than \e min_translation m, or if its rotation error is more than \e factor times the median error and
+  more than \e min_rotation rad. The minimal errors avoid rejecting pairs because of the noise of the poses.
+  A factor of 0 disables the rejection.
+ */
+void vpHandEyeSolver::setOutlierFactor(double factor, double min_translation, double min_rotation)
+{
+  m_outlier_factor = factor;
+  m_min_outlier_t = min_translation;
+  m_min_outlier_r = min_rotation;
+}
+
+/*!
+  Closed form hand-eye calibration of Tsai and Lenz from at least 3 pairs with rotations around
+  non parallel axes.
+ */
+vpHomogeneousMatrix vpHandEyeSolver::solveTsai(const std::vector<vpHomogeneousMatrix> &tMe,
+                                               const std::vector<vpHomogeneousMatrix> &cMo)
+{
+  unsigned int n = (unsigned int)tMe.size();
+  if (n < 3 || cMo.size() != n)
+    throw vpException(vpException::dimensionError, "Hand-eye calibration needs at least 3 pairs of poses");
+
+  // Relative motions A X = X B between all the pairs of poses
+  std::vector<vpHomogeneousMatrix> A, B;
+  for (unsigned int i=0; i < n; i++)
+    for (unsigned int j=i+1; j < n; j++) {
+      A.push_back(tMe[i].inverse() * tMe[j]);
+      B.push_back(cMo[i] * cMo[j].inverse());
+    }
+  unsigned int m = (unsigned int)A.size();
+
+  // Rotation: skew(Pa + Pb) q = Pb - Pa with P = 2 sin(theta/2) u and q = tan(theta_x/2) u_x
+  vpMatrix M(3*m, 3);
+  vpColVector y(3*m);
+  for (unsigned int k=0; k < m; k++) {
+    vpThetaUVector tu_a, tu_b;
+    A[k].extract(tu_a);
+    B[k].extract(tu_b);
+    double theta_a = sqrt(tu_a[0]*tu_a[0] + tu_a[1]*tu_a[1] + tu_a[2]*tu_a[2]);
+    double theta_b = sqrt(tu_b[0]*tu_b[0] + tu_b[1]*tu_b[1] + tu_b[2]*tu_b[2]);
+    if (theta_a < 1e-6 || theta_b < 1e-6)
+      continue; // Pure translation: no information on the rotation
+    double sa = 2 * sin(theta_a / 2) / theta_a, sb = 2 * sin(theta_b / 2) / theta_b;
+    double pa[3], pb[3], s[3];
+    for (unsigned int i=0; i < 3; i++) {
+      pa[i] = sa * tu_a[i];
+      pb[i] = sb * tu_b[i];
+      s[i] = pa[i] + pb[i];
+      y[3*k + i] = pb[i] - pa[i];
+    }
+    M[3*k][0] = 0;      M[3*k][1] = -s[2];  M[3*k][2] = s[1];
+    M[3*k+1][0] = s[2]; M[3*k+1][1] = 0;    M[3*k+1][2] = -s[0];
+    M[3*k+2][0] = -s[1]; M[3*k+2][1] = s[0]; M[3*k+2][2] = 0;
+  }
+  vpColVector q = M.pseudoInverse() * y;
+  double q_norm = sqrt(q[0]*q[0] + q[1]*q[1] + q[2]*q[2]);
+  vpThetaUVector tu_x(0, 0, 0);
+  if (q_norm > 0) {
+    double theta = 2 * atan(q_norm);
+    for (unsigned int i=0; i < 3; i++)
+      tu_x[i] = theta * q[i] / q_norm;
+  }
+  vpRotationMatrix R(tu_x);
+
+  // Translation: (Ra - I) t = R tb - ta
+  vpMatrix C(3*m, 3);
+  vpColVector d(3*m);
+  for (unsigned int k=0; k < m; k++) {
+    vpRotationMatrix Ra;
+    vpTranslationVector ta, tb;
+    A[k].extract(Ra);
+    A[k].extract(ta);
+    B[k].extract(tb);
+    for (unsigned int i=0; i < 3; i++) {
+      d[3*k + i] = -ta[i];
+      for (unsigned int j=0; j < 3; j++) {
+        C[3*k + i][j] = Ra[i][j] - (i == j ? 1. : 0.);
+        d[3*k + i] += R[i][j] * tb[j];
+      }
+    }
+  }
+  vpColVector t = C.pseudoInverse() * d;
+
+  vpHomogeneousMatrix eMc;
+  eMc.insert(R);
+  eMc.insert(vpTranslationVector(t[0], t[1], t[2]));
+  return eMc;
+}
+
+/*!
+  Pose errors tMo^-1 tMe_i eMc cMo_i of the pairs used, translation then weighted theta u for each pair.
+ */
+void vpHandEyeSolver::computeResidual(const vpHomogeneousMatrix &eMc, const vpHomogeneousMatrix &tMo, double weight,
+                                      vpColVector &r) const
+{
+  vpHomogeneousMatrix oMt = tMo.inverse();
+  unsigned int k = 0;
+  for (size_t i=0; i < m_tMe.size(); i++) {
+    if (! m_used[i])
+      continue;
+    vpHomogeneousMatrix E = oMt * m_tMe[i] * eMc * m_cMo[i];
+    vpTranslationVector t;
+    vpThetaUVector tu;
+    E.extract(t);
+    E.extract(tu);
+    for (unsigned int j=0; j < 3; j++) {
+      r[6*k + j] = t[j];
+      r[6*k + 3 + j] = weight * tu[j];
+    }
+    k ++;
+  }
+}
+
+/*!
+  Gauss-Newton refinement of eMc and tMo on the pairs used, with a numerical Jacobian of the 12 parameters.
+ */
+void vpHandEyeSolver::refine()
+{
+  unsigned int n = getNbUsed();
+  double weight = 0;
+  for (size_t i=0; i < m_cMo.size(); i++) {
+    if (! m_used[i])
+      continue;
+    vpTranslationVector t;
+    m_cMo[i].extract(t);
+    weight += sqrt(t[0]*t[0] + t[1]*t[1] + t[2]*t[2]) / n;
+  }
+  if (weight <= 0)
+    weight = 1.;
+
+  const double eps = 1e-7;
+  vpColVector r(6*n), r_eps(6*n), v(6), dx(12);
+  vpMatrix J(6*n, 12);
+  computeResidual(m_eMc, m_tMo, weight, r);
+  double cost = r.sumSquare();
+  for (m_nb_iter=0; m_nb_iter < m_max_iter; m_nb_iter++) {
+    for (unsigned int k=0; k < 12; k++) {
+      v = 0;
+      v[k % 6] = eps;
+      if (k < 6)
+        computeResidual(m_eMc * vpExponentialMap::direct(v), m_tMo, weight, r_eps);
+      else
+        computeResidual(m_eMc, m_tMo * vpExponentialMap::direct(v), weight, r_eps);
+      for (unsigned int i=0; i < 6*n; i++)
+        J[i][k] = (r_eps[i] - r[i]) / eps;
+    }
+    dx = -1. * ((J.t() * J).pseudoInverse() * (J.t() * r));
+
+    vpColVector dx_e(6), dx_o(6);
+    for (unsigned int k=0; k < 6; k++) {
+      dx_e[k] = dx[k];
+      dx_o[k] = dx[6 + k];
+    }
+    vpHomogeneousMatrix eMc = m_eMc * vpExponentialMap::direct(dx_e);
+    vpHomogeneousMatrix tMo = m_tMo * vpExponentialMap::direct(dx_o);
+    computeResidual(eMc, tMo, weight, r_eps);
+    double new_cost = r_eps.sumSquare();
+    if (new_cost >= cost)
+      break;
+    m_eMc = eMc;
+    m_tMo = tMo;
+    r = r_eps;
+    if (cost - new_cost < 1e-12 * cost) {
+      m_nb_iter ++;
+      break;
+    }
+    cost = new_cost;
+  }
+}
+
+void vpHandEyeSolver::computeErrors()
+{
+  vpHomogeneousMatrix oMt = m_tMo.inverse();
+  for (size_t i=0; i < m_tMe.size(); i++) {
+    vpHomogeneousMatrix E = oMt * m_tMe[i] * m_eMc * m_cMo[i];
+    vpTranslationVector t;
+    vpThetaUVector tu;
+    E.extract(t);
+    E.extract(tu);
+    m_error_t[i] = sqrt(t[0]*t[0] + t[1]*t[1] + t[2]*t[2]);
+    m_error_r[i] = sqrt(tu[0]*tu[0] + tu[1]*tu[1] + tu[2]*tu[2]);
+  }
+}
+
+/*!
+  Compute eMc and tMo from all the pairs, then once more without the outliers.
+ */
+void vpHandEyeSolver::solve()
+{
+  if (m_tMe.size() < 3)
+    throw vpException(vpException::dimensionError, "Hand-eye calibration needs at least 3 pairs of poses");
+  m_used.assign(m_tMe.size(), true);
+
+  for (unsigned int pass=0; pass < 2; pass++) {
+    std::vector<vpHomogeneousMatrix> tMe, cMo;
+    for (size_t i=0; i < m_tMe.size(); i++)
+      if (m_used[i]) {
+        tMe.push_back(m_tMe[i]);
+        cMo.push_back(m_cMo[i]);
+      }
+    m_eMc_tsai = solveTsai(tMe, cMo);
+    m_eMc = m_eMc_tsai;
+    m_tMo = tMe[0] * m_eMc * cMo[0];
+    refine();
+    computeErrors();
+    if (pass == 1 || m_outlier_factor <= 0)
+      break;
+
+    std::vector<double> error_t, error_r;
+    for (size_t i=0; i < m_tMe.size(); i++)
+      if (m_used[i]) {
+        error_t.push_back(m_error_t[i]);
+        error_r.push_back(m_error_r[i]);
+      }
+    double max_t = std::max(m_outlier_factor * median(error_t), m_min_outlier_t);
+    double max_r = std::max(m_outlier_factor * median(error_r), m_min_outlier_r);
+    std::vector<bool> used = m_used;
+    unsigned int nb_rejected = 0;
+    for (size_t i=0; i < m_tMe.size(); i++)
+      if (used[i] && (m_error_t[i] > max_t || m_error_r[i] > max_r)) {
+        used[i] = false;
+        nb_rejected ++;
+      }
+    if (nb_rejected == 0 || tMe.size() - nb_rejected < 3)
+      break;
+    m_used = used;
+  }
+}
@@ -0,0 +1,90 @@
+#ifndef __vpHandEyeSolver_h__
+#define __vpHandEyeSolver_h__
+
+#include <vector>
+
+#include <visp/vpColVector.h>
+#include <visp/vpHomogeneousMatrix.h>
+
+/*!
+  Hand-eye calibration: transformation eMc between the end-effector and the camera that it carries, from
+  pairs of end-effector poses tMe given by the robot and calibration grid poses cMo seen by the camera, the
+  grid being fixed in the torso frame t.
+
+  For every pair i, tMo = tMe_i eMc cMo_i. solve():
+  - computes a closed form initial eMc with the method of Tsai and Lenz on all the pairs of pairs i, j:
+    A X = X B with A = tMe_i^-1 tMe_j and B = cMo_i cMo_j^-1; the rotation is solved first in the least
+    squares sense with the modified Rodrigues vectors of A and B, then the translation;
+  - refines eMc and tMo together with a Gauss-Newton minimization of the pose errors
+    tMo^-1 tMe_i eMc cMo_i of all the pairs, the rotation errors being weighted by the mean distance
+    between the camera and the grid so that both parts are in meters;
+  - computes the translation and rotation error of each pair, removes the pairs whose error is more than
+    getOutlierFactor() times the median error, and solves again without them.
+
+  \code
+  vpHandEyeSolver solver;
+  for (unsigned int i=0; i < nb_pairs; i++)
+    solver.addPair(tMe[i], cMo[i]);
+  solver.solve();
+  for (unsigned int i=0; i < solver.getNbPairs(); i++)
+    std::cout << i << ": " << solver.getTranslationError(i) << " m, " << vpMath::deg(solver.getRotationError(i))
+              << " deg" << (solver.isUsed(i) ? "" : " rejected") << std::endl;
+  vpHomogeneousMatrix eMc = solver.get_eMc();
+  \endcode
+ */
+class vpHandEyeSolver
+{
+protected:
+  std::vector<vpHomogeneousMatrix> m_tMe;
+  std::vector<vpHomogeneousMatrix> m_cMo;
+  std::vector<bool> m_used;
+  std::vector<double> m_error_t;      // Translation error of each pair in m
+  std::vector<double> m_error_r;      // Rotation error of each pair in rad
+  vpHomogeneousMatrix m_eMc;
+  vpHomogeneousMatrix m_tMo;
+  vpHomogeneousMatrix m_eMc_tsai;
+  double m_outlier_factor;
+  double m_min_outlier_t;
+  double m_min_outlier_r;
+  unsigned int m_max_iter;
+  unsigned int m_nb_iter;
+
+public:
+  vpHandEyeSolver();
+  virtual ~vpHandEyeSolver() {}
+
+  void addPair(const vpHomogeneousMatrix &tMe, const vpHomogeneousMatrix &cMo);
+  void clear();
+
+  vpHomogeneousMatrix get_eMc() const {return m_eMc;}
+  //! Closed form solution of the last solve(), before the refinement.
+  vpHomogeneousMatrix get_eMc_tsai() const {return m_eMc_tsai;}
+  vpHomogeneousMatrix get_tMo() const {return m_tMo;}
+  //! Number of Gauss-Newton iterations of the last refinement.
+  unsigned int getNbIterations() const {return m_nb_iter;}
+  unsigned int getNbPairs() const {return (unsigned int)m_tMe.size();}
+  unsigned int getNbUsed() const;
+  double getOutlierFactor() const {return m_outlier_factor;}
+  //! Rotation error of pair \e i in rad after solve().
+  double getRotationError(unsigned int i) const {return m_error_r[i];}
+  //! Translation error of pair \e i in m after solve().
+  double getTranslationError(unsigned int i) const {return m_error_t[i];}
+  //! False if pair \e i was rejected as an outlier by solve().
+  bool isUsed(unsigned int i) const {return m_used[i];}
+
+  void setMaxIterations(unsigned int max_iter) {m_max_iter = max_iter;}
+  void setOutlierFactor(double factor, double min_translation=0.002, double min_rotation=0.002);
+
+  void solve();
+
+  static vpHomogeneousMatrix solveTsai(const std::vector<vpHomogeneousMatrix> &tMe,
+                                       const std::vector<vpHomogeneousMatrix> &cMo);
+
+protected:
+  void computeErrors();
+  void computeResidual(const vpHomogeneousMatrix &eMc, const vpHomogeneousMatrix &tMo, double weight,
+                       vpColVector &r) const;
+  void refine();
+};
+
+#endif
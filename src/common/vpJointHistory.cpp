@@ -0,0 +1,121 @@
+#include <vpJointHistory.h>
+
+
+/*!
+  Create an history.
+  \param nb_joints : Number of joints of each sample.
+  \param capacity : Maximum number of samples.
+ */
+vpJointHistory::vpJointHistory(unsigned int nb_joints, unsigned int capacity)
+  : m_nb_joints(nb_joints), m_capacity(capacity ? capacity : 1), m_size(0), m_head(0),
+    m_t(m_capacity), m_q(m_capacity*nb_joints)
+{
+}
+
+/*!
+  Add a sample. The samples have to be added with increasing timestamps.
+  \param t : Time in s of the joint positions.
+  \param q : Joint positions. Only the first getNbJoints() values are used.
+ */
+void vpJointHistory::add(double t, const vpColVector &q)
+{
+  m_t[m_head] = t;
+  double *q_head = &m_q[m_head*m_nb_joints];
+  for (unsigned int j=0; j < m_nb_joints; j++)
+    q_head[j] = (j < q.getRows()) ? q[j] : 0.;
+
+  m_head = (m_head + 1) % m_capacity;
+  if (m_size < m_capacity)
+    m_size ++;
+}
+
+/*!
+  Compute the joint displacement between \e t and the last sample: dq = q_last - q(t).
+  \param t : Time in s. Clamped to the time span of the history.
+  \param dq : Joint displacement. Only resized if it does not have getNbJoints() elements.
+  \return false if the history is empty.
+ */
+bool vpJointHistory::getDisplacement(double t, vpColVector &dq) const
+{
+  if (m_size == 0)
+    return false;
+
+  if (dq.getRows() != m_nb_joints)
+    dq.resize(m_nb_joints, false);
+
+  unsigned int i0, i1;
+  double alpha;
+  interpolate(t, i0, i1, alpha);
+  const double *q0 = &m_q[index(i0)*m_nb_joints];
+  const double *q1 = &m_q[index(i1)*m_nb_joints];
+  const double *q_last = &m_q[index(m_size-1)*m_nb_joints];
+  for (unsigned int j=0; j < m_nb_joints; j++)
+    dq[j] = q_last[j] - ((1 - alpha) * q0[j] + alpha * q1[j]);
+  return true;
+}
+
+/*!
+  Return the time of the last sample, or 0 if the history is empty.
+ */
+double vpJointHistory::getLastTimestamp() const
+{
+  if (m_size == 0)
+    return 0.;
+  return m_t[index(m_size-1)];
+}
+
+/*!
+  Compute the joint positions at time \e t by linear interpolation.
+  \param t : Time in s. Clamped to the time span of the history.
+  \param q : Joint positions. Only resized if it does not have getNbJoints() elements.
+  \return false if the history is empty.
+ */
+bool vpJointHistory::getPosition(double t, vpColVector &q) const
+{
+  if (m_size == 0)
+    return false;
+
+  if (q.getRows() != m_nb_joints)
+    q.resize(m_nb_joints, false);
+
+  unsigned int i0, i1;
+  double alpha;
+  interpolate(t, i0, i1, alpha);
+  const double *q0 = &m_q[index(i0)*m_nb_joints];
+  const double *q1 = &m_q[index(i1)*m_nb_joints];
+  for (unsigned int j=0; j < m_nb_joints; j++)
+    q[j] = (1 - alpha) * q0[j] + alpha * q1[j];
+  return true;
+}
+
+/*!
+  Find the samples i0 and i1 (in chronological order) around \e t and the interpolation factor.
+  The history should not be empty.
+ */
+void vpJointHistory::interpolate(double t, unsigned int &i0, unsigned int &i1, double &alpha) const
+{
+  if (t <= m_t[index(0)]) {
+    i0 = i1 = 0;
+    alpha = 0.;
+    return;
+  }
+  if (t >= m_t[index(m_size-1)]) {
+    i0 = i1 = m_size-1;
+    alpha = 0.;
+    return;
+  }
+
+  // Binary search of the last sample before t
+  unsigned int lo = 0, hi = m_size-1;
+  while (hi - lo > 1) {
+    unsigned int mid = (lo + hi) / 2;
+    if (m_t[index(mid)] <= t)
+      lo = mid;
+    else
+      hi = mid;
+  }
+  i0 = lo;
+  i1 = hi;
+  double dt = m_t[index(i1)] - m_t[index(i0)];
+  alpha = (dt > 0) ? (t - m_t[index(i0)]) / dt : 0.;
+}
@@ -0,0 +1,61 @@
+#ifndef __vpJointHistory_h__
+#define __vpJointHistory_h__
+
+#include <vector>
+
+#include <visp/vpColVector.h>
+
+/*!
+  Fixed size history of timestamped joint positions.
+
+  The samples are stored in a ring buffer allocated at construction: add() never allocates and
+  overwrites the oldest sample when the history is full. The positions between two samples are
+  linearly interpolated. Used by vpServoArm and vpServoHead to compensate the latency between the
+  capture of an image and the use of the measure in the control law.
+
+  \code
+  vpJointHistory history(joint_names.size());
+  servo_arm.setLatencyCompensation(&history);
+  while (1) {
+    double t_capture = vpTime::measureTimeSecond();
+    history.add(t_capture, robot.getPosition(joint_names));
+    g.acquire(I);
+    tracker.track(I);
+    history.add(vpTime::measureTimeSecond(), robot.getPosition(joint_names));
+    ...
+    servo_arm.setCurrentFeature(cdMc, t_capture);
+  }
+  \endcode
+
+  This class is not thread safe.
+ */
+class vpJointHistory
+{
+protected:
+  unsigned int m_nb_joints;
+  unsigned int m_capacity;
+  unsigned int m_size;
+  unsigned int m_head;          // Index of the next sample to write
+  std::vector<double> m_t;
+  std::vector<double> m_q;      // capacity x nb_joints
+
+public:
+  vpJointHistory(unsigned int nb_joints=7, unsigned int capacity=256);
+  virtual ~vpJointHistory() {}
+
+  void add(double t, const vpColVector &q);
+  void clear() {m_size = 0; m_head = 0;}
+
+  unsigned int getCapacity() const {return m_capacity;}
+  bool getDisplacement(double t, vpColVector &dq) const;
+  double getLastTimestamp() const;
+  unsigned int getNbJoints() const {return m_nb_joints;}
+  bool getPosition(double t, vpColVector &q) const;
+  unsigned int getSize() const {return m_size;}
+
+protected:
+  unsigned int index(unsigned int i) const {return (m_head + m_capacity - m_size + i) % m_capacity;}
+  void interpolate(double t, unsigned int &i0, unsigned int &i1, double &alpha) const;
+};
+
+#endif
@@ -1,8 +1,13 @@
 #ifndef __vpJointLimitAvoidance_h__
 #define __vpJointLimitAvoidance_h__
 
+#include <math.h>
 
-double sigmoidFunction(const vpColVector & e)
+#include <visp/vpColVector.h>
+#include <visp/vpMath.h>
+#include <visp/vpMatrix.h>
+
+inline double sigmoidFunction(const vpColVector & e)
 {
   double e0 = 0.1;
   double e1 = 0.7;
@@ -22,7 +27,7 @@ double sigmoidFunction(const vpColVector & e)
   return sig;
 }
 
-vpMatrix computeP(const vpColVector & e, const vpMatrix & J, const vpMatrix & J_pinv,const int & n)
+inline vpMatrix computeP(const vpColVector & e, const vpMatrix & J, const vpMatrix & J_pinv,const int & n)
 {
 
   vpMatrix P(n,n);
@@ -61,7 +66,7 @@ vpMatrix computeP(const vpColVector & e, const vpMatrix & J, const vpMatrix & J_
 
 
 
-vpColVector computeQsec(const vpMatrix &P, const vpColVector &jointMin, const vpColVector &jointMax,  const vpColVector & q , const vpColVector & q1,  const double & ro,const double & ro1, vpColVector & q_l0_min, vpColVector & q_l0_max, vpColVector &q_l1_min, vpColVector &q_l1_max, bool use_custom_lim )
+inline vpColVector computeQsec(const vpMatrix &P, const vpColVector &jointMin, const vpColVector &jointMax,  const vpColVector & q , const vpColVector & q1,  const double & ro,const double & ro1, vpColVector & q_l0_min, vpColVector & q_l0_max, vpColVector &q_l1_min, vpColVector &q_l1_max, bool use_custom_lim )
 {
 
 
@@ -172,7 +177,7 @@ vpColVector computeQsec(const vpMatrix &P, const vpColVector &jointMin, const vp
 
 
 
-vpColVector computeQdotLimitAvoidance(const vpColVector & e, const vpMatrix & J, const vpMatrix & J_pinv,const vpColVector & jointMin,const vpColVector & jointMax, const vpColVector & q , const vpColVector & q1, const double & ro,const double & ro1, vpColVector & q_l0_min, vpColVector & q_l0_max, vpColVector &q_l1_min, vpColVector &q_l1_max, bool use_custom_lim = false  )
+inline vpColVector computeQdotLimitAvoidance(const vpColVector & e, const vpMatrix & J, const vpMatrix & J_pinv,const vpColVector & jointMin,const vpColVector & jointMax, const vpColVector & q , const vpColVector & q1, const double & ro,const double & ro1, vpColVector & q_l0_min, vpColVector & q_l0_max, vpColVector &q_l1_min, vpColVector &q_l1_max, bool use_custom_lim = false  )
 {
   int n = q.size();
   // Computation Projector operator P
@@ -189,9 +194,147 @@ vpColVector computeQdotLimitAvoidance(const vpColVector & e, const vpMatrix & J,
 }
 
 
+/*!
+  Joint limit avoidance for a chain of N joints (7 for the arms, 4 to 6 for the head and eyes).
+
+  Same computation than computeP(), computeQsec() and computeQdotLimitAvoidance(), but
+  the projector and the intermediate vectors are fixed size arrays on the stack: no memory is allocated
+  as long as the output vector already has N elements. The projector is computed once with
+  J^T e e^T J = v v^T where v = J^T e, the sigmoid is evaluated once, and since g is diagonal
+  P g_i is the i-th column of P scaled by g_i.
+
+  \code
+  vpColVector q2(7);
+  vpJointLimitAvoidance<7>::computeQdotLimitAvoidance(e, J, J_pinv, jointMin, jointMax, q, q1, ro, ro1,
+                                                      q_l0_min, q_l0_max, q_l1_min, q_l1_max, q2);
+  \endcode
+ */
+template <unsigned int N>
+class vpJointLimitAvoidance
+{
+public:
+  /*!
+    Compute the projector P = s(e) P_norm_e + (1 - s(e)) P_e in \e P.
+   */
+  static void computeP(const vpColVector &e, const vpMatrix &J, const vpMatrix &J_pinv, double P[N][N])
+  {
+    unsigned int m = J.getRows();
+
+    // v = J^T e and pp = e^T J J^T e = v^T v
+    double v[N];
+    double pp = 0.0;
+    for (unsigned int j = 0; j < N; j++) {
+      double sum = 0.0;
+      for (unsigned int k = 0; k < m; k++)
+        sum += J[k][j] * e[k];
+      v[j] = sum;
+      pp += sum * sum;
+    }
+
+    double sig = sigmoidFunction(e);
+    for (unsigned int i = 0; i < N; i++) {
+      for (unsigned int j = 0; j < N; j++) {
+        double JpJ = 0.0;
+        for (unsigned int k = 0; k < m; k++)
+          JpJ += J_pinv[i][k] * J[k][j];
+        double I_ij = (i == j) ? 1.0 : 0.0;
+        double P_e = I_ij - JpJ;
+        double P_norm_e = I_ij - (1.0 / pp) * v[i] * v[j];
+        P[i][j] = sig * P_norm_e + (1 - sig) * P_e;
+      }
+    }
+  }
+
+  /*!
+    Compute the secondary task \e q2 from the projector. \e q2 is only resized if it does not have N elements.
+   */
+  static void computeQsec(const double P[N][N], const vpColVector &jointMin, const vpColVector &jointMax,
+                          const vpColVector &q, const vpColVector &q1, const double &ro, const double &ro1,
+                          vpColVector &q_l0_min, vpColVector &q_l0_max, vpColVector &q_l1_min, vpColVector &q_l1_max,
+                          bool use_custom_lim, vpColVector &q2)
+  {
+    double lambda = 0.7;
+    double lambda_l = 0.0;
+
+    if (q2.getRows() != N)
+      q2.resize(N, false);
+
+    // Diagonal of g
+    double g[N];
+    for (unsigned int i = 0; i < N; i++) {
+      if (!use_custom_lim) {
+        double qmin = jointMin[i];
+        double qmax = jointMax[i];
 
+        q_l0_min[i] = qmin + ro *(qmax - qmin);
+        q_l0_max[i] = qmax - ro *(qmax - qmin);
 
+        q_l1_min[i] =  q_l0_min[i] - ro * ro1 * (qmax - qmin);
+        q_l1_max[i] =  q_l0_max[i] + ro * ro1 * (qmax - qmin);
+      }
 
+      if (q[i] < q_l0_min[i])
+        g[i] = -1;
+      else if (q[i] > q_l0_max[i])
+        g[i] = 1;
+      else
+        g[i] = 0;
+      q2[i] = 0.0;
+    }
 
+    // Like computeQsec(), q2_i and lambda_l keep the value of the previous joint when they are not updated
+    double q2_i[N];
+    for (unsigned int j = 0; j < N; j++)
+      q2_i[j] = 0.0;
+
+    for (unsigned int i = 0; i < N; i++) {
+      if (q[i] > q_l0_min[i] && q[i] < q_l0_max[i]) {
+        for (unsigned int j = 0; j < N; j++)
+          q2_i[j] = 0.0;
+        continue;
+      }
+
+      double b = vpMath::abs(q1[i]) / vpMath::abs(P[i][i] * g[i]);
+      if (b < 1) {
+        double k;
+        if (q[i] < q_l1_min[i] || q[i] > q_l1_max[i])
+          k = - (1 + lambda) * b;
+        else {
+          if (q[i] >= q_l0_max[i] && q[i] <= q_l1_max[i])
+            lambda_l = 1 / (1 + exp(-12 *( (q[i] - q_l0_max[i]) / (q_l1_max[i] - q_l0_max[i])  ) + 6 ) );
+          else if (q[i] >= q_l1_min[i] && q[i] < q_l0_min[i])
+            lambda_l = 1 / (1 + exp(-12 *( (q[i] - q_l0_min[i]) / (q_l1_min[i] - q_l0_min[i])  ) + 6 ) );
+          k = - lambda_l * (1 + lambda) * b;
+        }
+        // P g_i = g_i P_i
+        for (unsigned int j = 0; j < N; j++)
+          q2_i[j] = k * P[j][i] * g[i];
+      }
+      for (unsigned int j = 0; j < N; j++)
+        q2[j] += q2_i[j];
+    }
+  }
+
+  /*!
+    Compute the joint velocities \e q2 that avoid the joint limits. See computeQdotLimitAvoidance().
+    If the chain does not have N joints, the generic implementation is used.
+   */
+  static void computeQdotLimitAvoidance(const vpColVector &e, const vpMatrix &J, const vpMatrix &J_pinv,
+                                        const vpColVector &jointMin, const vpColVector &jointMax,
+                                        const vpColVector &q, const vpColVector &q1, const double &ro, const double &ro1,
+                                        vpColVector &q_l0_min, vpColVector &q_l0_max, vpColVector &q_l1_min, vpColVector &q_l1_max,
+                                        vpColVector &q2, bool use_custom_lim = false)
+  {
+    if (q.size() != N || J.getCols() != N || J_pinv.getRows() != N) {
+      q2 = ::computeQdotLimitAvoidance(e, J, J_pinv, jointMin, jointMax, q, q1, ro, ro1,
+                                       q_l0_min, q_l0_max, q_l1_min, q_l1_max, use_custom_lim);
+      return;
+    }
+
+    double P[N][N];
+    computeP(e, J, J_pinv, P);
+    computeQsec(P, jointMin, jointMax, q, q1, ro, ro1, q_l0_min, q_l0_max, q_l1_min, q_l1_max, use_custom_lim, q2);
+  }
+};
 
 #endif
@@ -50,7 +50,8 @@
   */
 vpMbLocalization::vpMbLocalization(const std::string &model, const std::string &configuration_file_folder, const vpCameraParameters &cam)
   : m_tracker(NULL), m_keypoint_learning(NULL), m_keypoint_detection (NULL), m_init_detection (false),m_state(detection),
-    m_num_iteration_detection(6), m_counter_detection(0), m_manual_detection (0), m_checkValiditycMo(NULL), m_only_detection(false), m_status_single_detection(false)
+    m_num_iteration_detection(6), m_counter_detection(0), m_manual_detection (0), m_checkValiditycMo(NULL), m_only_detection(false), m_status_single_detection(false),
+    m_profiler("vpMbLocalization"), m_frame_timestamp(0), m_timestamp(0), m_overlay()
 
 {
   m_model = model;
@@ -100,6 +101,7 @@ vpMbLocalization::vpMbLocalization(const std::string &model, const std::string &
  */
 void vpMbLocalization::learnObject(vpImage<unsigned char> &I)
 {
+  m_overlay.clear();
 
   //Keypoint declaration and initialization
   //  static bool firstTime = false;
@@ -136,7 +138,7 @@ void vpMbLocalization::learnObject(vpImage<unsigned char> &I)
 
   //Display reference keypoints
   for(std::vector<cv::KeyPoint>::const_iterator it = trainKeyPoints.begin(); it != trainKeyPoints.end(); ++it) {
-    vpDisplay::displayCross(I, it->pt.y, it->pt.x, 4, vpColor::red);
+    m_overlay.displayCross(I, vpImagePoint(it->pt.y, it->pt.x), 4, vpColor::red);
   }
 
 }
@@ -185,6 +187,7 @@ bool vpMbLocalization::track(const vpImage<unsigned char> &I)
 
   bool status_tracking = false;
   m_status_single_detection = false;
+  m_overlay.clear();
   bool verbose = 0;
 
   if (m_state == detection ) {
@@ -208,7 +211,13 @@ bool vpMbLocalization::track(const vpImage<unsigned char> &I)
         vpHomogeneousMatrix cMo_temp;
 
         //Matching and pose estimation
-        if(m_keypoint_detection->matchPoint(I, m_cam, cMo_temp, error, elapsedTime))
+        bool matched = m_keypoint_detection->matchPoint(I, m_cam, cMo_temp, error, elapsedTime);
+        if (m_profiler.isEnabled()) {
+          m_profiler.addSample(vpStageProfiler::detect, m_keypoint_detection->getDetectionTime() + m_keypoint_detection->getExtractionTime());
+          m_profiler.addSample(vpStageProfiler::match, m_keypoint_detection->getMatchingTime());
+          m_profiler.addSample(vpStageProfiler::ransac, m_keypoint_detection->getPoseTime());
+        }
+        if(matched)
         {
           if (verbose)
             std::cout <<"elaspedtime: " << elapsedTime << std::endl;
@@ -217,7 +226,10 @@ bool vpMbLocalization::track(const vpImage<unsigned char> &I)
 
             //Tracker set pose
             //m_tracker->setPose(I, cMo_temp);
-            m_tracker->initFromPose(I, cMo_temp);
+            {
+              vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::init);
+              m_tracker->initFromPose(I, cMo_temp);
+            }
             if (verbose)
             {
               std::cout << "Detection ok" << std::endl;
@@ -225,8 +237,8 @@ bool vpMbLocalization::track(const vpImage<unsigned char> &I)
             }
 
             //Display
-            m_tracker->display(I, cMo_temp, m_cam, vpColor::cyan, 1);
-            vpDisplay::displayFrame(I, cMo_temp, m_cam, 0.025, vpColor::none, 3);
+            m_overlay.displayModel(I, m_tracker, cMo_temp, m_cam, vpColor::cyan, 1);
+            m_overlay.displayFrame(I, cMo_temp, m_cam, 0.025, vpColor::none, 3);
 
             vpPoseVector cPo;
             cPo.buildFrom(cMo_temp);
@@ -258,6 +270,7 @@ bool vpMbLocalization::track(const vpImage<unsigned char> &I)
       else
 
       {
+        vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::validate);
         vpPoseVector cMo_;
         for (unsigned int i = 0; i<6; i++)
           cMo_[i] = vpColVector::median( m_stack_cMo_detection.getCol(i));
@@ -323,8 +336,14 @@ bool vpMbLocalization::track(const vpImage<unsigned char> &I)
 
     try
     {
-      m_tracker->track(I);
-      m_tracker->getPose(m_cMo);
+      {
+        vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::track);
+        m_tracker->track(I);
+      }
+      {
+        vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::pose);
+        m_tracker->getPose(m_cMo);
+      }
       //printPose("cMo teabox: ", cMo_teabox);
       //if (!m_checkValiditycMo(m_cMo))
       // std::cout << "OK";
@@ -346,6 +365,9 @@ bool vpMbLocalization::track(const vpImage<unsigned char> &I)
     }
   } // End State Tracking
 
+  if (status_tracking)
+    m_timestamp = m_frame_timestamp;
+
   return status_tracking;
 }
 
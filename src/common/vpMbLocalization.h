@@ -52,6 +52,9 @@
 #include <visp/vpImage.h>
 #include <visp/vpIoTools.h>
 
+#include <vpOverlay.h>
+#include <vpStageProfiler.h>
+
 
 /*!
   This class allows to learn, detect and track an object. We use keypoints to detect and estimate the pose of a known object
@@ -97,6 +100,10 @@ protected:
   unsigned int m_num_iteration_detection;
   vpMatrix m_stack_cMo_detection;
   bool (*m_checkValiditycMo)(vpHomogeneousMatrix);
+  vpStageProfiler m_profiler;
+  double m_frame_timestamp; // Capture time of the image given to the next track()
+  double m_timestamp; // Capture time of the image of the last successful track()
+  vpOverlay m_overlay;
 
 
 public:
@@ -111,6 +118,9 @@ public:
   //vpMbKltTracker * getTracker() const {return m_tracker;}
   vpImagePoint get_cog() const {return m_cog;}
   bool getDetectionStatus() const {return m_status_single_detection;}
+  vpOverlay &getOverlay() {return m_overlay;}
+  vpStageProfiler &getProfiler() {return m_profiler;}
+  double getTimestamp() const {return m_timestamp;}
   void initDetection(const std::string & name_file_learning_data);
   bool isIdentity (const vpHomogeneousMatrix &A) const;
   void learnObject(vpImage<unsigned char> &I);
@@ -118,6 +128,7 @@ public:
   void setForceDetection() {m_state = detection; }
   void setCameraParameters(const vpCameraParameters &cam) { m_cam = cam; }
   void setManualDetection(){m_manual_detection = true;}
+  void setTimestamp(double timestamp) {m_frame_timestamp = timestamp;}
   void setOnlyDetection(const bool only_detection){m_only_detection = only_detection;}
   void setNumberDetectionIteration (unsigned int &num) { m_num_iteration_detection = num;}
   void setValiditycMoFunction (bool (*funct)(vpHomogeneousMatrix)) { m_checkValiditycMo = funct;}
@@ -0,0 +1,225 @@
+#include <string.h>
+
+#include <visp/vpDisplay.h>
+#include <visp/vpTemplateTrackerTriangle.h>
+
+#include <vpOverlay.h>
+
+
+/*!
+  Create an overlay.
+  \param mode : Drawing mode.
+  \param capacity : Number of commands allocated at construction. The buffer grows if a frame
+  needs more commands, and keeps its size afterwards.
+ */
+vpOverlay::vpOverlay(mode_t mode, unsigned int capacity)
+  : m_mode(mode), m_commands(capacity), m_nb_commands(0), m_corners()
+{
+  m_corners.reserve(3);
+}
+
+/*!
+  Copy an overlay, with a command buffer of the capacity of \e overlay.
+ */
+vpOverlay::vpOverlay(const vpOverlay &overlay)
+  : m_mode(overlay.m_mode), m_commands(overlay.m_commands), m_nb_commands(overlay.m_nb_commands), m_corners()
+{
+  m_corners.reserve(3);
+}
+
+/*!
+  Render the recorded commands in the image. The image is not flushed.
+ */
+void vpOverlay::display(const vpImage<unsigned char> &I) const
+{
+  for (unsigned int i=0; i < m_nb_commands; i++)
+    render(I, m_commands[i]);
+}
+
+/*!
+  Render the recorded commands in the image. The image is not flushed.
+ */
+void vpOverlay::display(const vpImage<vpRGBa> &I) const
+{
+  for (unsigned int i=0; i < m_nb_commands; i++)
+    render(I, m_commands[i]);
+}
+
+void vpOverlay::displayCross(const vpImage<unsigned char> &I, const vpImagePoint &ip, unsigned int size,
+                             const vpColor &color, unsigned int thickness)
+{
+  if (m_mode == immediate)
+    vpDisplay::displayCross(I, ip, size, color, thickness);
+  else if (m_mode == deferred) {
+    vpCommand &cmd = newCommand(cross);
+    cmd.ip1 = ip;
+    cmd.size = size;
+    cmd.color = color;
+    cmd.thickness = thickness;
+  }
+}
+
+void vpOverlay::displayFrame(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam,
+                             double size, const vpColor &color, unsigned int thickness)
+{
+  if (m_mode == immediate)
+    vpDisplay::displayFrame(I, cMo, cam, size, color, thickness);
+  else if (m_mode == deferred) {
+    vpCommand &cmd = newCommand(frame);
+    for (unsigned int i=0; i < 3; i++)
+      for (unsigned int j=0; j < 4; j++)
+        cmd.cMo[4*i+j] = cMo[i][j];
+    cmd.cam = cam;
+    cmd.frame_size = size;
+    cmd.color = color;
+    cmd.thickness = thickness;
+  }
+}
+
+void vpOverlay::displayLine(const vpImage<unsigned char> &I, const vpImagePoint &ip1, const vpImagePoint &ip2,
+                            const vpColor &color, unsigned int thickness)
+{
+  if (m_mode == immediate)
+    vpDisplay::displayLine(I, ip1, ip2, color, thickness);
+  else if (m_mode == deferred) {
+    vpCommand &cmd = newCommand(line);
+    cmd.ip1 = ip1;
+    cmd.ip2 = ip2;
+    cmd.color = color;
+    cmd.thickness = thickness;
+  }
+}
+
+/*!
+  Display the CAD model of a model-based tracker. In deferred mode only the tracker pointer is recorded,
+  so the tracker has to be alive when display() is called.
+ */
+void vpOverlay::displayModel(const vpImage<unsigned char> &I, vpMbTracker *tracker, const vpHomogeneousMatrix &cMo,
+                             const vpCameraParameters &cam, const vpColor &color, unsigned int thickness)
+{
+  if (m_mode == immediate)
+    tracker->display(I, cMo, cam, color, thickness);
+  else if (m_mode == deferred) {
+    vpCommand &cmd = newCommand(model);
+    cmd.tracker = tracker;
+    for (unsigned int i=0; i < 3; i++)
+      for (unsigned int j=0; j < 4; j++)
+        cmd.cMo[4*i+j] = cMo[i][j];
+    cmd.cam = cam;
+    cmd.color = color;
+    cmd.thickness = thickness;
+  }
+}
+
+void vpOverlay::displayRectangle(const vpImage<unsigned char> &I, const vpImagePoint &topLeft, const vpImagePoint &bottomRight,
+                                 const vpColor &color, bool fill, unsigned int thickness)
+{
+  if (m_mode == immediate)
+    vpDisplay::displayRectangle(I, topLeft, bottomRight, color, fill, thickness);
+  else if (m_mode == deferred) {
+    vpCommand &cmd = newCommand(rectangle);
+    cmd.ip1 = topLeft;
+    cmd.ip2 = bottomRight;
+    cmd.color = color;
+    cmd.fill = fill;
+    cmd.thickness = thickness;
+  }
+}
+
+/*!
+  Display a text. In deferred mode the text is truncated to 63 characters.
+ */
+void vpOverlay::displayText(const vpImage<unsigned char> &I, const vpImagePoint &ip, const std::string &s, const vpColor &color)
+{
+  if (m_mode == immediate)
+    vpDisplay::displayText(I, ip, s, color);
+  else if (m_mode == deferred) {
+    vpCommand &cmd = newCommand(text);
+    cmd.ip1 = ip;
+    cmd.color = color;
+    strncpy(cmd.text, s.c_str(), sizeof(cmd.text) - 1);
+    cmd.text[sizeof(cmd.text) - 1] = '\0';
+  }
+}
+
+/*!
+  Display the triangles of a template tracker zone, like vpTemplateTracker::display() does for the current zone.
+ */
+void vpOverlay::displayZone(const vpImage<unsigned char> &I, const vpTemplateTrackerZone &zone, const vpColor &color,
+                            unsigned int thickness)
+{
+  if (m_mode == headless)
+    return;
+
+  for (int i=0; i < zone.getNbTriangle(); i++) {
+    vpTemplateTrackerTriangle triangle;
+    zone.getTriangle(i, triangle);
+    triangle.getCorners(m_corners);
+    for (unsigned int j=0; j < m_corners.size(); j++)
+      displayLine(I, m_corners[j], m_corners[(j+1) % m_corners.size()], color, thickness);
+  }
+}
+
+/*!
+  Copy the commands of another overlay. The memory already allocated is reused, so that a display thread can
+  keep its own copy of the overlay of a tracker without allocating at each frame.
+ */
+vpOverlay &vpOverlay::operator=(const vpOverlay &overlay)
+{
+  if (this == &overlay)
+    return *this;
+
+  m_mode = overlay.m_mode;
+  if (m_commands.size() < overlay.m_nb_commands)
+    m_commands.resize(overlay.m_nb_commands);
+  for (unsigned int i=0; i < overlay.m_nb_commands; i++)
+    m_commands[i] = overlay.m_commands[i];
+  m_nb_commands = overlay.m_nb_commands;
+  return *this;
+}
+
+vpOverlay::vpCommand &vpOverlay::newCommand(primitive_t type)
+{
+  if (m_nb_commands == m_commands.size())
+    m_commands.resize(2*m_commands.size() + 1);
+
+  vpCommand &cmd = m_commands[m_nb_commands++];
+  cmd.type = type;
+  cmd.size = 0;
+  cmd.frame_size = 0;
+  cmd.thickness = 1;
+  cmd.fill = false;
+  cmd.text[0] = '\0';
+  cmd.tracker = NULL;
+  return cmd;
+}
+
+template<class Type> void vpOverlay::render(const vpImage<Type> &I, const vpCommand &cmd) const
+{
+  switch (cmd.type) {
+  case cross:
+    vpDisplay::displayCross(I, cmd.ip1, cmd.size, cmd.color, cmd.thickness);
+    break;
+  case text:
+    vpDisplay::displayText(I, cmd.ip1, cmd.text, cmd.color);
+    break;
+  case line:
+    vpDisplay::displayLine(I, cmd.ip1, cmd.ip2, cmd.color, cmd.thickness);
+    break;
+  case rectangle:
+    vpDisplay::displayRectangle(I, cmd.ip1, cmd.ip2, cmd.color, cmd.fill, cmd.thickness);
+    break;
+  case frame:
+  case model: {
+    vpHomogeneousMatrix cMo;
+    for (unsigned int i=0; i < 3; i++)
+      for (unsigned int j=0; j < 4; j++)
+        cMo[i][j] = cmd.cMo[4*i+j];
+    if (cmd.type == frame)
+      vpDisplay::displayFrame(I, cMo, cmd.cam, cmd.frame_size, cmd.color, cmd.thickness);
+    else
+      cmd.tracker->display(I, cMo, cmd.cam, cmd.color, cmd.thickness);
+    break;
+  }
+  }
+}
@@ -0,0 +1,117 @@
+#ifndef __vpOverlay_h__
+#define __vpOverlay_h__
+
+#include <string>
+#include <vector>
+
+#include <visp/vpCameraParameters.h>
+#include <visp/vpColor.h>
+#include <visp/vpHomogeneousMatrix.h>
+#include <visp/vpImage.h>
+#include <visp/vpImagePoint.h>
+#include <visp/vpMbTracker.h>
+#include <visp/vpTemplateTrackerZone.h>
+
+/*!
+  Drawing abstraction used by the trackers instead of calling vpDisplay in their hot path.
+
+  The drawing functions have the same signature than the vpDisplay ones. Depending on the mode:
+  - vpOverlay::immediate: primitives are drawn as soon as they are recorded (default, same behavior
+    than calling vpDisplay directly);
+  - vpOverlay::deferred: primitives are stored in a per-frame command buffer. The buffer is cleared at
+    the beginning of each track() and its memory is reused from one frame to the other. The caller
+    renders the buffer with display(), possibly from its display thread after copying the overlay;
+  - vpOverlay::headless: primitives are dropped. No X server is needed.
+
+  \code
+  vpBlobsTargetTracker blobs_tracker;
+  blobs_tracker.getOverlay().setMode(vpOverlay::deferred);
+  ...
+  blobs_tracker.track(cvI, I);
+  vpDisplay::display(I);
+  blobs_tracker.getOverlay().display(I);
+  vpDisplay::flush(I);
+  \endcode
+ */
+class vpOverlay
+{
+public:
+  typedef enum {
+    immediate,
+    deferred,
+    headless
+  } mode_t;
+
+  typedef enum {
+    cross,
+    text,
+    line,
+    rectangle,
+    frame,
+    model
+  } primitive_t;
+
+  /*!
+    A recorded drawing primitive. Poses are stored as plain arrays to keep the command
+    buffer free of heap allocations once it reached its working size.
+   */
+  struct vpCommand {
+    primitive_t type;
+    vpImagePoint ip1;
+    vpImagePoint ip2;
+    unsigned int size;
+    double frame_size;
+    unsigned int thickness;
+    bool fill;
+    vpColor color;
+    char text[64];
+    double cMo[12];
+    vpCameraParameters cam;
+    vpMbTracker *tracker;
+  };
+
+protected:
+  mode_t m_mode;
+  std::vector<vpCommand> m_commands;
+  unsigned int m_nb_commands;
+  std::vector<vpImagePoint> m_corners; // Scratch buffer used to parse a template tracker zone
+
+public:
+  vpOverlay(mode_t mode=vpOverlay::immediate, unsigned int capacity=64);
+  vpOverlay(const vpOverlay &overlay);
+  virtual ~vpOverlay() {}
+
+  void clear() {m_nb_commands = 0;}
+  void display(const vpImage<unsigned char> &I) const;
+  void display(const vpImage<vpRGBa> &I) const;
+
+  void displayCross(const vpImage<unsigned char> &I, const vpImagePoint &ip, unsigned int size,
+                    const vpColor &color, unsigned int thickness=1);
+  void displayFrame(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam,
+                    double size, const vpColor &color=vpColor::none, unsigned int thickness=1);
+  void displayLine(const vpImage<unsigned char> &I, const vpImagePoint &ip1, const vpImagePoint &ip2,
+                   const vpColor &color, unsigned int thickness=1);
+  void displayModel(const vpImage<unsigned char> &I, vpMbTracker *tracker, const vpHomogeneousMatrix &cMo,
+                    const vpCameraParameters &cam, const vpColor &color, unsigned int thickness=1);
+  void displayRectangle(const vpImage<unsigned char> &I, const vpImagePoint &topLeft, const vpImagePoint &bottomRight,
+                        const vpColor &color, bool fill=false, unsigned int thickness=1);
+  void displayText(const vpImage<unsigned char> &I, const vpImagePoint &ip, const std::string &s, const vpColor &color);
+  void displayZone(const vpImage<unsigned char> &I, const vpTemplateTrackerZone &zone, const vpColor &color,
+                   unsigned int thickness=3);
+
+  const vpCommand &getCommand(unsigned int i) const {return m_commands[i];}
+  mode_t getMode() const {return m_mode;}
+  unsigned int getNbCommands() const {return m_nb_commands;}
+
+  bool isHeadless() const {return m_mode == headless;}
+
+  vpOverlay &operator=(const vpOverlay &overlay);
+
+  void setMode(mode_t mode) {m_mode = mode; m_nb_commands = 0;}
+
+private:
+  vpCommand &newCommand(primitive_t type);
+  template<class Type> void render(const vpImage<Type> &I, const vpCommand &cmd) const;
+};
+
+#endif
@@ -0,0 +1,94 @@
+#include <unistd.h>
+
+#include <exception>
+#include <string>
+#include <vector>
+
+#include <visp/vpException.h>
+#include <visp3/core/vpMutex.h>
+#include <visp3/core/vpThread.h>
+
+#include <vpParallelFor.h>
+
+namespace {
+  struct vpLoop {
+    vpParallelFor::function_t function;
+    void *data;
+    unsigned int nb_items;
+    volatile unsigned int next;   // Next index to process, set to nb_items to stop after an error
+    vpMutex mutex;
+    std::string error;
+  };
+
+  void stop(vpLoop *loop, const std::string &message)
+  {
+    vpMutex::vpScopedLock lock(loop->mutex);
+    if (loop->error.empty())
+      loop->error = message.empty() ? "Unknown error" : message;
+    loop->next = loop->nb_items;
+    __sync_synchronize();
+  }
+
+  vpThread::Return worker(vpThread::Args args)
+  {
+    vpLoop *loop = (vpLoop *)args;
+    for (;;) {
+      unsigned int index = __sync_fetch_and_add(&loop->next, 1);
+      if (index >= loop->nb_items)
+        break;
+      try {
+        loop->function(index, loop->data);
+      }
+      catch (const vpException &e) {
+        stop(loop, e.getMessage());
+      }
+      catch (const std::exception &e) {
+        stop(loop, e.what());
+      }
+    }
+    return 0;
+  }
+}
+
+/*!
+  Number of online cores, 1 if unknown.
+ */
+unsigned int vpParallelFor::getNbCores()
+{
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? (unsigned int)n : 1;
+}
+
+/*!
+  Call \e function(index, data) for each index in [0, nb_items) from \e nb_threads threads, getNbCores() if 0,
+  and wait for all the calls to return. With a single thread the calls are made in order by the calling thread.
+ */
+void vpParallelFor::run(unsigned int nb_items, function_t function, void *data, unsigned int nb_threads)
+{
+  if (nb_threads == 0)
+    nb_threads = getNbCores();
+  if (nb_threads > nb_items)
+    nb_threads = nb_items;
+  if (nb_threads <= 1) {
+    for (unsigned int i=0; i < nb_items; i++)
+      function(i, data);
+    return;
+  }
+
+  vpLoop loop;
+  loop.function = function;
+  loop.data = data;
+  loop.nb_items = nb_items;
+  loop.next = 0;
+
+  std::vector<vpThread *> threads(nb_threads);
+  for (unsigned int i=0; i < nb_threads; i++)
+    threads[i] = new vpThread(worker, (vpThread::Args)&loop);
+  for (unsigned int i=0; i < nb_threads; i++) {
+    threads[i]->join();
+    delete threads[i];
+  }
+
+  if (! loop.error.empty())
+    throw vpException(vpException::fatalError, "%s", loop.error.c_str());
+}
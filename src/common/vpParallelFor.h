@@ -0,0 +1,41 @@
+#ifndef __vpParallelFor_h__
+#define __vpParallelFor_h__
+
+/*!
+  Run the iterations of an independent loop on all the cores, for the batch tools that process a set of
+  recordings or images.
+
+  The function is called once for each index in [0, nb_items) by a pool of vpThread. Each thread takes the
+  next index with an atomic increment, so that long and short items are balanced between the threads. The
+  function writes its result in a slot of its own, for example the element \e index of a vector allocated
+  before run(), so that no lock is needed.
+
+  If the function throws, the remaining items are not started and run() throws a vpException with the message
+  of the first error once all the threads are joined.
+
+  \code
+  struct vpData {
+    std::vector<std::string> filenames;
+    std::vector<double> snr;
+  };
+  void evaluate(unsigned int index, void *data)
+  {
+    vpData *d = (vpData *)data;
+    d->snr[index] = ...; // process d->filenames[index]
+  }
+  ...
+  data.snr.resize(data.filenames.size());
+  vpParallelFor::run(data.filenames.size(), evaluate, &data);
+  \endcode
+ */
+class vpParallelFor
+{
+public:
+  typedef void (*function_t)(unsigned int index, void *data);
+
+  static unsigned int getNbCores();
+
+  static void run(unsigned int nb_items, function_t function, void *data, unsigned int nb_threads=0);
+};
+
+#endif
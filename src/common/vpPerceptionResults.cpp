@@ -0,0 +1,239 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <visp/vpException.h>
+#include <visp/vpTime.h>
+
+#include <vpPerceptionResults.h>
+
+namespace {
+  const unsigned int s_header_size = 64;
+}
+
+vpPerceptionResults::vpPerceptionResults()
+  : m_name(), m_map(NULL), m_map_size(0), m_owner(false), m_nb_retries(0)
+{
+}
+
+vpPerceptionResults::~vpPerceptionResults()
+{
+  close();
+}
+
+/*!
+  Create the shared memory segment \e name (for example "/romeo_tk_perception") and map it for writing.
+  An existing segment with the same name, for example left by a daemon that crashed, is replaced.
+ */
+void vpPerceptionResults::create(const std::string &name)
+{
+  close();
+
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd < 0)
+    throw vpException(vpException::ioError, "Cannot create shared memory %s: %s", name.c_str(), strerror(errno));
+
+  m_map_size = s_header_size + nbTargets * getSlotStride();
+  if (ftruncate(fd, (off_t)m_map_size) != 0) {
+    ::close(fd);
+    shm_unlink(name.c_str());
+    throw vpException(vpException::ioError, "Cannot allocate shared memory %s: %s", name.c_str(), strerror(errno));
+  }
+  void *map = mmap(NULL, m_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    throw vpException(vpException::ioError, "Cannot map shared memory %s: %s", name.c_str(), strerror(errno));
+  }
+  m_map = (unsigned char *)map;
+  m_name = name;
+  m_owner = true;
+
+  // The segment is filled with zeros by ftruncate(): all the sequences are even, no result is published yet
+  vpHeader *header = getHeader();
+  header->version = version;
+  header->nb_slots = nbTargets;
+  header->slot_stride = getSlotStride();
+  header->pid = (int64_t)getpid();
+  heartbeat();
+  // The magic is written last, so that a client never accepts a partially initialized header
+  __sync_synchronize();
+  memcpy(header->magic, "RTKPRC", 6);
+}
+
+/*!
+  Map the shared memory segment \e name created by the publisher, for reading only.
+ */
+void vpPerceptionResults::open(const std::string &name)
+{
+  close();
+
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0)
+    throw vpException(vpException::ioError, "Cannot open shared memory %s: %s", name.c_str(), strerror(errno));
+
+  struct stat st;
+  size_t size = s_header_size + nbTargets * getSlotStride();
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < size) {
+    ::close(fd);
+    throw vpException(vpException::ioError, "Shared memory %s is not initialized", name.c_str());
+  }
+  void *map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED)
+    throw vpException(vpException::ioError, "Cannot map shared memory %s: %s", name.c_str(), strerror(errno));
+  m_map = (unsigned char *)map;
+  m_map_size = size;
+  m_name = name;
+  m_owner = false;
+
+  const vpHeader *header = getHeader();
+  if (memcmp(header->magic, "RTKPRC", 6) != 0 || header->version != version
+      || header->nb_slots != nbTargets || header->slot_stride != getSlotStride()) {
+    close();
+    throw vpException(vpException::ioError, "Shared memory %s is not a compatible perception segment", name.c_str());
+  }
+}
+
+/*!
+  Unmap the segment. The publisher also removes it, so that clients opening it later fail instead of
+  reading stale results. Clients that already mapped it keep a valid mapping.
+ */
+void vpPerceptionResults::close()
+{
+  if (m_map == NULL)
+    return;
+  munmap(m_map, m_map_size);
+  if (m_owner)
+    shm_unlink(m_name.c_str());
+  m_map = NULL;
+  m_map_size = 0;
+  m_owner = false;
+}
+
+int64_t vpPerceptionResults::getHeartbeat() const
+{
+  return getHeader()->heartbeat;
+}
+
+int64_t vpPerceptionResults::getPublisherPid() const
+{
+  return getHeader()->pid;
+}
+
+/*!
+  Publisher side: record that the publisher is alive, so that the clients can detect a daemon that stopped.
+  An aligned 64 bits store is atomic on the targets of the robot.
+ */
+void vpPerceptionResults::heartbeat()
+{
+  getHeader()->heartbeat = (int64_t)vpTime::measureTimeMicros();
+}
+
+//! Slots are aligned on 64 bytes, so that two slots never share a cache line.
+unsigned int vpPerceptionResults::getSlotStride()
+{
+  return (unsigned int)((sizeof(vpSlot) + 63) & ~(size_t)63);
+}
+
+vpPerceptionResults::vpSlot *vpPerceptionResults::getSlot(target_t target) const
+{
+  return (vpSlot *)(m_map + s_header_size + target * getSlotStride());
+}
+
+/*!
+  Publisher side: write the latest result of a target. Never blocks.
+ */
+void vpPerceptionResults::publish(target_t target, const vpResult &result)
+{
+  vpSlot *slot = getSlot(target);
+  slot->sequence ++;          // Odd: being written
+  __sync_synchronize();
+  memcpy((void *)&slot->result, &result, sizeof(vpResult));
+  __sync_synchronize();
+  slot->sequence ++;          // Even: consistent
+}
+
+/*!
+  Client side: copy the latest result of a target.
+  \param sequence : Number of results published for this target so far, that allows to know if the
+  result is a new one.
+  \return false if no result was published yet for this target, or if the publisher kept writing it.
+ */
+bool vpPerceptionResults::read(target_t target, vpResult &result, unsigned long &sequence)
+{
+  const vpSlot *slot = getSlot(target);
+  for (unsigned int i=0; i < 1000; i++) {
+    uint32_t before = slot->sequence;
+    if ((before & 1) == 0) {
+      __sync_synchronize();
+      memcpy(&result, (const void *)&slot->result, sizeof(vpResult));
+      __sync_synchronize();
+      if (slot->sequence == before) {
+        sequence = before / 2;
+        return (sequence > 0);
+      }
+    }
+    m_nb_retries ++;
+    // The publisher may have been preempted in the middle of the write: let it finish
+    if (i >= 16)
+      sched_yield();
+  }
+  return false;
+}
+
+const char *vpPerceptionResults::getTargetName(target_t target)
+{
+  switch (target) {
+  case face: return "face";
+  case qrcode: return "qrcode";
+  case blobs: return "blobs";
+  case box: return "box";
+  default: return "unknown";
+  }
+}
+
+vpRect vpPerceptionResults::getBBox(const vpResult &result)
+{
+  return vpRect(result.bbox[1], result.bbox[0], result.bbox[2], result.bbox[3]);
+}
+
+vpHomogeneousMatrix vpPerceptionResults::get_cMo(const vpResult &result)
+{
+  vpHomogeneousMatrix cMo;
+  for (unsigned int i=0; i < 3; i++)
+    for (unsigned int j=0; j < 4; j++)
+      cMo[i][j] = result.cMo[4*i + j];
+  return cMo;
+}
+
+vpImagePoint vpPerceptionResults::getCog(const vpResult &result)
+{
+  return vpImagePoint(result.cog[0], result.cog[1]);
+}
+
+void vpPerceptionResults::setBBox(vpResult &result, const vpRect &bbox)
+{
+  result.bbox[0] = bbox.getTop();
+  result.bbox[1] = bbox.getLeft();
+  result.bbox[2] = bbox.getWidth();
+  result.bbox[3] = bbox.getHeight();
+}
+
+void vpPerceptionResults::set_cMo(vpResult &result, const vpHomogeneousMatrix &cMo)
+{
+  for (unsigned int i=0; i < 3; i++)
+    for (unsigned int j=0; j < 4; j++)
+      result.cMo[4*i + j] = cMo[i][j];
+}
+
+void vpPerceptionResults::setCog(vpResult &result, const vpImagePoint &cog)
+{
+  result.cog[0] = cog.get_i();
+  result.cog[1] = cog.get_j();
+}
@@ -0,0 +1,127 @@
+#ifndef __vpPerceptionResults_h__
+#define __vpPerceptionResults_h__
+
+#include <stdint.h>
+
+#include <string>
+
+#include <visp/vpHomogeneousMatrix.h>
+#include <visp/vpImagePoint.h>
+#include <visp/vpRect.h>
+
+/*!
+  Latest results of the trackers, published by the perception_daemon process in a POSIX shared memory
+  segment that any number of client processes can read.
+
+  The segment holds one slot per target. Each slot is protected by a sequence lock: the publisher makes the
+  sequence odd, writes the result and makes it even again, and a reader retries when the sequence was odd or
+  changed while it copied the result. The publisher never waits for the readers and readers never block each
+  other, so that a slow or crashed client cannot stall the daemon.
+
+  The segment starts with a header of 64 bytes: "RTKPRC" followed by two null characters, the format version,
+  the number of slots and the stride of the slots (uint32), the heartbeat of the publisher in microseconds
+  and its process id (int64). The slots follow, each one aligned on 64 bytes.
+
+  \code
+  // Client
+  vpPerceptionResults results;
+  results.open("/romeo_tk_perception");
+  vpPerceptionResults::vpResult face;
+  unsigned long sequence = 0, sequence_prev = 0;
+  while (...) {
+    if (results.read(vpPerceptionResults::face, face, sequence) && sequence != sequence_prev && face.found) {
+      sequence_prev = sequence;
+      servo_head.setCurrentFeature(vpPerceptionResults::getCog(face));
+    }
+  }
+  \endcode
+ */
+class vpPerceptionResults
+{
+public:
+  static const unsigned int version = 1;
+
+  typedef enum {
+    face,
+    qrcode,
+    blobs,
+    box,
+    nbTargets
+  } target_t;
+
+  //! Result of a tracker for one frame.
+  struct vpResult {
+    uint64_t frame;       //!< Index of the frame in the stream of the publisher
+    double timestamp;     //!< Capture time of the frame in seconds
+    int32_t found;        //!< 1 if the target was found in the frame
+    int32_t reserved;
+    double cMo[12];       //!< First three rows of the pose, when the tracker estimates one
+    double bbox[4];       //!< Bounding box in pixels: top, left, width, height
+    double cog[2];        //!< Center of gravity in pixels: i, j
+  };
+
+  static const char *getTargetName(target_t target);
+
+  static vpRect getBBox(const vpResult &result);
+  static vpHomogeneousMatrix get_cMo(const vpResult &result);
+  static vpImagePoint getCog(const vpResult &result);
+  static void setBBox(vpResult &result, const vpRect &bbox);
+  static void set_cMo(vpResult &result, const vpHomogeneousMatrix &cMo);
+  static void setCog(vpResult &result, const vpImagePoint &cog);
+
+protected:
+  struct vpHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t nb_slots;
+    uint32_t slot_stride;
+    uint32_t reserved;
+    volatile int64_t heartbeat;
+    int64_t pid;
+  };
+
+  struct vpSlot {
+    volatile uint32_t sequence;
+    uint32_t reserved;
+    vpResult result;
+  };
+
+  std::string m_name;
+  unsigned char *m_map;
+  size_t m_map_size;
+  bool m_owner;             // true for the publisher, that removes the segment on close()
+  unsigned long m_nb_retries;
+
+public:
+  vpPerceptionResults();
+  virtual ~vpPerceptionResults();
+
+  void close();
+  void create(const std::string &name);
+
+  //! Time of the last heartbeat() of the publisher, in microseconds since the Epoch.
+  int64_t getHeartbeat() const;
+  //! Number of times a reader had to copy a result again because it was being written.
+  unsigned long getNbRetries() const {return m_nb_retries;}
+  int64_t getPublisherPid() const;
+
+  void heartbeat();
+
+  bool isOpened() const {return m_map != NULL;}
+
+  void open(const std::string &name);
+
+  void publish(target_t target, const vpResult &result);
+  bool read(target_t target, vpResult &result, unsigned long &sequence);
+
+protected:
+  vpHeader *getHeader() const {return (vpHeader *)m_map;}
+  vpSlot *getSlot(target_t target) const;
+  static unsigned int getSlotStride();
+
+private:
+  vpPerceptionResults(const vpPerceptionResults &);
+  vpPerceptionResults &operator=(const vpPerceptionResults &);
+};
+
+#endif
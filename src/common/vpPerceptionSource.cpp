@@ -0,0 +1,64 @@
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <visp/vpTime.h>
+
+#include <vpPerceptionSource.h>
+
+/*!
+  Open the camera \e camera of the robot \e ip, or the recorded \e sequence if it is not empty.
+ */
+vpPerceptionSource::vpPerceptionSource(const std::string &ip, int camera, const std::string &sequence)
+  : m_robot_grabber(), m_replay_grabber(), m_replay(! sequence.empty())
+{
+  if (m_replay) {
+    m_replay_grabber.open(sequence);
+    m_replay_grabber.setLoop(true);
+    m_replay_grabber.setRealTime(true);
+  }
+  else {
+    m_robot_grabber.setRobotIp(ip);
+    m_robot_grabber.setCamera(camera);
+    m_robot_grabber.open();
+  }
+}
+
+/*!
+  Acquire the next frame in \e cvI, BGR when hasColor().
+  \return false at the end of a sequence that cannot be read again.
+ */
+bool vpPerceptionSource::acquire(cv::Mat &cvI, double &timestamp)
+{
+  if (m_replay) {
+    if (! m_replay_grabber.acquire(cvI))
+      return false;
+    timestamp = vpTime::measureTimeSecond();
+  }
+  else {
+    timestamp = vpTime::measureTimeSecond();
+    m_robot_grabber.acquire(cvI);
+  }
+  return true;
+}
+
+/*!
+  Acquire the next frame in \e cvI (BGR when hasColor()) and its gray level version in \e I, that has to be
+  allocated with the size of the images.
+ */
+bool vpPerceptionSource::acquire(cv::Mat &cvI, vpImage<unsigned char> &I, double &timestamp)
+{
+  if (! acquire(cvI, timestamp))
+    return false;
+  cv::Mat gray((int)I.getHeight(), (int)I.getWidth(), CV_8UC1, I.bitmap);
+  if (cvI.channels() == 3)
+    cv::cvtColor(cvI, gray, CV_BGR2GRAY);
+  else
+    cvI.copyTo(gray);
+  return true;
+}
+
+vpCameraParameters vpPerceptionSource::getCameraParameters(vpCameraParameters::vpCameraParametersProjType projection)
+{
+  if (m_replay)
+    return m_replay_grabber.getCameraParameters(projection);
+  return m_robot_grabber.getCameraParameters(projection);
+}
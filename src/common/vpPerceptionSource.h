@@ -0,0 +1,58 @@
+#ifndef __vpPerceptionSource_h__
+#define __vpPerceptionSource_h__
+
+#include <string>
+
+#include <opencv2/core/core.hpp>
+
+#include <visp/vpCameraParameters.h>
+#include <visp/vpImage.h>
+
+#include <visp_naoqi/vpNaoqiGrabber.h>
+
+#include <vpReplayGrabber.h>
+
+/*!
+  Camera of the robot, or a sequence recorded with record_sequence replayed in loop at its recorded speed when
+  no robot is available. This is the image source of the perception services, like perception_daemon and
+  frame_bus_producer.
+
+  The replayed frames are stamped with the replay time, so that the clients can compare the timestamps with
+  their own clock as with the robot.
+
+  \code
+  vpPerceptionSource source(ip, camera, sequence); // The robot if sequence is empty
+  vpImage<unsigned char> I(source.getHeight(), source.getWidth());
+  cv::Mat cvI;
+  double timestamp;
+  while (source.acquire(cvI, I, timestamp))
+    qrcode_tracker.track(I);
+  \endcode
+ */
+class vpPerceptionSource
+{
+protected:
+  vpNaoqiGrabber m_robot_grabber;
+  vpReplayGrabber m_replay_grabber;
+  bool m_replay;
+
+public:
+  vpPerceptionSource(const std::string &ip, int camera, const std::string &sequence);
+  virtual ~vpPerceptionSource() {}
+
+  bool acquire(cv::Mat &cvI, double &timestamp);
+  bool acquire(cv::Mat &cvI, vpImage<unsigned char> &I, double &timestamp);
+
+  vpCameraParameters getCameraParameters(vpCameraParameters::vpCameraParametersProjType projection
+                                         = vpCameraParameters::perspectiveProjWithoutDistortion);
+  //! Number of channels of the images given by acquire(), 3 for BGR images.
+  unsigned int getChannels() {return m_replay ? m_replay_grabber.getChannels() : 3;}
+  unsigned int getHeight() {return m_replay ? m_replay_grabber.getHeight() : m_robot_grabber.getHeight();}
+  unsigned int getWidth() {return m_replay ? m_replay_grabber.getWidth() : m_robot_grabber.getWidth();}
+  //! True if acquire() provides color images, that the blob tracker needs.
+  bool hasColor() {return getChannels() == 3;}
+  //! True if the images come from a recorded sequence.
+  bool isReplay() const {return m_replay;}
+};
+
+#endif
@@ -0,0 +1,37 @@
+#include <vpPerceptionStages.h>
+
+
+/*!
+  Create the stage.
+  \param scheduler : Arm scheduler, started by the caller.
+  \param cdMo : Desired pose of the target in the camera frame.
+  \param name : Name of the stage.
+ */
+vpServoArmStage::vpServoArmStage(vpServoArmScheduler &scheduler, const vpHomogeneousMatrix &cdMo, const std::string &name)
+  : vpPipelineInPlaceFilter<vpPerceptionFrame>(name), m_scheduler(scheduler), m_oMcd(cdMo.inverse())
+{
+}
+
+bool vpServoArmStage::process(vpPerceptionFrame &frame)
+{
+  if (frame.found)
+    m_scheduler.publishPose(m_oMcd * frame.cMo, frame.timestamp);
+  return true;
+}
+
+/*!
+  Create the stage.
+  \param scheduler : Head scheduler, started by the caller.
+  \param name : Name of the stage.
+ */
+vpServoHeadStage::vpServoHeadStage(vpServoHeadScheduler &scheduler, const std::string &name)
+  : vpPipelineInPlaceFilter<vpPerceptionFrame>(name), m_scheduler(scheduler)
+{
+}
+
+bool vpServoHeadStage::process(vpPerceptionFrame &frame)
+{
+  if (frame.found)
+    m_scheduler.publishPoint(frame.cog, frame.timestamp);
+  return true;
+}
@@ -0,0 +1,156 @@
+#ifndef __vpPerceptionStages_h__
+#define __vpPerceptionStages_h__
+
+#include <string>
+
+#include <visp/vpHomogeneousMatrix.h>
+#include <visp/vpImage.h>
+#include <visp/vpImagePoint.h>
+#include <visp/vpTime.h>
+
+#include <vpFaceTracker.h>
+#include <vpMbLocalization.h>
+#include <vpPipelineStage.h>
+#include <vpReplayGrabber.h>
+#include <vpServoArmScheduler.h>
+#include <vpServoHeadScheduler.h>
+
+/*!
+  Item exchanged between the perception stages: an image, its capture time and the result of the tracker.
+ */
+struct vpPerceptionFrame
+{
+  unsigned long index;        //!< Index of the frame since the capture stage was created
+  double timestamp;           //!< Capture time in s
+  vpImage<unsigned char> I;
+  bool found;                 //!< True if the tracker found the target in I
+  vpHomogeneousMatrix cMo;    //!< Pose of the target, when the tracker estimates it
+  vpImagePoint cog;           //!< Center of gravity of the target in the image
+
+  vpPerceptionFrame() : index(0), timestamp(0), I(), found(false), cMo(), cog() {}
+};
+
+/*!
+  Capture stage acquiring the images of a grabber: vpNaoqiGrabber, vpReplayGrabber or any grabber
+  with an acquire(vpImage<unsigned char> &) function. It should run in its own thread since
+  the acquisition waits for the next image.
+ */
+template <class Grabber> class vpCaptureStage : public vpPipelineSource<vpPerceptionFrame>
+{
+protected:
+  Grabber &m_grabber;
+  unsigned long m_index;
+
+public:
+  vpCaptureStage(Grabber &grabber, const std::string &name="capture")
+    : vpPipelineSource<vpPerceptionFrame>(name), m_grabber(grabber), m_index(0) {}
+
+protected:
+  bool process(vpPerceptionFrame &frame)
+  {
+    frame.timestamp = vpTime::measureTimeSecond();
+    m_grabber.acquire(frame.I);
+    frame.index = ++m_index;
+    frame.found = false;
+    return true;
+  }
+};
+
+//! The capture time of a replayed image is the recorded one.
+template <> inline bool vpCaptureStage<vpReplayGrabber>::process(vpPerceptionFrame &frame)
+{
+  if (! m_grabber.acquire(frame.I))
+    return false;
+  frame.timestamp = m_grabber.getTimestamp();
+  frame.index = ++m_index;
+  frame.found = false;
+  return true;
+}
+
+/*!
+  Tracking stage running the detection, tracking and pose estimation of a tracker of romeo_tk
+  (vpQRCodeTracker, vpTemplateLocatization, vpMbLocalization, vpFaceTracker...) on each frame.
+  The result is stored in the frame, that is always forwarded without copy, with found set to false when
+  the target is lost.
+ */
+template <class Tracker> class vpTrackerStage : public vpPipelineInPlaceFilter<vpPerceptionFrame>
+{
+protected:
+  Tracker &m_tracker;
+
+public:
+  vpTrackerStage(Tracker &tracker, const std::string &name="tracking")
+    : vpPipelineInPlaceFilter<vpPerceptionFrame>(name), m_tracker(tracker) {}
+
+protected:
+  bool process(vpPerceptionFrame &frame)
+  {
+    m_tracker.setTimestamp(frame.timestamp);
+    frame.found = track(frame.I, frame);
+    return true;
+  }
+
+  bool track(const vpImage<unsigned char> &I, vpPerceptionFrame &out)
+  {
+    if (! m_tracker.track(I))
+      return false;
+    out.cMo = m_tracker.get_cMo();
+    out.cog = m_tracker.getCog();
+    return true;
+  }
+};
+
+//! The face tracker only provides the bounding box of the face.
+template <> inline bool vpTrackerStage<vpFaceTracker>::track(const vpImage<unsigned char> &I, vpPerceptionFrame &out)
+{
+  if (! m_tracker.track(I))
+    return false;
+  out.cog = m_tracker.getFace().getCenter();
+  return true;
+}
+
+template <> inline bool vpTrackerStage<vpMbLocalization>::track(const vpImage<unsigned char> &I, vpPerceptionFrame &out)
+{
+  if (! m_tracker.track(I))
+    return false;
+  out.cMo = m_tracker.get_cMo();
+  out.cog = m_tracker.get_cog();
+  return true;
+}
+
+/*!
+  Control stage publishing the pose of the tracked target to a vpServoArmScheduler, that runs the
+  arm control law at its own rate. Frames are forwarded unchanged when an output queue is connected.
+ */
+class vpServoArmStage : public vpPipelineInPlaceFilter<vpPerceptionFrame>
+{
+protected:
+  vpServoArmScheduler &m_scheduler;
+  vpHomogeneousMatrix m_oMcd;     // Inverse of the desired pose of the target
+
+public:
+  vpServoArmStage(vpServoArmScheduler &scheduler, const vpHomogeneousMatrix &cdMo, const std::string &name="control");
+
+  void setDesiredPose(const vpHomogeneousMatrix &cdMo) {m_oMcd = cdMo.inverse();}
+
+protected:
+  bool process(vpPerceptionFrame &frame);
+};
+
+/*!
+  Control stage publishing the center of gravity of the tracked target to a vpServoHeadScheduler.
+  Frames are forwarded unchanged when an output queue is connected.
+ */
+class vpServoHeadStage : public vpPipelineInPlaceFilter<vpPerceptionFrame>
+{
+protected:
+  vpServoHeadScheduler &m_scheduler;
+
+public:
+  vpServoHeadStage(vpServoHeadScheduler &scheduler, const std::string &name="control");
+
+protected:
+  bool process(vpPerceptionFrame &frame);
+};
+
+#endif
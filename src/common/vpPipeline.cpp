@@ -0,0 +1,164 @@
+#include <exception>
+#include <iomanip>
+
+#include <visp/vpException.h>
+#include <visp/vpTime.h>
+
+#include <vpPipeline.h>
+
+
+vpPipeline::vpPipeline()
+  : m_stages(), m_execution(), m_workers(), m_threads(), m_pool_size(1), m_idle_time(1.), m_mutex(),
+    m_stop_requested(false)
+{
+}
+
+vpPipeline::~vpPipeline()
+{
+  stop();
+}
+
+/*!
+  Add a stage. Stages cannot be added while the pipeline is running.
+  \param stage : Stage, that has to be alive as long as the pipeline.
+  \param execution : vpPipeline::ownThread to run the stage in its own thread, vpPipeline::workerPool to
+  share the worker threads with the other stages of the pool.
+ */
+void vpPipeline::addStage(vpPipelineStage &stage, execution_t execution)
+{
+  if (! m_threads.empty())
+    throw vpException(vpException::fatalError, "Cannot add stage %s to a running pipeline", stage.getName().c_str());
+
+  m_stages.push_back(&stage);
+  m_execution.push_back(execution);
+}
+
+/*!
+  Return true if the threads are started and no stage stopped the pipeline after an exception.
+ */
+bool vpPipeline::isRunning()
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  return ! m_threads.empty() && ! m_stop_requested;
+}
+
+/*!
+  Print for each stage the number of processed items and the processing time percentiles in ms.
+  Should be called once the pipeline is stopped.
+ */
+void vpPipeline::printSummary(std::ostream &os)
+{
+  os << "Pipeline summary (ms)" << std::endl;
+  os << std::setw(16) << "stage" << std::setw(10) << "count" << std::setw(10) << "mean"
+     << std::setw(10) << "p50" << std::setw(10) << "p95" << std::setw(10) << "p99"
+     << std::setw(10) << "max" << std::endl;
+  for (size_t i=0; i < m_stages.size(); i++) {
+    vpStageProfiler &profiler = m_stages[i]->getProfiler();
+    os << std::setw(16) << m_stages[i]->getName() << std::setw(10) << m_stages[i]->getNbProcessed()
+       << std::fixed << std::setprecision(3)
+       << std::setw(10) << profiler.getMean(vpStageProfiler::process)
+       << std::setw(10) << profiler.getPercentile(vpStageProfiler::process, 50)
+       << std::setw(10) << profiler.getPercentile(vpStageProfiler::process, 95)
+       << std::setw(10) << profiler.getPercentile(vpStageProfiler::process, 99)
+       << std::setw(10) << profiler.getPercentile(vpStageProfiler::process, 100) << std::endl;
+  }
+}
+
+/*!
+  Start one thread per stage added with vpPipeline::ownThread, and the worker pool if some stages
+  were added with vpPipeline::workerPool. Does nothing if the pipeline is already running.
+ */
+void vpPipeline::start()
+{
+  if (! m_threads.empty())
+    return;
+
+  {
+    vpMutex::vpScopedLock lock(m_mutex);
+    m_stop_requested = false;
+  }
+
+  std::vector<vpPipelineStage *> pool;
+  for (size_t i=0; i < m_stages.size(); i++) {
+    m_stages[i]->getProfiler().reset();
+    if (m_execution[i] == workerPool)
+      pool.push_back(m_stages[i]);
+    else {
+      vpWorker *worker = new vpWorker;
+      worker->pipeline = this;
+      worker->stages.push_back(m_stages[i]);
+      m_workers.push_back(worker);
+    }
+  }
+  if (! pool.empty()) {
+    for (unsigned int i=0; i < m_pool_size; i++) {
+      vpWorker *worker = new vpWorker;
+      worker->pipeline = this;
+      worker->stages = pool;
+      m_workers.push_back(worker);
+    }
+  }
+
+  for (size_t i=0; i < m_workers.size(); i++)
+    m_threads.push_back(new vpThread(workerLoop, (vpThread::Args)m_workers[i]));
+}
+
+/*!
+  Stop and join all the threads. The items remaining in the queues are kept.
+ */
+void vpPipeline::stop()
+{
+  if (m_threads.empty())
+    return;
+
+  {
+    vpMutex::vpScopedLock lock(m_mutex);
+    m_stop_requested = true;
+  }
+  for (size_t i=0; i < m_threads.size(); i++) {
+    m_threads[i]->join();
+    delete m_threads[i];
+    delete m_workers[i];
+  }
+  m_threads.clear();
+  m_workers.clear();
+}
+
+vpThread::Return vpPipeline::workerLoop(vpThread::Args args)
+{
+  vpWorker *worker = (vpWorker *)args;
+  worker->pipeline->run(worker->stages);
+  return 0;
+}
+
+void vpPipeline::run(const std::vector<vpPipelineStage *> &stages)
+{
+  while (1) {
+    {
+      vpMutex::vpScopedLock lock(m_mutex);
+      if (m_stop_requested)
+        break;
+    }
+
+    bool done = false;
+    try {
+      for (size_t i=0; i < stages.size(); i++)
+        done |= stages[i]->tryStep();
+    }
+    catch (const vpException &e) {
+      std::cout << "Pipeline stopped by an exception: " << e.getMessage() << std::endl;
+      vpMutex::vpScopedLock lock(m_mutex);
+      m_stop_requested = true;
+      break;
+    }
+    catch (const std::exception &e) {
+      std::cout << "Pipeline stopped by an exception: " << e.what() << std::endl;
+      vpMutex::vpScopedLock lock(m_mutex);
+      m_stop_requested = true;
+      break;
+    }
+
+    if (! done)
+      vpTime::wait(m_idle_time);
+  }
+}
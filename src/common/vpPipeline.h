@@ -0,0 +1,89 @@
+#ifndef __vpPipeline_h__
+#define __vpPipeline_h__
+
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpMutex.h>
+#include <visp3/core/vpThread.h>
+
+#include <vpPipelineStage.h>
+
+/*!
+  Run the stages of a perception pipeline (capture, tracking, control, display...) concurrently.
+
+  Stages are connected by vpPipelineQueue objects and added to the pipeline either with their own thread
+  (vpPipeline::ownThread), or in a pool of worker threads shared by all the stages added with
+  vpPipeline::workerPool. A thread that finds nothing to process in its stages sleeps during the idle time
+  (1 ms by default). Stages that block, like a capture stage waiting for the next image, should have their own thread.
+
+  \code
+  vpPipelineQueue<vpPerceptionFrame> frames(1), poses(1);
+  vpCaptureStage<vpNaoqiGrabber> capture(g);
+  vpTrackerStage<vpQRCodeTracker> tracking(qrcode_tracker);
+  vpServoArmStage control(scheduler, cdMo);
+  capture.setOutput(frames);
+  tracking.setInput(frames);
+  tracking.setOutput(poses);
+  control.setInput(poses);
+
+  vpPipeline pipeline;
+  pipeline.addStage(capture);
+  pipeline.addStage(tracking);
+  pipeline.addStage(control, vpPipeline::workerPool);
+  pipeline.start();
+  ...
+  pipeline.stop();
+  pipeline.printSummary(std::cout);
+  \endcode
+ */
+class vpPipeline
+{
+public:
+  typedef enum {
+    ownThread,
+    workerPool
+  } execution_t;
+
+protected:
+  struct vpWorker {
+    vpPipeline *pipeline;
+    std::vector<vpPipelineStage *> stages;
+  };
+
+  std::vector<vpPipelineStage *> m_stages;
+  std::vector<execution_t> m_execution;
+  std::vector<vpWorker *> m_workers;
+  std::vector<vpThread *> m_threads;
+  unsigned int m_pool_size;
+  double m_idle_time;       // Sleep duration in ms of a thread that has nothing to process
+  vpMutex m_mutex;
+  bool m_stop_requested;
+
+public:
+  vpPipeline();
+  virtual ~vpPipeline();
+
+  void addStage(vpPipelineStage &stage, execution_t execution=vpPipeline::ownThread);
+
+  unsigned int getNbStages() const {return (unsigned int)m_stages.size();}
+  vpPipelineStage &getStage(unsigned int i) {return *m_stages[i];}
+
+  bool isRunning();
+
+  void printSummary(std::ostream &os);
+
+  void setIdleTime(double idle_time) {m_idle_time = idle_time;}
+  void setPoolSize(unsigned int pool_size) {m_pool_size = pool_size > 0 ? pool_size : 1;}
+
+  void start();
+  void stop();
+
+protected:
+  void run(const std::vector<vpPipelineStage *> &stages);
+
+private:
+  static vpThread::Return workerLoop(vpThread::Args args);
+};
+
+#endif
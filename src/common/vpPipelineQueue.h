@@ -0,0 +1,196 @@
+#ifndef __vpPipelineQueue_h__
+#define __vpPipelineQueue_h__
+
+#include <vector>
+
+#include <visp3/core/vpMutex.h>
+
+/*!
+  Bounded queue connecting a producer stage to a consumer stage of a vpPipeline.
+
+  The queue owns capacity + 2 preallocated items: the queued ones, the one being written by the producer
+  and the one being read by the consumer. Items are filled and read in place, only their indexes are
+  exchanged under the mutex, so that no item is copied nor allocated once the queue reached its working size.
+  A stage that reads an item and passes it on to the next queue, like a vpPipelineInPlaceFilter, uses forward()
+  that exchanges the items of both queues instead of copying them.
+  When the queue is full the oldest queued item is dropped, so that a slow consumer always gets recent data.
+
+  \code
+  // Producer
+  vpPerceptionFrame &frame = queue.beginPush();
+  g.acquire(frame.I);
+  queue.endPush();
+
+  // Consumer
+  if (queue.beginPop()) {
+    tracker.track(queue.front().I);
+    queue.endPop();
+  }
+  \endcode
+ */
+template <class T> class vpPipelineQueue
+{
+public:
+  static const unsigned int none = (unsigned int)-1;
+
+protected:
+  unsigned int m_capacity;
+  std::vector<T *> m_items;           // m_capacity + 2 items, that forward() exchanges with the ones of other queues
+  std::vector<unsigned int> m_queue;  // Ring of the indexes of the queued items, oldest first
+  std::vector<unsigned int> m_free;   // Stack of the indexes of the free items
+  unsigned int m_head;
+  unsigned int m_size;
+  unsigned int m_nb_free;
+  unsigned int m_write;               // Item being written by the producer, or none
+  unsigned int m_read;                // Item being read by the consumer, or none
+  unsigned long m_nb_pushed;
+  unsigned long m_nb_dropped;
+  vpMutex m_mutex;
+
+public:
+  /*!
+    Create a queue.
+    \param capacity : Maximum number of queued items. With 1, the consumer always gets the latest item.
+   */
+  vpPipelineQueue(unsigned int capacity=1)
+    : m_capacity(capacity > 0 ? capacity : 1), m_items(m_capacity + 2), m_queue(m_capacity), m_free(m_capacity + 2),
+      m_head(0), m_size(0), m_nb_free(m_capacity + 2), m_write(none), m_read(none), m_nb_pushed(0), m_nb_dropped(0),
+      m_mutex()
+  {
+    for (unsigned int i=0; i < m_nb_free; i++) {
+      m_items[i] = new T;
+      m_free[i] = i;
+    }
+  }
+  virtual ~vpPipelineQueue()
+  {
+    for (unsigned int i=0; i < m_items.size(); i++)
+      delete m_items[i];
+  }
+
+  /*!
+    Producer side: return the item to fill. It is queued by endPush() or released by cancelPush().
+   */
+  T &beginPush()
+  {
+    vpMutex::vpScopedLock lock(m_mutex);
+    if (m_write == none)
+      m_write = m_free[--m_nb_free];
+    return *m_items[m_write];
+  }
+
+  //! Producer side: release the item obtained with beginPush() without queuing it.
+  void cancelPush()
+  {
+    vpMutex::vpScopedLock lock(m_mutex);
+    if (m_write == none)
+      return;
+    m_free[m_nb_free++] = m_write;
+    m_write = none;
+  }
+
+  //! Producer side: queue the item obtained with beginPush(), dropping the oldest queued item if the queue is full.
+  void endPush()
+  {
+    vpMutex::vpScopedLock lock(m_mutex);
+    if (m_write == none)
+      return;
+    if (m_size == m_capacity) {
+      m_free[m_nb_free++] = m_queue[m_head];
+      m_head = (m_head + 1) % m_capacity;
+      m_size --;
+      m_nb_dropped ++;
+    }
+    m_queue[(m_head + m_size) % m_capacity] = m_write;
+    m_size ++;
+    m_write = none;
+    m_nb_pushed ++;
+  }
+
+  /*!
+    Consumer side: take the oldest queued item, available with front() until endPop().
+    \return false if the queue is empty.
+   */
+  bool beginPop()
+  {
+    vpMutex::vpScopedLock lock(m_mutex);
+    if (m_read != none)
+      return true;
+    if (m_size == 0)
+      return false;
+    m_read = m_queue[m_head];
+    m_head = (m_head + 1) % m_capacity;
+    m_size --;
+    return true;
+  }
+
+  //! Consumer side: item obtained with beginPop().
+  T &front() {return *m_items[m_read];}
+
+  //! Consumer side: release the item obtained with beginPop().
+  void endPop()
+  {
+    vpMutex::vpScopedLock lock(m_mutex);
+    if (m_read == none)
+      return;
+    m_free[m_nb_free++] = m_read;
+    m_read = none;
+  }
+
+  /*!
+    Consumer side: push the item obtained with beginPop() in \e output without copying it, and release it.
+    The item is exchanged with the one \e output gives to its producer: should be called by the stage that is
+    both the consumer of this queue and the producer of \e output.
+   */
+  void forward(vpPipelineQueue<T> &output)
+  {
+    if (m_read == none)
+      return;
+    output.beginPush();
+    // Both items are owned by the calling thread, that is the consumer of this queue and the producer
+    // of the output queue: no other thread accesses them until endPush() and endPop()
+    T *item = m_items[m_read];
+    m_items[m_read] = output.m_items[output.m_write];
+    output.m_items[output.m_write] = item;
+    output.endPush();
+    endPop();
+  }
+
+  unsigned int getCapacity() const {return m_capacity;}
+
+  //! Number of items dropped because the consumer was too slow.
+  unsigned long getNbDropped()
+  {
+    vpMutex::vpScopedLock lock(m_mutex);
+    return m_nb_dropped;
+  }
+
+  unsigned long getNbPushed()
+  {
+    vpMutex::vpScopedLock lock(m_mutex);
+    return m_nb_pushed;
+  }
+
+  unsigned int getSize()
+  {
+    vpMutex::vpScopedLock lock(m_mutex);
+    return m_size;
+  }
+
+  /*!
+    Initialize all the items with a copy of \e value, to preallocate them.
+    Should be called before the pipeline is started.
+   */
+  void init(const T &value)
+  {
+    vpMutex::vpScopedLock lock(m_mutex);
+    for (unsigned int i=0; i < m_items.size(); i++)
+      *m_items[i] = value;
+  }
+
+private:
+  vpPipelineQueue(const vpPipelineQueue &);
+  vpPipelineQueue &operator=(const vpPipelineQueue &);
+};
+
+#endif
@@ -0,0 +1,226 @@
+#ifndef __vpPipelineStage_h__
+#define __vpPipelineStage_h__
+
+#include <string>
+
+#include <vpAtomic.h>
+#include <vpPipelineQueue.h>
+#include <vpStageProfiler.h>
+
+/*!
+  Base class of the stages run by a vpPipeline.
+
+  A stage processes at most one item each time step() is called. The duration of each processing is
+  stored in the vpStageProfiler::process stage of its profiler, which is enabled by default.
+  Stages are usually derived from vpPipelineSource, vpPipelineFilter, vpPipelineInPlaceFilter or vpPipelineSink.
+ */
+class vpPipelineStage
+{
+protected:
+  std::string m_name;
+  vpStageProfiler m_profiler;
+  volatile long m_busy;           // Set while a thread is running step()
+  unsigned long m_nb_processed;
+
+public:
+  vpPipelineStage(const std::string &name)
+    : m_name(name), m_profiler(name), m_busy(0), m_nb_processed(0)
+  {
+    m_profiler.setEnabled(true);
+  }
+  virtual ~vpPipelineStage() {}
+
+  std::string getName() const {return m_name;}
+  //! Number of items processed. Only reliable once the pipeline is stopped.
+  unsigned long getNbProcessed() const {return m_nb_processed;}
+  //! Timings of the stage. Only reliable once the pipeline is stopped.
+  vpStageProfiler &getProfiler() {return m_profiler;}
+
+  /*!
+    Run step() unless another thread of the worker pool is already running it.
+    \return true if an item was processed.
+   */
+  bool tryStep()
+  {
+    if (! vpAtomic::compareAndSwap(&m_busy, 0, 1))
+      return false;
+    bool done = false;
+    try {
+      done = step();
+    }
+    catch (...) {
+      vpAtomic::store(&m_busy, 0);
+      throw;
+    }
+    if (done)
+      m_nb_processed ++;
+    vpAtomic::store(&m_busy, 0);
+    return done;
+  }
+
+protected:
+  /*!
+    Process one item.
+    \return false if there was nothing to process.
+   */
+  virtual bool step() = 0;
+};
+
+/*!
+  Stage producing items, for example from a grabber.
+ */
+template <class Out> class vpPipelineSource : public vpPipelineStage
+{
+protected:
+  vpPipelineQueue<Out> *m_output;
+
+public:
+  vpPipelineSource(const std::string &name) : vpPipelineStage(name), m_output(NULL) {}
+
+  void setOutput(vpPipelineQueue<Out> &output) {m_output = &output;}
+
+protected:
+  /*!
+    Produce an item in \e out, that is reused from one call to the other.
+    \return false if no item was produced.
+   */
+  virtual bool process(Out &out) = 0;
+
+  bool step()
+  {
+    if (m_output == NULL)
+      return false;
+
+    Out &out = m_output->beginPush();
+    bool produced;
+    {
+      vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::process);
+      produced = process(out);
+    }
+    if (produced)
+      m_output->endPush();
+    else
+      m_output->cancelPush();
+    return produced;
+  }
+};
+
+/*!
+  Stage transforming the items of its input queue into items of its output queue.
+  The output queue is optional, so that a filter can also end a pipeline.
+ */
+template <class In, class Out> class vpPipelineFilter : public vpPipelineStage
+{
+protected:
+  vpPipelineQueue<In> *m_input;
+  vpPipelineQueue<Out> *m_output;
+  Out m_out;                      // Output item used when no output queue is connected
+
+public:
+  vpPipelineFilter(const std::string &name) : vpPipelineStage(name), m_input(NULL), m_output(NULL), m_out() {}
+
+  void setInput(vpPipelineQueue<In> &input) {m_input = &input;}
+  void setOutput(vpPipelineQueue<Out> &output) {m_output = &output;}
+
+protected:
+  /*!
+    Process the item \e in into \e out, that is reused from one call to the other.
+    \return false if \e out should not be forwarded to the next stage.
+   */
+  virtual bool process(const In &in, Out &out) = 0;
+
+  bool step()
+  {
+    if (m_input == NULL || ! m_input->beginPop())
+      return false;
+
+    Out &out = (m_output != NULL) ? m_output->beginPush() : m_out;
+    bool forward;
+    {
+      vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::process);
+      forward = process(m_input->front(), out);
+    }
+    m_input->endPop();
+    if (m_output != NULL) {
+      if (forward)
+        m_output->endPush();
+      else
+        m_output->cancelPush();
+    }
+    return true;
+  }
+};
+
+/*!
+  Stage updating the items of its input queue in place, and passing them on to its output queue without
+  copying them. The output queue is optional, so that such a filter can also end a pipeline.
+ */
+template <class T> class vpPipelineInPlaceFilter : public vpPipelineStage
+{
+protected:
+  vpPipelineQueue<T> *m_input;
+  vpPipelineQueue<T> *m_output;
+
+public:
+  vpPipelineInPlaceFilter(const std::string &name) : vpPipelineStage(name), m_input(NULL), m_output(NULL) {}
+
+  void setInput(vpPipelineQueue<T> &input) {m_input = &input;}
+  void setOutput(vpPipelineQueue<T> &output) {m_output = &output;}
+
+protected:
+  /*!
+    Process the item \e item in place.
+    \return false if \e item should not be forwarded to the next stage.
+   */
+  virtual bool process(T &item) = 0;
+
+  bool step()
+  {
+    if (m_input == NULL || ! m_input->beginPop())
+      return false;
+
+    bool forward;
+    {
+      vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::process);
+      forward = process(m_input->front());
+    }
+    if (m_output != NULL && forward)
+      m_input->forward(*m_output);
+    else
+      m_input->endPop();
+    return true;
+  }
+};
+
+/*!
+  Last stage of a pipeline, for example a controller or a display.
+ */
+template <class In> class vpPipelineSink : public vpPipelineStage
+{
+protected:
+  vpPipelineQueue<In> *m_input;
+
+public:
+  vpPipelineSink(const std::string &name) : vpPipelineStage(name), m_input(NULL) {}
+
+  void setInput(vpPipelineQueue<In> &input) {m_input = &input;}
+
+protected:
+  //! Consume the item \e in, that may be modified since no other stage reads it.
+  virtual void process(In &in) = 0;
+
+  bool step()
+  {
+    if (m_input == NULL || ! m_input->beginPop())
+      return false;
+
+    {
+      vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::process);
+      process(m_input->front());
+    }
+    m_input->endPop();
+    return true;
+  }
+};
+
+#endif
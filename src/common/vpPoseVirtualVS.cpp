@@ -0,0 +1,126 @@
+#include <math.h>
+
+#include <algorithm>
+
+#include <visp/vpMath.h>
+
+#include <vpPoseVirtualVS.h>
+
+
+vpPoseVirtualVS::vpPoseVirtualVS()
+  : m_lambda(0.9), m_iter_max(200), m_L(), m_e()
+{
+}
+
+/*!
+  Refine the pose \e cMo so that the projection of the points matches their measured normalized coordinates.
+  \param points : Points with their coordinates in the object frame and their measured coordinates x, y.
+  \param cMo : Initial pose, replaced by the refined one.
+ */
+void vpPoseVirtualVS::computePose(const std::vector<vpPoint> &points, vpHomogeneousMatrix &cMo)
+{
+  const unsigned int n = (unsigned int)points.size();
+  m_L.resize(2*n*6);
+  m_e.resize(2*n);
+
+  double residual_prev = 1e8;
+  double residual = 1e8 - 1;
+  unsigned int iter = 0;
+  // Same stopping criterion than vpPose: the residual does not decrease anymore
+  while ((int)((residual_prev - residual)*1e12) != 0 && iter < m_iter_max) {
+    residual_prev = residual;
+    residual = 0;
+
+    // Error and interaction matrix of the points projected with the current pose
+    for (unsigned int k=0; k < n; k++) {
+      const vpPoint &P = points[k];
+      double oP[3] = {P.get_oX(), P.get_oY(), P.get_oZ()};
+      double cP[3];
+      for (unsigned int i=0; i < 3; i++)
+        cP[i] = cMo[i][0]*oP[0] + cMo[i][1]*oP[1] + cMo[i][2]*oP[2] + cMo[i][3];
+      double Z = cP[2];
+      double x = cP[0] / Z;
+      double y = cP[1] / Z;
+      m_e[2*k] = x - P.get_x();
+      m_e[2*k+1] = y - P.get_y();
+      residual += m_e[2*k]*m_e[2*k] + m_e[2*k+1]*m_e[2*k+1];
+
+      double *Lx = &m_L[2*k*6];
+      double *Ly = Lx + 6;
+      Lx[0] = -1/Z; Lx[1] = 0;    Lx[2] = x/Z; Lx[3] = x*y;   Lx[4] = -(1+x*x); Lx[5] = y;
+      Ly[0] = 0;    Ly[1] = -1/Z; Ly[2] = y/Z; Ly[3] = 1+y*y; Ly[4] = -x*y;     Ly[5] = -x;
+    }
+
+    // Least-squares velocity v = -lambda L^+ e, from the normal equations L^T L v = -lambda L^T e
+    double A[6][7];
+    for (unsigned int i=0; i < 6; i++) {
+      for (unsigned int j=0; j < 6; j++) {
+        double s = 0;
+        for (unsigned int r=0; r < 2*n; r++)
+          s += m_L[r*6+i] * m_L[r*6+j];
+        A[i][j] = s;
+      }
+      double s = 0;
+      for (unsigned int r=0; r < 2*n; r++)
+        s += m_L[r*6+i] * m_e[r];
+      A[i][6] = -m_lambda * s;
+    }
+    // Gauss-Jordan elimination with partial pivoting, the directions that are not observable are not moved
+    double v[6];
+    for (unsigned int c=0; c < 6; c++) {
+      unsigned int pivot = c;
+      for (unsigned int r=c+1; r < 6; r++)
+        if (fabs(A[r][c]) > fabs(A[pivot][c]))
+          pivot = r;
+      if (pivot != c)
+        for (unsigned int j=0; j < 7; j++)
+          std::swap(A[c][j], A[pivot][j]);
+      if (fabs(A[c][c]) < 1e-20)
+        continue;
+      for (unsigned int r=0; r < 6; r++) {
+        if (r == c)
+          continue;
+        double f = A[r][c] / A[c][c];
+        for (unsigned int j=c; j < 7; j++)
+          A[r][j] -= f * A[c][j];
+      }
+    }
+    for (unsigned int i=0; i < 6; i++)
+      v[i] = (fabs(A[i][i]) < 1e-20) ? 0. : A[i][6] / A[i][i];
+
+    // cMo = exp(v)^-1 cMo, with exp(v) = [dR dt] computed like vpExponentialMap::direct()
+    const double *u = v + 3;
+    double theta = sqrt(u[0]*u[0] + u[1]*u[1] + u[2]*u[2]);
+    double si = sin(theta);
+    double co = cos(theta);
+    double sinc = vpMath::sinc(si, theta);
+    double mcosc = vpMath::mcosc(co, theta);
+    double msinc = vpMath::msinc(si, theta);
+    double ux[3][3] = { {     0, -u[2],  u[1] },
+                        {  u[2],     0, -u[0] },
+                        { -u[1],  u[0],     0 } };
+    double dR[3][3], dt[3];
+    for (unsigned int i=0; i < 3; i++) {
+      dt[i] = 0;
+      for (unsigned int j=0; j < 3; j++) {
+        double ux2 = u[i]*u[j] - (i == j ? theta*theta : 0.);
+        double I = (i == j) ? 1. : 0.;
+        dR[i][j] = I + sinc*ux[i][j] + mcosc*ux2;
+        dt[i] += (I + mcosc*ux[i][j] + msinc*ux2) * v[j];
+      }
+    }
+    double M[3][4];
+    for (unsigned int i=0; i < 3; i++) {
+      // Rows of dR^T, and -dR^T dt
+      double t_inv = -(dR[0][i]*dt[0] + dR[1][i]*dt[1] + dR[2][i]*dt[2]);
+      for (unsigned int j=0; j < 4; j++)
+        M[i][j] = dR[0][i]*cMo[0][j] + dR[1][i]*cMo[1][j] + dR[2][i]*cMo[2][j];
+      M[i][3] += t_inv;
+    }
+    for (unsigned int i=0; i < 3; i++)
+      for (unsigned int j=0; j < 4; j++)
+        cMo[i][j] = M[i][j];
+
+    iter ++;
+  }
+}
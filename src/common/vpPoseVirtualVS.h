@@ -0,0 +1,44 @@
+#ifndef __vpPoseVirtualVS_h__
+#define __vpPoseVirtualVS_h__
+
+#include <vector>
+
+#include <visp/vpHomogeneousMatrix.h>
+#include <visp/vpPoint.h>
+
+/*!
+  Refinement of a pose by virtual visual servoing, like vpPose::computePose(vpPose::VIRTUAL_VS) does, without
+  any allocation once the number of points is known. The trackers use it to update the pose from the one of
+  the previous frame, while vpPose allocates the list of its points and its matrices at each call.
+
+  \code
+  vpPoseVirtualVS pose;
+  for (unsigned int i=0; i < points.size(); i++) {
+    vpPixelMeterConversion::convertPoint(cam, corners[i], x, y);
+    points[i].set_x(x);
+    points[i].set_y(y);
+  }
+  pose.computePose(points, cMo); // cMo is the pose of the previous frame
+  \endcode
+ */
+class vpPoseVirtualVS
+{
+protected:
+  double m_lambda;
+  unsigned int m_iter_max;
+  std::vector<double> m_L;  // Interaction matrix of the points, 2n x 6 row major
+  std::vector<double> m_e;  // Error between the projected and the measured points, 2n
+
+public:
+  vpPoseVirtualVS();
+  virtual ~vpPoseVirtualVS() {}
+
+  void computePose(const std::vector<vpPoint> &points, vpHomogeneousMatrix &cMo);
+
+  //! Gain of the virtual control law, 0.9 by default like vpPose.
+  void setLambda(double lambda) {m_lambda = lambda;}
+  //! Maximum number of iterations, 200 by default like vpPose.
+  void setIterMax(unsigned int iter_max) {m_iter_max = iter_max;}
+};
+
+#endif
@@ -1,9 +1,12 @@
 
+#include <vpAllocationCounter.h>
 #include <vpQRCodeTracker.h>
 
 
 vpQRCodeTracker::vpQRCodeTracker(int barcode)
-  : m_detector(NULL), m_warp(), m_tracker(NULL), m_state(detection), m_target_found(false), m_P(4), m_force_detection(false), m_message("romeo_left_arm")
+  : m_detector(NULL), m_warp(), m_tracker(NULL), m_state(detection), m_corners_unordered(), m_triangle(),
+    m_triangle_corners(), m_p(), m_target_found(false), m_P(4), m_pose_vvs(), m_force_detection(false),
+    m_message("romeo_left_arm"), m_profiler("vpQRCodeTracker"), m_frame_timestamp(0), m_timestamp(0)
 {
   if (barcode == 0)
   {
@@ -62,7 +65,12 @@ void vpQRCodeTracker::setQRCodeSize(double qrcode_size)
 bool vpQRCodeTracker::track(const vpImage<unsigned char> &I)
 {
   bool result = false;
-  bool status = m_detector->detect(I);
+  bool status;
+  {
+    vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::detect);
+    vpAllocationCounter::vpExternalScope zbar;
+    status = m_detector->detect(I);
+  }
   if (status)
     result = track(I, m_detector);
 
@@ -73,9 +81,8 @@ bool vpQRCodeTracker::track(const vpImage<unsigned char> &I)
 
 bool vpQRCodeTracker::track(const vpImage<unsigned char> &I, vpDetectorBase * &detector )
 {
-  vpColVector p; // Estimated parameters
-
   if (m_state == detection || m_force_detection) {
+    vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::match);
     //bool status = detector->detect(I);
     if (detector->getNbObjects()>0) {
       for (size_t i=0; i < detector->getNbObjects(); i++) {
@@ -99,20 +106,26 @@ bool vpQRCodeTracker::track(const vpImage<unsigned char> &I, vpDetectorBase * &d
   if (m_state == init_tracking) {
     //vpDisplay::displayText(I, 40,10, "state: init tracking", vpColor::red);
     try {
-      m_tracker->resetTracker();
-      m_tracker->initFromPoints(I, m_corners_detected, true);
-      m_tracker->track(I);
-      //m_tracker->display(I, vpColor::green);
-      m_zone_ref = m_tracker->getZoneRef();
-      m_area_m_zone_ref = m_zone_ref.getArea();
-      p = m_tracker->getp();
-      m_warp.warpZone(m_zone_ref, p, zone_cur);
-      m_area_zone_prev = m_area_zone_cur = zone_cur.getArea();
-      m_corners_tracked = getTemplateTrackerCorners(zone_cur);
-      m_corners_tracked_index = computedTemplateTrackerCornersIndexes(m_corners_detected, m_corners_tracked);
-      m_corners_tracked = orderPointsFromIndexes(m_corners_tracked_index, m_corners_tracked);
-
-      computePose(m_P, m_corners_tracked, m_cam, true, m_cMo);
+      {
+        vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::init);
+        m_tracker->resetTracker();
+        m_tracker->initFromPoints(I, m_corners_detected, true);
+        m_tracker->track(I);
+        //m_tracker->display(I, vpColor::green);
+        m_zone_ref = m_tracker->getZoneRef();
+        m_area_m_zone_ref = m_zone_ref.getArea();
+        m_p = m_tracker->getp();
+        m_warp.warpZone(m_zone_ref, m_p, zone_cur);
+        m_area_zone_prev = m_area_zone_cur = zone_cur.getArea();
+        getTemplateTrackerCorners(zone_cur, m_corners_unordered);
+        m_corners_tracked_index = computedTemplateTrackerCornersIndexes(m_corners_detected, m_corners_unordered);
+        orderPointsFromIndexes(m_corners_tracked_index, m_corners_unordered, m_corners_tracked);
+      }
+
+      {
+        vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::pose);
+        computePose(m_P, m_corners_tracked, m_cam, true, m_cMo);
+      }
       //       vpDisplay::displayFrame(I, m_cMo, m_cam, 0.04, vpColor::none, 3);
 
       m_state = tracking;
@@ -127,32 +140,47 @@ bool vpQRCodeTracker::track(const vpImage<unsigned char> &I, vpDetectorBase * &d
   else if (m_state == tracking) {
     try {
       //vpDisplay::displayText(I, 40,10, "state: tracking", vpColor::red);
-      m_tracker->track(I);
+      {
+        vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::track);
+        vpAllocationCounter::vpExternalScope visp;
+        m_tracker->track(I);
 
-      //m_tracker->display(I, vpColor::blue);
+        //m_tracker->display(I, vpColor::blue);
 
-      // Instantiate and get the reference zone
-      p = m_tracker->getp();
-      m_warp.warpZone(m_zone_ref, p, zone_cur);
-      m_area_zone_cur = zone_cur.getArea();
+        // Instantiate and get the reference zone
+        m_p = m_tracker->getp();
+        m_warp.warpZone(m_zone_ref, m_p, zone_cur);
+      }
 
-      double size_percent = 0.95;
-      double max_target_size = I.getSize()/4;
-      if (m_area_zone_cur/m_area_zone_prev < size_percent || m_area_zone_cur/m_area_zone_prev > (1+size_percent)) {
-        //          std::cout << "reinit caused by size" << std::endl;
-        m_state = detection;
-        m_target_found = false;
+      bool valid = true;
+      {
+        vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::validate);
+        vpAllocationCounter::vpExternalScope visp;
+        m_area_zone_cur = zone_cur.getArea();
+
+        double size_percent = 0.95;
+        double max_target_size = I.getSize()/4;
+        if (m_area_zone_cur/m_area_zone_prev < size_percent || m_area_zone_cur/m_area_zone_prev > (1+size_percent)) {
+          //          std::cout << "reinit caused by size" << std::endl;
+          valid = false;
+        }
+        else if(zone_cur.getBoundingBox().getSize() > max_target_size) {
+          //          std::cout << "reinit caused by size area" << std::endl;
+          valid = false;
+        }
       }
-      else if(zone_cur.getBoundingBox().getSize() > max_target_size) {
-        //          std::cout << "reinit caused by size area" << std::endl;
+      if (! valid) {
         m_state = detection;
         m_target_found = false;
       }
       else {
-        m_corners_tracked = getTemplateTrackerCorners(zone_cur);
-        m_corners_tracked = orderPointsFromIndexes(m_corners_tracked_index, m_corners_tracked);
+        getTemplateTrackerCorners(zone_cur, m_corners_unordered);
+        orderPointsFromIndexes(m_corners_tracked_index, m_corners_unordered, m_corners_tracked);
 
-        computePose(m_P, m_corners_tracked, m_cam, false, m_cMo);
+        {
+          vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::pose);
+          computePose(m_P, m_corners_tracked, m_cam, false, m_cMo);
+        }
 
         //            vpDisplay::displayFrame(I, m_cMo, m_cam, 0.04, vpColor::none, 3);
         //            for(unsigned int j=0; j < m_corners_tracked.size(); j++) {
@@ -174,23 +202,31 @@ bool vpQRCodeTracker::track(const vpImage<unsigned char> &I, vpDetectorBase * &d
       m_target_found = false;
     }
   }
+  if (m_target_found)
+    m_timestamp = m_frame_timestamp;
+
   return m_target_found;
 }
 
-std::vector<vpImagePoint> vpQRCodeTracker::getTemplateTrackerCorners(const vpTemplateTrackerZone &zone)
+/*!
+  Get the corners of the zone in \e corners_tracked, that keeps its capacity from one frame to the other.
+ */
+void vpQRCodeTracker::getTemplateTrackerCorners(const vpTemplateTrackerZone &zone, std::vector<vpImagePoint> &corners_tracked)
 {
-  std::vector<vpImagePoint> corners_tracked;
+  std::vector<vpImagePoint> &corners = m_triangle_corners;
+  vpTemplateTrackerTriangle &triangle = m_triangle;
 
   // Parse all the triangles that describe the zone
   for (int i=0; i < zone.getNbTriangle(); i++) {
-    vpTemplateTrackerTriangle triangle;
-    // Get a triangle
-    zone.getTriangle(i, triangle);
-    std::vector<vpImagePoint> corners;
-    // Get the 3 triangle corners
-    triangle.getCorners( corners );
+    {
+      vpAllocationCounter::vpExternalScope visp;
+      // Get a triangle
+      zone.getTriangle(i, triangle);
+      // Get the 3 triangle corners
+      triangle.getCorners( corners );
+    }
     if (i==0)
-      corners_tracked = corners;
+      corners_tracked.assign(corners.begin(), corners.end());
     else {
       for(unsigned int m=0; m < corners.size(); m++) { // corners of the 2nd triangle
         bool already_exists = false;
@@ -206,7 +242,6 @@ std::vector<vpImagePoint> vpQRCodeTracker::getTemplateTrackerCorners(const vpTem
 
     }
   }
-  return corners_tracked;
 }
 
 std::vector<int> vpQRCodeTracker::computedTemplateTrackerCornersIndexes(const std::vector<vpImagePoint> &corners_detected, const std::vector<vpImagePoint> &corners_tracked)
@@ -223,38 +258,47 @@ std::vector<int> vpQRCodeTracker::computedTemplateTrackerCornersIndexes(const st
   return corners_tracked_index;
 }
 
-std::vector<vpImagePoint> vpQRCodeTracker::orderPointsFromIndexes(const std::vector<int> &indexes, const std::vector<vpImagePoint> &corners)
+void vpQRCodeTracker::orderPointsFromIndexes(const std::vector<int> &indexes, const std::vector<vpImagePoint> &corners,
+                                             std::vector<vpImagePoint> &corners_ordered)
 {
-  std::vector<vpImagePoint> corners_ordered(corners.size());
+  corners_ordered.resize(corners.size());
   for(unsigned int i=0; i < corners.size(); i++) {
     corners_ordered[indexes[i]] = corners[i];
   }
-  return corners_ordered;
 }
 
+/*!
+  Compute the pose from the tracked corners. While tracking, the pose of the previous frame is refined
+  with vpPoseVirtualVS, that does not allocate.
+ */
 void vpQRCodeTracker::computePose(std::vector<vpPoint> &point, const std::vector<vpImagePoint> &corners,
                                   const vpCameraParameters &cam, bool init, vpHomogeneousMatrix &cMo)
 {
-  vpPose pose;
   double x=0, y=0;
   for (unsigned int i=0; i < point.size(); i ++) {
     vpPixelMeterConversion::convertPoint(cam, corners[i], x, y);
     point[i].set_x(x);
     point[i].set_y(y);
-    pose.addPoint(point[i]);
   }
 
-  if (init) {
-    vpHomogeneousMatrix cMo_dementhon, cMo_lagrange;
-    pose.computePose(vpPose::DEMENTHON_VIRTUAL_VS, cMo_dementhon);
-    double residual_dementhon = pose.computeResidual(cMo_dementhon);
-    pose.computePose(vpPose::LAGRANGE_VIRTUAL_VS, cMo_lagrange);
-    double residual_lagrange = pose.computeResidual(cMo_lagrange);
-    if (residual_dementhon < residual_lagrange)
-      cMo = cMo_dementhon;
-    else
-      cMo = cMo_lagrange;
+  if (! init) {
+    m_pose_vvs.computePose(point, cMo);
+    return;
   }
 
+  vpPose pose;
+  for (unsigned int i=0; i < point.size(); i ++)
+    pose.addPoint(point[i]);
+
+  vpHomogeneousMatrix cMo_dementhon, cMo_lagrange;
+  pose.computePose(vpPose::DEMENTHON_VIRTUAL_VS, cMo_dementhon);
+  double residual_dementhon = pose.computeResidual(cMo_dementhon);
+  pose.computePose(vpPose::LAGRANGE_VIRTUAL_VS, cMo_lagrange);
+  double residual_lagrange = pose.computeResidual(cMo_lagrange);
+  if (residual_dementhon < residual_lagrange)
+    cMo = cMo_dementhon;
+  else
+    cMo = cMo_lagrange;
+
   pose.computePose(vpPose::VIRTUAL_VS, cMo) ;
 }
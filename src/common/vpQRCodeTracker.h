@@ -9,6 +9,9 @@
 #include <visp/vpTemplateTrackerWarpHomography.h>
 #include <visp/vpPixelMeterConversion.h>
 
+#include <vpPoseVirtualVS.h>
+#include <vpStageProfiler.h>
+
 #ifndef VISP_HAVE_ZBAR
 #  error "Cannot build the project, libzbar is missing. Install libzbar using apt-get install libzbar-dev and rebuild ViSP."
 #endif
@@ -34,13 +37,21 @@ protected:
   std::vector<vpImagePoint> m_corners_detected;
   std::vector<vpImagePoint> m_corners_tracked;
   std::vector<int> m_corners_tracked_index;
+  std::vector<vpImagePoint> m_corners_unordered; // Corners of the tracked zone before reordering
+  vpTemplateTrackerTriangle m_triangle; // Triangle of the tracked zone, reused from one frame to the other
+  std::vector<vpImagePoint> m_triangle_corners;
+  vpColVector m_p; // Estimated parameters of the warp
   bool m_target_found;
   vpRect m_target_bbox; // BBox of the tracked qrcode
   std::vector<vpPoint> m_P; // Points of the qrcode model
   vpCameraParameters m_cam;
   vpHomogeneousMatrix m_cMo;
+  vpPoseVirtualVS m_pose_vvs; // Pose refinement while tracking, without allocation
   bool m_force_detection;
   std::string m_message;
+  vpStageProfiler m_profiler;
+  double m_frame_timestamp; // Capture time of the image given to the next track()
+  double m_timestamp; // Capture time of the image of the last successful track()
 
 public:
 
@@ -58,7 +69,9 @@ public:
     Return the center of gravity location of the tracked bar code.
     */
   vpImagePoint getCog();
-  std::vector<vpImagePoint> getCorners() const {return m_corners_tracked;}
+  const std::vector<vpImagePoint> &getCorners() const {return m_corners_tracked;}
+  vpStageProfiler &getProfiler() {return m_profiler;}
+  double getTimestamp() const {return m_timestamp;}
 
   void setCameraParameters(const vpCameraParameters &cam) { m_cam = cam; }
 
@@ -71,18 +84,23 @@ public:
   }
 
   void setQRCodeSize(double qrcode_size);
+  /*!
+    Set the capture time of the next image given to track(). It is returned by getTimestamp() if the
+    qrcode is found, so that the pose can be associated to the time it was measured.
+   */
+  void setTimestamp(double timestamp) {m_frame_timestamp = timestamp;}
 
   bool track(const vpImage<unsigned char> &I);
   bool track(const vpImage<unsigned char> &I, vpDetectorBase *&detector );
 
 private:
-  std::vector<vpImagePoint> getTemplateTrackerCorners(const vpTemplateTrackerZone &zone);
+  void getTemplateTrackerCorners(const vpTemplateTrackerZone &zone, std::vector<vpImagePoint> &corners_tracked);
 
   std::vector<int> computedTemplateTrackerCornersIndexes(const std::vector<vpImagePoint> &corners_detected,
                                                          const std::vector<vpImagePoint> &corners_tracked);
 
-  std::vector<vpImagePoint> orderPointsFromIndexes(const std::vector<int> &indexes,
-                                                   const std::vector<vpImagePoint> &corners);
+  void orderPointsFromIndexes(const std::vector<int> &indexes, const std::vector<vpImagePoint> &corners,
+                              std::vector<vpImagePoint> &corners_ordered);
 
   void computePose(std::vector<vpPoint> &point, const std::vector<vpImagePoint> &corners,
                    const vpCameraParameters &cam, bool init, vpHomogeneousMatrix &cMo);
@@ -0,0 +1,205 @@
+#include <stdint.h>
+#include <string.h>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <visp/vpException.h>
+#include <visp/vpTime.h>
+
+#include <vpReplayGrabber.h>
+#include <vpSequenceRecorder.h>
+
+
+vpReplayGrabber::vpReplayGrabber()
+  : m_file(), m_filename(), m_width(0), m_height(0), m_channels(0), m_cam(), m_eMc(), m_eMc_dist(), m_joint_names(),
+    m_header_size(0), m_record_size(0), m_nb_frames(0), m_frame(0), m_timestamp(0), m_q(), m_bitmap(), m_realtime(true),
+    m_loop(false), m_t_start(-1), m_timestamp_start(0)
+{
+}
+
+vpReplayGrabber::~vpReplayGrabber()
+{
+  close();
+}
+
+/*!
+  Read the next frame as a gray image. Color sequences are converted.
+  \return false at the end of the sequence (I is then unchanged).
+ */
+bool vpReplayGrabber::acquire(vpImage<unsigned char> &I)
+{
+  if (! readRecord())
+    return false;
+
+  if (I.getWidth() != m_width || I.getHeight() != m_height)
+    I.resize(m_height, m_width);
+  if (m_channels == 1)
+    memcpy(I.bitmap, &m_bitmap[0], m_width * m_height);
+  else {
+    cv::Mat bgr((int)m_height, (int)m_width, CV_8UC3, &m_bitmap[0]);
+    cv::Mat gray((int)m_height, (int)m_width, CV_8UC1, I.bitmap);
+    cv::cvtColor(bgr, gray, CV_BGR2GRAY);
+  }
+  return true;
+}
+
+/*!
+  Read the next frame as a BGR image. Gray sequences are converted.
+  \return false at the end of the sequence (I is then unchanged).
+ */
+bool vpReplayGrabber::acquire(cv::Mat &I)
+{
+  if (! readRecord())
+    return false;
+
+  I.create((int)m_height, (int)m_width, CV_8UC3);
+  cv::Mat frame((int)m_height, (int)m_width, m_channels == 1 ? CV_8UC1 : CV_8UC3, &m_bitmap[0]);
+  if (m_channels == 1)
+    cv::cvtColor(frame, I, CV_GRAY2BGR);
+  else
+    frame.copyTo(I);
+  return true;
+}
+
+void vpReplayGrabber::close()
+{
+  if (m_file.is_open())
+    m_file.close();
+  m_nb_frames = 0;
+  m_frame = 0;
+}
+
+/*!
+  Return the recorded camera parameters, with or without distortion.
+ */
+vpCameraParameters vpReplayGrabber::getCameraParameters(vpCameraParameters::vpCameraParametersProjType projModel) const
+{
+  vpCameraParameters cam;
+  if (projModel == vpCameraParameters::perspectiveProjWithDistortion)
+    cam.initPersProjWithDistortion(m_cam.get_px(), m_cam.get_py(), m_cam.get_u0(), m_cam.get_v0(), m_cam.get_kud(), m_cam.get_kdu());
+  else
+    cam.initPersProjWithoutDistortion(m_cam.get_px(), m_cam.get_py(), m_cam.get_u0(), m_cam.get_v0());
+  return cam;
+}
+
+/*!
+  Return the recorded extrinsic camera parameters of the model with or without distortion.
+ */
+vpHomogeneousMatrix vpReplayGrabber::get_eMc(vpCameraParameters::vpCameraParametersProjType projModel) const
+{
+  if (projModel == vpCameraParameters::perspectiveProjWithDistortion)
+    return m_eMc_dist;
+  return m_eMc;
+}
+
+/*!
+  Open a sequence recorded with vpSequenceRecorder and read its header.
+ */
+void vpReplayGrabber::open(const std::string &filename)
+{
+  close();
+  m_file.open(filename.c_str(), std::ios::in | std::ios::binary);
+  if (! m_file.is_open())
+    throw vpException(vpException::ioError, "Cannot open sequence file: %s", filename.c_str());
+  m_filename = filename;
+
+  char magic[6];
+  uint32_t header[4];
+  double intrinsic[6];
+  double extrinsic[24];
+  uint32_t nb_joints = 0;
+  m_file.read(magic, 6);
+  m_file.read((char *)header, sizeof(header));
+  if (! m_file.good() || strncmp(magic, "RTKSEQ", 6) != 0 || header[0] != vpSequenceRecorder::version) {
+    close();
+    throw vpException(vpException::ioError, "%s is not a sequence file", filename.c_str());
+  }
+  if (header[1] == 0 || header[2] == 0 || (header[3] != 1 && header[3] != 3)) {
+    close();
+    throw vpException(vpException::ioError, "Unsupported %ux%u image with %u channels in sequence file %s",
+                      header[1], header[2], header[3], filename.c_str());
+  }
+  m_file.read((char *)intrinsic, sizeof(intrinsic));
+  m_file.read((char *)extrinsic, sizeof(extrinsic));
+  m_file.read((char *)&nb_joints, sizeof(uint32_t));
+
+  m_width = header[1];
+  m_height = header[2];
+  m_channels = header[3];
+  m_cam.initPersProjWithDistortion(intrinsic[0], intrinsic[1], intrinsic[2], intrinsic[3], intrinsic[4], intrinsic[5]);
+  for (unsigned int i=0; i < 3; i++) {
+    for (unsigned int j=0; j < 4; j++) {
+      m_eMc[i][j] = extrinsic[4*i+j];
+      m_eMc_dist[i][j] = extrinsic[12+4*i+j];
+    }
+  }
+
+  m_joint_names.resize(nb_joints);
+  for (uint32_t i=0; i < nb_joints && m_file.good(); i++) {
+    uint32_t length = 0;
+    m_file.read((char *)&length, sizeof(uint32_t));
+    m_joint_names[i].resize(length);
+    if (length)
+      m_file.read(&m_joint_names[i][0], length);
+  }
+  if (! m_file.good()) {
+    close();
+    throw vpException(vpException::ioError, "Cannot read sequence file header: %s", filename.c_str());
+  }
+
+  m_header_size = m_file.tellg();
+  m_record_size = (std::streamoff)((1 + nb_joints) * sizeof(double)) + (std::streamoff)m_width * m_height * m_channels;
+  m_file.seekg(0, std::ios::end);
+  std::streamoff file_size = m_file.tellg();
+  m_nb_frames = (unsigned int)((file_size - m_header_size) / m_record_size);
+  m_file.seekg(m_header_size, std::ios::beg);
+
+  m_q.resize(nb_joints);
+  m_bitmap.resize((size_t)m_width * m_height * m_channels);
+  m_frame = 0;
+  m_t_start = -1;
+}
+
+bool vpReplayGrabber::readRecord()
+{
+  if (! m_file.is_open())
+    throw vpException(vpException::notInitialized, "Sequence file is not opened");
+
+  if (m_frame >= m_nb_frames) {
+    if (! m_loop || m_nb_frames == 0)
+      return false;
+    setFrameIndex(0);
+  }
+
+  m_file.read((char *)&m_timestamp, sizeof(double));
+  for (unsigned int i=0; i < m_q.getRows(); i++)
+    m_file.read((char *)&m_q[i], sizeof(double));
+  m_file.read((char *)&m_bitmap[0], (std::streamsize)m_bitmap.size());
+  if (! m_file.good())
+    throw vpException(vpException::ioError, "Cannot read frame %d of %s", m_frame, m_filename.c_str());
+  m_frame ++;
+
+  if (m_realtime) {
+    if (m_t_start < 0) {
+      m_t_start = vpTime::measureTimeMs();
+      m_timestamp_start = m_timestamp;
+    }
+    else
+      vpTime::wait(m_t_start, 1000. * (m_timestamp - m_timestamp_start));
+  }
+  return true;
+}
+
+/*!
+  Move to a frame of the sequence. The next acquire() returns this frame.
+ */
+void vpReplayGrabber::setFrameIndex(unsigned int frame)
+{
+  if (frame > m_nb_frames)
+    throw vpException(vpException::badValue, "Frame %d is out of the sequence (%d frames)", frame, m_nb_frames);
+
+  m_file.clear();
+  m_file.seekg(m_header_size + (std::streamoff)frame * m_record_size, std::ios::beg);
+  m_frame = frame;
+  m_t_start = -1;
+}
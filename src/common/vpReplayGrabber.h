@@ -0,0 +1,91 @@
+#ifndef __vpReplayGrabber_h__
+#define __vpReplayGrabber_h__
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+#include <visp/vpCameraParameters.h>
+#include <visp/vpColVector.h>
+#include <visp/vpHomogeneousMatrix.h>
+#include <visp/vpImage.h>
+
+/*!
+  Frame source replaying a sequence recorded with vpSequenceRecorder, with the same
+  acquisition interface than vpNaoqiGrabber, so that trackers can be run and measured without a robot.
+
+  Frames are replayed at the recorded speed (acquire() waits until the frame is due) or,
+  with setRealTime(false), as fast as possible. acquire() returns false at the end of the sequence,
+  unless setLoop(true) was called.
+
+  \code
+  vpReplayGrabber g;
+  g.open("sequence.bin");
+  vpCameraParameters cam = g.getCameraParameters(vpCameraParameters::perspectiveProjWithoutDistortion);
+  vpImage<unsigned char> I(g.getHeight(), g.getWidth());
+  while (g.acquire(I)) {
+    qrcode_tracker.setTimestamp(g.getTimestamp());
+    qrcode_tracker.track(I);
+  }
+  \endcode
+ */
+class vpReplayGrabber
+{
+protected:
+  std::ifstream m_file;
+  std::string m_filename;
+  unsigned int m_width;
+  unsigned int m_height;
+  unsigned int m_channels;
+  vpCameraParameters m_cam;
+  vpHomogeneousMatrix m_eMc;
+  vpHomogeneousMatrix m_eMc_dist;
+  std::vector<std::string> m_joint_names;
+  std::streamoff m_header_size;
+  std::streamoff m_record_size;
+  unsigned int m_nb_frames;
+  unsigned int m_frame;            // Index of the next frame to read
+  double m_timestamp;              // Capture time of the last frame read
+  vpColVector m_q;                 // Joint positions of the last frame read
+  std::vector<unsigned char> m_bitmap;
+  bool m_realtime;
+  bool m_loop;
+  double m_t_start;                // Time at which the first frame of the loop was delivered
+  double m_timestamp_start;        // Capture time of this frame
+
+public:
+  vpReplayGrabber();
+  virtual ~vpReplayGrabber();
+
+  bool acquire(vpImage<unsigned char> &I);
+  bool acquire(cv::Mat &I);
+  void close();
+
+  vpCameraParameters getCameraParameters(vpCameraParameters::vpCameraParametersProjType projModel
+                                         = vpCameraParameters::perspectiveProjWithoutDistortion) const;
+  unsigned int getChannels() const {return m_channels;}
+  vpHomogeneousMatrix get_eMc(vpCameraParameters::vpCameraParametersProjType projModel
+                              = vpCameraParameters::perspectiveProjWithoutDistortion) const;
+  unsigned int getFrameIndex() const {return m_frame;}
+  unsigned int getHeight() const {return m_height;}
+  std::vector<std::string> getJointNames() const {return m_joint_names;}
+  vpColVector getJointPositions() const {return m_q;}
+  unsigned int getNbFrames() const {return m_nb_frames;}
+  double getTimestamp() const {return m_timestamp;}
+  unsigned int getWidth() const {return m_width;}
+
+  bool isOpened() const {return m_file.is_open();}
+
+  void open(const std::string &filename);
+
+  void setFrameIndex(unsigned int frame);
+  void setLoop(bool loop) {m_loop = loop;}
+  void setRealTime(bool realtime) {m_realtime = realtime;}
+
+protected:
+  bool readRecord();
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef __vpRobotBackend_h__
+#define __vpRobotBackend_h__
+
+#include <string>
+#include <vector>
+
+#include <visp/vpColVector.h>
+#include <visp/vpMatrix.h>
+
+#include <visp_naoqi/vpNaoqiRobot.h>
+
+/*!
+  Part of the vpNaoqiRobot interface used by the control loops of romeo_tk (vpControlScheduler and its
+  derived classes, vpCartesianDisplacement), so that they run either on the robot through
+  vpNaoqiRobotBackend or on a vpSimulatedRobot.
+ */
+class vpRobotBackend
+{
+public:
+  virtual ~vpRobotBackend() {}
+
+  //! Joint names of a chain ("Head", "LArm", "RArm", "LEye", "REye") or name of a single joint.
+  virtual std::vector<std::string> getBodyNames(const std::string &names) const = 0;
+  //! Jacobian of the chain expressed in its end-effector frame.
+  virtual vpMatrix get_eJe(const std::string &chain_name) const = 0;
+  //! Same as get_eJe(chain_name), in \e eJe that is only resized if the number of joints changes.
+  virtual void get_eJe(const std::string &chain_name, vpMatrix &eJe) const {eJe = get_eJe(chain_name);}
+  virtual vpColVector getPosition(const std::vector<std::string> &names) const = 0;
+  virtual void setVelocity(const std::vector<std::string> &names, const vpColVector &q_dot) = 0;
+  virtual void stop(const std::vector<std::string> &names) = 0;
+};
+
+/*!
+  vpRobotBackend of a real robot. The vpNaoqiRobot has to be opened and to outlive the backend.
+ */
+class vpNaoqiRobotBackend : public vpRobotBackend
+{
+protected:
+  vpNaoqiRobot &m_robot;
+
+public:
+  vpNaoqiRobotBackend(vpNaoqiRobot &robot) : m_robot(robot) {}
+
+  vpNaoqiRobot &getRobot() {return m_robot;}
+
+  virtual std::vector<std::string> getBodyNames(const std::string &names) const {return m_robot.getBodyNames(names);}
+  virtual vpMatrix get_eJe(const std::string &chain_name) const {return m_robot.get_eJe(chain_name);}
+  virtual void get_eJe(const std::string &chain_name, vpMatrix &eJe) const {eJe = m_robot.get_eJe(chain_name);}
+  virtual vpColVector getPosition(const std::vector<std::string> &names) const {return m_robot.getPosition(names);}
+  virtual void setVelocity(const std::vector<std::string> &names, const vpColVector &q_dot) {m_robot.setVelocity(names, q_dot);}
+  virtual void stop(const std::vector<std::string> &names) {m_robot.stop(names);}
+};
+
+#endif
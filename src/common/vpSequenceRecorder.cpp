@@ -0,0 +1,135 @@
+#include <stdint.h>
+
+#include <visp/vpException.h>
+
+#include <vpSequenceRecorder.h>
+
+
+vpSequenceRecorder::vpSequenceRecorder()
+  : m_file(), m_width(0), m_height(0), m_channels(0), m_joint_names(), m_nb_frames(0)
+{
+}
+
+vpSequenceRecorder::~vpSequenceRecorder()
+{
+  close();
+}
+
+void vpSequenceRecorder::close()
+{
+  if (m_file.is_open())
+    m_file.close();
+}
+
+/*!
+  Create the sequence file and write its header. The joint names have to be set before with setJointNames().
+  \param filename : Name of the file.
+  \param width, height : Image size.
+  \param channels : 1 to record gray images, 3 to record BGR images.
+  \param cam : Camera parameters (with their distortion coefficients).
+  \param eMc : Extrinsic camera parameters, used with and without distortion.
+ */
+void vpSequenceRecorder::open(const std::string &filename, unsigned int width, unsigned int height, unsigned int channels,
+                              const vpCameraParameters &cam, const vpHomogeneousMatrix &eMc)
+{
+  open(filename, width, height, channels, cam, eMc, eMc);
+}
+
+/*!
+  Create the sequence file and write its header. The joint names have to be set before with setJointNames().
+  \param filename : Name of the file.
+  \param width, height : Image size.
+  \param channels : 1 to record gray images, 3 to record BGR images.
+  \param cam : Camera parameters (with their distortion coefficients).
+  \param eMc : Extrinsic camera parameters of the model without distortion.
+  \param eMc_dist : Extrinsic camera parameters of the model with distortion.
+ */
+void vpSequenceRecorder::open(const std::string &filename, unsigned int width, unsigned int height, unsigned int channels,
+                              const vpCameraParameters &cam, const vpHomogeneousMatrix &eMc, const vpHomogeneousMatrix &eMc_dist)
+{
+  if (channels != 1 && channels != 3)
+    throw vpException(vpException::badValue, "Cannot record images with %d channels", channels);
+
+  close();
+  m_file.open(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (! m_file.is_open())
+    throw vpException(vpException::ioError, "Cannot create sequence file: %s", filename.c_str());
+
+  m_width = width;
+  m_height = height;
+  m_channels = channels;
+  m_nb_frames = 0;
+
+  uint32_t header[5] = {version, width, height, channels, (uint32_t)m_joint_names.size()};
+  double intrinsic[6] = {cam.get_px(), cam.get_py(), cam.get_u0(), cam.get_v0(), cam.get_kud(), cam.get_kdu()};
+  double extrinsic[24];
+  for (unsigned int i=0; i < 3; i++) {
+    for (unsigned int j=0; j < 4; j++) {
+      extrinsic[4*i+j] = eMc[i][j];
+      extrinsic[12+4*i+j] = eMc_dist[i][j];
+    }
+  }
+
+  m_file.write("RTKSEQ", 6);
+  m_file.write((const char *)header, 4*sizeof(uint32_t));
+  m_file.write((const char *)intrinsic, sizeof(intrinsic));
+  m_file.write((const char *)extrinsic, sizeof(extrinsic));
+  m_file.write((const char *)&header[4], sizeof(uint32_t));
+  for (size_t i=0; i < m_joint_names.size(); i++) {
+    uint32_t length = (uint32_t)m_joint_names[i].size();
+    m_file.write((const char *)&length, sizeof(uint32_t));
+    m_file.write(m_joint_names[i].c_str(), length);
+  }
+  if (! m_file.good())
+    throw vpException(vpException::ioError, "Cannot write sequence file header: %s", filename.c_str());
+}
+
+/*!
+  Record a gray image. The sequence has to be opened with 1 channel.
+  \param I : Image.
+  \param timestamp : Capture time of the image in seconds.
+  \param q : Joint positions at capture time, of the size of the joint names.
+ */
+void vpSequenceRecorder::record(const vpImage<unsigned char> &I, double timestamp, const vpColVector &q)
+{
+  if (m_channels != 1 || I.getWidth() != m_width || I.getHeight() != m_height)
+    throw vpException(vpException::dimensionError, "Image does not match the recorded sequence format");
+
+  writeRecord(I.bitmap, m_width, timestamp, q);
+}
+
+/*!
+  Record a gray (CV_8UC1) or BGR (CV_8UC3) image. The number of channels has to match the one of the sequence.
+  \param I : Image.
+  \param timestamp : Capture time of the image in seconds.
+  \param q : Joint positions at capture time, of the size of the joint names.
+ */
+void vpSequenceRecorder::record(const cv::Mat &I, double timestamp, const vpColVector &q)
+{
+  if (I.depth() != CV_8U || (unsigned int)I.channels() != m_channels
+      || (unsigned int)I.cols != m_width || (unsigned int)I.rows != m_height)
+    throw vpException(vpException::dimensionError, "Image does not match the recorded sequence format");
+
+  writeRecord(I.data, (unsigned int)I.step, timestamp, q);
+}
+
+void vpSequenceRecorder::writeRecord(const unsigned char *bitmap, unsigned int step, double timestamp, const vpColVector &q)
+{
+  if (! m_file.is_open())
+    throw vpException(vpException::notInitialized, "Sequence file is not opened");
+  if (q.getRows() != m_joint_names.size() && q.getRows() != 0)
+    throw vpException(vpException::dimensionError, "Joint positions do not match the joint names");
+
+  m_file.write((const char *)&timestamp, sizeof(double));
+  for (size_t i=0; i < m_joint_names.size(); i++) {
+    double qi = (q.getRows() != 0) ? q[(unsigned int)i] : 0.;
+    m_file.write((const char *)&qi, sizeof(double));
+  }
+  unsigned int row_size = m_width * m_channels;
+  for (unsigned int i=0; i < m_height; i++)
+    m_file.write((const char *)(bitmap + i*step), row_size);
+
+  if (! m_file.good())
+    throw vpException(vpException::ioError, "Cannot write frame %d of the sequence", m_nb_frames);
+  m_nb_frames ++;
+}
@@ -0,0 +1,78 @@
+#ifndef __vpSequenceRecorder_h__
+#define __vpSequenceRecorder_h__
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+#include <visp/vpCameraParameters.h>
+#include <visp/vpColVector.h>
+#include <visp/vpHomogeneousMatrix.h>
+#include <visp/vpImage.h>
+
+/*!
+  Record a camera sequence in a single binary file that can be replayed with vpReplayGrabber.
+
+  The file starts with a header:
+  - "RTKSEQ" followed by the format version (uint32);
+  - image width, height and number of channels (uint32, 1 for gray images, 3 for BGR images);
+  - camera parameters px, py, u0, v0, kud, kdu (double);
+  - eMc without and with distortion, 3 x 4 row-major (double);
+  - number of joints (uint32) and for each joint its name (uint32 length followed by the characters).
+
+  It is followed by one fixed size record per frame: capture timestamp in seconds (double), joint positions
+  (double) and raw pixels (row-major, BGR order for color images). Values are written in the native byte order.
+
+  \code
+  vpSequenceRecorder recorder;
+  recorder.setJointNames(robot.getBodyNames("Head"));
+  recorder.open("sequence.bin", g.getWidth(), g.getHeight(), 1, g.getCameraParameters(vpCameraParameters::perspectiveProjWithDistortion),
+                g.get_eMc(vpCameraParameters::perspectiveProjWithoutDistortion), g.get_eMc(vpCameraParameters::perspectiveProjWithDistortion));
+  while (...) {
+    g.acquire(I);
+    recorder.record(I, vpTime::measureTimeSecond(), robot.getPosition(recorder.getJointNames()));
+  }
+  recorder.close();
+  \endcode
+ */
+class vpSequenceRecorder
+{
+public:
+  static const unsigned int version = 1;
+
+protected:
+  std::ofstream m_file;
+  unsigned int m_width;
+  unsigned int m_height;
+  unsigned int m_channels;
+  std::vector<std::string> m_joint_names;
+  unsigned int m_nb_frames;
+
+public:
+  vpSequenceRecorder();
+  virtual ~vpSequenceRecorder();
+
+  void close();
+
+  std::vector<std::string> getJointNames() const {return m_joint_names;}
+  unsigned int getNbFrames() const {return m_nb_frames;}
+
+  bool isOpened() const {return m_file.is_open();}
+
+  void open(const std::string &filename, unsigned int width, unsigned int height, unsigned int channels,
+            const vpCameraParameters &cam, const vpHomogeneousMatrix &eMc);
+  void open(const std::string &filename, unsigned int width, unsigned int height, unsigned int channels,
+            const vpCameraParameters &cam, const vpHomogeneousMatrix &eMc, const vpHomogeneousMatrix &eMc_dist);
+
+  void record(const vpImage<unsigned char> &I, double timestamp, const vpColVector &q=vpColVector());
+  void record(const cv::Mat &I, double timestamp, const vpColVector &q=vpColVector());
+
+  void setJointNames(const std::vector<std::string> &joint_names) {m_joint_names = joint_names;}
+
+protected:
+  void writeRecord(const unsigned char *bitmap, unsigned int step, double timestamp, const vpColVector &q);
+};
+
+#endif
@@ -1,9 +1,59 @@
+#include <algorithm>
+
 #include <vpServoArm.h>
+#include <vpThetaU.h>
+
+
+/*!
+  Compute Mv = M exp(v) like M * vpExponentialMap::direct(v) does, without allocating any temporary.
+ */
+static void applyDisplacement(const vpHomogeneousMatrix &M, const double v[6], vpHomogeneousMatrix &Mv)
+{
+  const double *u = v + 3;
+  double theta = sqrt(u[0]*u[0] + u[1]*u[1] + u[2]*u[2]);
+  double si = sin(theta);
+  double co = cos(theta);
+  double sinc = vpMath::sinc(si, theta);
+  double mcosc = vpMath::mcosc(co, theta);
+  double msinc = vpMath::msinc(si, theta);
+
+  // dR = I + sinc [u]x + mcosc [u]x^2 and dt = (I + mcosc [u]x + msinc [u]x^2) v
+  double ux[3][3] = { {     0, -u[2],  u[1] },
+                      {  u[2],     0, -u[0] },
+                      { -u[1],  u[0],     0 } };
+  double dR[3][3], V[3][3];
+  for (unsigned int i=0; i < 3; i++) {
+    for (unsigned int j=0; j < 3; j++) {
+      double ux2 = u[i]*u[j] - (i == j ? theta*theta : 0.);
+      double I_ij = (i == j) ? 1. : 0.;
+      dR[i][j] = I_ij + sinc * ux[i][j] + mcosc * ux2;
+      V[i][j] = I_ij + mcosc * ux[i][j] + msinc * ux2;
+    }
+  }
+  double dt[3];
+  for (unsigned int i=0; i < 3; i++)
+    dt[i] = V[i][0]*v[0] + V[i][1]*v[1] + V[i][2]*v[2];
 
+  for (unsigned int i=0; i < 3; i++) {
+    for (unsigned int j=0; j < 3; j++)
+      Mv[i][j] = M[i][0]*dR[0][j] + M[i][1]*dR[1][j] + M[i][2]*dR[2][j];
+    Mv[i][3] = M[i][0]*dt[0] + M[i][1]*dt[1] + M[i][2]*dt[2] + M[i][3];
+  }
+}
 
 vpServoArm::vpServoArm(vpServoArmType n) : m_t(), m_tu(), m_axis(3),
-  m_lambda(0.1), m_type(n)
+  m_lambda(0.1), m_type(n), m_realtime(false), m_rt_dim(n == vpServoArm::vs5dof_cyl ? 5 : 6),
+  m_rt_eJe(), m_rt_J(), m_rt_e(), m_rt_e1(), m_rt_e1_initial(), m_rt_q_dot(), m_rt_servo_time_init(-1),
+  m_rt_use_adaptive_gain(false), m_rt_lambda(), m_rt_solver(), m_history(NULL), m_lc_dq(), m_lc_cdMc(),
+  m_timestamp(0)
 {
+  for (unsigned int i=0; i < 6; i++) {
+    m_rt_s[i] = 0;
+    for (unsigned int j=0; j < 6; j++) {
+      m_rt_L[i][j] = 0;
+      m_rt_LcVe[i][j] = 0;
+    }
+  }
 
   if (m_type == vpServoArm::vs6dof)
   {
@@ -56,8 +106,65 @@ vpServoArm::vpServoArm(vpServoArmType n) : m_t(), m_tu(), m_axis(3),
 
 }
 
+void vpServoArm::setCurrentFeature(const vpHomogeneousMatrix &cdMc)
+{
+  if (m_realtime) {
+    setRealTimeTranslation(cdMc);
+    if (m_type == vpServoArm::vs6dof_cyl)
+      return;
+
+    // Theta u feature (cdRc) and its interaction matrix [0_3 Lw] with
+    // Lw = I + theta/2 [u]x + (1 - sinc(theta)/sinc^2(theta/2)) [u]x^2
+    double tu[3];
+    vpThetaU::compute(cdMc, tu);
+    double theta = sqrt(tu[0]*tu[0] + tu[1]*tu[1] + tu[2]*tu[2]);
+    double u[3] = {0, 0, 0};
+    double k = 0;
+    if (theta >= 1e-6) {
+      for (unsigned int i=0; i < 3; i++)
+        u[i] = tu[i] / theta;
+      double sinc_2 = vpMath::sinc(theta / 2.0);
+      k = 1 - vpMath::sinc(theta) / (sinc_2 * sinc_2);
+    }
+    double half_tu_x[3][3] = { {       0, -tu[2]/2,  tu[1]/2 },
+                               {  tu[2]/2,       0, -tu[0]/2 },
+                               { -tu[1]/2,  tu[0]/2,       0 } };
+    unsigned int nb_rows = (m_type == vpServoArm::vs5dof_cyl) ? 2 : 3;
+    for (unsigned int i=0; i < nb_rows; i++) {
+      m_rt_s[3+i] = tu[i];
+      for (unsigned int j=0; j < 3; j++) {
+        // [u]x^2 = u u^T - I since ||u|| = 1
+        double u2 = (theta >= 1e-6) ? u[i]*u[j] - (i == j ? 1. : 0.) : 0.;
+        m_rt_L[3+i][j] = 0;
+        m_rt_L[3+i][3+j] = (i == j ? 1. : 0.) + half_tu_x[i][j] + k * u2;
+      }
+    }
+    return;
+  }
+
+  m_t.buildFrom(cdMc) ;
+  m_tu.buildFrom(cdMc) ;
+}
+
 void vpServoArm::setCurrentFeature(const vpHomogeneousMatrix &cdMc, const vpColVector &z_c, const vpColVector &z_d)
 {
+  if (m_realtime) {
+    setRealTimeTranslation(cdMc);
+    // Axis alignment feature e = z_c x z_d with the interaction matrix [0_3 [z_d]x [z_c]x]
+    m_rt_s[3] = z_c[1]*z_d[2] - z_c[2]*z_d[1];
+    m_rt_s[4] = z_c[2]*z_d[0] - z_c[0]*z_d[2];
+    m_rt_s[5] = z_c[0]*z_d[1] - z_c[1]*z_d[0];
+    double dot = z_c[0]*z_d[0] + z_c[1]*z_d[1] + z_c[2]*z_d[2];
+    for (unsigned int i=0; i < 3; i++) {
+      for (unsigned int j=0; j < 3; j++) {
+        // [a]x [b]x = b a^T - (a.b) I
+        m_rt_L[3+i][j] = 0;
+        m_rt_L[3+i][3+j] = z_c[i]*z_d[j] - (i == j ? dot : 0.);
+      }
+    }
+    return;
+  }
+
   m_t.buildFrom(cdMc) ;
   vpColVector e;
   e = vpColVector::crossProd(z_c,z_d);
@@ -73,3 +180,218 @@ void vpServoArm::setCurrentFeature(const vpHomogeneousMatrix &cdMc, const vpColV
   m_axis.setInteractionMatrix(Ls);
 
 }
+
+/*!
+  Translation feature (cdMc) and its interaction matrix [cdRc 0_3] used in real-time mode.
+ */
+void vpServoArm::setRealTimeTranslation(const vpHomogeneousMatrix &cdMc)
+{
+  for (unsigned int i=0; i < 3; i++) {
+    m_rt_s[i] = cdMc[i][3];
+    for (unsigned int j=0; j < 3; j++) {
+      m_rt_L[i][j] = cdMc[i][j];
+      m_rt_L[i][3+j] = 0;
+    }
+  }
+}
+
+/*!
+  Set the twist matrix of the task. It is stored in m_task in both modes, so that calling
+  m_task.set_cVe() directly is equivalent.
+ */
+void vpServoArm::set_cVe(const vpVelocityTwistMatrix &cVe)
+{
+  m_task.set_cVe(cVe);
+}
+
+void vpServoArm::set_eJe(const vpMatrix &eJe)
+{
+  if (eJe.getRows() != m_rt_eJe.getRows() || eJe.getCols() != m_rt_eJe.getCols()) {
+    // Only allocates when the number of joints changes
+    if (m_realtime)
+      setRealTime(true, eJe.getCols());
+    else
+      m_rt_eJe.resize(eJe.getRows(), eJe.getCols(), false);
+  }
+
+  // eJe is kept also in the default mode for the latency compensation
+  for (unsigned int i=0; i < 6; i++)
+    for (unsigned int j=0; j < eJe.getCols(); j++)
+      m_rt_eJe[i][j] = eJe[i][j];
+
+  if (! m_realtime)
+    m_task.set_eJe(eJe);
+}
+
+/*!
+  Set the current pose measured in an image captured at \e timestamp.
+
+  If a joint history was set with setLatencyCompensation(), the pose is advanced by the
+  motion of the joints since the capture: cdMc exp(cVe eJe dq) where dq is the joint displacement
+  between \e timestamp and the last sample of the history. cVe and eJe have to be set before with
+  vpServoArm::set_cVe() and vpServoArm::set_eJe(). The compensated pose is available with getCompensatedPose().
+
+  \param cdMc : Measured pose.
+  \param timestamp : Capture time in s of the image used to measure the pose, in the time base of the joint history.
+ */
+void vpServoArm::setCurrentFeature(const vpHomogeneousMatrix &cdMc, double timestamp)
+{
+  m_timestamp = timestamp;
+
+  if (m_history == NULL || ! m_history->getDisplacement(timestamp, m_lc_dq) || m_lc_dq.getRows() != m_rt_eJe.getCols()) {
+    m_lc_cdMc = cdMc;
+  }
+  else {
+    // Displacement of the feature frame v = cVe eJe dq
+    double eJe_dq[6], v[6];
+    for (unsigned int i=0; i < 6; i++) {
+      double sum = 0;
+      for (unsigned int j=0; j < m_lc_dq.getRows(); j++)
+        sum += m_rt_eJe[i][j] * m_lc_dq[j];
+      eJe_dq[i] = sum;
+    }
+    for (unsigned int i=0; i < 6; i++) {
+      double sum = 0;
+      for (unsigned int j=0; j < 6; j++)
+        sum += m_task.cVe[i][j] * eJe_dq[j];
+      v[i] = sum;
+    }
+    applyDisplacement(cdMc, v, m_lc_cdMc);
+  }
+
+  setCurrentFeature(m_lc_cdMc);
+}
+
+void vpServoArm::setLambda(double lambda)
+{
+  m_lambda = lambda;
+  m_rt_use_adaptive_gain = false;
+  m_task.setLambda(lambda);
+}
+
+void vpServoArm::setLambda(const vpAdaptiveGain &lambda)
+{
+  m_rt_lambda = lambda;
+  m_rt_use_adaptive_gain = true;
+  m_task.setLambda(lambda);
+}
+
+/*!
+  Enable or disable the real-time mode.
+
+  In real-time mode the task is no more computed by m_task but in workspaces allocated here, so that
+  setCurrentFeature(), set_cVe(), set_eJe() and computeControlLaw(vpColVector &) never print nor
+  allocate memory, and run in a bounded time (no iterative SVD, the pseudo-inverse is replaced by
+  a damped least-squares solution through a Cholesky factorization of the at most 6x6 matrix J1 J1^T).
+  The interaction matrix is the current one and J1 = -L cVe eJe, like the vpServo::EYETOHAND_L_cVe_eJe
+  task used in the default mode.
+
+  The twist matrix is read from m_task in both modes, so it can be set either with set_cVe() or
+  m_task.set_cVe().
+
+  \param realtime : true to enable the real-time mode.
+  \param nb_joints : Number of joints of the chain (number of columns of eJe).
+ */
+void vpServoArm::setRealTime(bool realtime, unsigned int nb_joints)
+{
+  m_realtime = realtime;
+  if (! m_realtime)
+    return;
+
+  m_rt_eJe.resize(6, nb_joints);
+  m_rt_J.resize(m_rt_dim, nb_joints);
+  m_rt_e.resize(m_rt_dim);
+  m_rt_e1.resize(nb_joints);
+  m_rt_e1_initial.resize(nb_joints);
+  m_rt_q_dot.resize(nb_joints);
+  m_rt_servo_time_init = -1;
+}
+
+/*!
+  Update the task error and the task Jacobian J1 = -L cVe eJe in real-time mode.
+ */
+void vpServoArm::computeRealTimeTask()
+{
+  // With vs5dof_cyl the ThetaUx and ThetaUy rows are stored in rows 3 and 4, so the
+  // task always uses the m_rt_dim first rows
+  unsigned int n = m_rt_eJe.getCols();
+
+  for (unsigned int i=0; i < m_rt_dim; i++) {
+    m_rt_e[i] = m_rt_s[i];
+    for (unsigned int j=0; j < 6; j++) {
+      double sum = 0;
+      for (unsigned int k=0; k < 6; k++)
+        sum += m_rt_L[i][k] * m_task.cVe[k][j];
+      m_rt_LcVe[i][j] = sum;
+    }
+    for (unsigned int j=0; j < n; j++) {
+      double sum = 0;
+      for (unsigned int k=0; k < 6; k++)
+        sum += m_rt_LcVe[i][k] * m_rt_eJe[k][j];
+      m_rt_J[i][j] = -sum;
+    }
+  }
+}
+
+/*!
+  Gain applied to e1 = J1^+ e in real-time mode.
+ */
+double vpServoArm::computeRealTimeGain() const
+{
+  if (! m_rt_use_adaptive_gain)
+    return m_lambda;
+
+  double norm = 0;
+  for (unsigned int k=0; k < m_rt_e1.getRows(); k++)
+    norm = std::max(norm, fabs(m_rt_e1[k]));
+  return m_rt_lambda.value(norm);
+}
+
+/*!
+  Compute the joint velocities without allocating memory when the real-time mode is enabled.
+  \param q_dot : Joint velocities. Should be preallocated with the number of joints.
+ */
+void vpServoArm::computeControlLaw(vpColVector &q_dot)
+{
+  if (! m_realtime) {
+    q_dot = m_task.computeControlLaw();
+    return;
+  }
+
+  computeRealTimeTask();
+  m_rt_solver.solve(m_rt_J, m_rt_e, m_rt_e1);
+
+  double lambda = computeRealTimeGain();
+
+  if (q_dot.getRows() != m_rt_e1.getRows())
+    q_dot.resize(m_rt_e1.getRows(), false);
+  for (unsigned int k=0; k < m_rt_e1.getRows(); k++)
+    q_dot[k] = -lambda * m_rt_e1[k];
+}
+
+/*!
+  Compute the joint velocities with a continuous sequencing without allocating memory when the real-time
+  mode is enabled. In real-time mode the initial task is memorized each time \e servo_time_init changes.
+  \param servo_time_init : Time in second when the servo started.
+  \param q_dot : Joint velocities. Should be preallocated with the number of joints.
+ */
+void vpServoArm::computeControlLaw(double servo_time_init, vpColVector &q_dot)
+{
+  if (! m_realtime) {
+    q_dot = computeControlLaw(servo_time_init);
+    return;
+  }
+
+  computeControlLaw(q_dot);
+  if (servo_time_init != m_rt_servo_time_init) {
+    for (unsigned int k=0; k < m_rt_e1.getRows(); k++)
+      m_rt_e1_initial[k] = m_rt_e1[k];
+    m_rt_servo_time_init = servo_time_init;
+  }
+
+  double lambda = computeRealTimeGain();
+  double mu = 4.; // Same value than vpServo
+  double decay = lambda * exp(-mu * (vpTime::measureTimeSecond() - servo_time_init));
+  for (unsigned int k=0; k < m_rt_e1.getRows(); k++)
+    q_dot[k] += decay * m_rt_e1_initial[k];
+}
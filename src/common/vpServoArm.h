@@ -1,6 +1,7 @@
 #ifndef __vpServoArm_h__
 #define __vpServoArm_h__
 
+#include <visp/vpAdaptiveGain.h>
 #include <visp/vpCameraParameters.h>
 #include <visp/vpImagePoint.h>
 #include <visp/vpFeatureThetaU.h>
@@ -9,6 +10,9 @@
 #include <visp/vpServoDisplay.h>
 #include <visp/vpGenericFeature.h>
 
+#include <vpDampedLeastSquares.h>
+#include <vpJointHistory.h>
+
 class vpServoArm
 {
 public:
@@ -38,6 +42,29 @@ protected:
   double m_lambda;
   vpServoArmType m_type;
 
+  // Real-time mode: the task is computed in preallocated workspaces instead of m_task
+  bool m_realtime;
+  unsigned int m_rt_dim;          // Task dimension (5 or 6)
+  double m_rt_s[6];               // Current features (the desired ones are null)
+  double m_rt_L[6][6];            // Interaction matrix
+  double m_rt_LcVe[6][6];
+  vpMatrix m_rt_eJe;
+  vpMatrix m_rt_J;                // Task Jacobian J1 = -L cVe eJe
+  vpColVector m_rt_e;             // Task error
+  vpColVector m_rt_e1;            // J1^+ e
+  vpColVector m_rt_e1_initial;    // J1^+ e at the beginning of a continuous sequencing
+  vpColVector m_rt_q_dot;
+  double m_rt_servo_time_init;
+  bool m_rt_use_adaptive_gain;
+  vpAdaptiveGain m_rt_lambda;
+  vpDampedLeastSquares m_rt_solver;
+
+  // Latency compensation
+  vpJointHistory *m_history;
+  vpColVector m_lc_dq;            // Joint displacement since the capture of the measure
+  vpHomogeneousMatrix m_lc_cdMc;  // Measure advanced to the current joint positions
+  double m_timestamp;             // Capture time of the current feature
+
 public:
 
   vpServoArm(vpServoArmType n = vpServoArm::vs6dof);
@@ -47,32 +74,48 @@ public:
 
   vpColVector computeControlLaw()
   {
+    if (m_realtime) {
+      computeControlLaw(m_rt_q_dot);
+      return m_rt_q_dot;
+    }
     m_task.print();
     return ( m_task.computeControlLaw() );
   }
   vpColVector computeControlLaw(double servo_time_init)
   {
+    if (m_realtime) {
+      computeControlLaw(servo_time_init, m_rt_q_dot);
+      return m_rt_q_dot;
+    }
     return ( m_task.computeControlLaw(vpTime::measureTimeSecond() - servo_time_init) );
   }
-  vpMatrix getTaskJacobian() {return m_task.getTaskJacobian();}
+  void computeControlLaw(vpColVector &q_dot);
+  void computeControlLaw(double servo_time_init, vpColVector &q_dot);
+  vpMatrix getTaskJacobian() {return m_realtime ? m_rt_J : m_task.getTaskJacobian();}
   vpMatrix getTaskJacobianPseudoInverse() {return m_task.getTaskJacobianPseudoInverse();}
   vpServoArm::vpServoArmType getServoArmType(){return m_type;}
 
-  vpColVector getError(){return m_task.getError();}
+  const vpHomogeneousMatrix &getCompensatedPose() const {return m_lc_cdMc;}
+  vpColVector getError(){return m_realtime ? m_rt_e : m_task.getError();}
+  bool getRealTime() const {return m_realtime;}
+  double getTimestamp() const {return m_timestamp;}
 
-  void set_eJe(const vpMatrix &eJe) { m_task.set_eJe(eJe);}
+  void set_cVe(const vpVelocityTwistMatrix &cVe);
+  void set_eJe(const vpMatrix &eJe);
   void set_cVf(const vpVelocityTwistMatrix &cVf) { m_task.set_cVf(cVf);}
   void set_fVe(const vpVelocityTwistMatrix &fVe) { m_task.set_fVe(fVe);}
-  void setCurrentFeature(const vpHomogeneousMatrix &cdMc)
-  {
-    m_t.buildFrom(cdMc) ;
-    m_tu.buildFrom(cdMc) ;
-  }
+  void setCurrentFeature(const vpHomogeneousMatrix &cdMc);
+  void setCurrentFeature(const vpHomogeneousMatrix &cdMc, double timestamp);
   void setCurrentFeature(const vpHomogeneousMatrix &cdMc, const vpColVector &z_c, const vpColVector &z_d);
-  void setLambda(double lambda) {m_task.setLambda(lambda);}
-  void setLambda(const vpAdaptiveGain &lambda) {m_task.setLambda(lambda);}
+  void setLambda(double lambda);
+  void setLambda(const vpAdaptiveGain &lambda);
+  void setLatencyCompensation(vpJointHistory *history) {m_history = history;}
+  void setRealTime(bool realtime, unsigned int nb_joints=7);
 
+protected:
+  double computeRealTimeGain() const;
+  void computeRealTimeTask();
+  void setRealTimeTranslation(const vpHomogeneousMatrix &cdMc);
 };
 
 #endif
-
@@ -0,0 +1,105 @@
+#include <vpServoArmScheduler.h>
+
+
+vpServoArmScheduler::vpServoArmScheduler(vpNaoqiRobot &robot, vpServoArm &servo, const std::string &chain_name,
+                                         const std::vector<std::string> &joint_names, double rate)
+  : vpControlScheduler(robot, chain_name, joint_names, rate), m_servo(servo),
+    m_cdMc_published(), m_pose_timestamp_published(0), m_new_pose(false), m_cVe_published(), m_servo_reset(true),
+    m_cdMc_ref(), m_pose_timestamp(0), m_pose_available(false), m_cdMc(), m_cVe(), m_servo_time_init(0)
+{
+  m_servo.setLatencyCompensation(&m_history);
+}
+
+vpServoArmScheduler::vpServoArmScheduler(vpRobotBackend &robot, vpServoArm &servo, const std::string &chain_name,
+                                         const std::vector<std::string> &joint_names, double rate)
+  : vpControlScheduler(robot, chain_name, joint_names, rate), m_servo(servo),
+    m_cdMc_published(), m_pose_timestamp_published(0), m_new_pose(false), m_cVe_published(), m_servo_reset(true),
+    m_cdMc_ref(), m_pose_timestamp(0), m_pose_available(false), m_cdMc(), m_cVe(), m_servo_time_init(0)
+{
+  m_servo.setLatencyCompensation(&m_history);
+}
+
+vpServoArmScheduler::~vpServoArmScheduler()
+{
+  stop();
+  m_servo.setLatencyCompensation(NULL);
+}
+
+/*!
+  Return the pose used by the last control iteration.
+ */
+vpHomogeneousMatrix vpServoArmScheduler::getExtrapolatedPose()
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  return m_cdMc;
+}
+
+/*!
+  Publish a new measure of the pose. Can be called from any thread.
+  \param cdMc : Measured pose.
+  \param timestamp : Time in s (vpTime::measureTimeSecond()) of the acquisition of the image used to measure the pose.
+ */
+void vpServoArmScheduler::publishPose(const vpHomogeneousMatrix &cdMc, double timestamp)
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  m_cdMc_published = cdMc;
+  m_pose_timestamp_published = timestamp;
+  m_new_pose = true;
+}
+
+/*!
+  Restart the continuous sequencing of the control law at the next iteration.
+ */
+void vpServoArmScheduler::resetServo()
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  m_servo_reset = true;
+}
+
+/*!
+  Set the twist matrix between the frame of the pose and the end-effector. Can be called from any thread.
+ */
+void vpServoArmScheduler::set_cVe(const vpVelocityTwistMatrix &cVe)
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  m_cVe_published = cVe;
+}
+
+bool vpServoArmScheduler::computeVelocity(double t, const vpColVector &q, vpColVector &q_dot)
+{
+  bool servo_reset = false;
+  {
+    vpMutex::vpScopedLock lock(m_mutex);
+    if (m_new_pose) {
+      m_cdMc_ref = m_cdMc_published;
+      m_pose_timestamp = m_pose_timestamp_published;
+      m_new_pose = false;
+      m_pose_available = true;
+    }
+    m_cVe = m_cVe_published;
+    servo_reset = m_servo_reset;
+    m_servo_reset = false;
+  }
+
+  if (! m_pose_available || t - m_pose_timestamp > m_timeout) {
+    // Lost target: the continuous sequencing restarts when a new pose is available
+    m_servo_time_init = 0;
+    return false;
+  }
+
+  const vpMatrix &eJe = get_eJe();
+
+  if (servo_reset || m_servo_time_init == 0)
+    m_servo_time_init = t;
+
+  m_servo.set_eJe(eJe);
+  m_servo.set_cVe(m_cVe);
+  m_servo.setCurrentFeature(m_cdMc_ref, m_pose_timestamp); // Extrapolated with the joint history
+  m_servo.computeControlLaw(m_servo_time_init, q_dot);
+  for (unsigned int i=0; i < q_dot.getRows(); i++)
+    q_dot[i] = -q_dot[i];
+
+  vpMutex::vpScopedLock lock(m_mutex);
+  m_cdMc = m_servo.getCompensatedPose();
+  return true;
+}
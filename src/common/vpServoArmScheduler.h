@@ -0,0 +1,59 @@
+#ifndef __vpServoArmScheduler_h__
+#define __vpServoArmScheduler_h__
+
+#include <visp/vpHomogeneousMatrix.h>
+#include <visp/vpVelocityTwistMatrix.h>
+
+#include <vpControlScheduler.h>
+#include <vpServoArm.h>
+
+/*!
+  Run a vpServoArm control law at a fixed rate on the last pose published by the perception.
+
+  The pose cdMc (same convention as vpServoArm::setCurrentFeature(), for example cdMo.inverse() * cMo
+  where o is the target attached to the hand) is extrapolated between two frames with the displacement
+  of the joints since the image was acquired, using the latency compensation of vpServoArm:
+
+  cdMc(t) = cdMc(t_k) exp(cVe eJe (q(t) - q(t_k)))
+
+  The velocities sent to the robot are -vpServoArm::computeControlLaw(servo_time_init), like in the demos.
+  Enable the real-time mode of the servo to avoid allocations and prints in the control thread.
+ */
+class vpServoArmScheduler : public vpControlScheduler
+{
+protected:
+  vpServoArm &m_servo;
+
+  // Shared with the publishers
+  vpHomogeneousMatrix m_cdMc_published;
+  double m_pose_timestamp_published;
+  bool m_new_pose;
+  vpVelocityTwistMatrix m_cVe_published;
+  bool m_servo_reset;
+
+  // Used only by the control thread
+  vpHomogeneousMatrix m_cdMc_ref;   // Last measured pose
+  double m_pose_timestamp;          // Acquisition time of the last measured pose
+  bool m_pose_available;
+  vpHomogeneousMatrix m_cdMc;       // Extrapolated pose
+  vpVelocityTwistMatrix m_cVe;
+  double m_servo_time_init;
+
+public:
+  vpServoArmScheduler(vpNaoqiRobot &robot, vpServoArm &servo, const std::string &chain_name,
+                      const std::vector<std::string> &joint_names, double rate=100.);
+  vpServoArmScheduler(vpRobotBackend &robot, vpServoArm &servo, const std::string &chain_name,
+                      const std::vector<std::string> &joint_names, double rate=100.);
+  virtual ~vpServoArmScheduler();
+
+  vpHomogeneousMatrix getExtrapolatedPose();
+
+  void publishPose(const vpHomogeneousMatrix &cdMc, double timestamp);
+  void resetServo();
+  void set_cVe(const vpVelocityTwistMatrix &cVe);
+
+protected:
+  virtual bool computeVelocity(double t, const vpColVector &q, vpColVector &q_dot);
+};
+
+#endif
@@ -1,10 +1,18 @@
 
+#include <algorithm>
+
+#include <visp/vpMeterPixelConversion.h>
+
 #include <vpServoHead.h>
 
 
 vpServoHead::vpServoHead(): m_xd(0), m_yd(0), m_Zd(0.8), m_x(0), m_y(0), m_Z(0.8),
-  m_cam()
+  m_cam(), m_lambda(0.2), m_realtime(false), m_rt_eJe(), m_rt_J(), m_rt_e(), m_rt_e1(), m_rt_e1_initial(),
+  m_rt_q_dot(), m_rt_servo_time_init(-1), m_rt_use_adaptive_gain(false), m_rt_lambda(), m_rt_solver(),
+  m_history(NULL), m_lc_dq(), m_timestamp(0)
 {
+  updateRealTimeInteractionMatrix();
+
   //Set the point feature thanks to the current parameters.
   m_s.buildFrom(m_x, m_y, m_Z);
 
@@ -23,5 +31,247 @@ vpServoHead::vpServoHead(): m_xd(0), m_yd(0), m_Zd(0.8), m_x(0), m_y(0), m_Z(0.8
 
   //vpAdaptiveGain lambda_head(2, 0.1, 30); // lambda(0)=2, lambda(oo)=0.1 and lambda_dot(0)=10
   //tm_ask_head.setLambda(lambda_head);
-  m_task_head.setLambda(0.2);
+  m_task_head.setLambda(m_lambda);
+}
+
+/*!
+  Set the twist matrix of the task. It is stored in m_task_head in both modes, so that calling
+  m_task_head.set_cVe() directly is equivalent.
+ */
+void vpServoHead::set_cVe(const vpVelocityTwistMatrix &cVe)
+{
+  m_task_head.set_cVe(cVe);
+}
+
+void vpServoHead::set_eJe(const vpMatrix &eJe)
+{
+  if (eJe.getRows() != m_rt_eJe.getRows() || eJe.getCols() != m_rt_eJe.getCols()) {
+    // Only allocates when the number of joints changes
+    if (m_realtime)
+      setRealTime(true, eJe.getCols());
+    else
+      m_rt_eJe.resize(eJe.getRows(), eJe.getCols(), false);
+  }
+
+  // eJe is kept also in the default mode for the latency compensation
+  for (unsigned int i=0; i < 6; i++)
+    for (unsigned int j=0; j < eJe.getCols(); j++)
+      m_rt_eJe[i][j] = eJe[i][j];
+
+  if (! m_realtime)
+    m_task_head.set_eJe(eJe);
+}
+
+/*!
+  Return the current feature, advanced by the joint motion since its capture when the latency compensation is enabled.
+ */
+vpImagePoint vpServoHead::getCompensatedFeature() const
+{
+  vpImagePoint ip;
+  vpMeterPixelConversion::convertPoint(m_cam, m_x, m_y, ip);
+  return ip;
+}
+
+void vpServoHead::setCurrentFeature(const vpImagePoint &ip)
+{
+  vpPixelMeterConversion::convertPoint(m_cam, ip, m_x, m_y);
+  if (! m_realtime)
+    m_s.buildFrom(m_x, m_y, m_Z);
+}
+
+/*!
+  Set the current point measured in an image captured at \e timestamp.
+
+  If a joint history was set with setLatencyCompensation(), the point is advanced by the
+  motion of the camera since the capture: s + L cVe eJe dq where L is the interaction matrix of the point
+  at the depth set with setDepth(), and dq the joint displacement between \e timestamp and the last sample
+  of the history. cVe and eJe have to be set before.
+
+  \param ip : Measured point.
+  \param timestamp : Capture time in s of the image, in the time base of the joint history.
+ */
+void vpServoHead::setCurrentFeature(const vpImagePoint &ip, double timestamp)
+{
+  m_timestamp = timestamp;
+  vpPixelMeterConversion::convertPoint(m_cam, ip, m_x, m_y);
+
+  if (m_history != NULL && m_history->getDisplacement(timestamp, m_lc_dq) && m_lc_dq.getRows() == m_rt_eJe.getCols()) {
+    // Camera displacement v = cVe eJe dq
+    double eJe_dq[6], v[6];
+    for (unsigned int i=0; i < 6; i++) {
+      double sum = 0;
+      for (unsigned int j=0; j < m_lc_dq.getRows(); j++)
+        sum += m_rt_eJe[i][j] * m_lc_dq[j];
+      eJe_dq[i] = sum;
+    }
+    for (unsigned int i=0; i < 6; i++) {
+      double sum = 0;
+      for (unsigned int j=0; j < 6; j++)
+        sum += m_task_head.cVe[i][j] * eJe_dq[j];
+      v[i] = sum;
+    }
+    double x = m_x, y = m_y, Z = m_Z;
+    double Lx[6] = { -1/Z, 0, x/Z, x*y, -(1+x*x), y };
+    double Ly[6] = { 0, -1/Z, y/Z, 1+y*y, -x*y, -x };
+    for (unsigned int j=0; j < 6; j++) {
+      m_x += Lx[j] * v[j];
+      m_y += Ly[j] * v[j];
+    }
+  }
+
+  if (! m_realtime)
+    m_s.buildFrom(m_x, m_y, m_Z);
+}
+
+void vpServoHead::setDesiredFeature(const vpImagePoint &ip)
+{
+  vpPixelMeterConversion::convertPoint(m_cam, ip, m_xd, m_yd);
+  if (m_realtime)
+    updateRealTimeInteractionMatrix();
+  else
+    m_sd.buildFrom(m_xd, m_yd, m_Zd);
+}
+
+void vpServoHead::setLambda(double lambda)
+{
+  m_lambda = lambda;
+  m_rt_use_adaptive_gain = false;
+  m_task_head.setLambda(lambda);
+}
+
+void vpServoHead::setLambda(const vpAdaptiveGain &lambda)
+{
+  m_rt_lambda = lambda;
+  m_rt_use_adaptive_gain = true;
+  m_task_head.setLambda(lambda);
+}
+
+/*!
+  Enable or disable the real-time mode. See vpServoArm::setRealTime() for the details.
+  The task is the same than the default one: J1 = L cVe eJe with the interaction matrix
+  of the point computed at the desired position.
+
+  In this mode m_task_head is no more updated, so it should not be used for display.
+
+  \param realtime : true to enable the real-time mode.
+  \param nb_joints : Number of joints of the chain (number of columns of eJe).
+ */
+void vpServoHead::setRealTime(bool realtime, unsigned int nb_joints)
+{
+  m_realtime = realtime;
+  if (! m_realtime) {
+    // Synchronize the features that were not updated in real-time mode
+    m_s.buildFrom(m_x, m_y, m_Z);
+    m_sd.buildFrom(m_xd, m_yd, m_Zd);
+    return;
+  }
+
+  m_rt_eJe.resize(6, nb_joints);
+  m_rt_J.resize(2, nb_joints);
+  m_rt_e.resize(2);
+  m_rt_e1.resize(nb_joints);
+  m_rt_e1_initial.resize(nb_joints);
+  m_rt_q_dot.resize(nb_joints);
+  m_rt_servo_time_init = -1;
+  updateRealTimeInteractionMatrix();
+}
+
+/*!
+  Interaction matrix of a 2D point computed with the desired feature, like vpFeaturePoint::interaction().
+ */
+void vpServoHead::updateRealTimeInteractionMatrix()
+{
+  double x = m_xd, y = m_yd, Z = m_Zd;
+  double Lx[6] = { -1/Z, 0, x/Z, x*y, -(1+x*x), y };
+  double Ly[6] = { 0, -1/Z, y/Z, 1+y*y, -x*y, -x };
+  for (unsigned int j=0; j < 6; j++) {
+    m_rt_L[0][j] = Lx[j];
+    m_rt_L[1][j] = Ly[j];
+  }
+}
+
+/*!
+  Update the task error and the task Jacobian J1 = L cVe eJe in real-time mode.
+ */
+void vpServoHead::computeRealTimeTask()
+{
+  unsigned int n = m_rt_eJe.getCols();
+  m_rt_e[0] = m_x - m_xd;
+  m_rt_e[1] = m_y - m_yd;
+
+  for (unsigned int i=0; i < 2; i++) {
+    for (unsigned int j=0; j < 6; j++) {
+      double sum = 0;
+      for (unsigned int k=0; k < 6; k++)
+        sum += m_rt_L[i][k] * m_task_head.cVe[k][j];
+      m_rt_LcVe[i][j] = sum;
+    }
+    for (unsigned int j=0; j < n; j++) {
+      double sum = 0;
+      for (unsigned int k=0; k < 6; k++)
+        sum += m_rt_LcVe[i][k] * m_rt_eJe[k][j];
+      m_rt_J[i][j] = sum;
+    }
+  }
+}
+
+/*!
+  Gain applied to e1 = J1^+ e in real-time mode.
+ */
+double vpServoHead::computeRealTimeGain() const
+{
+  if (! m_rt_use_adaptive_gain)
+    return m_lambda;
+
+  double norm = 0;
+  for (unsigned int k=0; k < m_rt_e1.getRows(); k++)
+    norm = std::max(norm, fabs(m_rt_e1[k]));
+  return m_rt_lambda.value(norm);
+}
+
+/*!
+  Compute the joint velocities without allocating memory when the real-time mode is enabled.
+  \param q_dot : Joint velocities. Should be preallocated with the number of joints.
+ */
+void vpServoHead::computeControlLaw(vpColVector &q_dot)
+{
+  if (! m_realtime) {
+    q_dot = m_task_head.computeControlLaw();
+    return;
+  }
+
+  computeRealTimeTask();
+  m_rt_solver.solve(m_rt_J, m_rt_e, m_rt_e1);
+
+  double lambda = computeRealTimeGain();
+  if (q_dot.getRows() != m_rt_e1.getRows())
+    q_dot.resize(m_rt_e1.getRows(), false);
+  for (unsigned int k=0; k < m_rt_e1.getRows(); k++)
+    q_dot[k] = -lambda * m_rt_e1[k];
+}
+
+/*!
+  Compute the joint velocities with a continuous sequencing without allocating memory when the real-time
+  mode is enabled. In real-time mode the initial task is memorized each time \e servo_time_init changes.
+  \param servo_time_init : Time in second when the servo started.
+  \param q_dot : Joint velocities. Should be preallocated with the number of joints.
+ */
+void vpServoHead::computeControlLaw(double servo_time_init, vpColVector &q_dot)
+{
+  if (! m_realtime) {
+    q_dot = computeControlLaw(servo_time_init);
+    return;
+  }
+
+  computeControlLaw(q_dot);
+  if (servo_time_init != m_rt_servo_time_init) {
+    for (unsigned int k=0; k < m_rt_e1.getRows(); k++)
+      m_rt_e1_initial[k] = m_rt_e1[k];
+    m_rt_servo_time_init = servo_time_init;
+  }
+
+  double mu = 4.; // Same value than vpServo
+  double decay = computeRealTimeGain() * exp(-mu * (vpTime::measureTimeSecond() - servo_time_init));
+  for (unsigned int k=0; k < m_rt_e1.getRows(); k++)
+    q_dot[k] += decay * m_rt_e1_initial[k];
 }
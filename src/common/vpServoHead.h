@@ -1,6 +1,7 @@
 #ifndef __vpServoHead_h__
 #define __vpServoHead_h__
 
+#include <visp/vpAdaptiveGain.h>
 #include <visp/vpCameraParameters.h>
 #include <visp/vpImagePoint.h>
 #include <visp/vpFeaturePoint.h>
@@ -8,6 +9,9 @@
 #include <visp/vpPixelMeterConversion.h>
 #include <visp/vpServoDisplay.h>
 
+#include <vpDampedLeastSquares.h>
+#include <vpJointHistory.h>
+
 
 class vpServoHead
 {
@@ -27,6 +31,27 @@ protected:
   double m_y; //You have to compute the value of y.
   double m_Z; //You have to compute the value of Z.
   vpCameraParameters m_cam;
+  double m_lambda;
+
+  // Real-time mode: the task is computed in preallocated workspaces instead of m_task_head
+  bool m_realtime;
+  double m_rt_L[2][6];            // Interaction matrix computed at the desired point
+  double m_rt_LcVe[2][6];
+  vpMatrix m_rt_eJe;
+  vpMatrix m_rt_J;                // Task Jacobian J1 = L cVe eJe
+  vpColVector m_rt_e;             // Task error s - s*
+  vpColVector m_rt_e1;            // J1^+ e
+  vpColVector m_rt_e1_initial;    // J1^+ e at the beginning of a continuous sequencing
+  vpColVector m_rt_q_dot;
+  double m_rt_servo_time_init;
+  bool m_rt_use_adaptive_gain;
+  vpAdaptiveGain m_rt_lambda;
+  vpDampedLeastSquares m_rt_solver;
+
+  // Latency compensation
+  vpJointHistory *m_history;
+  vpColVector m_lc_dq;            // Joint displacement since the capture of the measure
+  double m_timestamp;             // Capture time of the current feature
 
 public:
   vpServoHead();
@@ -36,30 +61,44 @@ public:
   }
   vpColVector computeControlLaw()
   {
+    if (m_realtime) {
+      computeControlLaw(m_rt_q_dot);
+      return m_rt_q_dot;
+    }
     return ( m_task_head.computeControlLaw() );
   }
   vpColVector computeControlLaw(double servo_time_init)
   {
+    if (m_realtime) {
+      computeControlLaw(servo_time_init, m_rt_q_dot);
+      return m_rt_q_dot;
+    }
     return ( m_task_head.computeControlLaw(vpTime::measureTimeSecond() - servo_time_init) );
   }
+  void computeControlLaw(vpColVector &q_dot);
+  void computeControlLaw(double servo_time_init, vpColVector &q_dot);
 
+  vpImagePoint getCompensatedFeature() const;
+  vpColVector getError(){return m_realtime ? m_rt_e : m_task_head.getError();}
+  bool getRealTime() const {return m_realtime;}
+  double getTimestamp() const {return m_timestamp;}
 
-
-  void set_eJe(const vpMatrix &eJe) { m_task_head.set_eJe(eJe);}
-  void set_cVe(const vpVelocityTwistMatrix &cVe) { m_task_head.set_cVe(cVe);}
+  void set_eJe(const vpMatrix &eJe);
+  void set_cVe(const vpVelocityTwistMatrix &cVe);
   void setCameraParameters(const vpCameraParameters &cam) {m_cam = cam;}
-  void setCurrentFeature(const vpImagePoint &ip)
-  {
-    vpPixelMeterConversion::convertPoint(m_cam, ip, m_x, m_y);
-    m_s.buildFrom(m_x, m_y, m_Z);
-  }
-  void setDesiredFeature(const vpImagePoint &ip)
-  {
-    vpPixelMeterConversion::convertPoint(m_cam, ip, m_xd, m_yd);
-    m_sd.buildFrom(m_xd, m_yd, m_Zd);
-  }
-  void setLambda(double lambda) {m_task_head.setLambda(lambda);}
-  void setLambda(const vpAdaptiveGain &lambda) {m_task_head.setLambda(lambda);}
+  void setCurrentFeature(const vpImagePoint &ip);
+  void setCurrentFeature(const vpImagePoint &ip, double timestamp);
+  void setDepth(double Z) {m_Z = Z;}
+  void setDesiredFeature(const vpImagePoint &ip);
+  void setLambda(double lambda);
+  void setLambda(const vpAdaptiveGain &lambda);
+  void setLatencyCompensation(vpJointHistory *history) {m_history = history;}
+  void setRealTime(bool realtime, unsigned int nb_joints=2);
+
+protected:
+  double computeRealTimeGain() const;
+  void computeRealTimeTask();
+  void updateRealTimeInteractionMatrix();
 };
 
 #endif
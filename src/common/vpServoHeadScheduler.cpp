@@ -0,0 +1,108 @@
+#include <vpServoHeadScheduler.h>
+
+
+vpServoHeadScheduler::vpServoHeadScheduler(vpNaoqiRobot &robot, vpServoHead &servo, const std::string &chain_name,
+                                           const std::vector<std::string> &joint_names, double rate)
+  : vpControlScheduler(robot, chain_name, joint_names, rate), m_servo(servo),
+    m_ip_published(), m_timestamp_published(0), m_new_point(false), m_ip_des_published(), m_cVe_published(),
+    m_servo_reset(true), m_ip_ref(), m_timestamp(0), m_point_available(false), m_ip(), m_cVe(), m_servo_time_init(0)
+{
+  m_servo.setLatencyCompensation(&m_history);
+}
+
+vpServoHeadScheduler::vpServoHeadScheduler(vpRobotBackend &robot, vpServoHead &servo, const std::string &chain_name,
+                                           const std::vector<std::string> &joint_names, double rate)
+  : vpControlScheduler(robot, chain_name, joint_names, rate), m_servo(servo),
+    m_ip_published(), m_timestamp_published(0), m_new_point(false), m_ip_des_published(), m_cVe_published(),
+    m_servo_reset(true), m_ip_ref(), m_timestamp(0), m_point_available(false), m_ip(), m_cVe(), m_servo_time_init(0)
+{
+  m_servo.setLatencyCompensation(&m_history);
+}
+
+vpServoHeadScheduler::~vpServoHeadScheduler()
+{
+  stop();
+  m_servo.setLatencyCompensation(NULL);
+}
+
+/*!
+  Return the point used by the last control iteration.
+ */
+vpImagePoint vpServoHeadScheduler::getExtrapolatedPoint()
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  return m_ip;
+}
+
+/*!
+  Publish a new measure of the point. Can be called from any thread.
+  \param ip : Measured point.
+  \param timestamp : Time in s (vpTime::measureTimeSecond()) of the acquisition of the image.
+ */
+void vpServoHeadScheduler::publishPoint(const vpImagePoint &ip, double timestamp)
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  m_ip_published = ip;
+  m_timestamp_published = timestamp;
+  m_new_point = true;
+}
+
+/*!
+  Restart the continuous sequencing of the control law at the next iteration.
+ */
+void vpServoHeadScheduler::resetServo()
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  m_servo_reset = true;
+}
+
+void vpServoHeadScheduler::set_cVe(const vpVelocityTwistMatrix &cVe)
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  m_cVe_published = cVe;
+}
+
+void vpServoHeadScheduler::setDesiredPoint(const vpImagePoint &ip)
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  m_ip_des_published = ip;
+}
+
+bool vpServoHeadScheduler::computeVelocity(double t, const vpColVector &q, vpColVector &q_dot)
+{
+  bool servo_reset = false;
+  vpImagePoint ip_des;
+  {
+    vpMutex::vpScopedLock lock(m_mutex);
+    if (m_new_point) {
+      m_ip_ref = m_ip_published;
+      m_timestamp = m_timestamp_published;
+      m_new_point = false;
+      m_point_available = true;
+    }
+    ip_des = m_ip_des_published;
+    m_cVe = m_cVe_published;
+    servo_reset = m_servo_reset;
+    m_servo_reset = false;
+  }
+
+  if (! m_point_available || t - m_timestamp > m_timeout) {
+    m_servo_time_init = 0;
+    return false;
+  }
+
+  const vpMatrix &eJe = get_eJe();
+
+  if (servo_reset || m_servo_time_init == 0)
+    m_servo_time_init = t;
+
+  m_servo.set_eJe(eJe);
+  m_servo.set_cVe(m_cVe);
+  m_servo.setCurrentFeature(m_ip_ref, m_timestamp); // Extrapolated with the joint history
+  m_servo.setDesiredFeature(ip_des);
+  m_servo.computeControlLaw(m_servo_time_init, q_dot);
+
+  vpMutex::vpScopedLock lock(m_mutex);
+  m_ip = m_servo.getCompensatedFeature();
+  return true;
+}
@@ -0,0 +1,57 @@
+#ifndef __vpServoHeadScheduler_h__
+#define __vpServoHeadScheduler_h__
+
+#include <visp/vpImagePoint.h>
+#include <visp/vpVelocityTwistMatrix.h>
+
+#include <vpControlScheduler.h>
+#include <vpServoHead.h>
+
+/*!
+  Run a vpServoHead control law at a fixed rate on the last image point published by the perception.
+
+  Between two frames the point is extrapolated with the displacement of the joints since the image was
+  acquired, using the latency compensation of vpServoHead:
+
+  s(t) = s(t_k) + L cVe eJe (q(t) - q(t_k))
+ */
+class vpServoHeadScheduler : public vpControlScheduler
+{
+protected:
+  vpServoHead &m_servo;
+
+  // Shared with the publishers
+  vpImagePoint m_ip_published;
+  double m_timestamp_published;
+  bool m_new_point;
+  vpImagePoint m_ip_des_published;
+  vpVelocityTwistMatrix m_cVe_published;
+  bool m_servo_reset;
+
+  // Used only by the control thread
+  vpImagePoint m_ip_ref;            // Last measured point
+  double m_timestamp;
+  bool m_point_available;
+  vpImagePoint m_ip;                // Extrapolated point
+  vpVelocityTwistMatrix m_cVe;
+  double m_servo_time_init;
+
+public:
+  vpServoHeadScheduler(vpNaoqiRobot &robot, vpServoHead &servo, const std::string &chain_name,
+                       const std::vector<std::string> &joint_names, double rate=100.);
+  vpServoHeadScheduler(vpRobotBackend &robot, vpServoHead &servo, const std::string &chain_name,
+                       const std::vector<std::string> &joint_names, double rate=100.);
+  virtual ~vpServoHeadScheduler();
+
+  vpImagePoint getExtrapolatedPoint();
+
+  void publishPoint(const vpImagePoint &ip, double timestamp);
+  void resetServo();
+  void set_cVe(const vpVelocityTwistMatrix &cVe);
+  void setDesiredPoint(const vpImagePoint &ip);
+
+protected:
+  virtual bool computeVelocity(double t, const vpColVector &q, vpColVector &q_dot);
+};
+
+#endif
@@ -0,0 +1,178 @@
+#include <algorithm>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <visp/vpException.h>
+#include <visp/vpTime.h>
+
+#include <vpSimulatedCamera.h>
+
+
+/*!
+  Create a camera of \e width x \e height pixels attached to the end-effector of \e chain_name, looking
+  along the x axis of the end-effector frame like the eyes of Romeo. The default intrinsic parameters give a
+  horizontal field of view of about 56 degrees. The images are rendered on demand, without waiting; use
+  setFrameRate() to acquire them at the rate of a real camera while the simulation thread runs.
+ */
+vpSimulatedCamera::vpSimulatedCamera(vpSimulatedRobot &robot, const std::string &chain_name,
+                                     unsigned int width, unsigned int height)
+  : m_robot(robot), m_chain_name(chain_name), m_eMc(), m_cam(), m_width(width), m_height(height),
+    m_background(128, 128, 128), m_targets(), m_frame_rate(0), m_t_last(0), m_timestamp(0), m_bgr(),
+    m_src(4), m_dst(4)
+{
+  // Camera z axis along the x axis of the end-effector, x axis along -y and y axis along -z
+  m_eMc[0][0] = 0;  m_eMc[0][1] = 0;  m_eMc[0][2] = 1;
+  m_eMc[1][0] = -1; m_eMc[1][1] = 0;  m_eMc[1][2] = 0;
+  m_eMc[2][0] = 0;  m_eMc[2][1] = -1; m_eMc[2][2] = 0;
+  m_cam.initPersProjWithoutDistortion(0.94 * width, 0.94 * width, 0.5 * width, 0.5 * height);
+}
+
+/*!
+  Add colored disks of radius \e radius (in m) centered on \e points, facing the camera.
+  \param points : Centers of the blobs in the target frame.
+  \param radius : Radius of the disks in m.
+  \param colors : BGR color of each blob.
+  \param M : Pose of the target in the end-effector frame of \e chain_name, or in the torso frame.
+  \param chain_name : Chain the target is attached to, empty if it is fixed.
+  \return Index of the target.
+ */
+unsigned int vpSimulatedCamera::addBlobsTarget(const std::vector<vpPoint> &points, double radius,
+                                               const std::vector<cv::Scalar> &colors, const vpHomogeneousMatrix &M,
+                                               const std::string &chain_name)
+{
+  if (colors.size() != points.size())
+    throw vpException(vpException::dimensionError, "%d colors for %d blobs", (int)colors.size(), (int)points.size());
+  vpTarget target;
+  target.chain_name = chain_name;
+  target.M = M;
+  target.size_x = target.size_y = 0;
+  target.points = points;
+  target.radius = radius;
+  target.colors = colors;
+  m_targets.push_back(target);
+  return (unsigned int)(m_targets.size() - 1);
+}
+
+/*!
+  Add a square planar target of side \e size (in m) textured with an image, for example a QR code. The
+  texture is centered on the target frame in its z = 0 plane, with its rows along the y axis.
+  \return Index of the target.
+ */
+unsigned int vpSimulatedCamera::addPlanarTarget(const cv::Mat &texture, double size, const vpHomogeneousMatrix &M,
+                                                const std::string &chain_name)
+{
+  if (texture.empty())
+    throw vpException(vpException::badValue, "Empty texture");
+  vpTarget target;
+  target.chain_name = chain_name;
+  target.M = M;
+  if (texture.channels() == 3)
+    target.texture = texture.clone();
+  else
+    cv::cvtColor(texture, target.texture, CV_GRAY2BGR);
+  target.size_x = size;
+  target.size_y = size * texture.rows / texture.cols;
+  target.radius = 0;
+  m_targets.push_back(target);
+  return (unsigned int)(m_targets.size() - 1);
+}
+
+/*!
+  Pose of the camera in the torso frame.
+ */
+vpHomogeneousMatrix vpSimulatedCamera::get_fMc() const
+{
+  return m_robot.get_fMe(m_chain_name) * m_eMc;
+}
+
+/*!
+  True pose of a target in the camera frame at the current time.
+ */
+vpHomogeneousMatrix vpSimulatedCamera::get_cMo(unsigned int target) const
+{
+  if (target >= m_targets.size())
+    throw vpException(vpException::badValue, "No simulated target %d", target);
+  const vpTarget &t = m_targets[target];
+  vpHomogeneousMatrix fMo = t.chain_name.empty() ? t.M : m_robot.get_fMe(t.chain_name) * t.M;
+  return get_fMc().inverse() * fMo;
+}
+
+void vpSimulatedCamera::setTargetPose(unsigned int target, const vpHomogeneousMatrix &M)
+{
+  if (target >= m_targets.size())
+    throw vpException(vpException::badValue, "No simulated target %d", target);
+  m_targets[target].M = M;
+}
+
+/*!
+  Render the current view in \e I (BGR). Waits for the next frame if a frame rate was set and the simulation
+  thread runs.
+ */
+void vpSimulatedCamera::acquire(cv::Mat &I)
+{
+  if (m_frame_rate > 0 && m_robot.isRunning()) {
+    vpTime::wait(m_t_last, 1000. / m_frame_rate);
+    m_t_last = vpTime::measureTimeMs();
+  }
+  render(I);
+}
+
+void vpSimulatedCamera::acquire(vpImage<unsigned char> &I)
+{
+  acquire(m_bgr);
+  if (I.getHeight() != m_height || I.getWidth() != m_width)
+    I.resize(m_height, m_width);
+  cv::Mat gray((int)m_height, (int)m_width, CV_8UC1, I.bitmap);
+  cv::cvtColor(m_bgr, gray, CV_BGR2GRAY);
+}
+
+/*!
+  Project a point of the target frame. Returns false if it is behind the camera.
+ */
+bool vpSimulatedCamera::project(const vpHomogeneousMatrix &cMo, double oX, double oY, double oZ, cv::Point2f &ip) const
+{
+  double X = cMo[0][0]*oX + cMo[0][1]*oY + cMo[0][2]*oZ + cMo[0][3];
+  double Y = cMo[1][0]*oX + cMo[1][1]*oY + cMo[1][2]*oZ + cMo[1][3];
+  double Z = cMo[2][0]*oX + cMo[2][1]*oY + cMo[2][2]*oZ + cMo[2][3];
+  if (Z < 0.01)
+    return false;
+  ip.x = (float)(m_cam.get_u0() + m_cam.get_px() * X / Z);
+  ip.y = (float)(m_cam.get_v0() + m_cam.get_py() * Y / Z);
+  return true;
+}
+
+void vpSimulatedCamera::render(cv::Mat &I)
+{
+  m_timestamp = m_robot.getTime();
+  vpHomogeneousMatrix cMf = get_fMc().inverse();
+
+  I.create((int)m_height, (int)m_width, CV_8UC3);
+  I.setTo(m_background);
+  for (size_t i=0; i < m_targets.size(); i++) {
+    const vpTarget &t = m_targets[i];
+    vpHomogeneousMatrix cMo = cMf * (t.chain_name.empty() ? t.M : m_robot.get_fMe(t.chain_name) * t.M);
+
+    if (! t.texture.empty()) {
+      double x[4] = {-0.5, 0.5, 0.5, -0.5};
+      double y[4] = {-0.5, -0.5, 0.5, 0.5};
+      bool visible = true;
+      for (unsigned int k=0; k < 4; k++) {
+        m_src[k] = cv::Point2f((float)((x[k] + 0.5) * t.texture.cols), (float)((y[k] + 0.5) * t.texture.rows));
+        visible = visible && project(cMo, x[k] * t.size_x, y[k] * t.size_y, 0, m_dst[k]);
+      }
+      if (visible) {
+        cv::Mat H = cv::getPerspectiveTransform(m_src, m_dst);
+        cv::warpPerspective(t.texture, I, H, I.size(), cv::INTER_LINEAR, cv::BORDER_TRANSPARENT);
+      }
+    }
+    for (size_t k=0; k < t.points.size(); k++) {
+      const vpPoint &P = t.points[k];
+      cv::Point2f ip;
+      if (! project(cMo, P.get_oX(), P.get_oY(), P.get_oZ(), ip))
+        continue;
+      double Z = cMo[2][0]*P.get_oX() + cMo[2][1]*P.get_oY() + cMo[2][2]*P.get_oZ() + cMo[2][3];
+      int radius = (int)(m_cam.get_px() * t.radius / Z + 0.5);
+      cv::circle(I, cv::Point((int)(ip.x + 0.5f), (int)(ip.y + 0.5f)), std::max(radius, 1), t.colors[k], -1);
+    }
+  }
+}
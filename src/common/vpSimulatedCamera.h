@@ -0,0 +1,101 @@
+#ifndef __vpSimulatedCamera_h__
+#define __vpSimulatedCamera_h__
+
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+#include <visp/vpCameraParameters.h>
+#include <visp/vpHomogeneousMatrix.h>
+#include <visp/vpImage.h>
+#include <visp/vpPoint.h>
+
+#include <vpSimulatedRobot.h>
+
+/*!
+  Camera attached to a chain of a vpSimulatedRobot, that renders planar textured targets (a QR code image)
+  and colored blobs, with the same acquisition interface than vpNaoqiGrabber and vpReplayGrabber. The
+  images are perspective projections without distortion nor noise, so that the trackers of romeo_tk can
+  close the control loop on them.
+
+  A target is either fixed in the torso frame of the robot or attached to the end-effector of a chain, like
+  the QR code held by the hand in the grasping demos. get_cMo() gives the true pose of a target, to measure
+  the accuracy of the trackers or to close the loop without them.
+
+  \code
+  vpSimulatedRobot robot;
+  vpSimulatedCamera camera(robot, "LEye");
+  cv::Mat qrcode = cv::imread(std::string(ROMEOTK_DATA_FOLDER) + "/QR-Code/qrcode_romeo_left_arm.png");
+  camera.addPlanarTarget(qrcode, 0.045, vpHomogeneousMatrix(0.05, 0, 0, 0, M_PI/2, 0), "LArm");
+  robot.start();
+  vpImage<unsigned char> I(camera.getHeight(), camera.getWidth());
+  while (...) {
+    camera.acquire(I);
+    qrcode_tracker.setTimestamp(camera.getTimestamp());
+    qrcode_tracker.track(I);
+  }
+  \endcode
+ */
+class vpSimulatedCamera
+{
+protected:
+  struct vpTarget {
+    std::string chain_name;     // Chain the target is attached to, empty if it is fixed in the torso frame
+    vpHomogeneousMatrix M;      // Pose of the target in the end-effector frame of the chain or the torso frame
+    cv::Mat texture;            // BGR texture of a planar target, centered on the target frame in its z = 0 plane
+    double size_x;
+    double size_y;
+    std::vector<vpPoint> points; // Centers of the blobs in the target frame
+    double radius;
+    std::vector<cv::Scalar> colors;
+  };
+
+  vpSimulatedRobot &m_robot;
+  std::string m_chain_name;
+  vpHomogeneousMatrix m_eMc;
+  vpCameraParameters m_cam;
+  unsigned int m_width;
+  unsigned int m_height;
+  cv::Scalar m_background;
+  std::vector<vpTarget> m_targets;
+  double m_frame_rate;
+  double m_t_last;              // Time of the last acquisition in ms
+  double m_timestamp;
+  cv::Mat m_bgr;
+  std::vector<cv::Point2f> m_src;
+  std::vector<cv::Point2f> m_dst;
+
+public:
+  vpSimulatedCamera(vpSimulatedRobot &robot, const std::string &chain_name="LEye",
+                    unsigned int width=320, unsigned int height=240);
+  virtual ~vpSimulatedCamera() {}
+
+  void acquire(cv::Mat &I);
+  void acquire(vpImage<unsigned char> &I);
+
+  unsigned int addBlobsTarget(const std::vector<vpPoint> &points, double radius, const std::vector<cv::Scalar> &colors,
+                              const vpHomogeneousMatrix &M, const std::string &chain_name="");
+  unsigned int addPlanarTarget(const cv::Mat &texture, double size, const vpHomogeneousMatrix &M,
+                               const std::string &chain_name="");
+
+  vpHomogeneousMatrix get_cMo(unsigned int target) const;
+  vpHomogeneousMatrix get_eMc() const {return m_eMc;}
+  vpHomogeneousMatrix get_fMc() const;
+  vpCameraParameters getCameraParameters() const {return m_cam;}
+  unsigned int getHeight() const {return m_height;}
+  double getTimestamp() const {return m_timestamp;}
+  unsigned int getWidth() const {return m_width;}
+
+  void set_eMc(const vpHomogeneousMatrix &eMc) {m_eMc = eMc;}
+  void setBackground(const cv::Scalar &color) {m_background = color;}
+  void setCameraParameters(const vpCameraParameters &cam) {m_cam = cam;}
+  void setFrameRate(double frame_rate) {m_frame_rate = frame_rate;}
+  void setTargetPose(unsigned int target, const vpHomogeneousMatrix &M);
+
+protected:
+  bool project(const vpHomogeneousMatrix &cMo, double oX, double oY, double oZ, cv::Point2f &ip) const;
+  void render(cv::Mat &I);
+};
+
+#endif
@@ -0,0 +1,431 @@
+#include <math.h>
+#include <algorithm>
+
+#include <visp/vpException.h>
+#include <visp/vpRotationMatrix.h>
+#include <visp/vpTime.h>
+#include <visp/vpTranslationVector.h>
+
+#include <vpSimulatedRobot.h>
+
+
+/*!
+  Create the model of Romeo, with all the joints at 0 except the elbows, that are bent to keep the arms away
+  from the singular stretched configuration. The simulation rate is 100 Hz, without latency.
+ */
+vpSimulatedRobot::vpSimulatedRobot()
+  : m_joints(), m_joint_index(), m_chains(), m_commands(), m_rate(100.), m_latency(0.), m_time(0.),
+    m_nb_steps(0), m_mutex(), m_thread(NULL), m_stop_requested(false)
+{
+  // Head
+  addJoint("NeckYaw", "", vpHomogeneousMatrix(0, 0, 0.30, 0, 0, 0), 2, -1.3, 1.3);
+  addJoint("NeckPitch", "NeckYaw", vpHomogeneousMatrix(0, 0, 0.04, 0, 0, 0), 1, -0.3, 0.3);
+  addJoint("HeadPitch", "NeckPitch", vpHomogeneousMatrix(0, 0, 0.10, 0, 0, 0), 1, -0.3, 0.3);
+  addJoint("HeadRoll", "HeadPitch", vpHomogeneousMatrix(), 0, -0.3, 0.3);
+  addChain("Head", "HeadRoll");
+
+  // Eyes, with the end-effector frame at the center of the eye, x axis looking forward
+  addJoint("LEyeYaw", "HeadRoll", vpHomogeneousMatrix(0.09, 0.035, 0.07, 0, 0, 0), 2, -0.5, 0.5);
+  addJoint("LEyePitch", "LEyeYaw", vpHomogeneousMatrix(), 1, -0.5, 0.5);
+  addChain("LEye", "LEyePitch", vpHomogeneousMatrix(), "", 2);
+  addJoint("REyeYaw", "HeadRoll", vpHomogeneousMatrix(0.09, -0.035, 0.07, 0, 0, 0), 2, -0.5, 0.5);
+  addJoint("REyePitch", "REyeYaw", vpHomogeneousMatrix(), 1, -0.5, 0.5);
+  addChain("REye", "REyePitch", vpHomogeneousMatrix(), "", 2);
+
+  // Arms, pointing forward at q = 0, with the end-effector frame in the palm
+  const char *side[2] = {"L", "R"};
+  for (unsigned int i=0; i < 2; i++) {
+    std::string s(side[i]);
+    double y = (i == 0) ? 0.22 : -0.22;
+    addJoint(s + "ShoulderPitch", "", vpHomogeneousMatrix(0, y, 0.20, 0, 0, 0), 1, -2.0, 2.0);
+    addJoint(s + "ShoulderYaw", s + "ShoulderPitch", vpHomogeneousMatrix(), 2, -1.5, 1.5);
+    addJoint(s + "ElbowRoll", s + "ShoulderYaw", vpHomogeneousMatrix(0.10, 0, 0, 0, 0, 0), 0, -2.0, 2.0);
+    addJoint(s + "ElbowYaw", s + "ElbowRoll", vpHomogeneousMatrix(0.10, 0, 0, 0, 0, 0), 2, -2.0, 2.0);
+    addJoint(s + "WristRoll", s + "ElbowYaw", vpHomogeneousMatrix(0.10, 0, 0, 0, 0, 0), 0, -2.0, 2.0);
+    addJoint(s + "WristYaw", s + "WristRoll", vpHomogeneousMatrix(0.10, 0, 0, 0, 0, 0), 2, -1.0, 1.0);
+    addJoint(s + "WristPitch", s + "WristYaw", vpHomogeneousMatrix(), 1, -1.0, 1.0);
+    addJoint(s + "Hand", s + "WristPitch", vpHomogeneousMatrix(), -1, 0., 1.);
+    addChain(s + "Arm", s + "WristPitch", vpHomogeneousMatrix(0.08, 0, 0, 0, 0, 0), s + "Hand");
+  }
+  m_joints[m_joint_index["LElbowYaw"]].q = -0.8;
+  m_joints[m_joint_index["RElbowYaw"]].q = 0.8;
+}
+
+vpSimulatedRobot::~vpSimulatedRobot()
+{
+  stopSimulation();
+}
+
+/*!
+  Add a joint to the model.
+  \param name : Name of the joint.
+  \param parent : Name of the previous joint of the chain, empty for a joint attached to the torso.
+  \param pMj : Pose of the joint frame in the frame of the parent at q = 0.
+  \param axis : Rotation axis 0 (x), 1 (y) or 2 (z), or -1 for a joint out of the kinematic chain like a hand.
+  \param min, max : Joint limits.
+  \param max_velocity : Maximum velocity in rad/s.
+ */
+unsigned int vpSimulatedRobot::addJoint(const std::string &name, const std::string &parent,
+                                        const vpHomogeneousMatrix &pMj, int axis, double min, double max,
+                                        double max_velocity)
+{
+  vpJoint joint;
+  joint.name = name;
+  joint.parent = parent.empty() ? -1 : (int)getJointIndex(parent);
+  joint.pMj = pMj;
+  joint.axis = axis;
+  joint.min = min;
+  joint.max = max;
+  joint.max_velocity = max_velocity;
+  joint.q = 0.;
+  joint.q_dot = 0.;
+  m_joints.push_back(joint);
+  m_joint_index[name] = (unsigned int)(m_joints.size() - 1);
+  return (unsigned int)(m_joints.size() - 1);
+}
+
+/*!
+  Add a chain made of all the joints from the torso to \e last_joint.
+  \param chain_name : Name of the chain.
+  \param last_joint : Last joint of the Jacobian.
+  \param jMe : End-effector frame in the frame of the last joint.
+  \param hand : If not empty, joint added at the end of the body names but not in the Jacobian.
+  \param nb_body_joints : If not 0, only the last joints of the Jacobian are in the body names.
+ */
+void vpSimulatedRobot::addChain(const std::string &chain_name, const std::string &last_joint,
+                                const vpHomogeneousMatrix &jMe, const std::string &hand,
+                                unsigned int nb_body_joints)
+{
+  vpChain chain;
+  for (int joint = (int)getJointIndex(last_joint); joint >= 0; joint = m_joints[joint].parent)
+    chain.joints.insert(chain.joints.begin(), (unsigned int)joint);
+  size_t first = (nb_body_joints == 0) ? 0 : chain.joints.size() - nb_body_joints;
+  for (size_t i=first; i < chain.joints.size(); i++)
+    chain.body_names.push_back(m_joints[chain.joints[i]].name);
+  if (! hand.empty())
+    chain.body_names.push_back(hand);
+  chain.jMe = jMe;
+  m_chains[chain_name] = chain;
+}
+
+const vpSimulatedRobot::vpChain &vpSimulatedRobot::getChain(const std::string &chain_name) const
+{
+  std::map<std::string, vpChain>::const_iterator it = m_chains.find(chain_name);
+  if (it == m_chains.end())
+    throw vpException(vpException::badValue, "The simulated robot has no chain %s", chain_name.c_str());
+  return it->second;
+}
+
+unsigned int vpSimulatedRobot::getJointIndex(const std::string &name) const
+{
+  std::map<std::string, unsigned int>::const_iterator it = m_joint_index.find(name);
+  if (it == m_joint_index.end())
+    throw vpException(vpException::badValue, "The simulated robot has no joint %s", name.c_str());
+  return it->second;
+}
+
+/*!
+  Pose of the frame of a joint in the torso frame. The mutex has to be locked.
+ */
+vpHomogeneousMatrix vpSimulatedRobot::getJointPose(unsigned int joint) const
+{
+  const vpJoint &j = m_joints[joint];
+  vpHomogeneousMatrix fMj = (j.parent < 0) ? j.pMj : getJointPose((unsigned int)j.parent) * j.pMj;
+  if (j.axis >= 0) {
+    double tu[3] = {0, 0, 0};
+    tu[j.axis] = j.q;
+    fMj = fMj * vpHomogeneousMatrix(0, 0, 0, tu[0], tu[1], tu[2]);
+  }
+  return fMj;
+}
+
+/*!
+  Return the joint names of a chain, all the joints with "Body", or \e names if it is the name of a joint.
+ */
+std::vector<std::string> vpSimulatedRobot::getBodyNames(const std::string &names) const
+{
+  std::map<std::string, vpChain>::const_iterator it = m_chains.find(names);
+  if (it != m_chains.end())
+    return it->second.body_names;
+
+  std::vector<std::string> body_names;
+  if (names == "Body") {
+    for (size_t i=0; i < m_joints.size(); i++)
+      body_names.push_back(m_joints[i].name);
+  }
+  else
+    body_names.push_back(m_joints[getJointIndex(names)].name);
+  return body_names;
+}
+
+/*!
+  Pose of the end-effector of a chain in the torso frame.
+ */
+vpHomogeneousMatrix vpSimulatedRobot::get_fMe(const std::string &chain_name) const
+{
+  const vpChain &chain = getChain(chain_name);
+  vpMutex::vpScopedLock lock(m_mutex);
+  return getJointPose(chain.joints.back()) * chain.jMe;
+}
+
+vpMatrix vpSimulatedRobot::get_eJe(const std::string &chain_name) const
+{
+  vpMatrix eJe;
+  get_eJe(chain_name, eJe);
+  return eJe;
+}
+
+void vpSimulatedRobot::get_eJe(const std::string &chain_name, vpMatrix &eJe) const
+{
+  const vpChain &chain = getChain(chain_name);
+  vpMutex::vpScopedLock lock(m_mutex);
+
+  vpHomogeneousMatrix fMe = getJointPose(chain.joints.back()) * chain.jMe;
+  vpRotationMatrix eRf = fMe.getRotationMatrix().t();
+  vpTranslationVector f_t_e = fMe.getTranslationVector();
+
+  if (eJe.getRows() != 6 || eJe.getCols() != chain.joints.size())
+    eJe.resize(6, (unsigned int)chain.joints.size());
+  for (unsigned int i=0; i < chain.joints.size(); i++) {
+    vpHomogeneousMatrix fMj = getJointPose(chain.joints[i]);
+    int axis = m_joints[chain.joints[i]].axis;
+    double z[3], r[3], v[3];
+    for (unsigned int k=0; k < 3; k++) {
+      z[k] = fMj[k][axis];
+      r[k] = f_t_e[k] - fMj[k][3];
+    }
+    // Linear velocity of the end-effector z x r and angular velocity z, expressed in the end-effector frame
+    v[0] = z[1]*r[2] - z[2]*r[1];
+    v[1] = z[2]*r[0] - z[0]*r[2];
+    v[2] = z[0]*r[1] - z[1]*r[0];
+    for (unsigned int k=0; k < 3; k++) {
+      eJe[k][i]   = eRf[k][0]*v[0] + eRf[k][1]*v[1] + eRf[k][2]*v[2];
+      eJe[k+3][i] = eRf[k][0]*z[0] + eRf[k][1]*z[1] + eRf[k][2]*z[2];
+    }
+  }
+}
+
+vpColVector vpSimulatedRobot::getJointMax(const std::vector<std::string> &names) const
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  vpColVector q_max((unsigned int)names.size());
+  for (unsigned int i=0; i < names.size(); i++)
+    q_max[i] = m_joints[getJointIndex(names[i])].max;
+  return q_max;
+}
+
+vpColVector vpSimulatedRobot::getJointMin(const std::vector<std::string> &names) const
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  vpColVector q_min((unsigned int)names.size());
+  for (unsigned int i=0; i < names.size(); i++)
+    q_min[i] = m_joints[getJointIndex(names[i])].min;
+  return q_min;
+}
+
+/*!
+  Velocities currently applied to the joints, that differ from the last ones set during the actuator latency.
+ */
+vpColVector vpSimulatedRobot::getJointVelocity(const std::vector<std::string> &names) const
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  vpColVector q_dot((unsigned int)names.size());
+  for (unsigned int i=0; i < names.size(); i++)
+    q_dot[i] = m_joints[getJointIndex(names[i])].q_dot;
+  return q_dot;
+}
+
+double vpSimulatedRobot::getLatency() const
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  return m_latency;
+}
+
+unsigned long vpSimulatedRobot::getNbSteps() const
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  return m_nb_steps;
+}
+
+vpColVector vpSimulatedRobot::getPosition(const std::vector<std::string> &names) const
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  vpColVector q((unsigned int)names.size());
+  for (unsigned int i=0; i < names.size(); i++)
+    q[i] = m_joints[getJointIndex(names[i])].q;
+  return q;
+}
+
+double vpSimulatedRobot::getRate() const
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  return m_rate;
+}
+
+/*!
+  Simulated time in s: the time of the wall clock while the simulation thread runs, otherwise the sum of the
+  durations given to step().
+ */
+double vpSimulatedRobot::getTime() const
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  return m_time;
+}
+
+void vpSimulatedRobot::setJointLimits(const std::string &name, double min, double max)
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  vpJoint &joint = m_joints[getJointIndex(name)];
+  joint.min = min;
+  joint.max = max;
+  joint.q = std::min(std::max(joint.q, min), max);
+}
+
+/*!
+  Set the time between a call to setVelocity() and the moment the joints reach the velocity.
+ */
+void vpSimulatedRobot::setLatency(double latency)
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  m_latency = latency;
+}
+
+void vpSimulatedRobot::setMaxVelocity(const std::string &name, double max_velocity)
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  m_joints[getJointIndex(name)].max_velocity = max_velocity;
+}
+
+/*!
+  Move the joints immediately to \e q, saturated to the joint limits. Used to set the initial configuration.
+ */
+void vpSimulatedRobot::setPosition(const std::vector<std::string> &names, const vpColVector &q)
+{
+  if (q.size() != names.size())
+    throw vpException(vpException::dimensionError, "%d joint positions for %d joints", (int)q.size(), (int)names.size());
+  vpMutex::vpScopedLock lock(m_mutex);
+  for (unsigned int i=0; i < names.size(); i++) {
+    vpJoint &joint = m_joints[getJointIndex(names[i])];
+    joint.q = std::min(std::max(q[i], joint.min), joint.max);
+  }
+}
+
+/*!
+  Set the rate in Hz at which the velocities are integrated.
+ */
+void vpSimulatedRobot::setRate(double rate)
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  m_rate = rate;
+}
+
+void vpSimulatedRobot::setVelocity(const std::vector<std::string> &names, const vpColVector &q_dot)
+{
+  if (q_dot.size() != names.size())
+    throw vpException(vpException::dimensionError, "%d joint velocities for %d joints", (int)q_dot.size(), (int)names.size());
+  vpMutex::vpScopedLock lock(m_mutex);
+  for (unsigned int i=0; i < names.size(); i++) {
+    vpCommand command;
+    command.joint = getJointIndex(names[i]);
+    double max_velocity = m_joints[command.joint].max_velocity;
+    command.q_dot = std::min(std::max(q_dot[i], -max_velocity), max_velocity);
+    command.time = m_time + m_latency;
+    m_commands.push_back(command);
+  }
+}
+
+void vpSimulatedRobot::stop(const std::vector<std::string> &names)
+{
+  setVelocity(names, vpColVector((unsigned int)names.size(), 0.));
+}
+
+/*!
+  Advance the simulation by \e dt seconds, in steps of at most one period. Only when the simulation thread
+  is not running.
+ */
+void vpSimulatedRobot::step(double dt)
+{
+  vpMutex::vpScopedLock lock(m_mutex);
+  double period = 1. / m_rate;
+  while (dt > 1e-12) {
+    double h = std::min(dt, period);
+    integrate(h);
+    dt -= h;
+  }
+}
+
+/*!
+  Apply the commands due at the beginning of the step and integrate the velocities. The mutex has to be locked.
+ */
+void vpSimulatedRobot::integrate(double dt)
+{
+  while (! m_commands.empty() && m_commands.front().time <= m_time + 1e-9) {
+    m_joints[m_commands.front().joint].q_dot = m_commands.front().q_dot;
+    m_commands.pop_front();
+  }
+  for (size_t i=0; i < m_joints.size(); i++) {
+    vpJoint &joint = m_joints[i];
+    joint.q += joint.q_dot * dt;
+    if (joint.q > joint.max || joint.q < joint.min) {
+      joint.q = std::min(std::max(joint.q, joint.min), joint.max);
+      joint.q_dot = 0.;
+    }
+  }
+  m_time += dt;
+  m_nb_steps ++;
+}
+
+/*!
+  Start the simulation thread, that integrates the velocities at the simulation rate following the wall clock.
+  Does nothing if it is already running.
+ */
+void vpSimulatedRobot::start()
+{
+  if (m_thread != NULL)
+    return;
+  {
+    vpMutex::vpScopedLock lock(m_mutex);
+    m_stop_requested = false;
+    m_time = vpTime::measureTimeSecond();
+    m_commands.clear();
+  }
+  m_thread = new vpThread(simulationLoop, (vpThread::Args)this);
+}
+
+void vpSimulatedRobot::stopSimulation()
+{
+  if (m_thread == NULL)
+    return;
+  {
+    vpMutex::vpScopedLock lock(m_mutex);
+    m_stop_requested = true;
+  }
+  m_thread->join();
+  delete m_thread;
+  m_thread = NULL;
+}
+
+vpThread::Return vpSimulatedRobot::simulationLoop(vpThread::Args args)
+{
+  vpSimulatedRobot *robot = (vpSimulatedRobot *)args;
+  robot->run();
+  return 0;
+}
+
+void vpSimulatedRobot::run()
+{
+  while (1) {
+    double t = vpTime::measureTimeMs();
+    double period;
+    {
+      vpMutex::vpScopedLock lock(m_mutex);
+      if (m_stop_requested)
+        break;
+      double dt = t / 1000. - m_time;
+      if (dt > 0)
+        integrate(dt);
+      period = 1000. / m_rate;
+    }
+    vpTime::wait(t, period);
+  }
+}
@@ -0,0 +1,136 @@
+#ifndef __vpSimulatedRobot_h__
+#define __vpSimulatedRobot_h__
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <visp/vpColVector.h>
+#include <visp/vpHomogeneousMatrix.h>
+#include <visp/vpMatrix.h>
+#include <visp3/core/vpMutex.h>
+#include <visp3/core/vpThread.h>
+
+#include <vpRobotBackend.h>
+
+/*!
+  Kinematic simulation of Romeo with the vpRobotBackend interface of vpNaoqiRobot, to run the control loops
+  of romeo_tk (vpServoArmScheduler, vpServoHeadScheduler, vpCartesianDisplacement) and measure their
+  convergence and throughput without robot. Use it with vpSimulatedCamera to close the loop on images.
+
+  The chains "Head" (NeckYaw, NeckPitch, HeadPitch, HeadRoll), "LEye" and "REye" (eye yaw and pitch),
+  "LArm" and "RArm" (7 joints and the hand) follow the structure of Romeo with an approximate geometry.
+  As with the robot, getBodyNames() of an arm ends with the hand, which is not in the Jacobian, and the
+  Jacobian of an eye has the four joints of the head followed by the two joints of the eye. All the poses
+  are expressed in the torso frame.
+
+  The velocities set with setVelocity() are applied after the actuator latency (see setLatency()), are
+  saturated to the maximum velocity of each joint and integrated at the simulation rate. A joint that reaches
+  one of its limits stops there.
+
+  The simulation either follows the wall clock in its own thread (start() and stopSimulation()), which is
+  needed by the schedulers, or is advanced with step() for deterministic runs.
+
+  \code
+  vpSimulatedRobot robot;
+  robot.setLatency(0.02);
+  robot.start();
+  std::vector<std::string> joint_names = robot.getBodyNames("Head");
+  vpServoHeadScheduler scheduler(robot, servo_head, "Head", joint_names);
+  scheduler.start();
+  ...
+  scheduler.stop();
+  robot.stopSimulation();
+  \endcode
+ */
+class vpSimulatedRobot : public vpRobotBackend
+{
+protected:
+  struct vpJoint {
+    std::string name;
+    int parent;                 // Index of the previous joint of the chain, -1 for the torso
+    vpHomogeneousMatrix pMj;    // Pose of the joint frame in the parent frame at q = 0
+    int axis;                   // Rotation axis 0 (x), 1 (y) or 2 (z) of the joint frame, -1 for a hand
+    double min;
+    double max;
+    double max_velocity;
+    double q;
+    double q_dot;               // Velocity currently applied
+  };
+  struct vpCommand {
+    double time;                // Time at which the command reaches the actuator
+    unsigned int joint;
+    double q_dot;
+  };
+  struct vpChain {
+    std::vector<std::string> body_names;
+    std::vector<unsigned int> joints;   // Joints of the Jacobian, from the torso to the end-effector
+    vpHomogeneousMatrix jMe;            // End-effector frame in the frame of the last joint
+  };
+
+  std::vector<vpJoint> m_joints;
+  std::map<std::string, unsigned int> m_joint_index;
+  std::map<std::string, vpChain> m_chains;
+  std::deque<vpCommand> m_commands;
+  double m_rate;                // Integration rate in Hz
+  double m_latency;             // Actuator latency in s
+  double m_time;                // Simulated time in s
+  unsigned long m_nb_steps;
+  mutable vpMutex m_mutex;      // Protects the state shared with the simulation thread
+  vpThread *m_thread;
+  bool m_stop_requested;
+
+public:
+  vpSimulatedRobot();
+  virtual ~vpSimulatedRobot();
+
+  // vpRobotBackend
+  virtual std::vector<std::string> getBodyNames(const std::string &names) const;
+  virtual vpMatrix get_eJe(const std::string &chain_name) const;
+  virtual void get_eJe(const std::string &chain_name, vpMatrix &eJe) const;
+  virtual vpColVector getPosition(const std::vector<std::string> &names) const;
+  virtual void setVelocity(const std::vector<std::string> &names, const vpColVector &q_dot);
+  virtual void stop(const std::vector<std::string> &names);
+
+  vpHomogeneousMatrix get_fMe(const std::string &chain_name) const;
+  vpColVector getJointMax(const std::vector<std::string> &names) const;
+  vpColVector getJointMin(const std::vector<std::string> &names) const;
+  vpColVector getJointVelocity(const std::vector<std::string> &names) const;
+  double getLatency() const;
+  unsigned long getNbSteps() const;
+  double getRate() const;
+  double getTime() const;
+
+  bool isRunning() const {return m_thread != NULL;}
+
+  void setJointLimits(const std::string &name, double min, double max);
+  void setLatency(double latency);
+  void setMaxVelocity(const std::string &name, double max_velocity);
+  void setPosition(const std::vector<std::string> &names, const vpColVector &q);
+  void setRate(double rate);
+
+  void start();
+  void step(double dt);
+  void stopSimulation();
+
+protected:
+  unsigned int addJoint(const std::string &name, const std::string &parent, const vpHomogeneousMatrix &pMj,
+                        int axis, double min, double max, double max_velocity=2.);
+  void addChain(const std::string &chain_name, const std::string &last_joint,
+                const vpHomogeneousMatrix &jMe=vpHomogeneousMatrix(), const std::string &hand="",
+                unsigned int nb_body_joints=0);
+  const vpChain &getChain(const std::string &chain_name) const;
+  unsigned int getJointIndex(const std::string &name) const;
+  vpHomogeneousMatrix getJointPose(unsigned int joint) const;
+  void integrate(double dt);
+
+private:
+  static vpThread::Return simulationLoop(vpThread::Args args);
+  void run();
+
+  vpSimulatedRobot(const vpSimulatedRobot &);
+  vpSimulatedRobot &operator=(const vpSimulatedRobot &);
+};
+
+#endif
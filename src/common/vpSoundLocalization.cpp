@@ -0,0 +1,196 @@
+#include <math.h>
+#include <algorithm>
+
+#include <visp/vpException.h>
+
+#include <vpAudioFeatures.h>
+#include <vpSoundLocalization.h>
+
+/*!
+  Create a localization on frames of \e frame_length samples at \e sample_rate Hz from two microphones
+  \e mic_distance m apart. The default distance is the one of the microphones used for the head
+  servoing experiments on Romeo.
+ */
+vpSoundLocalization::vpSoundLocalization(double sample_rate, unsigned int frame_length, double mic_distance,
+                                         double sound_speed)
+  : m_sample_rate(sample_rate), m_frame_length(frame_length), m_nfft(1), m_mic_distance(0.),
+    m_sound_speed(sound_speed), m_energy_threshold(1e-6), m_max_lag(0), m_window(frame_length),
+    m_w2(frame_length), m_frame_l(), m_frame_r(), m_spectrum_l(), m_spectrum_r(), m_cross(), m_correlation(),
+    m_valid(false), m_energy_l(0), m_energy_r(0), m_delay(0), m_azimuth(0), m_peak(0), m_time(0), m_nb_frames(0)
+{
+  if (sample_rate <= 0 || sound_speed <= 0)
+    throw vpException(vpException::badValue, "Sample rate of %f Hz, sound speed of %f m/s", sample_rate, sound_speed);
+  if (frame_length < 2)
+    throw vpException(vpException::badValue, "Audio frame of %d samples", frame_length);
+
+  for (unsigned int j=0; j < frame_length; j++) {
+    m_window[j] = (float)(0.54 - 0.46 * cos(2. * M_PI * j / (frame_length - 1.)));
+    m_w2[j] = m_window[j] * m_window[j];
+  }
+
+  // Zero padding to twice the frame length avoids the circular wrap of the correlation
+  while (m_nfft < 2 * frame_length)
+    m_nfft <<= 1;
+  m_frame_l = cv::Mat::zeros(1, (int)m_nfft, CV_32F);
+  m_frame_r = cv::Mat::zeros(1, (int)m_nfft, CV_32F);
+  m_spectrum_l.create(1, (int)m_nfft, CV_32F);
+  m_spectrum_r.create(1, (int)m_nfft, CV_32F);
+  m_cross.create(1, (int)m_nfft, CV_32F);
+  m_correlation.create(1, (int)m_nfft, CV_32F);
+
+  setMicrophoneDistance(mic_distance);
+}
+
+/*!
+  Set the distance in m between the two microphones, that bounds the delays searched by GCC-PHAT.
+ */
+void vpSoundLocalization::setMicrophoneDistance(double distance)
+{
+  if (distance <= 0)
+    throw vpException(vpException::badValue, "Microphone distance of %f m", distance);
+  m_mic_distance = distance;
+  m_max_lag = (int)ceil(distance / m_sound_speed * m_sample_rate) + 1;
+  if (m_max_lag >= (int)m_frame_length)
+    throw vpException(vpException::badValue, "Frames of %d samples are shorter than the delay of %d samples between "
+                      "microphones %f m apart", m_frame_length, m_max_lag, distance);
+}
+
+/*!
+  Interaural level difference 10.log10(E_left / E_right) in dB of the last frame, positive when the source is
+  on the left.
+ */
+double vpSoundLocalization::getIld() const
+{
+  if (m_energy_l <= 0 || m_energy_r <= 0)
+    return 0.;
+  return 10. * log10(m_energy_l / m_energy_r);
+}
+
+/*!
+  Energy ratio right / left of the last frame, like computeRatio() of the audio tests, or -1 if the frame is
+  below the energy threshold.
+ */
+double vpSoundLocalization::getLevelRatio() const
+{
+  if (! m_valid || m_energy_l <= 0)
+    return -1.;
+  return m_energy_r / m_energy_l;
+}
+
+/*!
+  Energy ratio right / left of the \e nb_slices consecutive energies \e energy_l and \e energy_r, summed on the
+  slices where one of the channels is louder than \e threshold, or -1 if the sums are too low. Same as getRatio()
+  of audio_test_romeo_neck, on the energy vectors of ALSoundProcessing or on the envelopes of vpAudioFeatures
+  scaled to int16 samples.
+ */
+float vpSoundLocalization::getLevelRatio(const float *energy_l, const float *energy_r, float threshold,
+                                         unsigned int nb_slices)
+{
+  float sum_l = 0, sum_r = 0;
+  for (unsigned int i=0; i < nb_slices; i++)
+    if (energy_l[i] > threshold || energy_r[i] > threshold) {
+      sum_l += energy_l[i];
+      sum_r += energy_r[i];
+    }
+  if (sum_r > 1 && sum_l > 1)
+    return sum_r / sum_l;
+  return -1;
+}
+
+/*!
+  Projection in the image of a camera looking forward of the direction of the source, at the height of the
+  principal point. The azimuth is saturated to \e max_azimuth rad so that the point stays finite when the source
+  is on the side or behind.
+ */
+vpImagePoint vpSoundLocalization::getImagePoint(const vpCameraParameters &cam, double max_azimuth) const
+{
+  double azimuth = std::max(-max_azimuth, std::min(max_azimuth, m_azimuth));
+  // The camera x axis points to the right, the azimuth is positive on the left
+  double x = -tan(azimuth);
+  return vpImagePoint(cam.get_v0(), cam.get_u0() + cam.get_px() * x);
+}
+
+/*!
+  Localize the source on a frame of getFrameLength() samples of each microphone.
+  \return true if the frame is loud enough, in which case getAzimuth() and getDelay() are updated.
+ */
+bool vpSoundLocalization::process(const float *left, const float *right)
+{
+  m_nb_frames ++;
+  m_energy_l = vpAudioFeatures::dotSquare(&m_w2[0], left, m_frame_length);
+  m_energy_r = vpAudioFeatures::dotSquare(&m_w2[0], right, m_frame_length);
+  m_valid = (std::max(m_energy_l, m_energy_r) >= m_energy_threshold);
+  if (! m_valid)
+    return false;
+
+  float *frame_l = m_frame_l.ptr<float>(0);
+  float *frame_r = m_frame_r.ptr<float>(0);
+  for (unsigned int j=0; j < m_frame_length; j++) {
+    frame_l[j] = m_window[j] * left[j];
+    frame_r[j] = m_window[j] * right[j];
+  }
+  cv::dft(m_frame_l, m_spectrum_l);
+  cv::dft(m_frame_r, m_spectrum_r);
+
+  // Cross-spectrum R.conj(L), whose inverse peaks at the delay of the right channel, keeping only the phase.
+  // The spectra are packed (CCS): DC and Nyquist bins are real, the others are (re, im) pairs.
+  cv::mulSpectrums(m_spectrum_r, m_spectrum_l, m_cross, 0, true);
+  float *cross = m_cross.ptr<float>(0);
+  const float eps = 1e-12f;
+  cross[0] = cross[0] / (fabsf(cross[0]) + eps);
+  cross[m_nfft-1] = cross[m_nfft-1] / (fabsf(cross[m_nfft-1]) + eps);
+  for (unsigned int k=1; k + 1 < m_nfft; k += 2) {
+    float norm = sqrtf(cross[k]*cross[k] + cross[k+1]*cross[k+1]) + eps;
+    cross[k] /= norm;
+    cross[k+1] /= norm;
+  }
+  cv::dft(m_cross, m_correlation, cv::DFT_INVERSE | cv::DFT_REAL_OUTPUT | cv::DFT_SCALE);
+
+  m_delay = findDelay() / m_sample_rate;
+  double s = std::max(-1., std::min(1., m_delay * m_sound_speed / m_mic_distance));
+  m_azimuth = asin(s);
+  return true;
+}
+
+/*!
+  Localize the source on the current frame of \e capture, using its channels \e left and \e right.
+ */
+bool vpSoundLocalization::process(const vpAudioCapture &capture, unsigned int left, unsigned int right)
+{
+  if (capture.getFrameLength() != m_frame_length)
+    throw vpException(vpException::dimensionError, "Audio frames of %d samples instead of %d",
+                      capture.getFrameLength(), m_frame_length);
+  if (left >= capture.getNbChannels() || right >= capture.getNbChannels())
+    throw vpException(vpException::badValue, "No audio channel %d or %d", left, right);
+  m_time = capture.getTime();
+  return process(capture.getChannel(left), capture.getChannel(right));
+}
+
+/*!
+  Delay in samples of the highest peak of the correlation within +/- m_max_lag, with sub-sample precision.
+ */
+double vpSoundLocalization::findDelay()
+{
+  const float *r = m_correlation.ptr<float>(0);
+  int n = (int)m_nfft;
+  int best = 0;
+  float best_value = r[0];
+  for (int lag = -m_max_lag; lag <= m_max_lag; lag++) {
+    float value = r[(lag + n) % n];
+    if (value > best_value) {
+      best_value = value;
+      best = lag;
+    }
+  }
+  m_peak = best_value;
+
+  // Parabola through the peak and its neighbours
+  double y0 = r[(best - 1 + n) % n];
+  double y1 = best_value;
+  double y2 = r[(best + 1) % n];
+  double denominator = y0 - 2. * y1 + y2;
+  double offset = 0.;
+  if (denominator < 0)
+    offset = std::max(-0.5, std::min(0.5, 0.5 * (y0 - y2) / denominator));
+  return best + offset;
+}
@@ -0,0 +1,111 @@
+#ifndef __vpSoundLocalization_h__
+#define __vpSoundLocalization_h__
+
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+#include <visp/vpCameraParameters.h>
+#include <visp/vpImagePoint.h>
+
+#include <vpAudioCapture.h>
+
+/*!
+  Azimuth of a sound source from a pair of microphones, estimated on each frame of a vpAudioCapture.
+
+  For each frame the class computes:
+  - the interaural level difference (ILD) from the Hamming windowed energies of both channels, with the
+    energy ratio right / left used by the audio tests,
+  - the time delay between the channels by generalized cross-correlation with phase transform (GCC-PHAT):
+    the cross-spectrum of the zero padded frames is normalized to keep only its phase, and the peak of its
+    inverse FFT within the delays allowed by the microphone distance gives the delay, refined to a fraction
+    of sample by parabolic interpolation,
+  - the azimuth asin(c.delay / d), positive when the source is on the left like the yaw of the head.
+
+  The frames quieter than the energy threshold give no estimate. All the buffers are allocated by the
+  constructor, so that process() can run at hop rate in the processing loop.
+
+  getImagePoint() projects the direction of the source in the image of a head camera, so that it can be
+  given as current feature to vpServoHead with the image center as desired feature to turn the head toward
+  the speaker.
+
+  \code
+  vpAudioCapture capture(2, 48000, 1024, 512);
+  vpSoundLocalization localization(48000, 1024, 0.31);
+  ... // start the RtAudio stream with vpAudioCapture::callbackInt16
+  while (...) {
+    if (capture.acquire(100) && localization.process(capture)) {
+      servo_head.setCurrentFeature(localization.getImagePoint(cam));
+      q_dot = servo_head.computeControlLaw();
+    }
+  }
+  \endcode
+ */
+class vpSoundLocalization
+{
+protected:
+  double m_sample_rate;
+  unsigned int m_frame_length;
+  unsigned int m_nfft;              // Length of the zero padded frames, a power of two
+  double m_mic_distance;
+  double m_sound_speed;
+  double m_energy_threshold;
+  int m_max_lag;                    // Largest delay in samples allowed by the microphone distance
+  std::vector<float> m_window;
+  std::vector<float> m_w2;
+  cv::Mat m_frame_l;
+  cv::Mat m_frame_r;
+  cv::Mat m_spectrum_l;
+  cv::Mat m_spectrum_r;
+  cv::Mat m_cross;
+  cv::Mat m_correlation;
+
+  bool m_valid;
+  double m_energy_l;
+  double m_energy_r;
+  double m_delay;
+  double m_azimuth;
+  double m_peak;
+  double m_time;
+  unsigned long m_nb_frames;
+
+public:
+  vpSoundLocalization(double sample_rate=48000., unsigned int frame_length=1024, double mic_distance=0.31,
+                      double sound_speed=343.);
+  virtual ~vpSoundLocalization() {}
+
+  //! Azimuth of the source in rad of the last valid frame, positive on the left.
+  double getAzimuth() const {return m_azimuth;}
+  //! Delay in s of the right channel on the left one for the last valid frame.
+  double getDelay() const {return m_delay;}
+  double getEnergyLeft() const {return m_energy_l;}
+  double getEnergyRight() const {return m_energy_r;}
+  double getEnergyThreshold() const {return m_energy_threshold;}
+  unsigned int getFrameLength() const {return m_frame_length;}
+  double getIld() const;
+  vpImagePoint getImagePoint(const vpCameraParameters &cam, double max_azimuth=1.2) const;
+  double getLevelRatio() const;
+  static float getLevelRatio(const float *energy_l, const float *energy_r, float threshold, unsigned int nb_slices);
+  //! Largest delay in samples that the microphone distance allows.
+  unsigned int getMaxLag() const {return (unsigned int)m_max_lag;}
+  double getMicrophoneDistance() const {return m_mic_distance;}
+  //! Number of frames processed.
+  unsigned long getNbFrames() const {return m_nb_frames;}
+  //! Height of the GCC-PHAT peak, close to 1 for a single source without reverberation.
+  double getPeak() const {return m_peak;}
+  //! Time in s of the last frame given by process(const vpAudioCapture &).
+  double getTime() const {return m_time;}
+  //! True if the last frame was loud enough to be localized.
+  bool isValid() const {return m_valid;}
+
+  bool process(const float *left, const float *right);
+  bool process(const vpAudioCapture &capture, unsigned int left=0, unsigned int right=1);
+
+  void setEnergyThreshold(double threshold) {m_energy_threshold = threshold;}
+  void setMicrophoneDistance(double distance);
+
+protected:
+  double findDelay();
+};
+
+#endif
@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+#include <vpStageProfiler.h>
+
+
+/*!
+  Create a profiler able to keep the last \e capacity durations of each stage.
+  All the memory is allocated here, addSample() never allocates.
+  The profiler is disabled by default.
+ */
+vpStageProfiler::vpStageProfiler(const std::string &name, unsigned int capacity)
+  : m_name(name), m_enabled(false), m_capacity(capacity > 0 ? capacity : 1),
+    m_samples(nb_stages * (capacity > 0 ? capacity : 1), 0.), m_sorted(capacity > 0 ? capacity : 1, 0.)
+{
+  reset();
+}
+
+/*!
+  Store the duration of a stage in its ring buffer. The oldest sample is overwritten
+  when the buffer is full.
+  \param stage : Stage that was measured.
+  \param duration_ms : Duration in ms.
+ */
+void vpStageProfiler::addSample(stage_t stage, double duration_ms)
+{
+  if (stage >= nb_stages)
+    return;
+  m_samples[stage*m_capacity + m_index[stage]] = duration_ms;
+  m_index[stage] = (m_index[stage] + 1) % m_capacity;
+  if (m_count[stage] < m_capacity)
+    m_count[stage] ++;
+  m_total[stage] ++;
+}
+
+/*!
+  Return the last duration in ms recorded for \e stage, or 0 if the stage was never measured.
+ */
+double vpStageProfiler::getLast(stage_t stage) const
+{
+  if (m_count[stage] == 0)
+    return 0.;
+  unsigned int last = (m_index[stage] + m_capacity - 1) % m_capacity;
+  return m_samples[stage*m_capacity + last];
+}
+
+/*!
+  Return the mean duration in ms of the samples available for \e stage.
+ */
+double vpStageProfiler::getMean(stage_t stage) const
+{
+  if (m_count[stage] == 0)
+    return 0.;
+  double sum = 0.;
+  for (unsigned int i=0; i < m_count[stage]; i++)
+    sum += m_samples[stage*m_capacity + i];
+  return sum / m_count[stage];
+}
+
+/*!
+  Return the percentile of the durations in ms available for \e stage.
+  \param stage : Stage to consider.
+  \param percent : Percentile in [0, 100], for example 50 for the median or 99.
+ */
+double vpStageProfiler::getPercentile(stage_t stage, double percent)
+{
+  unsigned int n = m_count[stage];
+  if (n == 0)
+    return 0.;
+  if (percent < 0.)
+    percent = 0.;
+  else if (percent > 100.)
+    percent = 100.;
+
+  std::copy(m_samples.begin() + stage*m_capacity, m_samples.begin() + stage*m_capacity + n, m_sorted.begin());
+  unsigned int k = (unsigned int)(percent / 100. * (n - 1) + 0.5);
+  std::nth_element(m_sorted.begin(), m_sorted.begin() + k, m_sorted.begin() + n);
+  return m_sorted[k];
+}
+
+std::string vpStageProfiler::getStageName(stage_t stage)
+{
+  switch (stage) {
+  case detect:   return "detect";
+  case match:    return "match";
+  case ransac:   return "ransac";
+  case init:     return "init";
+  case track:    return "track";
+  case pose:     return "pose";
+  case validate: return "validate";
+  case process:  return "process";
+  default:       return "unknown";
+  }
+}
+
+/*!
+  Print for each measured stage the number of samples, the mean, the 50, 95, 99 percentiles
+  and the max duration in ms.
+ */
+void vpStageProfiler::printSummary(std::ostream &os)
+{
+  os << "Timing summary for " << m_name << " (ms)" << std::endl;
+  os << std::setw(10) << "stage" << std::setw(10) << "count" << std::setw(10) << "mean"
+     << std::setw(10) << "p50" << std::setw(10) << "p95" << std::setw(10) << "p99"
+     << std::setw(10) << "max" << std::endl;
+  for (unsigned int s=0; s < nb_stages; s++) {
+    stage_t stage = (stage_t)s;
+    if (m_count[stage] == 0)
+      continue;
+    os << std::setw(10) << getStageName(stage) << std::setw(10) << m_total[stage]
+       << std::fixed << std::setprecision(3)
+       << std::setw(10) << getMean(stage)
+       << std::setw(10) << getPercentile(stage, 50)
+       << std::setw(10) << getPercentile(stage, 95)
+       << std::setw(10) << getPercentile(stage, 99)
+       << std::setw(10) << getPercentile(stage, 100) << std::endl;
+  }
+}
+
+/*!
+  Remove all the samples. The memory is kept.
+ */
+void vpStageProfiler::reset()
+{
+  for (unsigned int s=0; s < nb_stages; s++) {
+    m_index[s] = 0;
+    m_count[s] = 0;
+    m_total[s] = 0;
+  }
+}
+
+/*!
+  Save the available samples in a CSV file with columns: tracker, stage, sample, duration_ms.
+  Samples are saved from the oldest to the newest.
+  \return true if the file could be written.
+ */
+bool vpStageProfiler::saveCsv(const std::string &filename) const
+{
+  std::ofstream file(filename.c_str());
+  if (! file.is_open()) {
+    std::cout << "Cannot create timing file: " << filename << std::endl;
+    return false;
+  }
+
+  file << "tracker,stage,sample,duration_ms" << std::endl;
+  for (unsigned int s=0; s < nb_stages; s++) {
+    stage_t stage = (stage_t)s;
+    unsigned int n = m_count[stage];
+    unsigned int first = (m_index[stage] + m_capacity - n) % m_capacity;
+    unsigned long id = m_total[stage] - n;
+    for (unsigned int i=0; i < n; i++) {
+      file << m_name << "," << getStageName(stage) << "," << id + i << ","
+           << m_samples[stage*m_capacity + (first + i) % m_capacity] << std::endl;
+    }
+  }
+  file.close();
+  return true;
+}
@@ -0,0 +1,115 @@
+#ifndef __vpStageProfiler_h__
+#define __vpStageProfiler_h__
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <visp/vpTime.h>
+
+/*!
+  Per-stage timing instrumentation used inside the trackers.
+
+  Each stage (detection, matching, RANSAC, initialization, tracking, pose
+  estimation, validation, or the whole processing of a pipeline stage) owns a ring buffer of the last durations, allocated
+  once in the constructor. When the profiler is disabled (default) a scoped
+  timer costs a single test and never reads the clock.
+
+  \code
+  vpQRCodeTracker qrcode_tracker;
+  qrcode_tracker.getProfiler().setEnabled(true);
+  ...
+  qrcode_tracker.track(I);
+  ...
+  qrcode_tracker.getProfiler().printSummary(std::cout);
+  qrcode_tracker.getProfiler().saveCsv("qrcode_timings.csv");
+  \endcode
+ */
+class vpStageProfiler
+{
+public:
+  typedef enum {
+    detect,
+    match,
+    ransac,
+    init,
+    track,
+    pose,
+    validate,
+    process,
+    nb_stages
+  } stage_t;
+
+  /*!
+    Measure the time spent in a scope and store it in the profiler
+    when the timer goes out of scope.
+   */
+  class vpScopedTimer
+  {
+  public:
+    vpScopedTimer(vpStageProfiler &profiler, vpStageProfiler::stage_t stage)
+      : m_profiler(profiler), m_stage(stage), m_running(profiler.isEnabled()), m_t_start(0)
+    {
+      if (m_running)
+        m_t_start = vpTime::measureTimeMs();
+    }
+    ~vpScopedTimer()
+    {
+      stop();
+    }
+
+    //! Stop the timer before the end of the scope.
+    void stop()
+    {
+      if (m_running) {
+        m_profiler.addSample(m_stage, vpTime::measureTimeMs() - m_t_start);
+        m_running = false;
+      }
+    }
+
+  private:
+    vpScopedTimer(const vpScopedTimer &);
+    vpScopedTimer &operator=(const vpScopedTimer &);
+
+    vpStageProfiler &m_profiler;
+    vpStageProfiler::stage_t m_stage;
+    bool m_running;
+    double m_t_start;
+  };
+
+protected:
+  std::string m_name;
+  bool m_enabled;
+  unsigned int m_capacity;
+  std::vector<double> m_samples; // nb_stages ring buffers of m_capacity durations in ms
+  std::vector<double> m_sorted;  // Scratch buffer used to compute the percentiles
+  unsigned int m_index[nb_stages];
+  unsigned int m_count[nb_stages];
+  unsigned long m_total[nb_stages];
+
+public:
+  vpStageProfiler(const std::string &name="tracker", unsigned int capacity=512);
+  virtual ~vpStageProfiler() {}
+
+  void addSample(stage_t stage, double duration_ms);
+
+  unsigned int getCapacity() const {return m_capacity;}
+  unsigned int getCount(stage_t stage) const {return m_count[stage];}
+  double getLast(stage_t stage) const;
+  double getMean(stage_t stage) const;
+  std::string getName() const {return m_name;}
+  double getPercentile(stage_t stage, double percent);
+  static std::string getStageName(stage_t stage);
+  unsigned long getTotalCount(stage_t stage) const {return m_total[stage];}
+
+  bool isEnabled() const {return m_enabled;}
+
+  void printSummary(std::ostream &os);
+  void reset();
+  bool saveCsv(const std::string &filename) const;
+
+  void setEnabled(bool enabled) {m_enabled = enabled;}
+  void setName(const std::string &name) {m_name = name;}
+};
+
+#endif
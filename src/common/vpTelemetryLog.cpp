@@ -0,0 +1,149 @@
+#include <string.h>
+
+#include <fstream>
+#include <iomanip>
+
+#include <visp/vpException.h>
+
+#include <vpTelemetryLog.h>
+
+
+vpTelemetryLog::vpTelemetryLog()
+  : m_channels(), m_records(), m_record_size(0), m_nb_records(0)
+{
+}
+
+/*!
+  Read the whole file. Only the records counted in the header are read, so that a file left by a process
+  that crashed can be read.
+ */
+void vpTelemetryLog::open(const std::string &filename)
+{
+  std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+  if (! file.is_open())
+    throw vpException(vpException::ioError, "Cannot open telemetry file: %s", filename.c_str());
+
+  vpTelemetryRecorder::vpHeader header;
+  file.read((char *)&header, sizeof(header));
+  if (! file.good() || memcmp(header.magic, "RTKTLM", 6) != 0)
+    throw vpException(vpException::ioError, "%s is not a telemetry file", filename.c_str());
+  if (header.version != vpTelemetryRecorder::version)
+    throw vpException(vpException::ioError, "Unsupported telemetry file version %d", header.version);
+  if (header.nb_channels > vpTelemetryRecorder::maxChannels)
+    throw vpException(vpException::ioError, "Corrupted telemetry file header: %s has %u channels, at most %u are supported",
+                      filename.c_str(), (unsigned int)header.nb_channels, vpTelemetryRecorder::maxChannels);
+
+  m_channels.resize(header.nb_channels);
+  unsigned int offset = vpTelemetryRecorder::valuesOffset;
+  for (unsigned int i=0; i < header.nb_channels; i++) {
+    uint32_t description[3];
+    file.read((char *)description, sizeof(description));
+    m_channels[i].type = (vpTelemetryRecorder::type_t)description[0];
+    m_channels[i].size = description[1];
+    m_channels[i].name.resize(description[2]);
+    if (description[2] > 0)
+      file.read(&m_channels[i].name[0], description[2]);
+    m_channels[i].offset = offset;
+    unsigned int size = m_channels[i].size * vpTelemetryRecorder::getTypeSize(m_channels[i].type);
+    offset += (size + 7) & ~7u;
+  }
+  if (! file.good() || offset != header.record_size)
+    throw vpException(vpException::ioError, "Corrupted telemetry file header: %s", filename.c_str());
+
+  m_record_size = header.record_size;
+  m_nb_records = (unsigned long)header.nb_records;
+  m_records.resize((size_t)m_nb_records * m_record_size);
+  file.seekg(header.header_size, std::ios::beg);
+  if (! m_records.empty())
+    file.read((char *)&m_records[0], m_records.size());
+  if (! file.good()) {
+    // The file may have been truncated by a crash: only keep the complete records
+    m_nb_records = (unsigned long)(file.gcount() / m_record_size);
+    m_records.resize((size_t)m_nb_records * m_record_size);
+  }
+}
+
+/*!
+  Return the index of the channel named \e name, or -1.
+ */
+int vpTelemetryLog::getChannel(const std::string &name) const
+{
+  for (size_t i=0; i < m_channels.size(); i++)
+    if (m_channels[i].name == name)
+      return (int)i;
+  return -1;
+}
+
+double vpTelemetryLog::getTimestamp(unsigned long record) const
+{
+  double t;
+  memcpy(&t, &m_records[(size_t)record * m_record_size], sizeof(double));
+  return t;
+}
+
+/*!
+  Return true if \e channel was written in \e record.
+ */
+bool vpTelemetryLog::hasValues(unsigned long record, unsigned int channel) const
+{
+  uint64_t mask;
+  memcpy(&mask, &m_records[(size_t)record * m_record_size + vpTelemetryRecorder::maskOffset], sizeof(uint64_t));
+  return (mask & ((uint64_t)1 << channel)) != 0;
+}
+
+double vpTelemetryLog::getValue(unsigned long record, unsigned int channel, unsigned int index) const
+{
+  const vpChannel &c = m_channels[channel];
+  const unsigned char *ptr = &m_records[(size_t)record * m_record_size + c.offset];
+  if (c.type == vpTelemetryRecorder::float64) {
+    double v;
+    memcpy(&v, ptr + index * sizeof(double), sizeof(double));
+    return v;
+  }
+  else if (c.type == vpTelemetryRecorder::float32) {
+    float v;
+    memcpy(&v, ptr + index * sizeof(float), sizeof(float));
+    return v;
+  }
+  int32_t v;
+  memcpy(&v, ptr + index * sizeof(int32_t), sizeof(int32_t));
+  return v;
+}
+
+/*!
+  Write the records as CSV: the timestamp followed by the values of \e channels, or of all the channels
+  if \e channels is empty. Values of the channels that were not written in a record are left empty.
+ */
+void vpTelemetryLog::saveCsv(std::ostream &os, const std::vector<unsigned int> &channels) const
+{
+  std::vector<unsigned int> selection = channels;
+  if (selection.empty())
+    for (unsigned int i=0; i < m_channels.size(); i++)
+      selection.push_back(i);
+
+  os << "t";
+  for (size_t i=0; i < selection.size(); i++) {
+    const vpChannel &c = m_channels[selection[i]];
+    if (c.size == 1)
+      os << "," << c.name;
+    else
+      for (unsigned int j=0; j < c.size; j++)
+        os << "," << c.name << "_" << j;
+  }
+  os << std::endl;
+
+  os << std::setprecision(15);
+  for (unsigned long r=0; r < m_nb_records; r++) {
+    os << getTimestamp(r);
+    for (size_t i=0; i < selection.size(); i++) {
+      unsigned int ch = selection[i];
+      bool valid = hasValues(r, ch);
+      for (unsigned int j=0; j < m_channels[ch].size; j++) {
+        os << ",";
+        if (valid)
+          os << getValue(r, ch, j);
+      }
+    }
+    os << "\n";
+  }
+}
@@ -0,0 +1,58 @@
+#ifndef __vpTelemetryLog_h__
+#define __vpTelemetryLog_h__
+
+#include <stdint.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <vpTelemetryRecorder.h>
+
+/*!
+  Read a telemetry file written by vpTelemetryRecorder, even if the recording process crashed.
+
+  \code
+  vpTelemetryLog log;
+  log.open("telemetry.bin");
+  int ch = log.getChannel("q_dot");
+  for (unsigned long r=0; r < log.getNbRecords(); r++)
+    if (log.hasValues(r, ch))
+      std::cout << log.getTimestamp(r) << " " << log.getValue(r, ch, 0) << std::endl;
+  \endcode
+ */
+class vpTelemetryLog
+{
+protected:
+  struct vpChannel {
+    std::string name;
+    vpTelemetryRecorder::type_t type;
+    unsigned int size;
+    unsigned int offset;
+  };
+
+  std::vector<vpChannel> m_channels;
+  std::vector<unsigned char> m_records;
+  unsigned int m_record_size;
+  unsigned long m_nb_records;
+
+public:
+  vpTelemetryLog();
+  virtual ~vpTelemetryLog() {}
+
+  int getChannel(const std::string &name) const;
+  std::string getChannelName(unsigned int channel) const {return m_channels[channel].name;}
+  unsigned int getChannelSize(unsigned int channel) const {return m_channels[channel].size;}
+  unsigned int getNbChannels() const {return (unsigned int)m_channels.size();}
+  unsigned long getNbRecords() const {return m_nb_records;}
+  double getTimestamp(unsigned long record) const;
+  double getValue(unsigned long record, unsigned int channel, unsigned int index) const;
+
+  bool hasValues(unsigned long record, unsigned int channel) const;
+
+  void open(const std::string &filename);
+
+  void saveCsv(std::ostream &os, const std::vector<unsigned int> &channels) const;
+};
+
+#endif
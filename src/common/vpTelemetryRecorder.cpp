@@ -0,0 +1,246 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <iostream>
+
+#include <visp/vpException.h>
+
+#include <vpTelemetryRecorder.h>
+#include <vpThetaU.h>
+
+namespace {
+  unsigned int align8(unsigned int size) {return (size + 7) & ~7u;}
+
+  // Write a value with the type of its channel and move to the next value
+  void writeValue(unsigned char *&ptr, vpTelemetryRecorder::type_t type, double value)
+  {
+    if (type == vpTelemetryRecorder::float64) {
+      memcpy(ptr, &value, sizeof(double));
+      ptr += sizeof(double);
+    }
+    else if (type == vpTelemetryRecorder::float32) {
+      float v = (float)value;
+      memcpy(ptr, &v, sizeof(float));
+      ptr += sizeof(float);
+    }
+    else {
+      int32_t v = (int32_t)value;
+      memcpy(ptr, &v, sizeof(int32_t));
+      ptr += sizeof(int32_t);
+    }
+  }
+}
+
+vpTelemetryRecorder::vpTelemetryRecorder()
+  : m_channels(), m_filename(), m_fd(-1), m_map(NULL), m_map_size(0), m_header_size(0), m_record_size(valuesOffset),
+    m_capacity(0), m_nb_records(0), m_nb_dropped(0), m_record(NULL)
+{
+}
+
+vpTelemetryRecorder::~vpTelemetryRecorder()
+{
+  close();
+}
+
+/*!
+  Declare a channel. Channels cannot be added once the file is opened.
+  \param name : Name of the channel, used by the exporter.
+  \param size : Number of values of the channel.
+  \param type : Type of the values in the file. Values are always given as double and converted.
+  \return Index of the channel, to pass to record().
+ */
+unsigned int vpTelemetryRecorder::addChannel(const std::string &name, unsigned int size, type_t type)
+{
+  if (isOpened())
+    throw vpException(vpException::fatalError, "Cannot add channel %s to an opened telemetry file", name.c_str());
+  if (m_channels.size() == maxChannels)
+    throw vpException(vpException::dimensionError, "Cannot add more than %d telemetry channels", maxChannels);
+
+  vpChannel channel;
+  channel.name = name;
+  channel.type = type;
+  channel.size = size;
+  channel.offset = m_record_size;
+  m_channels.push_back(channel);
+  m_record_size += align8(size * getTypeSize(type));
+  return (unsigned int)m_channels.size() - 1;
+}
+
+/*!
+  Create the file, preallocated for \e capacity records, and map it in memory.
+ */
+void vpTelemetryRecorder::open(const std::string &filename, unsigned long capacity)
+{
+  close();
+
+  m_header_size = sizeof(vpHeader);
+  for (size_t i=0; i < m_channels.size(); i++)
+    m_header_size += 3*sizeof(uint32_t) + (unsigned int)m_channels[i].name.size();
+  m_header_size = align8(m_header_size);
+
+  m_fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (m_fd < 0)
+    throw vpException(vpException::ioError, "Cannot create telemetry file %s: %s", filename.c_str(), strerror(errno));
+
+  m_map_size = m_header_size + (size_t)capacity * m_record_size;
+  if (ftruncate(m_fd, (off_t)m_map_size) != 0) {
+    ::close(m_fd);
+    m_fd = -1;
+    throw vpException(vpException::ioError, "Cannot allocate telemetry file %s: %s", filename.c_str(), strerror(errno));
+  }
+
+  void *map = mmap(NULL, m_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+  if (map == MAP_FAILED) {
+    ::close(m_fd);
+    m_fd = -1;
+    throw vpException(vpException::ioError, "Cannot map telemetry file %s: %s", filename.c_str(), strerror(errno));
+  }
+  m_map = (unsigned char *)map;
+  m_filename = filename;
+  m_capacity = capacity;
+  m_nb_records = 0;
+  m_nb_dropped = 0;
+  m_record = NULL;
+
+  // Touch all the pages now rather than in the control loop
+  memset(m_map, 0, m_map_size);
+
+  vpHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, "RTKTLM", 6);
+  header.version = version;
+  header.nb_channels = (uint32_t)m_channels.size();
+  header.record_size = m_record_size;
+  header.header_size = m_header_size;
+  header.capacity = m_capacity;
+  header.nb_records = 0;
+  memcpy(m_map, &header, sizeof(header));
+
+  unsigned char *ptr = m_map + sizeof(vpHeader);
+  for (size_t i=0; i < m_channels.size(); i++) {
+    uint32_t description[3] = {(uint32_t)m_channels[i].type, m_channels[i].size, (uint32_t)m_channels[i].name.size()};
+    memcpy(ptr, description, sizeof(description));
+    ptr += sizeof(description);
+    memcpy(ptr, m_channels[i].name.c_str(), m_channels[i].name.size());
+    ptr += m_channels[i].name.size();
+  }
+}
+
+/*!
+  Unmap the file and truncate it to the written records.
+ */
+void vpTelemetryRecorder::close()
+{
+  if (m_map == NULL)
+    return;
+
+  msync(m_map, m_map_size, MS_SYNC);
+  munmap(m_map, m_map_size);
+  m_map = NULL;
+  m_record = NULL;
+  if (ftruncate(m_fd, (off_t)(m_header_size + m_nb_records * m_record_size)) != 0)
+    std::cerr << "Cannot truncate telemetry file " << m_filename << std::endl;
+  ::close(m_fd);
+  m_fd = -1;
+}
+
+/*!
+  Start a new record. Channels that are not written before endRecord() are marked as missing in the record.
+ */
+void vpTelemetryRecorder::beginRecord(double timestamp)
+{
+  if (m_map == NULL)
+    return;
+  if (m_nb_records == m_capacity) {
+    m_record = NULL;
+    m_nb_dropped ++;
+    return;
+  }
+
+  m_record = m_map + m_header_size + m_nb_records * m_record_size;
+  uint64_t mask = 0;
+  memcpy(m_record, &timestamp, sizeof(double));
+  memcpy(m_record + maskOffset, &mask, sizeof(uint64_t));
+}
+
+/*!
+  Validate the current record.
+ */
+void vpTelemetryRecorder::endRecord()
+{
+  if (m_record == NULL)
+    return;
+  m_record = NULL;
+  m_nb_records ++;
+  // The number of records is written last, so that a reader never sees a partial record
+  __sync_synchronize();
+  ((vpHeader *)m_map)->nb_records = m_nb_records;
+}
+
+/*!
+  Return the values of \e channel in the current record and mark the channel as written, or NULL.
+ */
+unsigned char *vpTelemetryRecorder::getValues(unsigned int channel)
+{
+  if (m_record == NULL || channel >= m_channels.size())
+    return NULL;
+
+  uint64_t mask;
+  memcpy(&mask, m_record + maskOffset, sizeof(uint64_t));
+  mask |= ((uint64_t)1 << channel);
+  memcpy(m_record + maskOffset, &mask, sizeof(uint64_t));
+  return m_record + m_channels[channel].offset;
+}
+
+/*!
+  Write the values of a channel in the current record. Extra values are ignored, missing values are set to 0.
+ */
+void vpTelemetryRecorder::record(unsigned int channel, const double *values, unsigned int size)
+{
+  unsigned char *ptr = getValues(channel);
+  if (ptr == NULL)
+    return;
+
+  const vpChannel &c = m_channels[channel];
+  for (unsigned int i=0; i < c.size; i++)
+    writeValue(ptr, c.type, (i < size) ? values[i] : 0.);
+}
+
+void vpTelemetryRecorder::record(unsigned int channel, double value)
+{
+  record(channel, &value, 1);
+}
+
+void vpTelemetryRecorder::record(unsigned int channel, const vpColVector &v)
+{
+  record(channel, v.data, v.getRows());
+}
+
+void vpTelemetryRecorder::record(unsigned int channel, const std::vector<float> &v)
+{
+  unsigned char *ptr = getValues(channel);
+  if (ptr == NULL)
+    return;
+
+  const vpChannel &c = m_channels[channel];
+  for (unsigned int i=0; i < c.size; i++)
+    writeValue(ptr, c.type, (i < v.size()) ? v[i] : 0.);
+}
+
+/*!
+  Write a pose as tx, ty, tz, tux, tuy, tuz. The theta u vector is computed by vpThetaU, without the
+  allocations of vpThetaUVector.
+ */
+void vpTelemetryRecorder::record(unsigned int channel, const vpHomogeneousMatrix &M)
+{
+  double p[6];
+  for (unsigned int i=0; i < 3; i++)
+    p[i] = M[i][3];
+  vpThetaU::compute(M, p + 3);
+  record(channel, p, 6);
+}
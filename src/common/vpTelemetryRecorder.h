@@ -0,0 +1,132 @@
+#ifndef __vpTelemetryRecorder_h__
+#define __vpTelemetryRecorder_h__
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <visp/vpColVector.h>
+#include <visp/vpHomogeneousMatrix.h>
+
+/*!
+  Record full-rate traces of a control loop (errors, joint positions and velocities, poses...) in a
+  memory-mapped binary file, that can be plotted or exported to CSV afterwards with the telemetry_export tool.
+
+  Channels are declared before open() with addChannel(). Each loop iteration then writes one fixed-size
+  record, in place in the mapped file: no lock, no allocation, no formatting and no system call. The file
+  is preallocated for a given number of records; the records beyond this capacity are dropped and counted.
+  The number of records is updated in the file after each record, so that the trace survives a crash.
+
+  The file starts with a header:
+  - "RTKTLM" followed by two null characters and the format version (uint32);
+  - number of channels, record size and header size in bytes (uint32);
+  - capacity and number of records (uint64);
+  - for each channel its type, number of values and name length (uint32) followed by the characters of the name.
+
+  The header is padded to a multiple of 8 bytes. Each record holds the timestamp in seconds (double),
+  a mask of the channels written in the record (uint64) and the values of the channels, each channel being
+  padded to a multiple of 8 bytes. Values are written in the native byte order.
+
+  \code
+  vpTelemetryRecorder telemetry;
+  unsigned int ch_error = telemetry.addChannel("error", 6);
+  unsigned int ch_q_dot = telemetry.addChannel("q_dot", jointNames.size());
+  unsigned int ch_cMo = telemetry.addChannel("cMo", 6); // tx ty tz tux tuy tuz
+  telemetry.open("telemetry.bin", 60*100); // 60 s at 100 Hz
+
+  while (...) {
+    telemetry.beginRecord(vpTime::measureTimeSecond());
+    telemetry.record(ch_error, servo.m_task.getError());
+    telemetry.record(ch_q_dot, q_dot);
+    if (found)
+      telemetry.record(ch_cMo, cMo);
+    telemetry.endRecord();
+  }
+  telemetry.close();
+  \endcode
+ */
+class vpTelemetryRecorder
+{
+public:
+  static const unsigned int version = 1;
+  static const unsigned int maxChannels = 64;
+  static const unsigned int maskOffset = 8;     //!< Offset of the mask of the written channels in a record
+  static const unsigned int valuesOffset = 16;  //!< Offset of the values of the first channel in a record
+
+  typedef enum {
+    float64,
+    float32,
+    int32
+  } type_t;
+
+  //! Fixed part of the header of a telemetry file.
+  struct vpHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t nb_channels;
+    uint32_t record_size;
+    uint32_t header_size;
+    uint64_t capacity;
+    uint64_t nb_records;
+  };
+
+  static unsigned int getTypeSize(type_t type) {return (type == float64) ? 8 : 4;}
+
+protected:
+  struct vpChannel {
+    std::string name;
+    type_t type;
+    unsigned int size;
+    unsigned int offset;    // Offset of the values in the record
+  };
+
+  std::vector<vpChannel> m_channels;
+  std::string m_filename;
+  int m_fd;
+  unsigned char *m_map;     // Mapped file
+  size_t m_map_size;
+  unsigned int m_header_size;
+  unsigned int m_record_size;
+  uint64_t m_capacity;
+  uint64_t m_nb_records;
+  unsigned long m_nb_dropped;
+  unsigned char *m_record;  // Record being written, NULL if there is none or if the file is full
+
+public:
+  vpTelemetryRecorder();
+  virtual ~vpTelemetryRecorder();
+
+  unsigned int addChannel(const std::string &name, unsigned int size=1, type_t type=vpTelemetryRecorder::float64);
+
+  void beginRecord(double timestamp);
+
+  void close();
+
+  void endRecord();
+
+  unsigned long getCapacity() const {return (unsigned long)m_capacity;}
+  unsigned int getNbChannels() const {return (unsigned int)m_channels.size();}
+  //! Number of records that did not fit in the file.
+  unsigned long getNbDropped() const {return m_nb_dropped;}
+  unsigned long getNbRecords() const {return (unsigned long)m_nb_records;}
+
+  bool isOpened() const {return m_map != NULL;}
+
+  void open(const std::string &filename, unsigned long capacity);
+
+  void record(unsigned int channel, double value);
+  void record(unsigned int channel, const double *values, unsigned int size);
+  void record(unsigned int channel, const vpColVector &v);
+  void record(unsigned int channel, const std::vector<float> &v);
+  void record(unsigned int channel, const vpHomogeneousMatrix &M);
+
+protected:
+  unsigned char *getValues(unsigned int channel);
+
+private:
+  vpTelemetryRecorder(const vpTelemetryRecorder &);
+  vpTelemetryRecorder &operator=(const vpTelemetryRecorder &);
+};
+
+#endif
@@ -5,7 +5,8 @@
 vpTemplateLocatization::vpTemplateLocatization(const std::string &model, const std::string &configuration_file_folder, const vpCameraParameters &cam)
   : m_warp(), m_tracker(NULL), m_state(detection), m_target_found(false), m_P(4), m_message("romeo_left_arm"), m_tracker_det(NULL),
     m_keypoint_learning(NULL), m_keypoint_detection (NULL), m_init_detection (false),m_num_iteration_detection(6), m_counter_detection(0),
-    m_manual_detection (0), m_checkValiditycMo(NULL), m_only_detection(false), m_status_single_detection(false), verbose (true), m_corners_detected()
+    m_manual_detection (0), m_checkValiditycMo(NULL), m_only_detection(false), m_status_single_detection(false), verbose (true), m_corners_detected(),
+    m_profiler("vpTemplateLocatization"), m_frame_timestamp(0), m_timestamp(0), m_overlay()
 {
 
   //Detection *****************************************
@@ -112,6 +113,7 @@ void vpTemplateLocatization::setTemplateSize(double x,double y)
 bool vpTemplateLocatization::track(const vpImage<unsigned char> &I)//, vpDetectorBase * &detector )
 {
   vpColVector p; // Estimated parameters
+  m_overlay.clear();
 
   if (m_state == detection) {
 
@@ -133,7 +135,13 @@ bool vpTemplateLocatization::track(const vpImage<unsigned char> &I)//, vpDetecto
       vpHomogeneousMatrix cMo_temp;
 
       //Matching and pose estimation
-      if(m_keypoint_detection->matchPoint(I, m_cam, cMo_temp, error, elapsedTime))
+      bool matched = m_keypoint_detection->matchPoint(I, m_cam, cMo_temp, error, elapsedTime);
+      if (m_profiler.isEnabled()) {
+        m_profiler.addSample(vpStageProfiler::detect, m_keypoint_detection->getDetectionTime() + m_keypoint_detection->getExtractionTime());
+        m_profiler.addSample(vpStageProfiler::match, m_keypoint_detection->getMatchingTime());
+        m_profiler.addSample(vpStageProfiler::ransac, m_keypoint_detection->getPoseTime());
+      }
+      if(matched)
       {
         if (verbose)
           std::cout <<"elaspedtime: " << elapsedTime << std::endl;
@@ -141,7 +149,10 @@ bool vpTemplateLocatization::track(const vpImage<unsigned char> &I)//, vpDetecto
         {
 
           //Tracker set pose
-          m_tracker_det->initFromPose(I, cMo_temp);
+          {
+            vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::init);
+            m_tracker_det->initFromPose(I, cMo_temp);
+          }
           if (verbose)
           {
             std::cout << "Detection ok" << std::endl;
@@ -149,8 +160,8 @@ bool vpTemplateLocatization::track(const vpImage<unsigned char> &I)//, vpDetecto
           }
 
           //Display
-          m_tracker_det->display(I, cMo_temp, m_cam, vpColor::cyan, 1);
-          vpDisplay::displayFrame(I, cMo_temp, m_cam, 0.025, vpColor::none, 3);
+          m_overlay.displayModel(I, m_tracker_det, cMo_temp, m_cam, vpColor::cyan, 1);
+          m_overlay.displayFrame(I, cMo_temp, m_cam, 0.025, vpColor::none, 3);
 
 
           std::vector<vpPolygon> polygons;
@@ -167,8 +178,8 @@ bool vpTemplateLocatization::track(const vpImage<unsigned char> &I)//, vpDetecto
             for(size_t j=0; j < m_corners_detected.size(); j++) {
               std::ostringstream s;
               s << j;
-              vpDisplay::displayText(I, m_corners_detected[j]+vpImagePoint(-20,-20), s.str(), vpColor::green);
-              vpDisplay::displayCross(I, m_corners_detected[j], 25, vpColor::green, 2);
+              m_overlay.displayText(I, m_corners_detected[j]+vpImagePoint(-20,-20), s.str(), vpColor::green);
+              m_overlay.displayCross(I, m_corners_detected[j], 25, vpColor::green, 2);
               //              vpDisplay::flush(I);
               //              vpDisplay::getClick(I,true);
 
@@ -366,23 +377,29 @@ bool vpTemplateLocatization::track(const vpImage<unsigned char> &I)//, vpDetecto
   if (m_state == init_tracking) {
     //vpDisplay::displayText(I, 40,10, "state: init tracking", vpColor::red);
     try {
-      m_tracker->resetTracker();
+      {
+        vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::init);
+        m_tracker->resetTracker();
 
-      m_tracker->initFromPoints(I, m_corners_detected, true);
-      // m_tracker->initClick(I,true);
-      m_tracker->track(I);
-      m_tracker->display(I, vpColor::green);
+        m_tracker->initFromPoints(I, m_corners_detected, true);
+        // m_tracker->initClick(I,true);
+        m_tracker->track(I);
+      }
       m_zone_ref = m_tracker->getZoneRef();
       m_area_m_zone_ref = m_zone_ref.getArea();
       p = m_tracker->getp();
       m_warp.warpZone(m_zone_ref, p, zone_cur);
+      m_overlay.displayZone(I, zone_cur, vpColor::green);
       m_area_zone_prev = m_area_zone_cur = zone_cur.getArea();
       m_corners_tracked = getTemplateTrackerCorners(zone_cur);
       m_corners_tracked_index = computedTemplateTrackerCornersIndexes(m_corners_detected, m_corners_tracked);
       //std::cout << "Size:" << m_corners_tracked.size() <<std::endl;
       m_corners_tracked = orderPointsFromIndexes(m_corners_tracked_index, m_corners_tracked);
 
-      computePose(m_P, m_corners_tracked, m_cam, true, m_cMo);
+      {
+        vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::pose);
+        computePose(m_P, m_corners_tracked, m_cam, true, m_cMo);
+      }
       //vpDisplay::displayFrame(I, m_cMo, m_cam, 0.04, vpColor::none, 3);
 
       m_state = tracking;
@@ -397,18 +414,25 @@ bool vpTemplateLocatization::track(const vpImage<unsigned char> &I)//, vpDetecto
   else if (m_state == tracking) {
     try {
       //vpDisplay::displayText(I, 40,10, "state: tracking", vpColor::red);
-      m_tracker->track(I);
+      {
+        vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::track);
+        m_tracker->track(I);
 
-      //m_tracker->display(I, vpColor::blue);
+        //m_tracker->display(I, vpColor::blue);
 
-      // Instantiate and get the reference zone
-      p = m_tracker->getp();
-      m_warp.warpZone(m_zone_ref, p, zone_cur);
+        // Instantiate and get the reference zone
+        p = m_tracker->getp();
+        m_warp.warpZone(m_zone_ref, p, zone_cur);
+      }
+
+      vpStageProfiler::vpScopedTimer timer_validate(m_profiler, vpStageProfiler::validate);
       m_area_zone_cur = zone_cur.getArea();
 
       double size_percent = 0.95;
       double max_target_size = I.getSize()/4;
-      if (m_area_zone_cur/m_area_zone_prev < size_percent || m_area_zone_cur/m_area_zone_prev > (1+size_percent)) {
+      bool valid = ! (m_area_zone_cur/m_area_zone_prev < size_percent || m_area_zone_cur/m_area_zone_prev > (1+size_percent));
+      timer_validate.stop();
+      if (! valid) {
         //          std::cout << "reinit caused by size" << std::endl;
         m_state = detection;
         m_target_found = false;
@@ -421,7 +445,10 @@ bool vpTemplateLocatization::track(const vpImage<unsigned char> &I)//, vpDetecto
       else {
         m_corners_tracked = getTemplateTrackerCorners(zone_cur);
         m_corners_tracked = orderPointsFromIndexes(m_corners_tracked_index, m_corners_tracked);
-        computePose(m_P, m_corners_tracked, m_cam, false, m_cMo);
+        {
+          vpStageProfiler::vpScopedTimer timer(m_profiler, vpStageProfiler::pose);
+          computePose(m_P, m_corners_tracked, m_cam, false, m_cMo);
+        }
 
         //                   vpDisplay::displayFrame(I, m_cMo, m_cam, 0.04, vpColor::none, 3);
         //                    for(unsigned int j=0; j < m_corners_tracked.size(); j++) {
@@ -444,6 +471,9 @@ bool vpTemplateLocatization::track(const vpImage<unsigned char> &I)//, vpDetecto
       m_target_found = false;
     }
   }
+  if (m_target_found)
+    m_timestamp = m_frame_timestamp;
+
   return m_target_found;
 }
 
@@ -12,6 +12,9 @@
 #include <visp/vpTemplateTrackerWarpHomography.h>
 #include <visp/vpPixelMeterConversion.h>
 
+#include <vpOverlay.h>
+#include <vpStageProfiler.h>
+
 
 class vpTemplateLocatization
 {
@@ -60,6 +63,10 @@ protected:
   vpMatrix m_stack_cMo_detection;
   bool (*m_checkValiditycMo)(vpHomogeneousMatrix);
   bool verbose;
+  vpStageProfiler m_profiler;
+  double m_frame_timestamp; // Capture time of the image given to the next track()
+  double m_timestamp; // Capture time of the image of the last successful track()
+  vpOverlay m_overlay;
 
 public:
 
@@ -78,6 +85,9 @@ public:
     */
   vpImagePoint getCog();
   std::vector<vpImagePoint> getCorners() const {return m_corners_tracked;}
+  vpOverlay &getOverlay() {return m_overlay;}
+  vpStageProfiler &getProfiler() {return m_profiler;}
+  double getTimestamp() const {return m_timestamp;}
 
   vpCameraParameters getCameraParameters() {
     vpCameraParameters cam;
@@ -104,6 +114,7 @@ public:
 
   void setForceDetection() {m_state = detection; }
   void setManualDetection(){m_manual_detection = true;}
+  void setTimestamp(double timestamp) {m_frame_timestamp = timestamp;}
   void setOnlyDetection(const bool only_detection){m_only_detection = only_detection;}
   void setNumberDetectionIteration (unsigned int &num) { m_num_iteration_detection = num;}
   void setValiditycMoFunction (bool (*funct)(vpHomogeneousMatrix)) { m_checkValiditycMo = funct;}
@@ -0,0 +1,42 @@
+#include <math.h>
+
+#include <limits>
+
+#include <visp/vpMath.h>
+
+#include <vpThetaU.h>
+
+
+/*!
+  Compute theta u from the rotation part of \e M.
+  \param M : Pose.
+  \param tu : Theta u vector, with theta in [0, pi].
+ */
+void vpThetaU::compute(const vpHomogeneousMatrix &M, double tu[3])
+{
+  const double minimum = 0.0001;
+  double s = (M[1][0]-M[0][1])*(M[1][0]-M[0][1])
+      + (M[2][0]-M[0][2])*(M[2][0]-M[0][2])
+      + (M[2][1]-M[1][2])*(M[2][1]-M[1][2]);
+  s = sqrt(s)/2.0;
+  double c = (M[0][0]+M[1][1]+M[2][2]-1.0)/2.0;
+  double theta = atan2(s,c);  // theta in [0, PI] since s > 0
+
+  if ((1+c) > minimum) {
+    double sinc = vpMath::sinc(s, theta);
+    tu[0] = (M[2][1]-M[1][2])/(2*sinc);
+    tu[1] = (M[0][2]-M[2][0])/(2*sinc);
+    tu[2] = (M[1][0]-M[0][1])/(2*sinc);
+  }
+  else { // theta near PI
+    for (unsigned int i=0; i < 3; i++) {
+      if ((M[i][i]-c) < std::numeric_limits<double>::epsilon())
+        tu[i] = 0.;
+      else
+        tu[i] = theta*(sqrt((M[i][i]-c)/(1-c)));
+    }
+    if ((M[2][1]-M[1][2]) < 0) tu[0] = -tu[0];
+    if ((M[0][2]-M[2][0]) < 0) tu[1] = -tu[1];
+    if ((M[1][0]-M[0][1]) < 0) tu[2] = -tu[2];
+  }
+}
@@ -0,0 +1,17 @@
+#ifndef __vpThetaU_h__
+#define __vpThetaU_h__
+
+#include <visp/vpHomogeneousMatrix.h>
+
+/*!
+  Theta u representation of the rotation of a pose, computed like vpThetaUVector::buildFrom() does but
+  without building any temporary rotation matrix nor vector, so that it can be called in the real-time
+  control loops and by the telemetry recorder.
+ */
+class vpThetaU
+{
+public:
+  static void compute(const vpHomogeneousMatrix &M, double tu[3]);
+};
+
+#endif
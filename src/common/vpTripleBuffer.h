@@ -0,0 +1,110 @@
+#ifndef __vpTripleBuffer_h__
+#define __vpTripleBuffer_h__
+
+#include <vpAtomic.h>
+
+/*!
+  Lock-free exchange of the latest value between one producer thread and one consumer thread.
+
+  Three preallocated buffers are used: the producer fills the write buffer and publishes it, the consumer
+  reads its read buffer, and the third one holds the latest published value. Publishing and updating only
+  swap buffer indexes with an atomic exchange, so the producer never blocks, no value is copied and the
+  consumer always gets the newest value. Values published while the consumer was busy are dropped.
+
+  Each published value gets a sequence number that allows the consumer to know how many values it skipped.
+
+  \code
+  vpTripleBuffer< vpImage<unsigned char> > frames;
+
+  // Capture thread
+  g.acquire(frame);
+  frames.init(frame); // Preallocate the buffers before the first publish()
+  while (! end) {
+    g.acquire(frames.getWriteBuffer());
+    frames.publish();
+  }
+
+  // Detection thread
+  while (! end) {
+    if (frames.update())
+      face_tracker.track(frames.getReadBuffer());
+    else
+      vpTime::wait(2);
+  }
+  \endcode
+
+  With more than one consumer, use a vpBroadcastBuffer.
+ */
+template <class T> class vpTripleBuffer
+{
+protected:
+  static const unsigned int index_mask = 3;
+  static const unsigned int fresh = 4; // Set when the middle buffer holds a value not read yet
+
+  T m_buffers[3];
+  unsigned long m_sequence[3];
+  volatile long m_middle;     // Index of the middle buffer, shared by the producer and the consumer
+  unsigned int m_write;       // Index of the write buffer, owned by the producer
+  unsigned int m_read;        // Index of the read buffer, owned by the consumer
+  unsigned long m_nb_published;
+
+public:
+  vpTripleBuffer()
+    : m_middle(1), m_write(0), m_read(2), m_nb_published(0)
+  {
+    for (unsigned int i=0; i < 3; i++)
+      m_sequence[i] = 0;
+  }
+  virtual ~vpTripleBuffer() {}
+
+  //! Number of values published by the producer. Should only be called by the producer.
+  unsigned long getNbPublished() const {return m_nb_published;}
+  //! Latest value obtained by update(). Should only be called by the consumer.
+  const T &getReadBuffer() const {return m_buffers[m_read];}
+  //! Latest value obtained by update(), that the consumer can modify in place.
+  T &getReadBuffer() {return m_buffers[m_read];}
+  //! Sequence number of the read buffer, 0 if no value was read yet.
+  unsigned long getReadSequence() const {return m_sequence[m_read];}
+  //! Buffer to fill before publish(). Should only be called by the producer.
+  T &getWriteBuffer() {return m_buffers[m_write];}
+
+  //! Return true if a value was published since the last update().
+  bool hasNewValue() const {return (m_middle & fresh) != 0;}
+
+  /*!
+    Initialize the three buffers with a copy of \e value, to preallocate them.
+    Should be called by the producer before its first publish().
+   */
+  void init(const T &value)
+  {
+    for (unsigned int i=0; i < 3; i++)
+      m_buffers[i] = value;
+  }
+
+  /*!
+    Publish the write buffer. The producer gets a new write buffer, that contains an older value.
+   */
+  void publish()
+  {
+    m_sequence[m_write] = ++m_nb_published;
+    m_write = (unsigned int)(vpAtomic::exchange(&m_middle, m_write | fresh) & index_mask);
+  }
+
+  /*!
+    Get the latest published value in the read buffer.
+    \return true if a new value is available, false if the read buffer is still the latest value.
+   */
+  bool update()
+  {
+    if (! hasNewValue())
+      return false;
+    m_read = (unsigned int)(vpAtomic::exchange(&m_middle, m_read) & index_mask);
+    return true;
+  }
+
+private:
+  vpTripleBuffer(const vpTripleBuffer &);
+  vpTripleBuffer &operator=(const vpTripleBuffer &);
+};
+
+#endif
@@ -0,0 +1,80 @@
+/**
+ *
+ * This example compares the time spent converting the int16 interleaved buffers of the sound card to planar
+ * float samples, for 2, 4 and 8 channels and buffers of 256 and 64 frames:
+ * - the scalar conversion of the record() callback of the audio tests, in double, channel by channel,
+ * - vpAudioConvert::int16ToPlanar(), as used by vpAudioRingBuffer in the capture callback.
+ *
+ * Usage: ./bench_audio_convert [--iter <number of iterations>]
+ *
+ */
+
+#include <stdlib.h>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <visp/vpTime.h>
+
+#include <vpAudioConvert.h>
+
+/*!
+  Conversion of the record() callback of the audio tests.
+ */
+void scalarToPlanar(const short *frames, unsigned int nb_channels, unsigned int framesize, double *planar)
+{
+  for (unsigned int channel = 0; channel < nb_channels; channel++)
+    for (unsigned int frame_index = 0; frame_index < framesize; frame_index++)
+      planar[channel * framesize + frame_index] = ((float) frames[channel + (nb_channels * frame_index)])/32768.0;
+}
+
+int main(int argc, const char* argv[])
+{
+  unsigned int nb_iter = 100000;
+  for (int i=1; i < argc; i++) {
+    if (std::string(argv[i]) == "--iter" && i+1 < argc)
+      nb_iter = (unsigned int)atoi(argv[++i]);
+    else if (std::string(argv[i]) == "--help") {
+      std::cout << "Usage: " << argv[0] << " [--iter <number of iterations>] [--help]" << std::endl;
+      return 0;
+    }
+  }
+  if (nb_iter == 0)
+    nb_iter = 1;
+
+  unsigned int channels[3] = {2, 4, 8};
+  unsigned int sizes[2] = {256, 64};
+  for (unsigned int c=0; c < 3; c++) {
+    for (unsigned int s=0; s < 2; s++) {
+      unsigned int nb_channels = channels[c];
+      unsigned int nb_frames = sizes[s];
+      std::vector<short> interleaved(nb_channels * nb_frames);
+      for (size_t i=0; i < interleaved.size(); i++)
+        interleaved[i] = (short)(rand() % 65536 - 32768);
+      std::vector<double> planar_double(nb_channels * nb_frames);
+      std::vector<float> planar(nb_channels * nb_frames);
+
+      double t0 = vpTime::measureTimeMicros();
+      for (unsigned int iter=0; iter < nb_iter; iter++) {
+        interleaved[iter % interleaved.size()] ^= 1; // Do not let the compiler hoist the conversion
+        scalarToPlanar(&interleaved[0], nb_channels, nb_frames, &planar_double[0]);
+      }
+      double t_scalar = (vpTime::measureTimeMicros() - t0) / nb_iter;
+
+      t0 = vpTime::measureTimeMicros();
+      for (unsigned int iter=0; iter < nb_iter; iter++) {
+        interleaved[iter % interleaved.size()] ^= 1;
+        vpAudioConvert::int16ToPlanar(&interleaved[0], nb_channels, nb_frames, &planar[0], nb_frames);
+      }
+      double t_simd = (vpTime::measureTimeMicros() - t0) / nb_iter;
+
+      std::cout << nb_channels << " channels x " << std::setw(3) << nb_frames << " frames: scalar "
+                << std::setprecision(3) << t_scalar << " us, vpAudioConvert " << t_simd << " us, speed-up "
+                << t_scalar / t_simd << " (checksum " << planar_double[1] + planar[1] << ")" << std::endl;
+    }
+  }
+
+  return 0;
+}
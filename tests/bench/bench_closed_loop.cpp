@@ -0,0 +1,379 @@
+/**
+ *
+ * This example measures the closed-loop behavior of the head and arm visual servoing without robot, on
+ * vpSimulatedRobot and vpSimulatedCamera:
+ * - in simulated time, with the control law computed at each step of the simulation: convergence time and
+ *   throughput of the control loop (simulation steps and control laws per second of CPU),
+ * - in real time, with vpServoHeadScheduler and vpServoArmScheduler driven by a 30 fps camera: convergence time,
+ *   rate and overruns of the control thread. With --qrcode, the head follows the QR code tracked by
+ *   vpQRCodeTracker in the rendered images instead of its true position.
+ *
+ * Usage: ./bench_closed_loop [--latency <s>] [--rate <Hz>] [--qrcode] [--no-realtime]
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+
+#include <visp/vpAdaptiveGain.h>
+#include <visp/vpImage.h>
+#include <visp/vpImagePoint.h>
+#include <visp/vpMath.h>
+#include <visp/vpThetaUVector.h>
+#include <visp/vpTime.h>
+#include <visp/vpVelocityTwistMatrix.h>
+
+#include <vpQRCodeTracker.h>
+#include <vpRomeoTkConfig.h>
+#include <vpServoArm.h>
+#include <vpServoArmScheduler.h>
+#include <vpServoHead.h>
+#include <vpServoHeadScheduler.h>
+#include <vpSimulatedCamera.h>
+#include <vpSimulatedRobot.h>
+
+static const double s_head_tolerance = 1.;     // Convergence threshold in pixels
+static const double s_arm_tolerance_t = 0.001; // Convergence thresholds in m and rad
+static const double s_arm_tolerance_r = vpMath::rad(0.5);
+static const double s_duration = 10.;          // Maximum duration of a run in s
+
+struct vpRunResult {
+  double convergence_time;      // Time after which the error stays below the tolerance, negative if never
+  double final_error;
+  unsigned long nb_iterations;  // Control iterations
+  double cpu_time;              // Wall time of the run in s
+  double loop_time;             // Real time only: duration of the last control iteration in ms
+  unsigned long nb_overruns;    // Real time only
+};
+
+/*!
+  Place a QR code in front of the robot for the head servo (\e arm false), or in the left hand for the arm
+  servo. The head looks down, so that the QR code is in the field of view of the left eye in both cases.
+  \return Index of the target.
+ */
+unsigned int setupScene(vpSimulatedRobot &robot, vpSimulatedCamera &camera, bool arm, vpHomogeneousMatrix &eMh)
+{
+  cv::Mat qrcode = cv::imread(std::string(ROMEOTK_DATA_FOLDER) + "/QR-Code/qrcode_romeo_left_arm.png");
+  if (qrcode.empty()) {
+    qrcode.create(210, 210, CV_8UC3);
+    qrcode.setTo(cv::Scalar(255, 255, 255));
+    cv::rectangle(qrcode, cv::Point(30, 30), cv::Point(180, 180), cv::Scalar(0, 0, 0), -1);
+  }
+
+  std::vector<std::string> names;
+  names.push_back("NeckPitch");
+  names.push_back("HeadPitch");
+  robot.setPosition(names, vpColVector(2, 0.3));
+
+  // Target planes facing the robot: their z axis along -x of the torso, the elbow of the left arm being bent
+  eMh = vpHomogeneousMatrix(0.02, 0, 0.04, 0, 0, 0.8) * vpHomogeneousMatrix(0, 0, 0, 0, -M_PI/2, 0);
+  if (arm)
+    return camera.addPlanarTarget(qrcode, 0.045, eMh, "LArm");
+  return camera.addPlanarTarget(qrcode, 0.12, vpHomogeneousMatrix(0.80, 0.12, 0.12, 0, -M_PI/2, 0));
+}
+
+vpImagePoint getTargetPoint(const vpSimulatedCamera &camera, unsigned int target)
+{
+  vpHomogeneousMatrix cMo = camera.get_cMo(target);
+  vpCameraParameters cam = camera.getCameraParameters();
+  return vpImagePoint(cam.get_v0() + cam.get_py() * cMo[1][3] / cMo[2][3],
+                      cam.get_u0() + cam.get_px() * cMo[0][3] / cMo[2][3]);
+}
+
+/*!
+  Pose of the hand-held target in its desired pose, that the arm servo regulates to identity.
+ */
+vpHomogeneousMatrix getArmError(const vpSimulatedCamera &camera, unsigned int hand_target, const vpHomogeneousMatrix &fMhd)
+{
+  return (camera.get_fMc().inverse() * fMhd).inverse() * camera.get_cMo(hand_target);
+}
+
+bool isArmConverged(const vpHomogeneousMatrix &hdMh)
+{
+  vpThetaUVector tu(hdMh);
+  return hdMh.getTranslationVector().euclideanNorm() < s_arm_tolerance_t
+      && sqrt(tu[0]*tu[0] + tu[1]*tu[1] + tu[2]*tu[2]) < s_arm_tolerance_r;
+}
+
+void printResult(const std::string &name, const vpRunResult &r, bool realtime)
+{
+  std::cout << std::setw(22) << std::left << name;
+  if (r.convergence_time < 0)
+    std::cout << " not converged (error " << r.final_error << ")";
+  else
+    std::cout << " converged in " << std::setprecision(3) << r.convergence_time << " s";
+  if (realtime)
+    std::cout << ", control " << std::setprecision(4) << r.nb_iterations / r.cpu_time << " Hz, last iteration "
+              << r.loop_time << " ms, " << r.nb_overruns << " overruns" << std::endl;
+  else
+    std::cout << ", " << r.nb_iterations << " iterations, " << std::setprecision(4)
+              << r.nb_iterations / r.cpu_time << " iterations/s" << std::endl;
+}
+
+/*!
+  Head servo in simulated time: the control law runs at the simulation rate, the camera at 30 fps.
+ */
+vpRunResult runHeadSimulated(double latency, double rate)
+{
+  vpSimulatedRobot robot;
+  robot.setLatency(latency);
+  robot.setRate(rate);
+  vpSimulatedCamera camera(robot, "LEye");
+  vpHomogeneousMatrix eMh;
+  unsigned int head_target = setupScene(robot, camera, false, eMh);
+
+  std::vector<std::string> names = robot.getBodyNames("Head");
+  vpCameraParameters cam = camera.getCameraParameters();
+  vpImagePoint ip_des(cam.get_v0(), cam.get_u0());
+  vpServoHead servo;
+  servo.setCameraParameters(cam);
+  servo.setRealTime(true, (unsigned int)names.size());
+  servo.setLambda(vpAdaptiveGain(2.5, 1., 30));
+  // The eyes do not move: constant twist between the head and the camera
+  vpVelocityTwistMatrix cVe((camera.get_fMc().inverse() * robot.get_fMe("Head")));
+  vpColVector q_dot((unsigned int)names.size());
+
+  double dt = 1. / rate;
+  unsigned int frame_period = (unsigned int)(rate / 30. + 0.5);
+  vpImagePoint ip;
+  vpRunResult r;
+  r.convergence_time = -1;
+  r.nb_iterations = 0;
+  r.loop_time = 0;
+  r.nb_overruns = 0;
+  double t_start = vpTime::measureTimeSecond();
+  for (unsigned int iter=0; iter * dt < s_duration; iter++) {
+    if (iter % std::max(frame_period, 1u) == 0) {
+      ip = getTargetPoint(camera, head_target);
+      servo.setDepth(camera.get_cMo(head_target)[2][3]);
+    }
+    servo.set_eJe(robot.get_eJe("Head"));
+    servo.set_cVe(cVe);
+    servo.setCurrentFeature(ip);
+    servo.setDesiredFeature(ip_des);
+    servo.computeControlLaw(q_dot);
+    robot.setVelocity(names, q_dot);
+    robot.step(dt);
+    r.nb_iterations ++;
+
+    r.final_error = vpImagePoint::distance(getTargetPoint(camera, head_target), ip_des);
+    if (r.final_error > s_head_tolerance)
+      r.convergence_time = -1;
+    else if (r.convergence_time < 0)
+      r.convergence_time = robot.getTime();
+  }
+  r.cpu_time = vpTime::measureTimeSecond() - t_start;
+  return r;
+}
+
+/*!
+  Arm servo in simulated time: bring the hand-held QR code to a pose 8 cm away from its initial pose.
+ */
+vpRunResult runArmSimulated(double latency, double rate)
+{
+  vpSimulatedRobot robot;
+  robot.setLatency(latency);
+  robot.setRate(rate);
+  vpSimulatedCamera camera(robot, "LEye");
+  vpHomogeneousMatrix eMh;
+  unsigned int hand_target = setupScene(robot, camera, true, eMh);
+
+  std::vector<std::string> names = robot.getBodyNames("LArm");
+  names.pop_back(); // LHand is not in the Jacobian
+  vpHomogeneousMatrix fMhd = robot.get_fMe("LArm") * eMh * vpHomogeneousMatrix(0.05, -0.04, 0.05, 0.2, -0.1, 0.15);
+  vpServoArm servo;
+  servo.setRealTime(true, (unsigned int)names.size());
+  servo.setLambda(vpAdaptiveGain(2., 0.8, 30));
+  vpVelocityTwistMatrix hVe(eMh.inverse());
+  vpColVector q_dot((unsigned int)names.size());
+
+  double dt = 1. / rate;
+  unsigned int frame_period = (unsigned int)(rate / 30. + 0.5);
+  vpHomogeneousMatrix cdMc;
+  vpRunResult r;
+  r.convergence_time = -1;
+  r.nb_iterations = 0;
+  r.loop_time = 0;
+  r.nb_overruns = 0;
+  double t_start = vpTime::measureTimeSecond();
+  for (unsigned int iter=0; iter * dt < s_duration; iter++) {
+    if (iter % std::max(frame_period, 1u) == 0)
+      cdMc = getArmError(camera, hand_target, fMhd);
+    servo.set_eJe(robot.get_eJe("LArm"));
+    servo.set_cVe(hVe);
+    servo.setCurrentFeature(cdMc);
+    servo.computeControlLaw(q_dot);
+    robot.setVelocity(names, -q_dot);
+    robot.step(dt);
+    r.nb_iterations ++;
+
+    vpHomogeneousMatrix hdMh = getArmError(camera, hand_target, fMhd);
+    r.final_error = hdMh.getTranslationVector().euclideanNorm();
+    if (! isArmConverged(hdMh))
+      r.convergence_time = -1;
+    else if (r.convergence_time < 0)
+      r.convergence_time = robot.getTime();
+  }
+  r.cpu_time = vpTime::measureTimeSecond() - t_start;
+  return r;
+}
+
+/*!
+  Head servo in real time with vpServoHeadScheduler, on the true position of the QR code or on the one
+  tracked in the rendered images.
+ */
+vpRunResult runHeadRealTime(double latency, double rate, bool use_tracker)
+{
+  vpSimulatedRobot robot;
+  robot.setLatency(latency);
+  vpSimulatedCamera camera(robot, "LEye");
+  camera.setFrameRate(30);
+  vpHomogeneousMatrix eMh;
+  unsigned int head_target = setupScene(robot, camera, false, eMh);
+
+  std::vector<std::string> names = robot.getBodyNames("Head");
+  vpCameraParameters cam = camera.getCameraParameters();
+  vpImagePoint ip_des(cam.get_v0(), cam.get_u0());
+  vpServoHead servo;
+  servo.setCameraParameters(cam);
+  servo.setRealTime(true, (unsigned int)names.size());
+  servo.setLambda(vpAdaptiveGain(2.5, 1., 30));
+  servo.setDepth(camera.get_cMo(head_target)[2][3]);
+
+  vpQRCodeTracker qrcode_tracker;
+  qrcode_tracker.setCameraParameters(cam);
+  qrcode_tracker.setQRCodeSize(0.12);
+  vpImage<unsigned char> I(camera.getHeight(), camera.getWidth());
+
+  robot.start();
+  vpServoHeadScheduler scheduler(robot, servo, "Head", names, rate);
+  scheduler.set_cVe(vpVelocityTwistMatrix(camera.get_fMc().inverse() * robot.get_fMe("Head")));
+  scheduler.setDesiredPoint(ip_des);
+  scheduler.start();
+
+  vpRunResult r;
+  r.convergence_time = -1;
+  double t_start = vpTime::measureTimeSecond();
+  while (vpTime::measureTimeSecond() - t_start < s_duration) {
+    camera.acquire(I);
+    if (use_tracker) {
+      qrcode_tracker.setTimestamp(camera.getTimestamp());
+      if (qrcode_tracker.track(I))
+        scheduler.publishPoint(qrcode_tracker.getCog(), camera.getTimestamp());
+    }
+    else
+      scheduler.publishPoint(getTargetPoint(camera, head_target), camera.getTimestamp());
+
+    r.final_error = vpImagePoint::distance(getTargetPoint(camera, head_target), ip_des);
+    if (r.final_error > s_head_tolerance)
+      r.convergence_time = -1;
+    else if (r.convergence_time < 0)
+      r.convergence_time = vpTime::measureTimeSecond() - t_start;
+  }
+  r.cpu_time = vpTime::measureTimeSecond() - t_start;
+  r.nb_iterations = scheduler.getNbIterations();
+  r.loop_time = scheduler.getLoopTime();
+  r.nb_overruns = scheduler.getNbOverruns();
+  scheduler.stop();
+  robot.stopSimulation();
+  return r;
+}
+
+/*!
+  Arm servo in real time with vpServoArmScheduler, on the true pose of the hand-held QR code.
+ */
+vpRunResult runArmRealTime(double latency, double rate)
+{
+  vpSimulatedRobot robot;
+  robot.setLatency(latency);
+  vpSimulatedCamera camera(robot, "LEye");
+  camera.setFrameRate(30);
+  vpHomogeneousMatrix eMh;
+  unsigned int hand_target = setupScene(robot, camera, true, eMh);
+
+  std::vector<std::string> names = robot.getBodyNames("LArm");
+  names.pop_back(); // LHand is not in the Jacobian
+  vpHomogeneousMatrix fMhd = robot.get_fMe("LArm") * eMh * vpHomogeneousMatrix(0.05, -0.04, 0.05, 0.2, -0.1, 0.15);
+  vpServoArm servo;
+  servo.setRealTime(true, (unsigned int)names.size());
+  servo.setLambda(vpAdaptiveGain(2., 0.8, 30));
+
+  robot.start();
+  vpServoArmScheduler scheduler(robot, servo, "LArm", names, rate);
+  scheduler.set_cVe(vpVelocityTwistMatrix(eMh.inverse()));
+  scheduler.start();
+
+  vpRunResult r;
+  r.convergence_time = -1;
+  double t_start = vpTime::measureTimeSecond();
+  while (vpTime::measureTimeSecond() - t_start < s_duration) {
+    double t = vpTime::measureTimeMs();
+    double timestamp = robot.getTime();
+    scheduler.publishPose(getArmError(camera, hand_target, fMhd), timestamp);
+
+    vpHomogeneousMatrix hdMh = getArmError(camera, hand_target, fMhd);
+    r.final_error = hdMh.getTranslationVector().euclideanNorm();
+    if (! isArmConverged(hdMh))
+      r.convergence_time = -1;
+    else if (r.convergence_time < 0)
+      r.convergence_time = vpTime::measureTimeSecond() - t_start;
+    vpTime::wait(t, 1000. / 30.);
+  }
+  r.cpu_time = vpTime::measureTimeSecond() - t_start;
+  r.nb_iterations = scheduler.getNbIterations();
+  r.loop_time = scheduler.getLoopTime();
+  r.nb_overruns = scheduler.getNbOverruns();
+  scheduler.stop();
+  robot.stopSimulation();
+  return r;
+}
+
+int main(int argc, const char* argv[])
+{
+  double opt_latency = 0.02;
+  double opt_rate = 100.;
+  bool opt_qrcode = false;
+  bool opt_realtime = true;
+  for (int i=1; i < argc; i++) {
+    if (std::string(argv[i]) == "--latency" && i+1 < argc)
+      opt_latency = atof(argv[++i]);
+    else if (std::string(argv[i]) == "--rate" && i+1 < argc)
+      opt_rate = atof(argv[++i]);
+    else if (std::string(argv[i]) == "--qrcode")
+      opt_qrcode = true;
+    else if (std::string(argv[i]) == "--no-realtime")
+      opt_realtime = false;
+    else if (std::string(argv[i]) == "--help") {
+      std::cout << "Usage: " << argv[0] << " [--latency <s>] [--rate <Hz>] [--qrcode] [--no-realtime] [--help]" << std::endl;
+      return 0;
+    }
+  }
+  if (opt_rate <= 0)
+    opt_rate = 100.;
+
+  try {
+    std::cout << "Actuator latency " << 1000. * opt_latency << " ms, control rate " << opt_rate << " Hz" << std::endl;
+    std::cout << "Simulated time:" << std::endl;
+    printResult("  head", runHeadSimulated(opt_latency, opt_rate), false);
+    printResult("  arm", runArmSimulated(opt_latency, opt_rate), false);
+    if (opt_realtime) {
+      std::cout << "Real time:" << std::endl;
+      printResult(opt_qrcode ? "  head (QR code)" : "  head", runHeadRealTime(opt_latency, opt_rate, opt_qrcode), true);
+      printResult("  arm", runArmRealTime(opt_latency, opt_rate), true);
+    }
+  }
+  catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
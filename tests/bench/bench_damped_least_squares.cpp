@@ -0,0 +1,99 @@
+/**
+ *
+ * This example compares the SVD based pseudo-inverse used by vpCartesianDisplacement with the
+ * vpDampedLeastSquares solver, along a trajectory of a 6 x 7 Jacobian that slowly looses rank.
+ * For each method it prints the latency and the largest joint velocity norm, which shows how the
+ * pseudo-inverse blows up near the singularity while the adaptive damping keeps the velocity bounded.
+ *
+ * Usage: ./bench_damped_least_squares [--iter <number of iterations>]
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <visp/vpColVector.h>
+#include <visp/vpMatrix.h>
+#include <visp/vpTime.h>
+
+#include <vpDampedLeastSquares.h>
+
+/*!
+  Print the median, 99th percentile and maximum of the latencies in us.
+ */
+void printLatency(const std::string &name, std::vector<double> &latency)
+{
+  std::sort(latency.begin(), latency.end());
+  size_t n = latency.size();
+  std::cout << std::setw(28) << std::left << name
+            << " p50: " << std::setw(8) << std::setprecision(4) << latency[n/2]
+            << " p99: " << std::setw(8) << std::setprecision(4) << latency[(99*n)/100]
+            << " max: " << std::setprecision(4) << latency[n-1] << " us" << std::endl;
+}
+
+/*!
+  Jacobian of the trajectory at iteration \e iter. The third row vanishes in the middle of the trajectory.
+ */
+void computeJacobian(unsigned int iter, unsigned int nb_iter, vpMatrix &J)
+{
+  double s = 2. * (double)iter / nb_iter - 1.;
+  for (unsigned int i=0; i < J.getRows(); i++)
+    for (unsigned int j=0; j < J.getCols(); j++)
+      J[i][j] = cos(1.3*i + 0.7*j + 0.1*i*j) * (i == 2 ? s : 1.);
+}
+
+int main(int argc, const char* argv[])
+{
+  unsigned int nb_iter = 10000;
+  for (int i=1; i < argc; i++) {
+    if (std::string(argv[i]) == "--iter" && i+1 < argc)
+      nb_iter = (unsigned int)atoi(argv[++i]);
+    else if (std::string(argv[i]) == "--help") {
+      std::cout << "Usage: " << argv[0] << " [--iter <number of iterations>] [--help]" << std::endl;
+      return 0;
+    }
+  }
+  if (nb_iter == 0)
+    nb_iter = 1;
+
+  vpMatrix J(6, 7);
+  vpColVector v(6, 0.05), q_dot(7);
+
+  const char *names[3] = {"pseudoInverse", "vpDampedLeastSquares", "vpDampedLeastSquares reuse"};
+  for (unsigned int k=0; k < 3; k++) {
+    vpDampedLeastSquares solver;
+    solver.setAdaptiveDamping(0.05, 1e-3);
+    if (k == 2)
+      solver.setReuseTolerance(1e-3);
+
+    std::vector<double> latency(nb_iter);
+    double q_dot_max = 0.;
+    unsigned int nb_reused = 0;
+    for (unsigned int iter=0; iter < nb_iter; iter++) {
+      computeJacobian(iter, nb_iter, J);
+
+      double t0 = vpTime::measureTimeMicros();
+      if (k == 0)
+        q_dot = J.pseudoInverse() * v;
+      else
+        solver.solve(J, v, q_dot);
+      latency[iter] = vpTime::measureTimeMicros() - t0;
+
+      q_dot_max = std::max(q_dot_max, sqrt(q_dot.sumSquare()));
+      if (solver.isFactorizationReused())
+        nb_reused ++;
+    }
+    printLatency(names[k], latency);
+    std::cout << "  max |q_dot|: " << q_dot_max;
+    if (k == 2)
+      std::cout << "  reused factorizations: " << nb_reused << "/" << nb_iter;
+    std::cout << std::endl;
+  }
+
+  return 0;
+}
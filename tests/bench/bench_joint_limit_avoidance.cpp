@@ -0,0 +1,91 @@
+/**
+ *
+ * This example measures the latency of the joint limit avoidance for both arms of Romeo (2 x 7 joints),
+ * with the generic computeQdotLimitAvoidance() and with the fixed size vpJointLimitAvoidance<7> kernel.
+ *
+ * Usage: ./bench_joint_limit_avoidance [--iter <number of iterations>]
+ *
+ */
+
+#include <stdlib.h>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <visp/vpColVector.h>
+#include <visp/vpMatrix.h>
+#include <visp/vpTime.h>
+
+#include <vpJointLimitAvoidance.h>
+
+/*!
+  Print the median, 99th percentile and maximum of the latencies in us.
+ */
+void printLatency(const std::string &name, std::vector<double> &latency)
+{
+  std::sort(latency.begin(), latency.end());
+  size_t n = latency.size();
+  std::cout << std::setw(28) << std::left << name
+            << " p50: " << std::setw(8) << std::setprecision(4) << latency[n/2]
+            << " p99: " << std::setw(8) << std::setprecision(4) << latency[(99*n)/100]
+            << " max: " << std::setprecision(4) << latency[n-1] << " us" << std::endl;
+}
+
+int main(int argc, const char* argv[])
+{
+  unsigned int nb_iter = 10000;
+  for (int i=1; i < argc; i++) {
+    if (std::string(argv[i]) == "--iter" && i+1 < argc)
+      nb_iter = (unsigned int)atoi(argv[++i]);
+    else if (std::string(argv[i]) == "--help") {
+      std::cout << "Usage: " << argv[0] << " [--iter <number of iterations>] [--help]" << std::endl;
+      return 0;
+    }
+  }
+  if (nb_iter == 0)
+    nb_iter = 1;
+
+  const unsigned int nb_joints = 7;
+  const unsigned int nb_arms = 2;
+  const double ro = 0.1;
+  const double ro1 = 0.3;
+
+  vpMatrix J(6, nb_joints);
+  for (unsigned int i=0; i < 6; i++)
+    for (unsigned int j=0; j < nb_joints; j++)
+      J[i][j] = cos(1.3*i + 0.7*j + 0.1*i*j);
+  vpMatrix J_pinv = J.pseudoInverse();
+  vpColVector e(6, 0.2);
+  vpColVector jointMin(nb_joints, -1.5), jointMax(nb_joints, 1.5);
+  vpColVector q_l0_min(nb_joints), q_l0_max(nb_joints), q_l1_min(nb_joints), q_l1_max(nb_joints);
+  vpColVector q(nb_joints), q1(nb_joints, 0.01), q2(nb_joints);
+  double checksum[2] = {0, 0};
+
+  for (unsigned int k=0; k < 2; k++) {
+    bool fixed_size = (k == 1);
+    std::vector<double> latency(nb_iter);
+    for (unsigned int iter=0; iter < nb_iter; iter++) {
+      // Some joints are close to their limits
+      for (unsigned int j=0; j < nb_joints; j++)
+        q[j] = 1.45 * sin(0.01*iter + j);
+
+      double t0 = vpTime::measureTimeMicros();
+      for (unsigned int arm=0; arm < nb_arms; arm++) {
+        if (fixed_size)
+          vpJointLimitAvoidance<nb_joints>::computeQdotLimitAvoidance(e, J, J_pinv, jointMin, jointMax, q, q1, ro, ro1,
+                                                                      q_l0_min, q_l0_max, q_l1_min, q_l1_max, q2);
+        else
+          q2 = computeQdotLimitAvoidance(e, J, J_pinv, jointMin, jointMax, q, q1, ro, ro1,
+                                         q_l0_min, q_l0_max, q_l1_min, q_l1_max);
+      }
+      latency[iter] = vpTime::measureTimeMicros() - t0;
+      checksum[k] += q2.sumSquare();
+    }
+    printLatency(fixed_size ? "2 arms vpJointLimitAvoidance<7>" : "2 arms computeQdotLimitAvoidance", latency);
+  }
+
+  std::cout << "Checksum: " << checksum[0] << " " << checksum[1] << std::endl;
+  return 0;
+}
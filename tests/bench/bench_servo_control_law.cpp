@@ -0,0 +1,131 @@
+/**
+ *
+ * This example measures the latency of the arm and head control laws, with the vpServo
+ * implementation and with the real-time mode of vpServoArm and vpServoHead.
+ *
+ * Usage: ./bench_servo_control_law [--iter <number of iterations>]
+ *
+ */
+
+#include <stdlib.h>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <visp/vpHomogeneousMatrix.h>
+#include <visp/vpTime.h>
+#include <visp/vpVelocityTwistMatrix.h>
+
+#include <vpServoArm.h>
+#include <vpServoHead.h>
+
+/*!
+  Print the median, 99th percentile and maximum of the latencies in us.
+ */
+void printLatency(const std::string &name, std::vector<double> &latency)
+{
+  std::sort(latency.begin(), latency.end());
+  size_t n = latency.size();
+  std::cout << std::setw(28) << std::left << name
+            << " p50: " << std::setw(8) << std::setprecision(4) << latency[n/2]
+            << " p99: " << std::setw(8) << std::setprecision(4) << latency[(99*n)/100]
+            << " max: " << std::setprecision(4) << latency[n-1] << " us" << std::endl;
+}
+
+void benchServoArm(vpServoArm::vpServoArmType type, const std::string &name, bool realtime, unsigned int nb_iter)
+{
+  const unsigned int nb_joints = 7;
+  vpMatrix eJe(6, nb_joints);
+  for (unsigned int i=0; i < 6; i++)
+    for (unsigned int j=0; j < nb_joints; j++)
+      eJe[i][j] = cos(1.3*i + 0.7*j + 0.1*i*j);
+  vpVelocityTwistMatrix cVe(vpHomogeneousMatrix(0.1, -0.05, 0.2, 0.3, -0.2, 0.1));
+  vpColVector z_c(3), z_d(3);
+  z_c[0] = 0.1; z_c[1] = 0.2; z_c[2] = 1.; z_c.normalize();
+  z_d[2] = 1.;
+
+  vpServoArm servo(type);
+  servo.setRealTime(realtime, nb_joints);
+  vpColVector q_dot(nb_joints);
+  std::vector<double> latency(nb_iter);
+
+  // Redirect the prints of the default mode
+  std::streambuf *cout_buf = std::cout.rdbuf(NULL);
+  for (unsigned int iter=0; iter < nb_iter; iter++) {
+    double t = 0.01*iter;
+    vpHomogeneousMatrix cdMc(0.05*cos(t), 0.02, -0.1*sin(t), 0.3*sin(t), 0.1, -0.2*cos(t));
+
+    double t0 = vpTime::measureTimeMicros();
+    servo.set_cVe(cVe);
+    servo.set_eJe(eJe);
+    if (type == vpServoArm::vs6dof_cyl)
+      servo.setCurrentFeature(cdMc, z_c, z_d);
+    else
+      servo.setCurrentFeature(cdMc);
+    if (realtime)
+      servo.computeControlLaw(q_dot);
+    else
+      q_dot = servo.m_task.computeControlLaw();
+    latency[iter] = vpTime::measureTimeMicros() - t0;
+  }
+  std::cout.rdbuf(cout_buf);
+
+  printLatency(name + (realtime ? " real-time" : " vpServo"), latency);
+}
+
+void benchServoHead(bool realtime, unsigned int nb_iter)
+{
+  const unsigned int nb_joints = 4;
+  vpMatrix eJe(6, nb_joints);
+  for (unsigned int i=0; i < 6; i++)
+    for (unsigned int j=0; j < nb_joints; j++)
+      eJe[i][j] = cos(1.3*i + 0.7*j + 0.1*i*j);
+  vpVelocityTwistMatrix cVe(vpHomogeneousMatrix(0.05, 0.1, 0.0, 0.0, 0.1, 0.0));
+
+  vpServoHead servo;
+  servo.setCameraParameters(vpCameraParameters(600, 600, 320, 240));
+  servo.setRealTime(realtime, nb_joints);
+  vpColVector q_dot(nb_joints);
+  std::vector<double> latency(nb_iter);
+
+  for (unsigned int iter=0; iter < nb_iter; iter++) {
+    vpImagePoint ip_cur(240 + 80*sin(0.05*iter), 320 + 60*cos(0.05*iter));
+
+    double t0 = vpTime::measureTimeMicros();
+    servo.set_cVe(cVe);
+    servo.set_eJe(eJe);
+    servo.setCurrentFeature(ip_cur);
+    servo.setDesiredFeature(vpImagePoint(200, 300));
+    servo.computeControlLaw(q_dot);
+    latency[iter] = vpTime::measureTimeMicros() - t0;
+  }
+
+  printLatency(std::string("head") + (realtime ? " real-time" : " vpServo"), latency);
+}
+
+int main(int argc, const char* argv[])
+{
+  unsigned int nb_iter = 10000;
+  for (int i=1; i < argc; i++) {
+    if (std::string(argv[i]) == "--iter" && i+1 < argc)
+      nb_iter = (unsigned int)atoi(argv[++i]);
+    else if (std::string(argv[i]) == "--help") {
+      std::cout << "Usage: " << argv[0] << " [--iter <number of iterations>] [--help]" << std::endl;
+      return 0;
+    }
+  }
+  if (nb_iter == 0)
+    nb_iter = 1;
+
+  for (unsigned int i=0; i < 2; i++) {
+    bool realtime = (i == 1);
+    benchServoArm(vpServoArm::vs6dof, "vs6dof", realtime, nb_iter);
+    benchServoArm(vpServoArm::vs5dof_cyl, "vs5dof_cyl", realtime, nb_iter);
+    benchServoArm(vpServoArm::vs6dof_cyl, "vs6dof_cyl", realtime, nb_iter);
+    benchServoHead(realtime, nb_iter);
+  }
+
+  return 0;
+}
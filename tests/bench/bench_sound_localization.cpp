@@ -0,0 +1,134 @@
+/**
+ *
+ * This example measures the throughput and the accuracy of vpSoundLocalization on synthetic stereo signals:
+ * white noise emitted from several azimuths reaches the right microphone with the delay and the attenuation
+ * given by the geometry, both microphones getting an independent noise. The signal is streamed through a
+ * vpAudioCapture by buffers of 256 frames like the sound card, and the localization runs on every hop.
+ *
+ * For each azimuth it prints the mean and the RMS error of the estimated azimuth, then the time spent in
+ * process() per frame and the real-time factor, the audio duration of a hop divided by that time.
+ *
+ * Usage: ./bench_sound_localization [--iter <number of frames per azimuth>] [--frame <frame length>]
+ *                                   [--snr <signal to noise ratio in dB>]
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <visp/vpTime.h>
+
+#include <vpAudioCapture.h>
+#include <vpSoundLocalization.h>
+
+/*!
+  White noise in [-amplitude, amplitude].
+ */
+double noise(double amplitude)
+{
+  return amplitude * (2. * rand() / RAND_MAX - 1.);
+}
+
+/*!
+  Value of \e s at the fractional index \e t, by windowed sinc interpolation.
+ */
+double interpolate(const std::vector<double> &s, double t)
+{
+  const int half = 16;
+  int i0 = (int)floor(t);
+  double sum = 0.;
+  for (int i = i0 - half + 1; i <= i0 + half; i++) {
+    if (i < 0 || i >= (int)s.size())
+      continue;
+    double x = t - i;
+    double sinc = (fabs(x) < 1e-9) ? 1. : sin(M_PI * x) / (M_PI * x);
+    double window = 0.5 + 0.5 * cos(M_PI * x / half);
+    sum += s[i] * sinc * window;
+  }
+  return sum;
+}
+
+int main(int argc, const char* argv[])
+{
+  unsigned int nb_iter = 200;
+  unsigned int frame_length = 1024;
+  double snr = 20.;
+  for (int i=1; i < argc; i++) {
+    if (std::string(argv[i]) == "--iter" && i+1 < argc)
+      nb_iter = (unsigned int)atoi(argv[++i]);
+    else if (std::string(argv[i]) == "--frame" && i+1 < argc)
+      frame_length = (unsigned int)atoi(argv[++i]);
+    else if (std::string(argv[i]) == "--snr" && i+1 < argc)
+      snr = atof(argv[++i]);
+    else if (std::string(argv[i]) == "--help") {
+      std::cout << "Usage: " << argv[0] << " [--iter <number of frames per azimuth>] [--frame <frame length>]"
+                << " [--snr <signal to noise ratio in dB>] [--help]" << std::endl;
+      return 0;
+    }
+  }
+  if (nb_iter == 0)
+    nb_iter = 1;
+
+  const double fs = 48000.;
+  const double d = 0.31;
+  const double c = 343.;
+  const unsigned int hop = frame_length / 2;
+  const unsigned int buffer_frames = 256;
+  const double noise_amplitude = 0.3 * pow(10., -snr / 20.);
+
+  srand(0);
+  vpSoundLocalization localization(fs, frame_length, d, c);
+  std::vector<double> times;
+  double azimuths_deg[7] = {-60., -30., -10., 0., 10., 30., 60.};
+
+  std::cout << "Frames of " << frame_length << " samples every " << hop << " samples, SNR " << snr << " dB" << std::endl;
+  for (unsigned int a=0; a < 7; a++) {
+    double azimuth = azimuths_deg[a] * M_PI / 180.;
+    double delay = d * sin(azimuth) / c * fs;
+    double gain_r = pow(10., -6. * sin(azimuth) / 20.); // Shadow of the head
+
+    unsigned int n = frame_length + nb_iter * hop;
+    std::vector<double> source(n + 64);
+    for (size_t i=0; i < source.size(); i++)
+      source[i] = noise(0.3);
+    std::vector<float> stereo(2 * n);
+    for (unsigned int i=0; i < n; i++) {
+      stereo[2*i] = (float)(source[i + 32] + noise(noise_amplitude));
+      stereo[2*i+1] = (float)(gain_r * interpolate(source, i + 32 - delay) + noise(noise_amplitude));
+    }
+
+    vpAudioCapture capture(2, fs, frame_length, hop, (double)n / fs);
+    for (unsigned int i=0; i + buffer_frames <= n; i += buffer_frames)
+      vpAudioCapture::callbackFloat32(NULL, &stereo[2*i], buffer_frames, 0., 0, &capture);
+
+    double sum = 0., sum_square = 0.;
+    unsigned int nb_valid = 0;
+    while (capture.acquire(0.)) {
+      double t0 = vpTime::measureTimeMicros();
+      bool valid = localization.process(capture);
+      times.push_back(vpTime::measureTimeMicros() - t0);
+      if (valid) {
+        double error = (localization.getAzimuth() - azimuth) * 180. / M_PI;
+        sum += error;
+        sum_square += error * error;
+        nb_valid ++;
+      }
+    }
+    std::cout << "azimuth " << std::setw(5) << azimuths_deg[a] << " deg: " << nb_valid << " frames, mean error "
+              << std::setprecision(3) << (nb_valid ? sum / nb_valid : 0.) << " deg, RMS error "
+              << (nb_valid ? sqrt(sum_square / nb_valid) : 0.) << " deg, ILD " << localization.getIld() << " dB"
+              << std::endl;
+  }
+
+  std::sort(times.begin(), times.end());
+  double median = times[times.size() / 2];
+  std::cout << "process() p50: " << std::setprecision(4) << median << " us, p99: " << times[(99 * times.size()) / 100]
+            << " us, real-time factor: " << hop / fs * 1e6 / median << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,460 @@
+/**
+ *
+ * Benchmark of the trackers of romeo_tk over a recorded sequence (see tools/sequence/record_sequence)
+ * or over a synthetic sequence when no sequence is given.
+ *
+ * Each tracker processes the same frames, as fast as possible. For each of them the benchmark reports
+ * the throughput, the latency percentiles of track(), the number of frames where the target was found,
+ * among them the frames where it was acquired by a detection and the ones where it was kept by the tracking
+ * (when the tracker is instrumented with vpStageProfiler and thus has a detection and a tracking state),
+ * the number of memory allocations per frame and the peak resident memory of the process.
+ * Results are written in JSON, so that they can be compared between commits.
+ *
+ * Usage: ./romeo_tk_bench [--input <sequence file>] [--frames <number of frames>] [--tracker <name>]
+ *                         [--data <data folder>] [--label <label>] [--output <json file>]
+ *
+ * Trackers: qrcode, face, color, blobs, template, mbt (all of them by default, --tracker can be repeated).
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <stdio.h>
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <visp/vpImage.h>
+#include <visp/vpPoint.h>
+#include <visp/vpTime.h>
+
+#include <vpAllocationHooks.h>
+#include <vpBlobsTargetTracker.h>
+#include <vpColorDetection.h>
+#include <vpFaceTracker.h>
+#include <vpMbLocalization.h>
+#include <vpQRCodeTracker.h>
+#include <vpReplayGrabber.h>
+#include <vpRomeoTkConfig.h>
+#include <vpTemplateLocatization.h>
+
+/*!
+  Peak resident memory of the process in kB.
+ */
+long getPeakRss()
+{
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return -1;
+  return usage.ru_maxrss;
+}
+
+/*!
+  Frames given to the trackers, either replayed from a sequence file or synthesized.
+  Each frame is provided both as a gray image and as a BGR image.
+ */
+class vpBenchSource
+{
+protected:
+  vpReplayGrabber m_grabber;
+  bool m_synthetic;
+  unsigned int m_nb_frames;
+  unsigned int m_frame;
+  unsigned int m_width;
+  unsigned int m_height;
+  vpCameraParameters m_cam;
+
+public:
+  vpBenchSource(const std::string &filename, unsigned int nb_frames)
+    : m_grabber(), m_synthetic(filename.empty()), m_nb_frames(nb_frames), m_frame(0), m_width(320), m_height(240), m_cam()
+  {
+    if (m_synthetic) {
+      m_cam.initPersProjWithoutDistortion(300, 300, m_width/2, m_height/2);
+      return;
+    }
+    m_grabber.open(filename);
+    m_grabber.setRealTime(false);
+    m_width = m_grabber.getWidth();
+    m_height = m_grabber.getHeight();
+    m_cam = m_grabber.getCameraParameters(vpCameraParameters::perspectiveProjWithoutDistortion);
+    if (m_nb_frames == 0 || m_nb_frames > m_grabber.getNbFrames())
+      m_nb_frames = m_grabber.getNbFrames();
+  }
+
+  vpCameraParameters getCameraParameters() const {return m_cam;}
+  unsigned int getHeight() const {return m_height;}
+  unsigned int getNbFrames() const {return m_nb_frames;}
+  unsigned int getWidth() const {return m_width;}
+  bool isSynthetic() const {return m_synthetic;}
+
+  /*!
+    Provide the next frame. I and cvI have to be allocated with the size of the sequence.
+   */
+  bool next(vpImage<unsigned char> &I, cv::Mat &cvI)
+  {
+    if (m_frame >= m_nb_frames)
+      return false;
+
+    if (m_synthetic)
+      render(m_frame, cvI);
+    else if (! m_grabber.acquire(cvI))
+      return false;
+
+    cv::Mat gray((int)m_height, (int)m_width, CV_8UC1, I.bitmap);
+    cv::cvtColor(cvI, gray, CV_BGR2GRAY);
+    m_frame ++;
+    return true;
+  }
+
+  void rewind()
+  {
+    m_frame = 0;
+    if (! m_synthetic)
+      m_grabber.setFrameIndex(0);
+  }
+
+protected:
+  /*!
+    Synthetic frame: a colored plate carrying four dark blobs, moving on a light background.
+   */
+  void render(unsigned int frame, cv::Mat &cvI) const
+  {
+    cvI.setTo(cv::Scalar(200, 200, 200));
+    double t = 0.05 * frame;
+    cv::Point center((int)(m_width/2 + 0.25*m_width*cos(t)), (int)(m_height/2 + 0.2*m_height*sin(1.3*t)));
+    int half = (int)(0.12 * m_width);
+    cv::rectangle(cvI, cv::Point(center.x - half, center.y - half), cv::Point(center.x + half, center.y + half),
+                  cv::Scalar(40, 40, 200), CV_FILLED);
+    int offset = half / 2;
+    for (int i=0; i < 4; i++) {
+      cv::Point blob(center.x + ((i == 0 || i == 3) ? offset : -offset), center.y + ((i < 2) ? offset : -offset));
+      cv::circle(cvI, blob, half / 5, cv::Scalar(20, 20, 20), CV_FILLED);
+    }
+  }
+};
+
+/*!
+  Common interface of the benchmarked trackers.
+ */
+class vpBenchTracker
+{
+public:
+  virtual ~vpBenchTracker() {}
+  virtual vpStageProfiler *getProfiler() {return NULL;}
+  virtual bool track(const vpImage<unsigned char> &I, const cv::Mat &cvI) = 0;
+};
+
+class vpBenchQRCode : public vpBenchTracker
+{
+  vpQRCodeTracker m_tracker;
+public:
+  vpBenchQRCode(const vpCameraParameters &cam)
+  {
+    m_tracker.setCameraParameters(cam);
+    m_tracker.setQRCodeSize(0.045);
+  }
+  vpStageProfiler *getProfiler() {return &m_tracker.getProfiler();}
+  bool track(const vpImage<unsigned char> &I, const cv::Mat &) {return m_tracker.track(I);}
+};
+
+class vpBenchFace : public vpBenchTracker
+{
+  vpFaceTracker m_tracker;
+public:
+  vpBenchFace(const std::string &data_folder)
+  {
+    m_tracker.setFaceCascade(data_folder + "/face/haarcascade_frontalface_alt.xml");
+  }
+  bool track(const vpImage<unsigned char> &I, const cv::Mat &) {return m_tracker.track(I);}
+};
+
+class vpBenchColor : public vpBenchTracker
+{
+  vpColorDetection m_tracker;
+public:
+  vpBenchColor(const std::string &data_folder)
+  {
+    std::string filename = data_folder + "/objects/star_wars_pic/color/star_wars_picHSV.txt";
+    if (! m_tracker.loadHSV(filename))
+      throw vpException(vpException::ioError, "Cannot load %s", filename.c_str());
+  }
+  bool track(const vpImage<unsigned char> &, const cv::Mat &cvI) {return m_tracker.detect(cvI);}
+};
+
+class vpBenchBlobs : public vpBenchTracker
+{
+  vpBlobsTargetTracker m_tracker;
+public:
+  vpBenchBlobs(const std::string &data_folder, const vpCameraParameters &cam)
+  {
+    const double L = 0.025/2;
+    std::vector<vpPoint> points(4);
+    points[2].setWorldCoordinates(-L, -L, 0);
+    points[1].setWorldCoordinates(-L,  L, 0);
+    points[0].setWorldCoordinates( L,  L, 0);
+    points[3].setWorldCoordinates( L, -L, 0);
+
+    std::string filename = data_folder + "/target/LArm/color.txt";
+    m_tracker.setName("LArm");
+    m_tracker.setCameraParameters(cam);
+    m_tracker.setPoints(points);
+    m_tracker.getOverlay().setMode(vpOverlay::headless);
+    if (! m_tracker.loadHSV(filename))
+      throw vpException(vpException::ioError, "Cannot load %s", filename.c_str());
+  }
+  vpStageProfiler *getProfiler() {return &m_tracker.getProfiler();}
+  bool track(const vpImage<unsigned char> &I, const cv::Mat &cvI) {return m_tracker.track(cvI, I);}
+};
+
+class vpBenchTemplate : public vpBenchTracker
+{
+  vpTemplateLocatization m_tracker;
+public:
+  vpBenchTemplate(const std::string &data_folder, const vpCameraParameters &cam)
+    : m_tracker(data_folder + "/objects/star_wars_pic/model/star_wars_pic", data_folder + "/objects/star_wars_pic/detection/", cam)
+  {
+    m_tracker.setTemplateSize(0.175, 0.12);
+    m_tracker.initDetection(data_folder + "/objects/star_wars_pic/detection/learning/20/learning_data.bin");
+    m_tracker.getOverlay().setMode(vpOverlay::headless);
+  }
+  vpStageProfiler *getProfiler() {return &m_tracker.getProfiler();}
+  bool track(const vpImage<unsigned char> &I, const cv::Mat &) {return m_tracker.track(I);}
+};
+
+class vpBenchMbt : public vpBenchTracker
+{
+  vpMbLocalization m_tracker;
+public:
+  vpBenchMbt(const std::string &data_folder, const vpCameraParameters &cam)
+    : m_tracker(data_folder + "/objects/milkbox/model/milkbox", data_folder + "/objects/milkbox/detection/", cam)
+  {
+    m_tracker.initDetection(data_folder + "/objects/milkbox/detection/learning/learning_data.bin");
+    m_tracker.getOverlay().setMode(vpOverlay::headless);
+  }
+  vpStageProfiler *getProfiler() {return &m_tracker.getProfiler();}
+  bool track(const vpImage<unsigned char> &I, const cv::Mat &) {return m_tracker.track(I);}
+};
+
+vpBenchTracker *createTracker(const std::string &name, const std::string &data_folder, const vpCameraParameters &cam)
+{
+  if (name == "qrcode")
+    return new vpBenchQRCode(cam);
+  else if (name == "face")
+    return new vpBenchFace(data_folder);
+  else if (name == "color")
+    return new vpBenchColor(data_folder);
+  else if (name == "blobs")
+    return new vpBenchBlobs(data_folder, cam);
+  else if (name == "template")
+    return new vpBenchTemplate(data_folder, cam);
+  else if (name == "mbt")
+    return new vpBenchMbt(data_folder, cam);
+  throw vpException(vpException::badValue, "Unknown tracker %s", name.c_str());
+}
+
+/*!
+  Escape \e value to write it in a JSON string.
+ */
+std::string escapeJson(const std::string &value)
+{
+  std::string escaped;
+  for (size_t i=0; i < value.size(); i++) {
+    unsigned char c = (unsigned char)value[i];
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+      escaped += (char)c;
+    }
+    else if (c < 0x20) {
+      char code[8];
+      sprintf(code, "\\u%04x", c);
+      escaped += code;
+    }
+    else
+      escaped += (char)c;
+  }
+  return escaped;
+}
+
+double getPercentile(const std::vector<double> &sorted, double percent)
+{
+  if (sorted.empty())
+    return 0.;
+  return sorted[(size_t)(percent / 100. * (sorted.size() - 1) + 0.5)];
+}
+
+/*!
+  Run a tracker over the whole sequence and write its JSON result.
+ */
+void runTracker(const std::string &name, const std::string &data_folder, vpBenchSource &source,
+                vpImage<unsigned char> &I, cv::Mat &cvI, std::ostream &os)
+{
+  os << "    {\"tracker\": \"" << escapeJson(name) << "\", ";
+
+  vpBenchTracker *tracker = NULL;
+  try {
+    tracker = createTracker(name, data_folder, source.getCameraParameters());
+  }
+  catch (const vpException &e) {
+    std::cerr << name << ": " << e.getMessage() << std::endl;
+    os << "\"error\": \"cannot initialize the tracker\"}";
+    return;
+  }
+  catch (const std::exception &e) {
+    std::cerr << name << ": " << e.what() << std::endl;
+    os << "\"error\": \"cannot initialize the tracker\"}";
+    return;
+  }
+
+  vpStageProfiler *profiler = tracker->getProfiler();
+  if (profiler) {
+    profiler->reset();
+    profiler->setEnabled(true);
+  }
+
+  std::vector<double> latency;
+  latency.reserve(source.getNbFrames());
+  unsigned int nb_found = 0;
+  unsigned int nb_detected = 0;  // Found after a frame where the target was not: acquired by a detection
+  unsigned int nb_tracked = 0;   // Found after a frame where it was found: kept by the tracking
+  bool found_prev = false;
+  unsigned long nb_allocations = 0;
+  bool failed = false;
+
+  source.rewind();
+  while (source.next(I, cvI)) {
+    vpAllocationCounter::vpScope allocations;
+    double t0 = vpTime::measureTimeMs();
+    bool found = false;
+    try {
+      found = tracker->track(I, cvI);
+    }
+    catch (const vpException &e) {
+      std::cerr << name << ": " << e.getMessage() << std::endl;
+      failed = true;
+      break;
+    }
+    catch (const std::exception &e) {
+      std::cerr << name << ": " << e.what() << std::endl;
+      failed = true;
+      break;
+    }
+    double t = vpTime::measureTimeMs() - t0;
+    nb_allocations += allocations.getNbAllocations();
+
+    latency.push_back(t);
+    if (found) {
+      nb_found ++;
+      if (found_prev)
+        nb_tracked ++;
+      else
+        nb_detected ++;
+    }
+    found_prev = found;
+  }
+
+  double total = 0.;
+  for (size_t i=0; i < latency.size(); i++)
+    total += latency[i];
+  std::sort(latency.begin(), latency.end());
+  size_t n = latency.size();
+
+  os << "\"frames\": " << n << ", "
+     << "\"fps\": " << (total > 0. ? 1000. * n / total : 0.) << ", "
+     << "\"latency_ms\": {\"p50\": " << getPercentile(latency, 50) << ", \"p95\": " << getPercentile(latency, 95)
+     << ", \"p99\": " << getPercentile(latency, 99) << ", \"max\": " << (n ? latency[n-1] : 0.) << "}, "
+     << "\"found\": " << nb_found << ", ";
+  // The stages run are not counted: the QR code detection for example runs on every frame, even while tracking
+  if (profiler)
+    os << "\"detections\": " << nb_detected << ", \"tracks\": " << nb_tracked << ", ";
+  else // Detection and tracking are not distinguished without a profiler
+    os << "\"detections\": null, \"tracks\": null, ";
+  os << "\"allocations_per_frame\": " << (n ? (double)nb_allocations / n : 0.) << ", "
+     << "\"peak_rss_kb\": " << getPeakRss();
+  if (failed)
+    os << ", \"error\": \"exception during tracking\"";
+  os << "}";
+
+  std::cout << name << ": " << n << " frames, " << (total > 0. ? 1000. * n / total : 0.) << " frames/s, found "
+            << nb_found << std::endl;
+  delete tracker;
+}
+
+int main(int argc, const char* argv[])
+{
+  std::string opt_input;
+  std::string opt_data_folder = std::string(ROMEOTK_DATA_FOLDER);
+  std::string opt_label = "unknown";
+  std::string opt_output;
+  unsigned int opt_frames = 0;
+  std::vector<std::string> opt_trackers;
+
+  for (int i=1; i < argc; i++) {
+    if (std::string(argv[i]) == "--input" && i+1 < argc)
+      opt_input = argv[++i];
+    else if (std::string(argv[i]) == "--frames" && i+1 < argc)
+      opt_frames = (unsigned int)atoi(argv[++i]);
+    else if (std::string(argv[i]) == "--tracker" && i+1 < argc)
+      opt_trackers.push_back(argv[++i]);
+    else if (std::string(argv[i]) == "--data" && i+1 < argc)
+      opt_data_folder = argv[++i];
+    else if (std::string(argv[i]) == "--label" && i+1 < argc)
+      opt_label = argv[++i];
+    else if (std::string(argv[i]) == "--output" && i+1 < argc)
+      opt_output = argv[++i];
+    else if (std::string(argv[i]) == "--help") {
+      std::cout << "Usage: " << argv[0] << " [--input <sequence file>] [--frames <number of frames>] [--tracker <name>]"
+                << " [--data <data folder>] [--label <label>] [--output <json file>] [--help]" << std::endl;
+      std::cout << "Trackers: qrcode, face, color, blobs, template, mbt" << std::endl;
+      return 0;
+    }
+  }
+  if (opt_trackers.empty()) {
+    const char *trackers[] = {"qrcode", "face", "color", "blobs", "template", "mbt"};
+    opt_trackers.assign(trackers, trackers + 6);
+  }
+  if (opt_input.empty() && opt_frames == 0)
+    opt_frames = 300;
+
+  try {
+    vpBenchSource source(opt_input, opt_frames);
+    vpImage<unsigned char> I(source.getHeight(), source.getWidth());
+    cv::Mat cvI((int)source.getHeight(), (int)source.getWidth(), CV_8UC3);
+
+    std::ofstream file;
+    if (! opt_output.empty()) {
+      file.open(opt_output.c_str());
+      if (! file.is_open()) {
+        std::cerr << "Cannot create " << opt_output << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    std::ostream &os = opt_output.empty() ? std::cout : file;
+
+    os << "{\n  \"label\": \"" << escapeJson(opt_label) << "\",\n"
+       << "  \"sequence\": \"" << (source.isSynthetic() ? "synthetic" : escapeJson(opt_input)) << "\",\n"
+       << "  \"width\": " << source.getWidth() << ", \"height\": " << source.getHeight() << ",\n"
+       << "  \"results\": [\n";
+    for (size_t i=0; i < opt_trackers.size(); i++) {
+      runTracker(opt_trackers[i], opt_data_folder, source, I, cvI, os);
+      os << (i+1 < opt_trackers.size() ? ",\n" : "\n");
+    }
+    os << "  ]\n}" << std::endl;
+  }
+  catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+  catch (const std::exception &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
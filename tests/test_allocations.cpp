@@ -0,0 +1,303 @@
+/**
+ *
+ * This example counts the heap allocations done by the hot paths of romeo_tk once they reached their
+ * working size. romeo_tk itself should not allocate in vpDampedLeastSquares::solve(),
+ * vpJointLimitAvoidance<7>::computeQdotLimitAvoidance(), vpColorDetection::detect(), and in the tracking
+ * state of vpQRCodeTracker::track() and vpBlobsTargetTracker::track(). The allocations done by OpenCV, zbar
+ * and ViSP within these calls are marked by a vpAllocationCounter::vpExternalScope: they are only reported, but
+ * the number of live allocations should not grow from one frame to the other.
+ *
+ * Usage: ./test_allocations [--iter <number of iterations>]
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <visp/vpColVector.h>
+#include <visp/vpImage.h>
+#include <visp/vpImageConvert.h>
+#include <visp/vpIoTools.h>
+#include <visp/vpMatrix.h>
+#include <visp/vpPoint.h>
+
+#include <vpAllocationHooks.h>
+#include <vpBlobsTargetTracker.h>
+#include <vpColorDetection.h>
+#include <vpDampedLeastSquares.h>
+#include <vpJointLimitAvoidance.h>
+#include <vpQRCodeTracker.h>
+#include <vpRomeoTkConfig.h>
+
+/*!
+  Print the allocations of \e nb_iter calls, and check that romeo_tk itself did not allocate and that the
+  live allocations did not grow.
+ */
+bool checkAllocations(const std::string &name, const vpAllocationCounter::vpScope &scope, unsigned int nb_iter)
+{
+  std::cout << name << ": " << (double)scope.getNbOwnAllocations() / nb_iter << " own allocation(s) per call, "
+            << (double)scope.getNbExternalAllocations() / nb_iter << " by third-party libraries, "
+            << scope.getNbBytes() / nb_iter << " bytes per call, " << scope.getNbLive()
+            << " live allocation(s) after " << nb_iter << " calls" << std::endl;
+  bool success = true;
+  if (scope.getNbOwnAllocations() > 0) {
+    std::cout << name << ": romeo_tk allocates" << std::endl;
+    success = false;
+  }
+  if (scope.getNbLive() > 0) {
+    std::cout << name << ": the live allocations grow" << std::endl;
+    success = false;
+  }
+  return success;
+}
+
+vpMatrix buildJacobian(unsigned int nb_joints)
+{
+  vpMatrix J(6, nb_joints);
+  for (unsigned int i=0; i < 6; i++)
+    for (unsigned int j=0; j < nb_joints; j++)
+      J[i][j] = cos(1.3*i + 0.7*j + 0.1*i*j);
+  return J;
+}
+
+bool testDampedLeastSquares(unsigned int nb_iter)
+{
+  vpMatrix J = buildJacobian(7);
+  vpColVector e(6, 0.1);
+  vpColVector x(7);
+  vpDampedLeastSquares solver(1e-3);
+  solver.setAdaptiveDamping(0.05, 1e-2);
+  solver.solve(J, e, x);
+
+  vpAllocationCounter::vpScope scope;
+  for (unsigned int iter=0; iter < nb_iter; iter++) {
+    J[0][iter % 7] += 1e-4;
+    e[iter % 6] = 0.1 * sin(0.01*iter);
+    solver.solve(J, e, x);
+  }
+  return checkAllocations("vpDampedLeastSquares::solve", scope, nb_iter);
+}
+
+bool testJointLimitAvoidance(unsigned int nb_iter)
+{
+  const unsigned int nb_joints = 7;
+  vpMatrix J = buildJacobian(nb_joints);
+  vpMatrix J_pinv = J.pseudoInverse();
+  vpColVector e(6, 0.2);
+  vpColVector jointMin(nb_joints, -1.5), jointMax(nb_joints, 1.5);
+  vpColVector q_l0_min(nb_joints), q_l0_max(nb_joints), q_l1_min(nb_joints), q_l1_max(nb_joints);
+  vpColVector q(nb_joints), q1(nb_joints, 0.01), q2(nb_joints);
+
+  vpAllocationCounter::vpScope scope;
+  for (unsigned int iter=0; iter < nb_iter; iter++) {
+    // Some joints are close to their limits
+    for (unsigned int j=0; j < nb_joints; j++)
+      q[j] = 1.45 * sin(0.01*iter + j);
+    vpJointLimitAvoidance<nb_joints>::computeQdotLimitAvoidance(e, J, J_pinv, jointMin, jointMax, q, q1, 0.1, 0.3,
+                                                                q_l0_min, q_l0_max, q_l1_min, q_l1_max, q2);
+  }
+  return checkAllocations("vpJointLimitAvoidance<7>", scope, nb_iter);
+}
+
+/*!
+  Check that the target was found in each of the \e nb_iter measured frames.
+ */
+bool checkTracking(const std::string &name, unsigned int nb_found, unsigned int nb_iter)
+{
+  if (nb_found != nb_iter) {
+    std::cout << name << ": target found in " << nb_found << " frames over " << nb_iter << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/*!
+  Red square moving on a gray background.
+ */
+void render(unsigned int frame, cv::Mat &cvI)
+{
+  cvI.setTo(cv::Scalar(128, 128, 128));
+  cv::Point center(160 + (int)(60*cos(0.05*frame)), 120 + (int)(40*sin(0.05*frame)));
+  cv::rectangle(cvI, cv::Point(center.x - 30, center.y - 30), cv::Point(center.x + 30, center.y + 30),
+                cv::Scalar(0, 0, 255), CV_FILLED);
+}
+
+bool testColorDetection(unsigned int nb_iter)
+{
+  cv::Mat cvI(240, 320, CV_8UC3);
+  vpColorDetection detector;
+  detector.setValuesHSV(0, 150, 150, 10, 255, 255);
+  detector.setMaxAndMinObjectArea(500, 10000);
+
+  // Warm up: reach the working size of the internal buffers
+  for (unsigned int iter=0; iter < 10; iter++) {
+    render(iter, cvI);
+    detector.detect(cvI);
+  }
+
+  vpAllocationCounter::vpScope scope;
+  unsigned int nb_found = 0;
+  for (unsigned int iter=0; iter < nb_iter; iter++) {
+    render(iter, cvI);
+    if (detector.detect(cvI))
+      nb_found ++;
+  }
+  bool success = checkAllocations("vpColorDetection::detect", scope, nb_iter);
+  return checkTracking("vpColorDetection::detect", nb_found, nb_iter) && success;
+}
+
+/*!
+  QR code of the left arm of Romeo, moving by one pixel from one frame to the other on a white background.
+ */
+void renderQRCode(unsigned int frame, const cv::Mat &qrcode, vpImage<unsigned char> &I)
+{
+  I = 255;
+  unsigned int top = (I.getHeight() - qrcode.rows) / 2 + frame % 2;
+  unsigned int left = (I.getWidth() - qrcode.cols) / 2 + (frame / 2) % 2;
+  for (int i=0; i < qrcode.rows; i++)
+    for (int j=0; j < qrcode.cols; j++)
+      I[top + i][left + j] = qrcode.at<unsigned char>(i, j);
+}
+
+bool testQRCodeTracker(unsigned int nb_iter)
+{
+  std::string filename = std::string(ROMEOTK_DATA_FOLDER) + "/QR-Code/qrcode_romeo_left_arm.png";
+  cv::Mat qrcode_file = cv::imread(filename, CV_LOAD_IMAGE_GRAYSCALE);
+  if (qrcode_file.empty()) {
+    std::cout << "vpQRCodeTracker::track: cannot read " << filename << std::endl;
+    return false;
+  }
+  cv::Mat qrcode;
+  cv::resize(qrcode_file, qrcode, cv::Size(100, 100), 0, 0, cv::INTER_AREA);
+
+  vpImage<unsigned char> I(240, 320);
+  vpQRCodeTracker tracker;
+  tracker.setCameraParameters(vpCameraParameters(300, 300, 160, 120));
+  tracker.setQRCodeSize(0.045);
+  tracker.setMessage("romeo_left_arm");
+
+  // Warm up: detection, initialization of the template tracker, then a few frames in the tracking state
+  unsigned int iter = 0;
+  for (unsigned int nb_tracked=0; nb_tracked < 10 && iter < 100; iter++) {
+    renderQRCode(iter, qrcode, I);
+    nb_tracked = tracker.track(I) ? nb_tracked + 1 : 0;
+  }
+
+  vpAllocationCounter::vpScope scope;
+  unsigned int nb_found = 0;
+  for (unsigned int k=0; k < nb_iter; k++, iter++) {
+    renderQRCode(iter, qrcode, I);
+    if (tracker.track(I))
+      nb_found ++;
+  }
+  bool success = checkAllocations("vpQRCodeTracker::track", scope, nb_iter);
+  return checkTracking("vpQRCodeTracker::track", nb_found, nb_iter) && success;
+}
+
+/*!
+  Target of the left hand of Romeo: a red blob and three black blobs at the corners of a 50 x 40 pixels rectangle,
+  the red one at the top-right corner, moving by one pixel from one frame to the other on a gray background.
+ */
+void renderBlobs(unsigned int frame, cv::Mat &cvI, vpImage<unsigned char> &I)
+{
+  cvI.setTo(cv::Scalar(128, 128, 128));
+  int i = 100 + (int)(frame % 2);
+  int j = 185 + (int)((frame / 2) % 2);
+  cv::circle(cvI, cv::Point(j, i), 10, cv::Scalar(0, 0, 255), CV_FILLED);
+  cv::circle(cvI, cv::Point(j, i + 40), 10, cv::Scalar(0, 0, 0), CV_FILLED);
+  cv::circle(cvI, cv::Point(j - 50, i + 40), 10, cv::Scalar(0, 0, 0), CV_FILLED);
+  cv::circle(cvI, cv::Point(j - 50, i), 10, cv::Scalar(0, 0, 0), CV_FILLED);
+  vpImageConvert::convert(cvI, I);
+}
+
+bool testBlobsTargetTracker(unsigned int nb_iter)
+{
+  std::string username;
+  vpIoTools::getUserName(username);
+  std::string folder = "/tmp/" + username;
+  if (vpIoTools::checkDirectory(folder) == false)
+    vpIoTools::makeDirectory(folder);
+  std::string filename = folder + "/test_allocations_hsv.txt";
+  {
+    std::ofstream file(filename.c_str());
+    file << "red 0 10 150 255 150 255" << std::endl;
+  }
+
+  // Size of the target at 0.5 meter, in the order of the blobs tracked from the red one
+  const double depth = 0.5;
+  const double sx = 50 * depth / 300, sy = 40 * depth / 300;
+  std::vector<vpPoint> points(4);
+  points[0].setWorldCoordinates( sx/2, -sy/2, 0);
+  points[1].setWorldCoordinates( sx/2,  sy/2, 0);
+  points[2].setWorldCoordinates(-sx/2,  sy/2, 0);
+  points[3].setWorldCoordinates(-sx/2, -sy/2, 0);
+
+  vpBlobsTargetTracker tracker;
+  bool loaded = tracker.loadHSV(filename);
+  remove(filename.c_str());
+  if (! loaded)
+    return false;
+  tracker.getOverlay().setMode(vpOverlay::headless);
+  tracker.setCameraParameters(vpCameraParameters(300, 300, 160, 120));
+  tracker.setNumBlobs(4);
+  tracker.setLeftHandTarget(true);
+  tracker.setPoints(points);
+
+  cv::Mat cvI(240, 320, CV_8UC3);
+  vpImage<unsigned char> I(240, 320);
+  unsigned int iter = 0;
+  for (unsigned int nb_tracked=0; nb_tracked < 10 && iter < 100; iter++) {
+    renderBlobs(iter, cvI, I);
+    nb_tracked = tracker.track(cvI, I) ? nb_tracked + 1 : 0;
+  }
+
+  vpAllocationCounter::vpScope scope;
+  unsigned int nb_found = 0;
+  for (unsigned int k=0; k < nb_iter; k++, iter++) {
+    renderBlobs(iter, cvI, I);
+    if (tracker.track(cvI, I))
+      nb_found ++;
+  }
+  bool success = checkAllocations("vpBlobsTargetTracker::track", scope, nb_iter);
+  return checkTracking("vpBlobsTargetTracker::track", nb_found, nb_iter) && success;
+}
+
+int main(int argc, const char* argv[])
+{
+  unsigned int nb_iter = 200;
+  for (int i=1; i < argc; i++) {
+    if (std::string(argv[i]) == "--iter" && i+1 < argc)
+      nb_iter = (unsigned int)atoi(argv[++i]);
+    else if (std::string(argv[i]) == "--help") {
+      std::cout << "Usage: " << argv[0] << " [--iter <number of iterations>] [--help]" << std::endl;
+      return 0;
+    }
+  }
+  if (nb_iter == 0)
+    nb_iter = 1;
+
+  if (! vpAllocationCounter::isInstalled()) {
+    std::cout << "Allocation hooks are not installed" << std::endl;
+    std::cout << "Test failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  bool success = true;
+  success = testDampedLeastSquares(nb_iter) && success;
+  success = testJointLimitAvoidance(nb_iter) && success;
+  success = testColorDetection(nb_iter) && success;
+  success = testQRCodeTracker(nb_iter) && success;
+  success = testBlobsTargetTracker(nb_iter) && success;
+
+  std::cout << (success ? "Test succeed" : "Test failed") << std::endl;
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
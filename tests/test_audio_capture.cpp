@@ -0,0 +1,92 @@
+/**
+ *
+ * This example checks vpAudioCapture without sound card: a producer thread calls the RtAudio callback with
+ * interleaved int16 stereo buffers of 256 frames, while the consumer pulls overlapping frames. Each sample holds
+ * its index in the stream, so that the consumer can check that no sample is lost, duplicated or torn. When the
+ * consumer does not read, the frames that do not fit in the ring buffer should be dropped and counted.
+ *
+ */
+
+#include <stdlib.h>
+#include <iostream>
+#include <vector>
+
+#include <visp/vpException.h>
+#include <visp/vpTime.h>
+#include <visp3/core/vpThread.h>
+
+#include <vpAudioCapture.h>
+
+static const unsigned int s_buffer_frames = 256;
+static const unsigned long s_nb_frames = 200000;
+
+vpThread::Return producerFunction(vpThread::Args args)
+{
+  vpAudioCapture *capture = (vpAudioCapture *)args;
+  std::vector<short> buffer(2 * s_buffer_frames);
+  for (unsigned long k=0; k < s_nb_frames; k += s_buffer_frames) {
+    for (unsigned int i=0; i < s_buffer_frames; i++) {
+      buffer[2*i] = (short)((k + i) & 0x7fff);
+      buffer[2*i+1] = (short)(-(short)((k + i) & 0x7fff));
+    }
+    // The sound card waits between two buffers: do not overflow the ring buffer
+    while (capture->getRingBuffer().getNbFree() < s_buffer_frames)
+      vpTime::wait(1);
+    vpAudioCapture::callbackInt16(NULL, &buffer[0], s_buffer_frames, 0., 0, capture);
+  }
+  return 0;
+}
+
+int main()
+{
+  bool success = true;
+  try {
+    vpAudioCapture capture(2, 48000., 512, 256, 0.05);
+
+    if (capture.acquire(0.)) {
+      std::cout << "A frame was acquired before the stream started" << std::endl;
+      success = false;
+    }
+
+    vpThread producer(producerFunction, (vpThread::Args)&capture);
+    unsigned long nb_errors = 0;
+    unsigned long nb_expected = (s_nb_frames - capture.getFrameLength()) / capture.getHop() + 1;
+    while (capture.getNbFrames() < nb_expected) {
+      if (! capture.acquire(1000.)) {
+        std::cout << "Timeout after " << capture.getNbFrames() << " frames" << std::endl;
+        success = false;
+        break;
+      }
+      unsigned long first = (capture.getNbFrames() - 1) * capture.getHop();
+      for (unsigned int i=0; i < capture.getFrameLength(); i++) {
+        float expected = (float)((first + i) & 0x7fff) / 32768.f;
+        if (capture.getChannel(0)[i] != expected || capture.getChannel(1)[i] != -expected)
+          nb_errors ++;
+      }
+      if (capture.getTime() != first / 48000.)
+        nb_errors ++;
+    }
+    producer.join();
+    std::cout << capture.getNbFrames() << " frames acquired, " << nb_errors << " errors" << std::endl;
+    if (nb_errors != 0 || capture.getRingBuffer().getNbDropped() != 0)
+      success = false;
+
+    // Without consumer the newest frames are dropped
+    vpAudioRingBuffer ring(2, 1000);
+    std::vector<short> buffer(2 * s_buffer_frames, 0);
+    unsigned int nb_written = 0;
+    for (unsigned int i=0; i < 5; i++)
+      nb_written += ring.writeInt16(&buffer[0], s_buffer_frames);
+    std::cout << "Ring buffer of " << ring.getCapacity() << " frames: " << nb_written << " written, "
+              << ring.getNbDropped() << " dropped" << std::endl;
+    if (ring.getCapacity() != 1024 || nb_written != 1024 || ring.getNbDropped() != 5 * s_buffer_frames - 1024)
+      success = false;
+  }
+  catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e.getMessage() << std::endl;
+    success = false;
+  }
+
+  std::cout << (success ? "Test succeed" : "Test failed") << std::endl;
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
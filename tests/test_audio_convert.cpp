@@ -0,0 +1,56 @@
+/**
+ *
+ * This example checks that vpAudioConvert gives the same planar samples than the scalar conversion of the
+ * audio tests, for 1 to 8 channels and for numbers of frames that are not multiples of the SIMD width, from
+ * int16 and float interleaved buffers.
+ *
+ */
+
+#include <stdlib.h>
+#include <iostream>
+#include <vector>
+
+#include <vpAudioConvert.h>
+
+int main()
+{
+  bool success = true;
+  srand(0);
+  const unsigned int max_frames = 37;
+  const size_t stride = 40;
+  for (unsigned int nb_channels=1; nb_channels <= 8; nb_channels++) {
+    for (unsigned int nb_frames=0; nb_frames <= max_frames; nb_frames++) {
+      std::vector<short> interleaved16(nb_channels * nb_frames + 1);
+      std::vector<float> interleaved32(nb_channels * nb_frames + 1);
+      for (size_t i=0; i < interleaved16.size(); i++) {
+        interleaved16[i] = (short)(rand() % 65536 - 32768);
+        interleaved32[i] = (float)interleaved16[i];
+      }
+      // The samples after the last frame should not be touched
+      std::vector<float> planar16(nb_channels * stride, -2.f);
+      std::vector<float> planar32(nb_channels * stride, -2.f);
+      vpAudioConvert::int16ToPlanar(&interleaved16[0], nb_channels, nb_frames, &planar16[0], stride);
+      vpAudioConvert::floatToPlanar(&interleaved32[0], nb_channels, nb_frames, &planar32[0], stride, 0.5f);
+
+      unsigned int nb_errors = 0;
+      for (unsigned int c=0; c < nb_channels; c++)
+        for (unsigned int i=0; i < stride; i++) {
+          float expected16 = -2.f, expected32 = -2.f;
+          if (i < nb_frames) {
+            short value = interleaved16[i * nb_channels + c];
+            expected16 = (float)(value / 32768.0);
+            expected32 = 0.5f * value;
+          }
+          if (planar16[c * stride + i] != expected16 || planar32[c * stride + i] != expected32)
+            nb_errors ++;
+        }
+      if (nb_errors) {
+        std::cout << nb_channels << " channels, " << nb_frames << " frames: " << nb_errors << " errors" << std::endl;
+        success = false;
+      }
+    }
+  }
+
+  std::cout << (success ? "Test succeed" : "Test failed") << std::endl;
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,109 @@
+/**
+ *
+ * This example checks vpAudioFeatures:
+ * - totalEnergy() gives the sum of the short-time energies computed in O(N.wlen) by the audio tests,
+ * - the frames of an interleaved stream pushed by blocks of any size have the energy of the same frames
+ *   computed directly, and a sine has the expected zero-crossing rate,
+ * - push() does not allocate.
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include <visp/vpException.h>
+
+#include <vpAllocationHooks.h>
+#include <vpAudioFeatures.h>
+
+// Short-time energy of every sample like shortTimeEnergy(signal, wlen).sum() in the audio tests
+double naiveTotalEnergy(const std::vector<float> &signal, unsigned int wlen)
+{
+  double total = 0;
+  for (size_t i=0; i < signal.size(); i++)
+    for (unsigned int j=0; j < wlen && i + j < signal.size(); j++) {
+      double w = 0.54 - 0.46 * cos(2. * M_PI * j / (wlen - 1.));
+      total += w * signal[i+j] * w * signal[i+j];
+    }
+  return total;
+}
+
+int main()
+{
+  bool success = true;
+  try {
+    const unsigned int wlen = 512;
+    const unsigned int hop = 256;
+    const unsigned int n = 48000 / 4;
+    const double fs = 48000.;
+    const double f = 440.;
+
+    // Stereo interleaved stream: a sine on the left, noise on the right
+    std::vector<float> stereo(2*n), left(n);
+    srand(0);
+    for (unsigned int i=0; i < n; i++) {
+      left[i] = (float)(0.5 * sin(2 * M_PI * f * i / fs));
+      stereo[2*i] = left[i];
+      stereo[2*i+1] = (float)(0.1 * (2. * rand() / RAND_MAX - 1.));
+    }
+
+    vpAudioFeatures features(wlen, hop);
+    double total = features.totalEnergy(&left[0], n);
+    double naive = naiveTotalEnergy(left, wlen);
+    std::cout << "Total energy: " << total << " naive: " << naive << std::endl;
+    if (fabs(total - naive) > 1e-6 * naive) {
+      std::cout << "totalEnergy() differs from the naive short-time energy" << std::endl;
+      success = false;
+    }
+
+    // Streaming by blocks of 256 frames like the RtAudio callback, then by irregular blocks
+    unsigned int blocks[2] = {256, 97};
+    for (unsigned int b=0; b < 2; b++) {
+      features.reset();
+      vpAllocationCounter::vpScope scope;
+      unsigned int nb_frames = 0;
+      double max_error = 0;
+      for (unsigned int i=0; i < n; i += blocks[b]) {
+        unsigned int k = std::min(blocks[b], n - i);
+        if (features.push(&stereo[2*i], k, 2)) {
+          nb_frames = features.getNbFrames();
+          const float *frame = &left[(nb_frames - 1) * hop];
+          max_error = std::max(max_error, (double)fabs(features.getEnergy() - features.energy(frame)));
+        }
+      }
+      if (scope.getNbAllocations() != 0) {
+        std::cout << "push() allocated " << scope.getNbAllocations() << " times" << std::endl;
+        success = false;
+      }
+      if (features.getNbFrames() != (n - wlen) / hop + 1 || max_error > 1e-4) {
+        std::cout << "Blocks of " << blocks[b] << ": " << features.getNbFrames() << " frames, energy error "
+                  << max_error << std::endl;
+        success = false;
+      }
+    }
+
+    float zcr = features.getZeroCrossingRate();
+    std::cout << "Zero-crossing rate: " << zcr << " expected: " << 2 * f / fs << std::endl;
+    if (fabs(zcr - 2 * f / fs) > 2. / (wlen - 1)) {
+      success = false;
+    }
+    // Energy of a frame of the sine: 0.5^2 / 2 * sum(w^2)
+    double sum_w2 = 0;
+    for (unsigned int j=0; j < wlen; j++)
+      sum_w2 += features.getSquaredWindow()[j];
+    if (fabs(features.getEnergy() - 0.125 * sum_w2) > 0.02 * 0.125 * sum_w2) {
+      std::cout << "Energy of the sine " << features.getEnergy() << " instead of " << 0.125 * sum_w2 << std::endl;
+      success = false;
+    }
+  }
+  catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e.getMessage() << std::endl;
+    success = false;
+  }
+
+  std::cout << (success ? "Test succeed" : "Test failed") << std::endl;
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
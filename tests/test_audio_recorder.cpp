@@ -0,0 +1,181 @@
+/**
+ *
+ * This example checks vpAudioRecorder and vpAudioRecording without sound card:
+ * - a thread calls the RtAudio callback of a vpAudioCapture with a recorder, like the sound card, and the
+ *   raw and WAVE files read back hold exactly the captured samples,
+ * - a 16 bits PCM WAVE file written by hand is loaded with the expected scaling,
+ * - the 32 bits sizes of a WAVE header never wrap: a header beyond 4 GiB is refused,
+ * - save() and open() give back the same recording.
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <visp/vpException.h>
+#include <visp/vpTime.h>
+#include <visp3/core/vpThread.h>
+
+#include <vpAudioCapture.h>
+#include <vpAudioRecorder.h>
+#include <vpAudioRecording.h>
+
+static const unsigned int s_buffer_frames = 256;
+static const unsigned int s_nb_buffers = 300;
+
+short sample(unsigned long k, unsigned int c)
+{
+  return (short)(((k * 7 + c * 1000) % 65536) - 32768);
+}
+
+vpThread::Return producerFunction(vpThread::Args args)
+{
+  vpAudioCapture *capture = (vpAudioCapture *)args;
+  std::vector<short> buffer(2 * s_buffer_frames);
+  for (unsigned long k=0; k < s_nb_buffers * s_buffer_frames; k += s_buffer_frames) {
+    for (unsigned int i=0; i < s_buffer_frames; i++)
+      for (unsigned int c=0; c < 2; c++)
+        buffer[2*i+c] = sample(k + i, c);
+    vpAudioCapture::callbackInt16(NULL, &buffer[0], s_buffer_frames, 0., 0, capture);
+    vpTime::wait(0.5); // 256 frames at 48 kHz last 5 ms
+  }
+  return 0;
+}
+
+bool checkRecording(const std::string &filename, unsigned long nb_frames)
+{
+  vpAudioRecording recording;
+  recording.open(filename);
+  unsigned long nb_errors = 0;
+  for (unsigned int c=0; c < 2; c++)
+    for (unsigned long k=0; k < recording.getNbFrames(); k++)
+      if (recording.getChannel(c)[k] != sample(k, c) / 32768.f)
+        nb_errors ++;
+  std::cout << filename << ": " << recording.getNbFrames() << " frames at " << recording.getSampleRate() << " Hz, "
+            << nb_errors << " errors" << std::endl;
+  return recording.getNbChannels() == 2 && recording.getNbFrames() == nb_frames
+      && recording.getSampleRate() == 48000. && nb_errors == 0;
+}
+
+int main()
+{
+  bool success = true;
+  try {
+    const std::string raw_file = "test_audio_recorder.raw";
+    const std::string wav_file = "test_audio_recorder.wav";
+    const unsigned long nb_frames = s_nb_buffers * s_buffer_frames;
+
+    for (unsigned int f=0; f < 2; f++) {
+      vpAudioCapture capture(2, 48000.);
+      vpAudioRecorder recorder;
+      recorder.open(f == 0 ? raw_file : wav_file, 2, 48000., f == 0 ? vpAudioRecorder::raw : vpAudioRecorder::wav,
+                    1., 1000);
+      capture.setRecorder(&recorder);
+      {
+        vpThread producer(producerFunction, (vpThread::Args)&capture);
+        // The processing thread consumes the capture as usual
+        unsigned long nb_hops = (nb_frames - capture.getFrameLength()) / capture.getHop() + 1;
+        while (capture.getNbFrames() < nb_hops && capture.acquire(1000.)) {}
+      }
+      recorder.close();
+      if (recorder.getNbDropped() != 0 || recorder.getNbFrames() != nb_frames) {
+        std::cout << "Recorder wrote " << recorder.getNbFrames() << " frames, dropped " << recorder.getNbDropped()
+                  << std::endl;
+        success = false;
+      }
+      success = checkRecording(recorder.getFilename(), nb_frames) && success;
+    }
+
+    // 16 bits PCM WAVE file, mono
+    {
+      const char *pcm_file = "test_audio_recorder_pcm.wav";
+      short pcm[4] = {0, 16384, -32768, 32767};
+      unsigned char header[vpAudioRecorder::wavHeaderSize];
+      vpAudioRecorder::getWavHeader(1, 16000., 2, header); // 2 float frames = 8 bytes = 4 int16 frames
+      uint16_t format = 1, block_align = 2, bits = 16;
+      uint32_t byte_rate = 32000;
+      memcpy(header + 20, &format, 2);
+      memcpy(header + 28, &byte_rate, 4);
+      memcpy(header + 32, &block_align, 2);
+      memcpy(header + 34, &bits, 2);
+      std::ofstream file(pcm_file, std::ios::out | std::ios::binary);
+      file.write((const char *)header, sizeof(header));
+      file.write((const char *)pcm, sizeof(pcm));
+      file.close();
+
+      vpAudioRecording recording;
+      recording.open(pcm_file);
+      const float *s = recording.getChannel(0);
+      if (recording.getNbFrames() != 4 || recording.getSampleRate() != 16000. || s[1] != 0.5f || s[2] != -1.f) {
+        std::cout << "Wrong 16 bits PCM WAVE file" << std::endl;
+        success = false;
+      }
+      remove(pcm_file);
+    }
+
+    // Largest WAVE file: the RIFF size is the last 32 bits value, one more frame is refused
+    {
+      unsigned char header[vpAudioRecorder::wavHeaderSize];
+      uint64_t nb_max = vpAudioRecorder::getWavMaxFrames(2);
+      vpAudioRecorder::getWavHeader(2, 48000., nb_max, header);
+      uint32_t riff_size, data_size;
+      memcpy(&riff_size, header + 4, 4);
+      memcpy(&data_size, header + 40, 4);
+      if ((uint64_t)data_size != nb_max * 2 * sizeof(float) || (uint64_t)riff_size != 36 + (uint64_t)data_size
+          || (uint64_t)riff_size + 2 * sizeof(float) <= 0xffffffffu) {
+        std::cout << "Wrong sizes of the largest WAVE header" << std::endl;
+        success = false;
+      }
+      bool refused = false;
+      try {
+        vpAudioRecorder::getWavHeader(2, 48000., nb_max + 1, header);
+      }
+      catch (const vpException &) {
+        refused = true;
+      }
+      if (! refused) {
+        std::cout << "A WAVE header beyond 4 GiB should be refused" << std::endl;
+        success = false;
+      }
+    }
+
+    // save() and open() round trip with a partial last block
+    {
+      vpAudioRecording recording;
+      recording.init(3, 1001, 44100.);
+      for (unsigned int c=0; c < 3; c++)
+        for (unsigned long k=0; k < 1001; k++)
+          recording.getChannel(c)[k] = 0.001f * k - (float)c;
+      for (unsigned int f=0; f < 2; f++) {
+        const char *filename = (f == 0) ? "test_audio_recorder_save.raw" : "test_audio_recorder_save.wav";
+        recording.save(filename, f == 0 ? vpAudioRecorder::raw : vpAudioRecorder::wav, 256);
+        vpAudioRecording loaded;
+        loaded.open(filename);
+        bool same = loaded.getNbChannels() == 3 && loaded.getNbFrames() == 1001 && loaded.getSampleRate() == 44100.;
+        for (unsigned int c=0; c < 3 && same; c++)
+          same = (memcmp(loaded.getChannel(c), recording.getChannel(c), 1001 * sizeof(float)) == 0);
+        if (! same) {
+          std::cout << "Wrong round trip through " << filename << std::endl;
+          success = false;
+        }
+        remove(filename);
+      }
+    }
+
+    remove(raw_file.c_str());
+    remove(wav_file.c_str());
+  }
+  catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e.getMessage() << std::endl;
+    success = false;
+  }
+
+  std::cout << (success ? "Test succeed" : "Test failed") << std::endl;
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,161 @@
+/**
+ *
+ * This example checks vpConfigCache without robot: transformations and camera parameters saved in XML files
+ * are parsed once, then read from the binary cache by the next instances, until the XML file changes, even
+ * within the same second.
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <iostream>
+#include <string>
+
+#include <visp/vpCameraParameters.h>
+#include <visp/vpHomogeneousMatrix.h>
+#include <visp/vpIoTools.h>
+#include <visp/vpXmlParserCamera.h>
+#include <visp/vpXmlParserHomogeneousMatrix.h>
+
+#include <vpConfigCache.h>
+
+bool check(bool condition, const std::string &message)
+{
+  if (! condition)
+    std::cout << "Error: " << message << std::endl;
+  return condition;
+}
+
+bool isEqual(const vpHomogeneousMatrix &A, const vpHomogeneousMatrix &B)
+{
+  for (unsigned int i=0; i < 4; i++)
+    for (unsigned int j=0; j < 4; j++)
+      if (fabs(A[i][j] - B[i][j]) > 1e-6) // The XML file has a limited precision
+        return false;
+  return true;
+}
+
+bool isEqual(const vpCameraParameters &a, const vpCameraParameters &b)
+{
+  return fabs(a.get_px() - b.get_px()) < 1e-6 && fabs(a.get_py() - b.get_py()) < 1e-6
+      && fabs(a.get_u0() - b.get_u0()) < 1e-6 && fabs(a.get_v0() - b.get_v0()) < 1e-6
+      && fabs(a.get_kud() - b.get_kud()) < 1e-6 && fabs(a.get_kdu() - b.get_kdu()) < 1e-6;
+}
+
+bool testCameraParameters(const std::string &xml_filename, const std::string &cache_filename)
+{
+  remove(xml_filename.c_str());
+  remove(cache_filename.c_str());
+
+  vpCameraParameters cam_ref;
+  cam_ref.initPersProjWithDistortion(310.5, 312.25, 161.5, 119.75, -0.05, 0.052);
+  vpXmlParserCamera parser;
+  parser.save(cam_ref, xml_filename.c_str(), "Camera", 320, 240);
+
+  bool success = true;
+  vpCameraParameters cam;
+  typedef vpCameraParameters::vpCameraParametersProjType projection_t;
+  const projection_t with_distortion = vpCameraParameters::perspectiveProjWithDistortion;
+  const projection_t without_distortion = vpCameraParameters::perspectiveProjWithoutDistortion;
+  {
+    vpConfigCache config;
+    config.load(cache_filename);
+    success = check(config.getCameraParameters(xml_filename, "Camera", 320, 240, with_distortion, cam),
+                    "cannot get the camera parameters") && success;
+    success = check(isEqual(cam, cam_ref), "wrong parsed camera parameters") && success;
+    success = check(config.getCameraParameters(xml_filename, "Camera", 320, 240, without_distortion, cam),
+                    "cannot get the camera parameters without distortion") && success;
+    success = check(! config.getCameraParameters(xml_filename, "Camera", 640, 480, with_distortion, cam),
+                    "the camera parameters should not exist for this image size") && success;
+    success = check(config.getNbParsed() == 2, "each projection should be parsed once") && success;
+    success = check(config.save(), "cannot save the cache") && success;
+  }
+  {
+    vpConfigCache config;
+    config.load(cache_filename);
+    success = check(config.getCameraParameters(xml_filename, "Camera", 320, 240, with_distortion, cam)
+                    && isEqual(cam, cam_ref), "wrong cached camera parameters") && success;
+    success = check(config.getCameraParameters(xml_filename, "Camera", 320, 240, without_distortion, cam)
+                    && cam.get_px() == cam_ref.get_px() && cam.get_kud() == 0.,
+                    "wrong cached camera parameters without distortion") && success;
+    success = check(config.getNbLoaded() == 2 && config.getNbParsed() == 0,
+                    "the camera parameters should not be parsed") && success;
+  }
+
+  remove(xml_filename.c_str());
+  remove(cache_filename.c_str());
+  return success;
+}
+
+int main()
+{
+  std::string username;
+  vpIoTools::getUserName(username);
+  std::string folder = "/tmp/" + username;
+  if (vpIoTools::checkDirectory(folder) == false)
+    vpIoTools::makeDirectory(folder);
+  std::string xml_filename = folder + "/test_config_cache.xml";
+  std::string cache_filename = folder + "/test_config_cache.bin";
+  remove(xml_filename.c_str());
+  remove(cache_filename.c_str());
+
+  vpHomogeneousMatrix M1(0.1, -0.2, 0.3, 0.1, 0.2, -0.3);
+  vpHomogeneousMatrix M2(0.4, 0.5, -0.6, -0.1, 0.0, 0.2);
+  vpHomogeneousMatrix M2_modified(0.7, 0.5, -0.6, -0.1, 0.0, 0.2);
+  vpXmlParserHomogeneousMatrix parser;
+  parser.save(M1, xml_filename, "M1");
+
+  bool success = true;
+  vpHomogeneousMatrix M;
+  {
+    // First run: no cache, the value is parsed from XML
+    vpConfigCache config;
+    success = check(! config.load(cache_filename), "the cache should not exist") && success;
+    success = check(config.getTransform(xml_filename, "M1", M), "cannot get M1") && success;
+    success = check(config.getTransform(xml_filename, "M1", M), "cannot get M1 again") && success;
+    success = check(config.getNbParsed() == 1, "M1 should be parsed once") && success;
+    success = check(! config.getTransform(xml_filename, "unknown", M), "unknown should not exist") && success;
+    success = check(config.save(), "cannot save the cache") && success;
+  }
+  {
+    // Second run: the value comes from the cache
+    vpConfigCache config;
+    success = check(config.load(cache_filename), "cannot load the cache") && success;
+    success = check(config.getTransform(xml_filename, "M1", M), "cannot get M1 from the cache") && success;
+    success = check(config.getNbLoaded() == 1 && config.getNbParsed() == 0, "M1 should not be parsed") && success;
+    success = check(isEqual(M, M1), "M1 differs from the saved matrix") && success;
+
+    // Values saved through the cache are available without parsing
+    success = check(config.saveTransform(xml_filename, "M2", M2), "cannot save M2") && success;
+    success = check(config.getTransform(xml_filename, "M2", M) && isEqual(M, M2), "cannot get M2") && success;
+    success = check(config.getNbParsed() == 0, "M2 should not be parsed") && success;
+    success = check(config.save(), "cannot save the cache") && success;
+  }
+  {
+    vpConfigCache config;
+    config.load(cache_filename);
+    success = check(config.getNbLoaded() == 2, "M1 and M2 should be cached") && success;
+  }
+
+  // Rewrite the XML file right away, with the same size: the cached values are discarded even if the
+  // modification time did not change
+  remove(xml_filename.c_str());
+  parser.save(M1, xml_filename, "M1");
+  parser.save(M2_modified, xml_filename, "M2");
+  {
+    vpConfigCache config;
+    config.load(cache_filename);
+    success = check(config.getNbLoaded() == 0, "the cache should be invalidated") && success;
+    success = check(config.getTransform(xml_filename, "M2", M) && isEqual(M, M2_modified),
+                    "cannot parse the modified M2") && success;
+    success = check(config.getNbParsed() == 1, "M2 should be parsed") && success;
+  }
+  remove(xml_filename.c_str());
+  remove(cache_filename.c_str());
+
+  success = testCameraParameters(folder + "/test_config_cache_camera.xml", cache_filename) && success;
+
+  std::cout << (success ? "Test succeed" : "Test failed") << std::endl;
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,109 @@
+/**
+ *
+ * This example checks vpHandEyeSolver on poses generated from a known eMc:
+ * - without noise, the closed form and the refined solutions are exact,
+ * - with noisy grid poses and a wrong pair, the wrong pair is rejected and eMc is found within the noise.
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <iostream>
+#include <vector>
+
+#include <visp/vpException.h>
+#include <visp/vpHomogeneousMatrix.h>
+#include <visp/vpMath.h>
+#include <visp/vpThetaUVector.h>
+#include <visp/vpTranslationVector.h>
+
+#include <vpHandEyeSolver.h>
+
+// Reproducible uniform values in [-1, 1]
+double uniform()
+{
+  static unsigned int state = 12345;
+  state = state * 1103515245u + 12345u;
+  return ((state >> 8) & 0xFFFF) / 32767.5 - 1.;
+}
+
+void getError(const vpHomogeneousMatrix &M, const vpHomogeneousMatrix &M_ref, double &error_t, double &error_r)
+{
+  vpHomogeneousMatrix E = M_ref.inverse() * M;
+  vpTranslationVector t;
+  vpThetaUVector tu;
+  E.extract(t);
+  E.extract(tu);
+  error_t = sqrt(t[0]*t[0] + t[1]*t[1] + t[2]*t[2]);
+  error_r = sqrt(tu[0]*tu[0] + tu[1]*tu[1] + tu[2]*tu[2]);
+}
+
+bool check(const std::string &name, const vpHomogeneousMatrix &eMc, const vpHomogeneousMatrix &eMc_ref,
+           double max_t, double max_r)
+{
+  double error_t, error_r;
+  getError(eMc, eMc_ref, error_t, error_r);
+  std::cout << name << ": eMc error " << error_t * 1000 << " mm, " << vpMath::deg(error_r) << " deg" << std::endl;
+  return error_t <= max_t && error_r <= max_r;
+}
+
+int main()
+{
+  bool success = true;
+  try {
+    // Camera in the head, grid 1 m in front of the robot
+    vpHomogeneousMatrix eMc_ref(0.05, 0.02, 0.08, vpMath::rad(-90), 0, vpMath::rad(-90));
+    vpHomogeneousMatrix tMo_ref(1.0, 0.1, 0.3, 0.2, -0.1, 0.3);
+    const unsigned int nb_pairs = 12;
+    std::vector<vpHomogeneousMatrix> tMe, cMo;
+    for (unsigned int i=0; i < nb_pairs; i++) {
+      vpHomogeneousMatrix M(0.1 * uniform(), 0.1 * uniform(), 0.5 + 0.05 * uniform(),
+                            vpMath::rad(20) * uniform(), vpMath::rad(20) * uniform(), vpMath::rad(30) * uniform());
+      tMe.push_back(M);
+      cMo.push_back((M * eMc_ref).inverse() * tMo_ref);
+    }
+
+    vpHandEyeSolver solver;
+    for (unsigned int i=0; i < nb_pairs; i++)
+      solver.addPair(tMe[i], cMo[i]);
+    solver.solve();
+    success = check("Tsai without noise", solver.get_eMc_tsai(), eMc_ref, 1e-6, 1e-6) && success;
+    success = check("Refined without noise", solver.get_eMc(), eMc_ref, 1e-6, 1e-6) && success;
+    if (solver.getNbUsed() != nb_pairs) {
+      std::cout << "No pair should be rejected without noise" << std::endl;
+      success = false;
+    }
+
+    // 1 mm and 0.1 deg of noise on the grid poses, pair 3 with a 5 cm error
+    solver.clear();
+    for (unsigned int i=0; i < nb_pairs; i++) {
+      vpHomogeneousMatrix noise(0.001 * uniform(), 0.001 * uniform(), 0.001 * uniform(),
+                                vpMath::rad(0.1) * uniform(), vpMath::rad(0.1) * uniform(),
+                                vpMath::rad(0.1) * uniform());
+      if (i == 3)
+        noise = vpHomogeneousMatrix(0.05, 0, 0, 0, 0, 0);
+      solver.addPair(tMe[i], noise * cMo[i]);
+    }
+    solver.solve();
+    for (unsigned int i=0; i < solver.getNbPairs(); i++)
+      std::cout << "  pair " << i << ": " << solver.getTranslationError(i) * 1000 << " mm, "
+                << vpMath::deg(solver.getRotationError(i)) << " deg" << (solver.isUsed(i) ? "" : ", rejected")
+                << std::endl;
+    success = check("Refined with noise", solver.get_eMc(), eMc_ref, 0.003, vpMath::rad(0.3)) && success;
+    if (solver.isUsed(3) || solver.getNbUsed() < nb_pairs - 2) {
+      std::cout << "Only the wrong pair should be rejected" << std::endl;
+      success = false;
+    }
+  }
+  catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e.getMessage() << std::endl;
+    success = false;
+  }
+
+  if (success) {
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  std::cout << "Test failed" << std::endl;
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,390 @@
+/**
+ *
+ * This example checks without robot the lock-free exchanges of the latest value between threads or processes:
+ * vpTripleBuffer, vpBroadcastBuffer, vpPerceptionResults and vpFrameBus. For each of them, a producer thread
+ * publishes values as fast as possible while consumer threads read them. Each value is filled with its frame
+ * number, so that the consumers can check that they never get a value being written, and that the values they
+ * get are always newer.
+ *
+ * Usage: ./test_seqlock_buffers [--buffer <triple|broadcast|results|bus>]
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+#include <visp/vpException.h>
+#include <visp/vpImage.h>
+#include <visp3/core/vpThread.h>
+
+#include <vpBroadcastBuffer.h>
+#include <vpFrameBus.h>
+#include <vpPerceptionResults.h>
+#include <vpTripleBuffer.h>
+
+/*!
+  Buffer under test: the producer writes the frames 1 to getNbFrames(), each consumer reads the latest one.
+  The consumer functions are called from the thread of the consumer.
+ */
+class vpLatestValueBuffer
+{
+public:
+  virtual ~vpLatestValueBuffer() {}
+
+  virtual std::string getName() const = 0;
+  virtual unsigned long getNbFrames() const = 0;
+  virtual unsigned int getNbConsumers() const {return 1;}
+  //! Busy loop iterations of the producer between two frames, as the tracking or the camera would do.
+  virtual unsigned int getProducerPause() const {return 0;}
+
+  //! Create the buffer. \return the number of errors of the checks done before the threads start.
+  virtual unsigned int create() {return 0;}
+  virtual void close() {}
+  virtual void write(unsigned long frame) = 0;
+
+  virtual void openConsumer(unsigned int consumer) {(void)consumer;}
+  /*!
+    Get the latest value of \e consumer.
+    \return false if there is no new value, or if it was overwritten while it was read.
+   */
+  virtual bool read(unsigned int consumer, unsigned long &frame, bool &torn) = 0;
+  //! Print the statistics of \e consumer. \return the number of errors of the final checks.
+  virtual unsigned int closeConsumer(unsigned int consumer) {(void)consumer; return 0;}
+};
+
+bool isFilled(const vpImage<unsigned int> &frame, unsigned long value)
+{
+  for (unsigned int i=0; i < frame.getSize(); i++)
+    if (frame.bitmap[i] != value)
+      return false;
+  return true;
+}
+
+class vpTripleBufferTest : public vpLatestValueBuffer
+{
+protected:
+  vpTripleBuffer< vpImage<unsigned int> > m_frames;
+
+public:
+  std::string getName() const {return "vpTripleBuffer";}
+  unsigned long getNbFrames() const {return 100000;}
+
+  unsigned int create()
+  {
+    m_frames.init(vpImage<unsigned int>(120, 160, 0));
+    return 0;
+  }
+  void write(unsigned long frame)
+  {
+    vpImage<unsigned int> &I = m_frames.getWriteBuffer();
+    for (unsigned int i=0; i < I.getSize(); i++)
+      I.bitmap[i] = (unsigned int)frame;
+    m_frames.publish();
+  }
+  bool read(unsigned int, unsigned long &frame, bool &torn)
+  {
+    if (! m_frames.update())
+      return false;
+    frame = m_frames.getReadSequence();
+    torn = ! isFilled(m_frames.getReadBuffer(), frame);
+    return true;
+  }
+};
+
+class vpBroadcastBufferTest : public vpLatestValueBuffer
+{
+protected:
+  vpBroadcastBuffer< vpImage<unsigned int> > m_frames;
+
+public:
+  vpBroadcastBufferTest() : m_frames(3) {}
+
+  std::string getName() const {return "vpBroadcastBuffer";}
+  unsigned long getNbFrames() const {return 100000;}
+  unsigned int getNbConsumers() const {return m_frames.getNbConsumers();}
+
+  unsigned int create()
+  {
+    m_frames.init(vpImage<unsigned int>(120, 160, 0));
+    return 0;
+  }
+  void write(unsigned long frame)
+  {
+    vpImage<unsigned int> &I = m_frames.getWriteBuffer();
+    for (unsigned int i=0; i < I.getSize(); i++)
+      I.bitmap[i] = (unsigned int)frame;
+    m_frames.publish();
+  }
+  bool read(unsigned int consumer, unsigned long &frame, bool &torn)
+  {
+    if (! m_frames.update(consumer))
+      return false;
+    frame = m_frames.getReadSequence(consumer);
+    torn = ! isFilled(m_frames.getReadBuffer(consumer), frame);
+    return true;
+  }
+};
+
+class vpPerceptionResultsTest : public vpLatestValueBuffer
+{
+protected:
+  vpPerceptionResults m_publisher;
+  vpPerceptionResults m_reader;
+  unsigned long m_sequence;
+
+public:
+  vpPerceptionResultsTest() : m_publisher(), m_reader(), m_sequence(0) {}
+
+  std::string getName() const {return "vpPerceptionResults";}
+  unsigned long getNbFrames() const {return 200000;}
+  unsigned int getProducerPause() const {return 500;}
+
+  unsigned int create()
+  {
+    m_publisher.create("/romeo_tk_test_perception");
+    return 0;
+  }
+  void close() {m_publisher.close();}
+  void write(unsigned long frame)
+  {
+    vpPerceptionResults::vpResult result;
+    result.frame = frame;
+    result.timestamp = (double)frame;
+    result.found = 1;
+    for (unsigned int i=0; i < 12; i++)
+      result.cMo[i] = (double)frame;
+    for (unsigned int i=0; i < 4; i++)
+      result.bbox[i] = (double)frame;
+    result.cog[0] = result.cog[1] = (double)frame;
+    m_publisher.publish(vpPerceptionResults::qrcode, result);
+  }
+
+  void openConsumer(unsigned int) {m_reader.open("/romeo_tk_test_perception");}
+  bool read(unsigned int, unsigned long &frame, bool &torn)
+  {
+    vpPerceptionResults::vpResult result;
+    unsigned long sequence;
+    if (! m_reader.read(vpPerceptionResults::qrcode, result, sequence) || sequence == m_sequence)
+      return false;
+    m_sequence = sequence;
+    frame = (unsigned long)result.frame;
+    double value = (double)result.frame;
+    torn = (result.timestamp != value || result.cog[0] != value || result.cog[1] != value);
+    for (unsigned int i=0; i < 12; i++)
+      torn = torn || (result.cMo[i] != value);
+    for (unsigned int i=0; i < 4; i++)
+      torn = torn || (result.bbox[i] != value);
+    return true;
+  }
+  unsigned int closeConsumer(unsigned int)
+  {
+    std::cout << getName() << ": " << m_reader.getNbRetries() << " retries" << std::endl;
+    // Targets that were never published are reported as such
+    vpPerceptionResults::vpResult result;
+    unsigned long sequence;
+    unsigned int nb_errors = m_reader.read(vpPerceptionResults::face, result, sequence) ? 1 : 0;
+    m_reader.close();
+    return nb_errors;
+  }
+};
+
+class vpFrameBusTest : public vpLatestValueBuffer
+{
+protected:
+  vpFrameBus m_producer;
+  vpFrameBus m_consumer;
+  vpImage<unsigned char> m_I;
+
+public:
+  vpFrameBusTest() : m_producer(), m_consumer(), m_I() {}
+
+  std::string getName() const {return "vpFrameBus";}
+  unsigned long getNbFrames() const {return 20000;}
+  unsigned int getProducerPause() const {return 20000;}
+
+  unsigned int create()
+  {
+    m_producer.create("/romeo_tk_test_frame_bus", 160, 120, 1, 3);
+
+    // A consumer can only read views of the frame format published by the producer
+    unsigned int nb_errors = 0;
+    vpFrameBus reader;
+    reader.open("/romeo_tk_test_frame_bus");
+    if (reader.getWidth() != 160 || reader.getHeight() != 120 || reader.getChannels() != 1 || reader.getNbSlots() != 3)
+      nb_errors ++;
+    if (reader.beginRead()) // Nothing published yet
+      nb_errors ++;
+    reader.close();
+
+    // A frame of another size is rejected instead of being written outside of the shared memory
+    try {
+      m_producer.write(cv::Mat(240, 320, CV_8UC1), 0.);
+      nb_errors ++;
+    }
+    catch (const vpException &) {
+    }
+    return nb_errors;
+  }
+  void close() {m_producer.close();}
+  void write(unsigned long frame)
+  {
+    cv::Mat view = m_producer.beginWrite();
+    memset(view.data, (int)(frame & 0xff), view.step * view.rows);
+    m_producer.endWrite((double)frame);
+  }
+
+  void openConsumer(unsigned int) {m_consumer.open("/romeo_tk_test_frame_bus");}
+  bool read(unsigned int, unsigned long &frame, bool &torn)
+  {
+    if (! m_consumer.beginRead(100.))
+      return false;
+    frame = m_consumer.getFrameNumber();
+    m_consumer.getImage(m_I);
+    unsigned char value = (unsigned char)(frame & 0xff);
+    torn = (m_consumer.getTimestamp() != (double)frame);
+    for (unsigned int i=0; i < m_I.getSize(); i++)
+      torn = torn || (m_I.bitmap[i] != value);
+    // Overwritten while read: the consumer is told, the content does not matter
+    return m_consumer.endRead();
+  }
+  unsigned int closeConsumer(unsigned int)
+  {
+    std::cout << getName() << ": " << m_consumer.getNbSkipped() << " skipped, " << m_consumer.getNbOverwritten()
+              << " overwritten" << std::endl;
+    m_consumer.close();
+    return 0;
+  }
+};
+
+struct vpConsumerArgs
+{
+  vpLatestValueBuffer *buffer;
+  unsigned int consumer;
+  unsigned int nb_errors;
+};
+
+vpThread::Return producerFunction(vpThread::Args args)
+{
+  vpLatestValueBuffer *buffer = (vpLatestValueBuffer *)args;
+  unsigned int pause = buffer->getProducerPause();
+  for (unsigned long frame=1; frame <= buffer->getNbFrames(); frame++) {
+    buffer->write(frame);
+    for (volatile unsigned int i=0; i < pause; i++) {}
+  }
+  return 0;
+}
+
+vpThread::Return consumerFunction(vpThread::Args args)
+{
+  vpConsumerArgs *consumer_args = (vpConsumerArgs *)args;
+  vpLatestValueBuffer *buffer = consumer_args->buffer;
+  unsigned int consumer = consumer_args->consumer;
+  try {
+    buffer->openConsumer(consumer);
+  }
+  catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e.getMessage() << std::endl;
+    consumer_args->nb_errors ++;
+    return 0;
+  }
+
+  unsigned long frame_prev = 0;
+  unsigned long nb_read = 0;
+  while (frame_prev < buffer->getNbFrames()) {
+    unsigned long frame;
+    bool torn;
+    if (! buffer->read(consumer, frame, torn))
+      continue;
+    if (torn || frame <= frame_prev)
+      consumer_args->nb_errors ++;
+    frame_prev = frame;
+    nb_read ++;
+  }
+  std::cout << buffer->getName() << ": consumer " << consumer << " read " << nb_read << " of "
+            << buffer->getNbFrames() << " frames" << std::endl;
+  consumer_args->nb_errors += buffer->closeConsumer(consumer);
+  return 0;
+}
+
+/*!
+  Run the producer and the consumers of \e buffer. \return the number of torn or stale values.
+ */
+unsigned int run(vpLatestValueBuffer &buffer)
+{
+  unsigned int nb_errors = 0;
+  try {
+    nb_errors += buffer.create();
+    std::vector<vpConsumerArgs> args(buffer.getNbConsumers());
+    {
+      std::vector<vpThread *> consumers;
+      for (unsigned int c=0; c < args.size(); c++) {
+        args[c].buffer = &buffer;
+        args[c].consumer = c;
+        args[c].nb_errors = 0;
+        consumers.push_back(new vpThread(consumerFunction, (vpThread::Args)&args[c]));
+      }
+      vpThread producer(producerFunction, (vpThread::Args)&buffer);
+      producer.join();
+      for (unsigned int c=0; c < consumers.size(); c++)
+        delete consumers[c]; // Joins the thread
+    }
+    for (unsigned int c=0; c < args.size(); c++)
+      nb_errors += args[c].nb_errors;
+    buffer.close();
+  }
+  catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e.getMessage() << std::endl;
+    nb_errors ++;
+  }
+  if (nb_errors)
+    std::cout << buffer.getName() << ": " << nb_errors << " torn or stale values" << std::endl;
+  return nb_errors;
+}
+
+int main(int argc, const char* argv[])
+{
+  std::string opt_buffer;
+  for (int i=1; i < argc; i++) {
+    if (std::string(argv[i]) == "--buffer" && i+1 < argc)
+      opt_buffer = argv[++i];
+    else if (std::string(argv[i]) == "--help") {
+      std::cout << "Usage: " << argv[0] << " [--buffer <triple|broadcast|results|bus>] [--help]" << std::endl;
+      return 0;
+    }
+  }
+
+  vpTripleBufferTest triple;
+  vpBroadcastBufferTest broadcast;
+  vpPerceptionResultsTest results;
+  vpFrameBusTest bus;
+  std::vector<std::pair<std::string, vpLatestValueBuffer *> > buffers;
+  buffers.push_back(std::make_pair(std::string("triple"), (vpLatestValueBuffer *)&triple));
+  buffers.push_back(std::make_pair(std::string("broadcast"), (vpLatestValueBuffer *)&broadcast));
+  buffers.push_back(std::make_pair(std::string("results"), (vpLatestValueBuffer *)&results));
+  buffers.push_back(std::make_pair(std::string("bus"), (vpLatestValueBuffer *)&bus));
+
+  unsigned int nb_errors = 0;
+  unsigned int nb_run = 0;
+  for (unsigned int i=0; i < buffers.size(); i++) {
+    if (opt_buffer.empty() || opt_buffer == buffers[i].first) {
+      nb_errors += run(*buffers[i].second);
+      nb_run ++;
+    }
+  }
+  if (nb_run == 0) {
+    std::cout << "Unknown buffer " << opt_buffer << std::endl;
+    nb_errors ++;
+  }
+
+  if (nb_errors) {
+    std::cout << "Test failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test succeed" << std::endl;
+  return EXIT_SUCCESS;
+}
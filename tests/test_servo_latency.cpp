@@ -0,0 +1,154 @@
+/**
+ *
+ * This example checks the latency compensation of vpServoArm on a simulated arm without robot.
+ *
+ * The pose of the hand is measured in images captured every 70 ms (about 14 fps) and is available
+ * to the control law only 150 ms after the capture, while the control law runs at 100 Hz. With a
+ * high gain the servo oscillates when the measures are used as if they were current, and converges
+ * when they are advanced with the joint history.
+ *
+ */
+
+#include <stdlib.h>
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <limits>
+
+#include <visp/vpExponentialMap.h>
+#include <visp/vpHomogeneousMatrix.h>
+#include <visp/vpThetaUVector.h>
+#include <visp/vpTranslationVector.h>
+#include <visp/vpVelocityTwistMatrix.h>
+
+#include <vpJointHistory.h>
+#include <vpServoArm.h>
+
+struct vpMeasure {
+  double timestamp;
+  vpHomogeneousMatrix cdMc;
+};
+
+double poseError(const vpHomogeneousMatrix &cdMc)
+{
+  vpTranslationVector t;
+  vpThetaUVector tu;
+  cdMc.extract(t);
+  cdMc.extract(tu);
+  return sqrt(t.sumSquare() + tu[0]*tu[0] + tu[1]*tu[1] + tu[2]*tu[2]);
+}
+
+/*!
+  Pose of the hand at the beginning of the servo.
+ */
+vpHomogeneousMatrix initialPose()
+{
+  vpColVector v(6);
+  v[0] = 0.1; v[1] = -0.05; v[2] = 0.08; v[3] = 0.2; v[4] = -0.1; v[5] = 0.3;
+  return vpExponentialMap::direct(v, 1.);
+}
+
+/*!
+  Simulate the servo of the arm and return the maximal error after 4 seconds.
+  \param nb_sign_changes : Number of sign changes of the x translation error after 1 second, that tells
+  whether the servo oscillates around the target.
+ */
+double simulate(bool compensation, double lambda, double latency, unsigned int &nb_sign_changes)
+{
+  const unsigned int nb_joints = 6;
+  const double dt = 0.01;            // Control period
+  const unsigned int frame_period = 7; // Images captured every 70 ms
+  const unsigned int nb_iter = 600;
+
+  vpMatrix eJe(6, nb_joints);
+  for (unsigned int i=0; i < 6; i++)
+    for (unsigned int j=0; j < nb_joints; j++)
+      eJe[i][j] = (i == j ? 1. : 0.) + 0.2*cos(1.3*i + 0.7*j);
+  vpVelocityTwistMatrix cVe; // Identity
+
+  vpServoArm servo;
+  servo.setRealTime(true, nb_joints);
+  servo.setLambda(lambda);
+  vpJointHistory history(nb_joints, 128);
+  if (compensation)
+    servo.setLatencyCompensation(&history);
+
+  vpHomogeneousMatrix cdMc = initialPose(); // Simulated pose
+  vpColVector q(nb_joints), q_dot(nb_joints);
+
+  std::deque<vpMeasure> pending;     // Images being processed
+  vpMeasure measure;
+  bool measure_available = false;
+  double max_error = 0;
+  double error_x_prev = 0;
+  nb_sign_changes = 0;
+
+  for (unsigned int iter=0; iter < nb_iter; iter++) {
+    double t = iter * dt;
+
+    // Capture an image
+    if (iter % frame_period == 0) {
+      vpMeasure m;
+      m.timestamp = t;
+      m.cdMc = cdMc;
+      pending.push_back(m);
+    }
+    // The pose is available once the image is processed
+    while (! pending.empty() && pending.front().timestamp + latency <= t + 1e-9) {
+      measure = pending.front();
+      pending.pop_front();
+      measure_available = true;
+    }
+
+    history.add(t, q);
+    q_dot = 0;
+    if (measure_available) {
+      servo.set_eJe(eJe);
+      servo.set_cVe(cVe);
+      servo.setCurrentFeature(measure.cdMc, measure.timestamp);
+      servo.computeControlLaw(q_dot);
+      q_dot = -q_dot;
+    }
+
+    // Simulated arm
+    cdMc = cdMc * vpExponentialMap::direct(cVe * (eJe * q_dot), dt);
+    q += q_dot * dt;
+
+    double error_x = cdMc[0][3];
+    if (t > 1. && error_x != 0.) {
+      if (error_x_prev != 0. && (error_x > 0.) != (error_x_prev > 0.))
+        nb_sign_changes ++;
+      error_x_prev = error_x;
+    }
+    if (t > 4.)
+      max_error = std::max(max_error, poseError(cdMc));
+  }
+
+  return max_error;
+}
+
+int main()
+{
+  const double lambda = 8.;
+  const double latency = 0.15;
+
+  unsigned int nb_sign_changes_delayed, nb_sign_changes_compensated;
+  double error_delayed = simulate(false, lambda, latency, nb_sign_changes_delayed);
+  double error_compensated = simulate(true, lambda, latency, nb_sign_changes_compensated);
+
+  double error_initial = poseError(initialPose());
+  std::cout << "Initial error: " << error_initial << std::endl;
+  std::cout << "Error after 4 s without compensation: " << error_delayed << ", "
+            << nb_sign_changes_delayed << " sign changes of x after 1 s" << std::endl;
+  std::cout << "Error after 4 s with compensation: " << error_compensated << ", "
+            << nb_sign_changes_compensated << " sign changes of x after 1 s" << std::endl;
+
+  // Without compensation the loop gain times the delay is close to the stability limit: the servo
+  // oscillates around the target, with a period of about 4 times the delay, and is still far from it
+  // after 4 s, but it does not diverge. A slow servo would not cross the target several times.
+  bool delayed_finite = (error_delayed == error_delayed) && error_delayed <= std::numeric_limits<double>::max();
+  bool delayed_oscillates = (nb_sign_changes_delayed >= 4) && (error_delayed > 0.1 * error_initial);
+  bool success = (error_compensated < 1e-6) && delayed_finite && delayed_oscillates;
+  std::cout << (success ? "Test succeed" : "Test failed") << std::endl;
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
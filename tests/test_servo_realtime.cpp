@@ -0,0 +1,144 @@
+/**
+ *
+ * This example checks the real-time mode of vpServoArm and vpServoHead without robot:
+ * - the joint velocities are the same than the ones computed by vpServo, cVe being set with
+ *   vpServoArm::set_cVe() or m_task.set_cVe(),
+ * - computeControlLaw() does not allocate memory once the real-time mode is set.
+ *
+ */
+
+#include <stdlib.h>
+#include <iostream>
+
+#include <visp/vpHomogeneousMatrix.h>
+#include <visp/vpVelocityTwistMatrix.h>
+
+#include <vpAllocationHooks.h>
+#include <vpServoArm.h>
+#include <vpServoHead.h>
+
+/*!
+  Deterministic arm Jacobian with the given number of joints.
+ */
+vpMatrix buildJacobian(unsigned int nb_joints)
+{
+  vpMatrix eJe(6, nb_joints);
+  for (unsigned int i=0; i < 6; i++)
+    for (unsigned int j=0; j < nb_joints; j++)
+      eJe[i][j] = cos(1.3*i + 0.7*j + 0.1*i*j);
+  return eJe;
+}
+
+bool testServoArm(vpServoArm::vpServoArmType type, const std::string &name)
+{
+  const unsigned int nb_joints = 7;
+  const unsigned int nb_iter = 100;
+  vpMatrix eJe = buildJacobian(nb_joints);
+  vpVelocityTwistMatrix cVe(vpHomogeneousMatrix(0.1, -0.05, 0.2, 0.3, -0.2, 0.1));
+  vpColVector z_c(3), z_d(3);
+  z_c[0] = 0.1; z_c[1] = 0.2; z_c[2] = 1.; z_c.normalize();
+  z_d[2] = 1.;
+
+  vpServoArm servo_ref(type);
+  vpServoArm servo_rt(type);
+  servo_rt.setRealTime(true, nb_joints);
+  vpColVector q_dot(nb_joints);
+
+  bool success = true;
+  unsigned long nb_allocations = 0;
+  for (unsigned int iter=0; iter < nb_iter; iter++) {
+    double t = 0.01*iter;
+    vpHomogeneousMatrix cdMc(0.05*cos(t), 0.02, -0.1*sin(t), 0.3*sin(t), 0.1, -0.2*cos(t));
+
+    servo_ref.set_cVe(cVe);
+    servo_ref.set_eJe(eJe);
+    if (type == vpServoArm::vs6dof_cyl)
+      servo_ref.setCurrentFeature(cdMc, z_c, z_d);
+    else
+      servo_ref.setCurrentFeature(cdMc);
+    vpColVector q_dot_ref = servo_ref.m_task.computeControlLaw();
+
+    vpAllocationCounter::vpScope allocations;
+    // Both ways to set the twist matrix are used by the demos
+    if (iter % 2)
+      servo_rt.m_task.set_cVe(cVe);
+    else
+      servo_rt.set_cVe(cVe);
+    servo_rt.set_eJe(eJe);
+    if (type == vpServoArm::vs6dof_cyl)
+      servo_rt.setCurrentFeature(cdMc, z_c, z_d);
+    else
+      servo_rt.setCurrentFeature(cdMc);
+    servo_rt.computeControlLaw(q_dot);
+    nb_allocations += allocations.getNbAllocations();
+
+    double error = (q_dot - q_dot_ref).infinityNorm();
+    if (error > 1e-3 * (1 + q_dot_ref.infinityNorm())) {
+      std::cout << name << ": iteration " << iter << " joint velocities differ by " << error << std::endl;
+      std::cout << "vpServo: " << q_dot_ref.t() << std::endl;
+      std::cout << "real-time: " << q_dot.t() << std::endl;
+      success = false;
+      break;
+    }
+  }
+  std::cout << name << ": " << nb_allocations << " allocation(s) in " << nb_iter << " iterations" << std::endl;
+  return success && nb_allocations == 0;
+}
+
+bool testServoHead()
+{
+  const unsigned int nb_joints = 4;
+  const unsigned int nb_iter = 100;
+  vpMatrix eJe = buildJacobian(nb_joints);
+  vpVelocityTwistMatrix cVe(vpHomogeneousMatrix(0.05, 0.1, 0.0, 0.0, 0.1, 0.0));
+  vpCameraParameters cam(600, 600, 320, 240);
+
+  vpServoHead servo_ref;
+  vpServoHead servo_rt;
+  servo_ref.setCameraParameters(cam);
+  servo_rt.setCameraParameters(cam);
+  servo_rt.setRealTime(true, nb_joints);
+  vpColVector q_dot(nb_joints);
+
+  bool success = true;
+  unsigned long nb_allocations = 0;
+  for (unsigned int iter=0; iter < nb_iter; iter++) {
+    vpImagePoint ip_cur(240 + 80*sin(0.05*iter), 320 + 60*cos(0.05*iter));
+    vpImagePoint ip_des(200, 300);
+
+    servo_ref.set_cVe(cVe);
+    servo_ref.set_eJe(eJe);
+    servo_ref.setCurrentFeature(ip_cur);
+    servo_ref.setDesiredFeature(ip_des);
+    vpColVector q_dot_ref = servo_ref.computeControlLaw();
+
+    vpAllocationCounter::vpScope allocations;
+    servo_rt.set_cVe(cVe);
+    servo_rt.set_eJe(eJe);
+    servo_rt.setCurrentFeature(ip_cur);
+    servo_rt.setDesiredFeature(ip_des);
+    servo_rt.computeControlLaw(q_dot);
+    nb_allocations += allocations.getNbAllocations();
+
+    double error = (q_dot - q_dot_ref).infinityNorm();
+    if (error > 1e-3 * (1 + q_dot_ref.infinityNorm())) {
+      std::cout << "head: iteration " << iter << " joint velocities differ by " << error << std::endl;
+      success = false;
+      break;
+    }
+  }
+  std::cout << "head: " << nb_allocations << " allocation(s) in " << nb_iter << " iterations" << std::endl;
+  return success && nb_allocations == 0;
+}
+
+int main()
+{
+  bool success = true;
+  success = testServoArm(vpServoArm::vs6dof, "vs6dof") && success;
+  success = testServoArm(vpServoArm::vs5dof_cyl, "vs5dof_cyl") && success;
+  success = testServoArm(vpServoArm::vs6dof_cyl, "vs6dof_cyl") && success;
+  success = testServoHead() && success;
+
+  std::cout << (success ? "Test succeed" : "Test failed") << std::endl;
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
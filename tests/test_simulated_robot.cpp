@@ -0,0 +1,110 @@
+/**
+ *
+ * This example checks vpSimulatedRobot:
+ * - the Jacobian of each chain matches the finite differences of the end-effector pose,
+ * - the velocities are applied after the actuator latency and stop at the joint limits,
+ * - the arms have the hand as last body name, like with vpNaoqiRobot.
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <visp/vpExponentialMap.h>
+#include <visp/vpException.h>
+
+#include <vpSimulatedRobot.h>
+
+bool checkJacobian(vpSimulatedRobot &robot, const std::string &chain_name, const std::vector<std::string> &joint_names)
+{
+  const double dq = 1e-6;
+  vpMatrix eJe = robot.get_eJe(chain_name);
+  if (eJe.getCols() != joint_names.size()) {
+    std::cout << chain_name << ": Jacobian with " << eJe.getCols() << " columns for " << joint_names.size() << " joints" << std::endl;
+    return false;
+  }
+  vpHomogeneousMatrix fMe = robot.get_fMe(chain_name);
+  vpColVector q = robot.getPosition(joint_names);
+  double max_error = 0;
+  for (unsigned int j=0; j < joint_names.size(); j++) {
+    vpColVector q_j = q;
+    q_j[j] += dq;
+    robot.setPosition(joint_names, q_j);
+    vpColVector v = vpExponentialMap::inverse(fMe.inverse() * robot.get_fMe(chain_name), dq);
+    for (unsigned int i=0; i < 6; i++)
+      max_error = std::max(max_error, fabs(v[i] - eJe[i][j]));
+  }
+  robot.setPosition(joint_names, q);
+  std::cout << chain_name << ": max Jacobian error " << max_error << std::endl;
+  return max_error < 1e-4;
+}
+
+int main()
+{
+  bool success = true;
+  try {
+    vpSimulatedRobot robot;
+
+    // Generic configuration away from zero
+    std::vector<std::string> body = robot.getBodyNames("Body");
+    vpColVector q((unsigned int)body.size());
+    for (unsigned int i=0; i < q.size(); i++)
+      q[i] = 0.2 * sin(1.7 * i + 0.3);
+    robot.setPosition(body, q);
+
+    std::vector<std::string> larm = robot.getBodyNames("LArm");
+    if (larm.size() != 8 || larm.back() != "LHand") {
+      std::cout << "LArm should have 7 joints and LHand" << std::endl;
+      success = false;
+    }
+    larm.pop_back();
+    std::vector<std::string> rarm = robot.getBodyNames("RArm");
+    rarm.pop_back();
+    std::vector<std::string> head = robot.getBodyNames("Head");
+    std::vector<std::string> leye = head;
+    std::vector<std::string> leye_names = robot.getBodyNames("LEye");
+    leye.insert(leye.end(), leye_names.begin(), leye_names.end());
+
+    success = checkJacobian(robot, "Head", head) && success;
+    success = checkJacobian(robot, "LEye", leye) && success;
+    success = checkJacobian(robot, "LArm", larm) && success;
+    success = checkJacobian(robot, "RArm", rarm) && success;
+
+    // Latency: the velocity is applied 50 ms after the command
+    std::vector<std::string> neck_yaw = robot.getBodyNames("NeckYaw");
+    robot.setPosition(neck_yaw, vpColVector(1, 0.));
+    robot.setLatency(0.05);
+    robot.setVelocity(neck_yaw, vpColVector(1, 0.5));
+    robot.step(0.04);
+    if (robot.getPosition(neck_yaw)[0] != 0.) {
+      std::cout << "NeckYaw moved before the end of the latency" << std::endl;
+      success = false;
+    }
+    robot.step(0.06);
+    double q_yaw = robot.getPosition(neck_yaw)[0];
+    if (fabs(q_yaw - 0.5 * 0.05) > 1e-9) {
+      std::cout << "NeckYaw at " << q_yaw << " instead of " << 0.5 * 0.05 << std::endl;
+      success = false;
+    }
+
+    // Joint limits: the joint stops at its limit
+    robot.setJointLimits("NeckYaw", -0.1, 0.1);
+    robot.step(1.);
+    q_yaw = robot.getPosition(neck_yaw)[0];
+    if (q_yaw != 0.1 || robot.getJointVelocity(neck_yaw)[0] != 0.) {
+      std::cout << "NeckYaw at " << q_yaw << " did not stop at its limit 0.1" << std::endl;
+      success = false;
+    }
+  }
+  catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e.getMessage() << std::endl;
+    success = false;
+  }
+
+  std::cout << (success ? "Test succeed" : "Test failed") << std::endl;
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,153 @@
+/**
+ *
+ * This example checks vpTelemetryRecorder and vpTelemetryLog without robot: the records written by the
+ * recorder are read back by the log, with the channels that were not written in a record marked as missing,
+ * the records beyond the capacity dropped, and the poses stored as theta u vectors like vpThetaUVector.
+ * A file announcing more channels than the recorder supports is rejected.
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <visp/vpException.h>
+#include <visp/vpHomogeneousMatrix.h>
+#include <visp/vpIoTools.h>
+#include <visp/vpMath.h>
+#include <visp/vpThetaUVector.h>
+
+#include <vpTelemetryLog.h>
+#include <vpTelemetryRecorder.h>
+
+bool check(bool condition, const std::string &message)
+{
+  if (! condition)
+    std::cout << "Error: " << message << std::endl;
+  return condition;
+}
+
+int main()
+{
+  std::string username;
+  vpIoTools::getUserName(username);
+  std::string folder = "/tmp/" + username;
+  if (vpIoTools::checkDirectory(folder) == false)
+    vpIoTools::makeDirectory(folder);
+  std::string filename = folder + "/test_telemetry.bin";
+  std::string corrupted_filename = folder + "/test_telemetry_corrupted.bin";
+
+  const unsigned long capacity = 100;
+  const unsigned long nb_records = 120;
+
+  // Poses, with rotations close to pi for the particular case of the theta u computation
+  std::vector<vpHomogeneousMatrix> poses;
+  poses.push_back(vpHomogeneousMatrix(0.1, -0.2, 0.3, 0.1, 0.2, -0.3));
+  poses.push_back(vpHomogeneousMatrix(0.4, 0.5, -0.6, 0., 0., 0.));
+  poses.push_back(vpHomogeneousMatrix(-0.1, 0., 0.5, M_PI - 1e-3, 0., 0.));
+  poses.push_back(vpHomogeneousMatrix(0., 0.2, 0.1, 0.6*(M_PI - 1e-5), -0.8*(M_PI - 1e-5), 0.));
+
+  bool success = true;
+  try {
+    vpTelemetryRecorder recorder;
+    unsigned int ch_error = recorder.addChannel("error", 3);
+    unsigned int ch_q_dot = recorder.addChannel("q_dot", 5, vpTelemetryRecorder::float32);
+    unsigned int ch_state = recorder.addChannel("state", 1, vpTelemetryRecorder::int32);
+    unsigned int ch_cMo = recorder.addChannel("cMo", 6);
+    recorder.open(filename, capacity);
+
+    std::vector<float> q_dot(5);
+    for (unsigned long r=0; r < nb_records; r++) {
+      recorder.beginRecord(0.01 * r);
+      double error[3] = {1. * r, -2. * r, 0.5 * r};
+      recorder.record(ch_error, error, 3);
+      for (unsigned int i=0; i < q_dot.size(); i++)
+        q_dot[i] = 0.25f * (float)(r + i);
+      recorder.record(ch_q_dot, q_dot);
+      recorder.record(ch_state, (double)(r % 3));
+      if (r % 2 == 0) // The target is only found in one record out of two
+        recorder.record(ch_cMo, poses[(r / 2) % poses.size()]);
+      recorder.endRecord();
+    }
+    success = check(recorder.getNbRecords() == capacity, "the recorder should be full") && success;
+    success = check(recorder.getNbDropped() == nb_records - capacity, "wrong number of dropped records") && success;
+    recorder.close();
+
+    vpTelemetryLog log;
+    log.open(filename);
+    success = check(log.getNbChannels() == 4, "wrong number of channels") && success;
+    success = check(log.getNbRecords() == capacity, "wrong number of records") && success;
+    success = check(log.getChannel("error") == (int)ch_error && log.getChannel("q_dot") == (int)ch_q_dot
+                    && log.getChannel("state") == (int)ch_state && log.getChannel("cMo") == (int)ch_cMo,
+                    "wrong channel indexes") && success;
+    success = check(log.getChannel("unknown") == -1, "unknown channel found") && success;
+    success = check(log.getChannelSize(ch_q_dot) == 5 && log.getChannelName(ch_cMo) == "cMo",
+                    "wrong channel description") && success;
+
+    for (unsigned long r=0; r < log.getNbRecords() && success; r++) {
+      success = check(fabs(log.getTimestamp(r) - 0.01 * r) < 1e-12, "wrong timestamp") && success;
+      success = check(log.hasValues(r, ch_error) && log.hasValues(r, ch_q_dot) && log.hasValues(r, ch_state),
+                      "missing values") && success;
+      success = check(log.getValue(r, ch_error, 0) == 1. * r && log.getValue(r, ch_error, 1) == -2. * r
+                      && log.getValue(r, ch_error, 2) == 0.5 * r, "wrong float64 values") && success;
+      for (unsigned int i=0; i < 5; i++)
+        success = check(log.getValue(r, ch_q_dot, i) == 0.25f * (float)(r + i), "wrong float32 values") && success;
+      success = check(log.getValue(r, ch_state, 0) == (double)(r % 3), "wrong int32 value") && success;
+
+      success = check(log.hasValues(r, ch_cMo) == (r % 2 == 0), "wrong mask of the written channels") && success;
+      if (log.hasValues(r, ch_cMo)) {
+        const vpHomogeneousMatrix &M = poses[(r / 2) % poses.size()];
+        vpThetaUVector tu(M);
+        for (unsigned int i=0; i < 3; i++) {
+          success = check(log.getValue(r, ch_cMo, i) == M[i][3], "wrong translation") && success;
+          success = check(fabs(log.getValue(r, ch_cMo, 3+i) - tu[i]) < 1e-6, "wrong theta u") && success;
+        }
+      }
+    }
+
+    // Rewrite the header with more channels than a record mask can hold
+    std::vector<char> content;
+    {
+      std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+      content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    vpTelemetryRecorder::vpHeader header;
+    memcpy(&header, &content[0], sizeof(header));
+    header.nb_channels = vpTelemetryRecorder::maxChannels + 1;
+    memcpy(&content[0], &header, sizeof(header));
+    {
+      std::ofstream file(corrupted_filename.c_str(), std::ios::out | std::ios::binary);
+      file.write(&content[0], content.size());
+    }
+    bool rejected = false;
+    try {
+      vpTelemetryLog corrupted_log;
+      corrupted_log.open(corrupted_filename);
+    }
+    catch(vpException &e) {
+      std::cout << "Expected error: " << e.getMessage() << std::endl;
+      rejected = true;
+    }
+    success = check(rejected, "a file with too many channels should be rejected") && success;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e.getMessage() << std::endl;
+    success = false;
+  }
+
+  remove(filename.c_str());
+  remove(corrupted_filename.c_str());
+
+  if (success) {
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  std::cout << "Test failed" << std::endl;
+  return EXIT_FAILURE;
+}
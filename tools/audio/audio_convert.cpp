@@ -0,0 +1,132 @@
+/**
+ *
+ * Convert an audio recording between the text dumps written by writemat() in the audio tests (one line per
+ * frame, the samples of the channels separated by spaces), the raw format of vpAudioRecorder and WAVE files.
+ * The format of the input is recognized from its content, the format of the output from its extension:
+ * ".wav" for a 32 bits float WAVE file, ".txt" for a text dump, the raw format otherwise.
+ *
+ */
+
+#include <stdlib.h>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <visp/vpException.h>
+#include <visp/vpTime.h>
+
+#include <vpAudioRecording.h>
+
+bool hasExtension(const std::string &filename, const std::string &extension)
+{
+  return filename.size() >= extension.size()
+      && filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+/*!
+  Load a text dump of writemat().
+ */
+void loadText(const std::string &filename, double sample_rate, vpAudioRecording &recording)
+{
+  std::ifstream file(filename.c_str());
+  if (! file.is_open())
+    throw vpException(vpException::ioError, "Cannot open %s", filename.c_str());
+  std::vector<float> interleaved;
+  unsigned int nb_channels = 0;
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream ss(line);
+    unsigned int n = 0;
+    float value;
+    while (ss >> value) {
+      interleaved.push_back(value);
+      n ++;
+    }
+    if (n == 0)
+      continue;
+    if (nb_channels == 0)
+      nb_channels = n;
+    else if (n != nb_channels)
+      throw vpException(vpException::ioError, "%s: %d values instead of %d on a line", filename.c_str(), n, nb_channels);
+  }
+  if (nb_channels == 0)
+    throw vpException(vpException::ioError, "No samples in %s", filename.c_str());
+  unsigned long nb_frames = (unsigned long)(interleaved.size() / nb_channels);
+  recording.init(nb_channels, nb_frames, sample_rate);
+  for (unsigned int c=0; c < nb_channels; c++)
+    for (unsigned long i=0; i < nb_frames; i++)
+      recording.getChannel(c)[i] = interleaved[i * nb_channels + c];
+}
+
+/*!
+  Save a text dump like writemat().
+ */
+void saveText(const std::string &filename, const vpAudioRecording &recording)
+{
+  std::ofstream file(filename.c_str());
+  if (! file.is_open())
+    throw vpException(vpException::ioError, "Cannot create %s", filename.c_str());
+  for (unsigned long i=0; i < recording.getNbFrames(); i++) {
+    for (unsigned int c=0; c < recording.getNbChannels(); c++)
+      file << (c ? " " : "") << recording.getChannel(c)[i];
+    file << std::endl;
+  }
+}
+
+int main(int argc, const char* argv[])
+{
+  std::string opt_input;
+  std::string opt_output;
+  double opt_rate = 48000.;
+
+  for (int i=1; i<argc; i++) {
+    if (std::string(argv[i]) == "--input" && i+1 < argc)
+      opt_input = argv[++i];
+    else if (std::string(argv[i]) == "--output" && i+1 < argc)
+      opt_output = argv[++i];
+    else if (std::string(argv[i]) == "--rate" && i+1 < argc)
+      opt_rate = atof(argv[++i]);
+    else if (std::string(argv[i]) == "--help") {
+      std::cout << "Usage: " << argv[0] << " --input <recording> --output <recording> [--rate <Hz>] [--help]" << std::endl;
+      std::cout << "  The input is a raw file of vpAudioRecorder, a WAVE file or a text dump of writemat()." << std::endl;
+      std::cout << "  The output is a WAVE file if its name ends with .wav, a text dump with .txt, a raw file otherwise." << std::endl;
+      std::cout << "  --rate gives the sample rate of a text dump (default 48000)." << std::endl;
+      return 0;
+    }
+  }
+
+  if (opt_input.empty() || opt_output.empty()) {
+    std::cout << "Error: use --input and --output to give the recordings. Run \"" << argv[0] << " --help\" to get all the options." << std::endl;
+    return 0;
+  }
+
+  try {
+    double t = vpTime::measureTimeMs();
+    vpAudioRecording recording;
+    std::ifstream probe(opt_input.c_str(), std::ios::in | std::ios::binary);
+    char magic[4] = {0, 0, 0, 0};
+    probe.read(magic, 4);
+    probe.close();
+    if (std::string(magic, 4) == "RTKA" || std::string(magic, 4) == "RIFF")
+      recording.open(opt_input);
+    else
+      loadText(opt_input, opt_rate, recording);
+    std::cout << "Loaded " << recording.getNbChannels() << " channels of " << recording.getDuration() << " s from "
+              << opt_input << " in " << vpTime::measureTimeMs() - t << " ms" << std::endl;
+
+    t = vpTime::measureTimeMs();
+    if (hasExtension(opt_output, ".txt"))
+      saveText(opt_output, recording);
+    else
+      recording.save(opt_output, hasExtension(opt_output, ".wav") ? vpAudioRecorder::wav : vpAudioRecorder::raw);
+    std::cout << "Saved " << opt_output << " in " << vpTime::measureTimeMs() - t << " ms" << std::endl;
+  }
+  catch(vpException &e) {
+    std::cout << e.getMessage() << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,440 @@
+/**
+ *
+ * Evaluate the sound processing on a directory of recordings (raw files of vpAudioRecorder or WAVE files),
+ * processed in parallel on all the cores. For each recording the tool computes:
+ * - the short-time energy envelopes of the left and right channels and their SNR, the ratio of the loud
+ *   frames (90th percentile of the energies) to the background noise (10th percentile),
+ * - the azimuth of the source with vpSoundLocalization on each frame, and the error of the median azimuth
+ *   if the true azimuth is given in the --truth file,
+ * - the decisions of the energy ratio right / left of vpSoundLocalization::getLevelRatio(), the getRatio() of
+ *   audio_test_romeo_neck, for each pair of threshold and number of slices given with --thresholds and --slices.
+ *
+ * The results per recording are written in the summary table (--output). The tuning table (--tuning) gives
+ * for each pair of getRatio() parameters the rate of groups of slices that give a ratio, and the rate of
+ * ratios on the side of the true azimuth, so that the parameters can be chosen on a whole set of recordings.
+ *
+ * The truth file has one line per recording: the name of the file in the directory and the azimuth of the
+ * source in degrees, positive on the left.
+ *
+ */
+
+#include <dirent.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <visp/vpException.h>
+#include <visp/vpMath.h>
+#include <visp/vpTime.h>
+
+#include <vpAudioFeatures.h>
+#include <vpAudioRecording.h>
+#include <vpParallelFor.h>
+#include <vpSoundLocalization.h>
+
+struct vpEvaluationParameters {
+  std::string dir;
+  std::string envelopes;            // Directory of the envelopes, none if empty
+  unsigned int frame_length;
+  unsigned int hop;
+  unsigned int left;
+  unsigned int right;
+  double mic_distance;
+  double loc_threshold;
+  double energy_scale;              // Applied to the energies before getRatio()
+  std::vector<float> thresholds;
+  std::vector<int> slices;
+};
+
+struct vpEvaluationResult {
+  std::string filename;
+  std::string error;                // Not empty if the recording could not be processed
+  unsigned int nb_channels;
+  double duration;
+  double snr_left;
+  double snr_right;
+  unsigned int nb_frames;
+  unsigned int nb_valid;            // Frames localized
+  double azimuth;                   // Median of the azimuths of the valid frames in deg, if nb_valid > 0
+  double peak;                      // Median of the GCC-PHAT peaks, if nb_valid > 0
+  bool has_truth;
+  double truth;
+  double time;                      // Processing time in ms
+  std::vector<unsigned int> nb_groups;   // For each pair of getRatio() parameters
+  std::vector<unsigned int> nb_decisions;
+  std::vector<unsigned int> nb_correct;
+};
+
+struct vpEvaluation {
+  vpEvaluationParameters parameters;
+  std::vector<vpEvaluationResult> results;
+};
+
+bool hasExtension(const std::string &filename, const std::string &extension)
+{
+  return filename.size() >= extension.size()
+      && filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+/*!
+  Sorted list of the recordings of a directory.
+ */
+std::vector<std::string> listRecordings(const std::string &dir)
+{
+  DIR *d = opendir(dir.c_str());
+  if (d == NULL)
+    throw vpException(vpException::ioError, "Cannot open directory %s", dir.c_str());
+  std::vector<std::string> filenames;
+  struct dirent *entry;
+  while ((entry = readdir(d)) != NULL) {
+    std::string name(entry->d_name);
+    if (hasExtension(name, ".raw") || hasExtension(name, ".wav"))
+      filenames.push_back(name);
+  }
+  closedir(d);
+  std::sort(filenames.begin(), filenames.end());
+  return filenames;
+}
+
+template <class T>
+std::vector<T> parseList(const std::string &list)
+{
+  std::vector<T> values;
+  std::istringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    std::istringstream si(item);
+    T value;
+    if (si >> value)
+      values.push_back(value);
+  }
+  return values;
+}
+
+double median(std::vector<double> values)
+{
+  if (values.empty())
+    return 0.;
+  std::vector<double>::iterator middle = values.begin() + values.size() / 2;
+  std::nth_element(values.begin(), middle, values.end());
+  return *middle;
+}
+
+double percentile(std::vector<float> values, double p)
+{
+  if (values.empty())
+    return 0.;
+  std::vector<float>::iterator it = values.begin() + (size_t)(p * (values.size() - 1));
+  std::nth_element(values.begin(), it, values.end());
+  return *it;
+}
+
+double computeSnr(const std::vector<float> &energies)
+{
+  double noise = percentile(energies, 0.1);
+  double signal = percentile(energies, 0.9);
+  if (noise <= 0 || signal <= 0)
+    return 0.;
+  return 10. * log10(signal / noise);
+}
+
+/*!
+  Process one recording. Throw a vpException if the recording cannot be read or does not match the parameters.
+ */
+void evaluate(const vpEvaluationParameters &p, vpEvaluationResult &result)
+{
+  vpAudioRecording recording;
+  recording.open(p.dir + "/" + result.filename);
+  if (recording.getNbChannels() <= std::max(p.left, p.right))
+    throw vpException(vpException::badValue, "Only %d channels", recording.getNbChannels());
+  result.nb_channels = recording.getNbChannels();
+  result.duration = recording.getDuration();
+
+  const float *left = recording.getChannel(p.left);
+  const float *right = recording.getChannel(p.right);
+  vpAudioFeatures features(p.frame_length, p.hop);
+  vpSoundLocalization localization(recording.getSampleRate(), p.frame_length, p.mic_distance);
+  localization.setEnergyThreshold(p.loc_threshold);
+
+  std::vector<float> energy_l, energy_r, azimuths_frame;
+  std::vector<double> azimuths, peaks;
+  for (unsigned long i=0; i + p.frame_length <= recording.getNbFrames(); i += p.hop) {
+    energy_l.push_back(features.energy(left + i));
+    energy_r.push_back(features.energy(right + i));
+    if (localization.process(left + i, right + i)) {
+      azimuths.push_back(vpMath::deg(localization.getAzimuth()));
+      peaks.push_back(localization.getPeak());
+      azimuths_frame.push_back((float)azimuths.back());
+    }
+    else
+      azimuths_frame.push_back((float)NAN);
+  }
+  result.nb_frames = (unsigned int)energy_l.size();
+  result.nb_valid = (unsigned int)azimuths.size();
+  result.snr_left = computeSnr(energy_l);
+  result.snr_right = computeSnr(energy_r);
+  result.azimuth = median(azimuths);
+  result.peak = median(peaks);
+
+  // getRatio() of audio_test_romeo_neck on groups of slices for each pair of parameters
+  std::vector<float> scaled_l(energy_l.size()), scaled_r(energy_r.size());
+  for (size_t i=0; i < energy_l.size(); i++) {
+    scaled_l[i] = (float)(energy_l[i] * p.energy_scale);
+    scaled_r[i] = (float)(energy_r[i] * p.energy_scale);
+  }
+  for (size_t k=0; k < p.thresholds.size() * p.slices.size(); k++) {
+    float threshold = p.thresholds[k / p.slices.size()];
+    unsigned int nb_slices = (unsigned int)p.slices[k % p.slices.size()];
+    for (size_t g=0; g + nb_slices <= scaled_l.size(); g += nb_slices) {
+      result.nb_groups[k] ++;
+      float ratio = vpSoundLocalization::getLevelRatio(&scaled_l[g], &scaled_r[g], threshold, nb_slices);
+      if (ratio < 0)
+        continue;
+      result.nb_decisions[k] ++;
+      // A louder right channel means a source on the right, i.e. a negative azimuth
+      if (result.has_truth && ((result.truth > 0 && ratio < 1) || (result.truth < 0 && ratio > 1)))
+        result.nb_correct[k] ++;
+    }
+  }
+
+  if (! p.envelopes.empty()) {
+    std::string filename = p.envelopes + "/" + result.filename + ".txt";
+    std::ofstream file(filename.c_str());
+    if (! file.is_open())
+      throw vpException(vpException::ioError, "Cannot create %s", filename.c_str());
+    file << "# time energy_left energy_right azimuth" << std::endl;
+    for (size_t i=0; i < energy_l.size(); i++)
+      file << i * p.hop / recording.getSampleRate() << " " << energy_l[i] << " " << energy_r[i] << " "
+           << azimuths_frame[i] << std::endl;
+  }
+}
+
+/*!
+  Process one recording, called by vpParallelFor from several threads. An error on a recording, like a sample rate
+  too high for the frame length and the microphone distance, is reported in its result without stopping the others.
+ */
+void evaluate(unsigned int index, void *data)
+{
+  vpEvaluation *evaluation = (vpEvaluation *)data;
+  vpEvaluationResult &result = evaluation->results[index];
+  double t = vpTime::measureTimeMs();
+  try {
+    evaluate(evaluation->parameters, result);
+  }
+  catch (const vpException &e) {
+    result.error = e.getMessage();
+  }
+  catch (const std::exception &e) {
+    result.error = e.what();
+  }
+  result.time = vpTime::measureTimeMs() - t;
+}
+
+void writeSummary(std::ostream &os, const std::vector<vpEvaluationResult> &results, const std::string &separator)
+{
+  os << "file" << separator << "channels" << separator << "duration" << separator << "snr_left" << separator
+     << "snr_right" << separator << "frames" << separator << "localized" << separator << "azimuth" << separator
+     << "peak" << separator << "truth" << separator << "error" << separator << "time_ms" << std::endl;
+  for (size_t i=0; i < results.size(); i++) {
+    const vpEvaluationResult &r = results[i];
+    os << r.filename << separator;
+    if (! r.error.empty()) {
+      os << "error: " << r.error << std::endl;
+      continue;
+    }
+    os << r.nb_channels << separator << r.duration << separator << r.snr_left << separator << r.snr_right
+       << separator << r.nb_frames << separator << r.nb_valid << separator;
+    // Without localized frame there is no azimuth to report nor to compare with the truth
+    if (r.nb_valid)
+      os << r.azimuth << separator << r.peak << separator;
+    else
+      os << "-" << separator << "-" << separator;
+    if (r.has_truth)
+      os << r.truth << separator;
+    else
+      os << "-" << separator;
+    if (r.has_truth && r.nb_valid)
+      os << fabs(r.azimuth - r.truth) << separator;
+    else
+      os << "-" << separator;
+    os << r.time << std::endl;
+  }
+}
+
+int main(int argc, const char* argv[])
+{
+  vpEvaluation evaluation;
+  vpEvaluationParameters &p = evaluation.parameters;
+  p.frame_length = 1024;
+  p.hop = 512;
+  p.left = 0;
+  p.right = 1;
+  p.mic_distance = 0.31;
+  p.loc_threshold = 1e-6;
+  p.energy_scale = 32768. * 32768.;
+  std::string opt_output = "audio_evaluation.txt";
+  std::string opt_tuning = "audio_tuning.txt";
+  std::string opt_truth;
+  std::string opt_thresholds = "1e6,3e6,1e7,3e7,1e8";
+  std::string opt_slices = "5,10,19,30";
+  unsigned int opt_threads = 0;
+
+  for (int i=1; i<argc; i++) {
+    if (std::string(argv[i]) == "--dir" && i+1 < argc)
+      p.dir = argv[++i];
+    else if (std::string(argv[i]) == "--output" && i+1 < argc)
+      opt_output = argv[++i];
+    else if (std::string(argv[i]) == "--tuning" && i+1 < argc)
+      opt_tuning = argv[++i];
+    else if (std::string(argv[i]) == "--truth" && i+1 < argc)
+      opt_truth = argv[++i];
+    else if (std::string(argv[i]) == "--envelopes" && i+1 < argc)
+      p.envelopes = argv[++i];
+    else if (std::string(argv[i]) == "--threads" && i+1 < argc)
+      opt_threads = (unsigned int)atoi(argv[++i]);
+    else if (std::string(argv[i]) == "--frame" && i+1 < argc)
+      p.frame_length = (unsigned int)atoi(argv[++i]);
+    else if (std::string(argv[i]) == "--hop" && i+1 < argc)
+      p.hop = (unsigned int)atoi(argv[++i]);
+    else if (std::string(argv[i]) == "--channels" && i+2 < argc) {
+      p.left = (unsigned int)atoi(argv[++i]);
+      p.right = (unsigned int)atoi(argv[++i]);
+    }
+    else if (std::string(argv[i]) == "--distance" && i+1 < argc)
+      p.mic_distance = atof(argv[++i]);
+    else if (std::string(argv[i]) == "--loc-threshold" && i+1 < argc)
+      p.loc_threshold = atof(argv[++i]);
+    else if (std::string(argv[i]) == "--scale" && i+1 < argc)
+      p.energy_scale = atof(argv[++i]);
+    else if (std::string(argv[i]) == "--thresholds" && i+1 < argc)
+      opt_thresholds = argv[++i];
+    else if (std::string(argv[i]) == "--slices" && i+1 < argc)
+      opt_slices = argv[++i];
+    else if (std::string(argv[i]) == "--help") {
+      std::cout << "Usage: " << argv[0] << " --dir <directory> [--truth <file>] [--output <file>] [--tuning <file>]" << std::endl;
+      std::cout << "  [--envelopes <directory>] [--threads <n>] [--frame <samples>] [--hop <samples>]" << std::endl;
+      std::cout << "  [--channels <left> <right>] [--distance <m>] [--loc-threshold <energy>] [--scale <factor>]" << std::endl;
+      std::cout << "  [--thresholds <t1,t2...>] [--slices <n1,n2...>] [--help]" << std::endl;
+      std::cout << "  --truth: file with one line \"<recording> <azimuth in deg>\" per recording, positive on the left." << std::endl;
+      std::cout << "  --envelopes: write the energies and azimuth of each frame of <recording> in <directory>/<recording>.txt." << std::endl;
+      std::cout << "  --threads: number of threads, the number of cores by default." << std::endl;
+      std::cout << "  --loc-threshold: energy below which a frame is not localized (default " << p.loc_threshold << ")." << std::endl;
+      std::cout << "  --scale: factor of the energies given to getRatio(), " << p.energy_scale << " by default" << std::endl;
+      std::cout << "    to get the int16 scale of ALSoundProcessing from samples in [-1, 1]." << std::endl;
+      std::cout << "  --thresholds, --slices: parameters of getRatio() to evaluate (default " << opt_thresholds
+                << " and " << opt_slices << ")." << std::endl;
+      return 0;
+    }
+  }
+
+  if (p.dir.empty()) {
+    std::cout << "Error: use --dir to give the directory of the recordings. Run \"" << argv[0] << " --help\" to get all the options." << std::endl;
+    return 0;
+  }
+
+  try {
+    // Check the parameters once instead of failing on each recording. The delay between the microphones is
+    // checked against the frame length for the sample rate of each recording, when it is processed
+    vpAudioFeatures features(p.frame_length, p.hop);
+    if (p.mic_distance <= 0)
+      throw vpException(vpException::badValue, "Microphone distance of %f m", p.mic_distance);
+
+    p.thresholds = parseList<float>(opt_thresholds);
+    p.slices = parseList<int>(opt_slices);
+    for (size_t i=0; i < p.slices.size(); i++)
+      if (p.slices[i] <= 0)
+        throw vpException(vpException::badValue, "Invalid number of slices %d", p.slices[i]);
+
+    std::map<std::string, double> truth;
+    if (! opt_truth.empty()) {
+      std::ifstream file(opt_truth.c_str());
+      if (! file.is_open())
+        throw vpException(vpException::ioError, "Cannot open %s", opt_truth.c_str());
+      std::string name;
+      double azimuth;
+      while (file >> name >> azimuth)
+        truth[name] = azimuth;
+    }
+
+    std::vector<std::string> filenames = listRecordings(p.dir);
+    if (filenames.empty())
+      throw vpException(vpException::ioError, "No .raw or .wav recording in %s", p.dir.c_str());
+
+    size_t nb_pairs = p.thresholds.size() * p.slices.size();
+    evaluation.results.resize(filenames.size());
+    for (size_t i=0; i < filenames.size(); i++) {
+      vpEvaluationResult &r = evaluation.results[i];
+      r.filename = filenames[i];
+      r.nb_channels = 0;
+      r.duration = r.snr_left = r.snr_right = r.azimuth = r.peak = r.truth = r.time = 0;
+      r.nb_frames = r.nb_valid = 0;
+      r.has_truth = truth.find(filenames[i]) != truth.end();
+      if (r.has_truth)
+        r.truth = truth[filenames[i]];
+      r.nb_groups.assign(nb_pairs, 0);
+      r.nb_decisions.assign(nb_pairs, 0);
+      r.nb_correct.assign(nb_pairs, 0);
+    }
+
+    unsigned int nb_threads = opt_threads ? opt_threads : vpParallelFor::getNbCores();
+    double t = vpTime::measureTimeMs();
+    vpParallelFor::run((unsigned int)filenames.size(), evaluate, &evaluation, nb_threads);
+    t = vpTime::measureTimeMs() - t;
+
+    std::ofstream summary(opt_output.c_str());
+    if (! summary.is_open())
+      throw vpException(vpException::ioError, "Cannot create %s", opt_output.c_str());
+    writeSummary(summary, evaluation.results, " ");
+    writeSummary(std::cout, evaluation.results, "\t");
+
+    // Sum the decisions of getRatio() on all the recordings
+    std::ofstream tuning(opt_tuning.c_str());
+    if (! tuning.is_open())
+      throw vpException(vpException::ioError, "Cannot create %s", opt_tuning.c_str());
+    tuning << "threshold slices groups decision_rate side_accuracy" << std::endl;
+    size_t best = 0;
+    double best_accuracy = -1, best_rate = -1;
+    for (size_t k=0; k < nb_pairs; k++) {
+      unsigned int nb_groups = 0, nb_decisions = 0, nb_truth = 0, nb_correct = 0;
+      for (size_t i=0; i < evaluation.results.size(); i++) {
+        const vpEvaluationResult &r = evaluation.results[i];
+        nb_groups += r.nb_groups[k];
+        nb_decisions += r.nb_decisions[k];
+        if (r.has_truth && r.truth != 0) {
+          nb_truth += r.nb_decisions[k];
+          nb_correct += r.nb_correct[k];
+        }
+      }
+      double rate = nb_groups ? (double)nb_decisions / nb_groups : 0.;
+      double accuracy = nb_truth ? (double)nb_correct / nb_truth : 0.;
+      tuning << p.thresholds[k / p.slices.size()] << " " << p.slices[k % p.slices.size()] << " " << nb_groups << " "
+             << rate << " " << accuracy << std::endl;
+      if (accuracy > best_accuracy || (accuracy == best_accuracy && rate > best_rate)) {
+        best = k;
+        best_accuracy = accuracy;
+        best_rate = rate;
+      }
+    }
+
+    std::cout << "Processed " << filenames.size() << " recordings with " << nb_threads << " threads in " << t
+              << " ms" << std::endl;
+    std::cout << "Summary saved in " << opt_output << ", getRatio() tuning in " << opt_tuning << std::endl;
+    if (nb_pairs > 0 && ! truth.empty())
+      std::cout << "Best getRatio() parameters: threshold " << p.thresholds[best / p.slices.size()] << ", "
+                << p.slices[best % p.slices.size()] << " slices (side accuracy " << best_accuracy
+                << ", decision rate " << best_rate << ")" << std::endl;
+  }
+  catch(vpException &e) {
+    std::cout << e.getMessage() << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,344 @@
+/**
+ *
+ * Hand-eye calibration from the data saved by data-acquisition: the images I%04d.pgm of the Lagadic grid and
+ * the end-effector poses M%04d.xml (tMe) saved at the same time. The tool:
+ * - reads all the tMe poses, then extracts the grid and computes its pose cMo in all the images in parallel
+ *   with vpGridDetector, the camera parameters being fixed to the ones of the camera xml file,
+ * - computes eMc with vpHandEyeSolver: closed form solution of Tsai and Lenz refined on all the pairs, then
+ *   solved again without the pairs whose error is far above the others,
+ * - prints the errors of each pair and saves eMc in the output xml file.
+ *
+ * As in calibrate3dGrid-Lagadic -b, the 5 reference dots of the grid are found from germs: the file
+ * <image>.txt if it exists, otherwise the file given with --germs. Since data-acquisition saves no germs file
+ * and the head moves a lot between the pairs, the images rejected at these germs are retried with the germs
+ * projected from the pose of the grid in the nearest accepted image, then from the pose predicted by a first
+ * eMc computed on the accepted images. After a camera swap, calibrate the camera with calibrate3dGrid-Lagadic,
+ * acquire new data and run:
+ *
+ * ./calibrate-hand-eye --dir <data path> --camera camera.xml --name Camera --germs germs.txt
+ *
+ */
+
+#include <stdlib.h>
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <visp/vpCameraParameters.h>
+#include <visp/vpException.h>
+#include <visp/vpHomogeneousMatrix.h>
+#include <visp/vpImage.h>
+#include <visp/vpImageIo.h>
+#include <visp/vpIoTools.h>
+#include <visp/vpMath.h>
+#include <visp/vpRotationMatrix.h>
+#include <visp/vpRxyzVector.h>
+#include <visp/vpTime.h>
+#include <visp/vpXmlParserCamera.h>
+#include <visp/vpXmlParserHomogeneousMatrix.h>
+
+#include <vpGridDetector.h>
+#include <vpHandEyeSolver.h>
+
+std::string getFilename(const std::string &dir, const std::string &prefix, unsigned int index,
+                        const std::string &extension)
+{
+  std::ostringstream s;
+  s << prefix << std::setw(4) << std::setfill('0') << index << extension;
+  return vpIoTools::createFilePath(dir, s.str());
+}
+
+/*!
+  Detect the grid again in an image rejected at its germs, with the germs projected from a pose \e cMo of the
+  grid close to the one in this image.
+  \param cam_cMo : Camera parameters of \e cMo.
+  \param cam : Initial camera parameters of the detection.
+  \return true if the image is accepted, \e detection being then updated.
+*/
+bool detectFromPose(const vpGridDetector &detector, const std::string &filename, const vpHomogeneousMatrix &cMo,
+                    const vpCameraParameters &cam_cMo, const vpCameraParameters &cam,
+                    vpGridDetector::vpDetection &detection)
+{
+  vpImage<unsigned char> I;
+  try {
+    vpImageIo::read(I, filename);
+  }
+  catch(...) {
+    return false;
+  }
+  std::vector<vpImagePoint> germs;
+  detector.projectPosePoints(cMo, cam_cMo, germs);
+  vpGridDetector::vpDetection retry;
+  if (! detector.detect(I, germs, cam, retry))
+    return false;
+  detection = retry;
+  return true;
+}
+
+/*!
+  Retry the rejected images with the germs projected from the pose of the grid in the nearest accepted image,
+  until no more image is accepted. Consecutive images of data-acquisition are close, so that the grid is found
+  step by step along the motion of the head.
+  \return the number of images accepted.
+*/
+unsigned int detectFromNeighbours(const vpGridDetector &detector, const std::vector<std::string> &filenames,
+                                  const vpCameraParameters &cam, std::vector<vpGridDetector::vpDetection> &detections)
+{
+  unsigned int nb_accepted = 0;
+  std::vector<int> tried(detections.size(), -1); // Last neighbour tried for each image
+  bool accepted = true;
+  while (accepted) {
+    accepted = false;
+    for (unsigned int i=0; i < detections.size(); i++) {
+      if (detections[i].valid)
+        continue;
+      int neighbour = -1;
+      for (unsigned int d=1; d < detections.size() && neighbour < 0; d++) {
+        if (i >= d && detections[i-d].valid)
+          neighbour = (int)(i-d);
+        else if (i+d < detections.size() && detections[i+d].valid)
+          neighbour = (int)(i+d);
+      }
+      if (neighbour < 0 || neighbour == tried[i])
+        continue;
+      tried[i] = neighbour;
+      if (detectFromPose(detector, filenames[i], detections[neighbour].cMo, detections[neighbour].cam, cam,
+                         detections[i])) {
+        nb_accepted ++;
+        accepted = true;
+      }
+    }
+  }
+  return nb_accepted;
+}
+
+/*!
+  Retry the rejected images with the germs projected from the pose of the grid cMo = (tMe eMc)^-1 tMo predicted
+  by a first hand-eye calibration on the accepted images.
+  \return the number of images accepted.
+*/
+unsigned int detectFromHandEye(const vpGridDetector &detector, const std::vector<std::string> &filenames,
+                               const std::vector<vpHomogeneousMatrix> &tMe, const vpCameraParameters &cam,
+                               std::vector<vpGridDetector::vpDetection> &detections)
+{
+  vpHandEyeSolver solver;
+  for (unsigned int i=0; i < detections.size(); i++)
+    if (detections[i].valid)
+      solver.addPair(tMe[i], detections[i].cMo);
+  if (solver.getNbPairs() < 3 || solver.getNbPairs() == detections.size())
+    return 0;
+  try {
+    solver.solve();
+  }
+  catch(const vpException &) {
+    return 0; // Accepted pairs too close to each other: the images rejected so far are not used
+  }
+  vpHomogeneousMatrix eMc = solver.get_eMc();
+  vpHomogeneousMatrix tMo = solver.get_tMo();
+
+  unsigned int nb_accepted = 0;
+  for (unsigned int i=0; i < detections.size(); i++) {
+    if (detections[i].valid)
+      continue;
+    vpHomogeneousMatrix cMo = (tMe[i] * eMc).inverse() * tMo;
+    if (detectFromPose(detector, filenames[i], cMo, cam, cam, detections[i]))
+      nb_accepted ++;
+  }
+  return nb_accepted;
+}
+
+int main(int argc, const char* argv[])
+{
+  std::string opt_dir = "./";
+  std::string opt_grid = "mire3p.dat";
+  std::string opt_germs;
+  std::string opt_camera;
+  std::string opt_camera_name = "Camera";
+  std::string opt_output = "eMc.xml";
+  bool opt_distortion = false;
+  unsigned int opt_first = 1;
+  unsigned int opt_nimages = 0;
+  unsigned int opt_threads = 0;
+  double opt_max_residual = 1.;
+  double opt_outlier_factor = 3.;
+
+  for (int i=1; i<argc; i++) {
+    if (std::string(argv[i]) == "--dir" && i+1 < argc)
+      opt_dir = argv[++i];
+    else if (std::string(argv[i]) == "--grid" && i+1 < argc)
+      opt_grid = argv[++i];
+    else if (std::string(argv[i]) == "--germs" && i+1 < argc)
+      opt_germs = argv[++i];
+    else if (std::string(argv[i]) == "--camera" && i+1 < argc)
+      opt_camera = argv[++i];
+    else if (std::string(argv[i]) == "--name" && i+1 < argc)
+      opt_camera_name = argv[++i];
+    else if (std::string(argv[i]) == "--distortion")
+      opt_distortion = true;
+    else if (std::string(argv[i]) == "--output" && i+1 < argc)
+      opt_output = argv[++i];
+    else if (std::string(argv[i]) == "--first" && i+1 < argc)
+      opt_first = (unsigned int)atoi(argv[++i]);
+    else if (std::string(argv[i]) == "--nimages" && i+1 < argc)
+      opt_nimages = (unsigned int)atoi(argv[++i]);
+    else if (std::string(argv[i]) == "--threads" && i+1 < argc)
+      opt_threads = (unsigned int)atoi(argv[++i]);
+    else if (std::string(argv[i]) == "--max-residual" && i+1 < argc)
+      opt_max_residual = atof(argv[++i]);
+    else if (std::string(argv[i]) == "--outlier-factor" && i+1 < argc)
+      opt_outlier_factor = atof(argv[++i]);
+    else if (std::string(argv[i]) == "--help") {
+      std::cout << "Usage: " << argv[0] << " [--dir <data path>] [--grid <grid file>] [--germs <file>]" << std::endl;
+      std::cout << "  [--camera <xml file>] [--name <camera name>] [--distortion] [--output <xml file>]" << std::endl;
+      std::cout << "  [--first <index>] [--nimages <n>] [--threads <n>] [--max-residual <px>]" << std::endl;
+      std::cout << "  [--outlier-factor <factor>] [--help]" << std::endl;
+      std::cout << "  --dir: path of the I%04d.pgm images and M%04d.xml poses of data-acquisition (default "
+                << opt_dir << ")." << std::endl;
+      std::cout << "  --germs: positions \"u v\" of the 5 reference dots, used for the images without" << std::endl;
+      std::cout << "    their own <image>.txt file. The images rejected at these germs are retried with the" << std::endl;
+      std::cout << "    germs of the nearest accepted image, then with germs predicted by a first eMc, so" << std::endl;
+      std::cout << "    that at least one image should match them." << std::endl;
+      std::cout << "  --camera, --name: camera parameters, with distortion if --distortion is set. Without" << std::endl;
+      std::cout << "    camera file the parameters are estimated on each image, which is less accurate." << std::endl;
+      std::cout << "  --nimages: number of pairs, all the pairs from --first by default." << std::endl;
+      std::cout << "  --threads: number of threads, the number of cores by default." << std::endl;
+      std::cout << "  --max-residual: largest reprojection error of the grid in an image (default "
+                << opt_max_residual << " px)." << std::endl;
+      std::cout << "  --outlier-factor: pairs whose error is more than factor times the median error are" << std::endl;
+      std::cout << "    rejected (default " << opt_outlier_factor << ", 0 to keep all the pairs)." << std::endl;
+      return 0;
+    }
+  }
+
+  try {
+    vpGridDetector detector;
+    detector.loadGrid(opt_grid);
+    detector.setMaxResidual(opt_max_residual);
+
+    std::vector<vpImagePoint> germs;  // Germs of the images without their own file
+    if (! opt_germs.empty() && ! vpGridDetector::readGerms(opt_germs, germs)) {
+      std::cerr << "Cannot read germs file " << opt_germs << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // The xml files are read here since libxml2 is not used from several threads
+    std::vector<vpHomogeneousMatrix> tMe;
+    std::vector<std::string> filenames;
+    vpXmlParserHomogeneousMatrix parser;
+    for (unsigned int i=opt_first; opt_nimages == 0 || i < opt_first + opt_nimages; i++) {
+      std::string image = getFilename(opt_dir, "I", i, ".pgm");
+      std::string pose = getFilename(opt_dir, "M", i, ".xml");
+      if (! vpIoTools::checkFilename(image) || ! vpIoTools::checkFilename(pose))
+        break;
+      vpHomogeneousMatrix M;
+      if (parser.parse(M, pose, "tMe") != vpXmlParserHomogeneousMatrix::SEQUENCE_OK) {
+        std::cerr << "Cannot read tMe in " << pose << std::endl;
+        return EXIT_FAILURE;
+      }
+      tMe.push_back(M);
+      filenames.push_back(image);
+    }
+    if (filenames.size() < 3) {
+      std::cerr << "Only " << filenames.size() << " pairs in " << opt_dir
+                << ", at least 3 are needed. Run \"" << argv[0] << " --help\" to get all the options." << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    vpImage<unsigned char> I;
+    vpImageIo::read(I, filenames[0]);
+    vpCameraParameters cam;
+    cam.initPersProjWithoutDistortion(600, 600, I.getWidth()/2, I.getHeight()/2);
+    if (! opt_camera.empty()) {
+      vpXmlParserCamera p;
+      vpCameraParameters::vpCameraParametersProjType model = opt_distortion
+          ? vpCameraParameters::perspectiveProjWithDistortion : vpCameraParameters::perspectiveProjWithoutDistortion;
+      if (p.parse(cam, opt_camera.c_str(), opt_camera_name.c_str(), model, I.getWidth(), I.getHeight())
+          != vpXmlParserCamera::SEQUENCE_OK) {
+        std::cerr << "Cannot find camera parameters of " << opt_camera_name << " in " << opt_camera << std::endl;
+        return EXIT_FAILURE;
+      }
+      detector.setCameraEstimation(false);
+    }
+    else
+      std::cout << "Warning: no camera file, the camera parameters are estimated on each image." << std::endl;
+    std::cout << "Camera parameters: " << cam << std::endl;
+
+    std::vector<vpGridDetector::vpDetection> detections;
+    double t = vpTime::measureTimeMs();
+    detector.detect(filenames, germs, cam, opt_threads, detections);
+    std::cout << "Grid extracted from " << filenames.size() << " images in "
+              << vpTime::measureTimeMs() - t << " ms" << std::endl;
+
+    // data-acquisition saves no germs file, and the large head rotations needed by the hand-eye calibration
+    // move the grid far from the common germs: the rejected images are retried with predicted germs
+    unsigned int nb_neighbours = detectFromNeighbours(detector, filenames, cam, detections);
+    unsigned int nb_predicted = detectFromHandEye(detector, filenames, tMe, cam, detections);
+    if (nb_neighbours + nb_predicted)
+      std::cout << nb_neighbours << " images accepted with the germs of a neighbour image, " << nb_predicted
+                << " with the germs predicted by a first eMc" << std::endl;
+
+    vpHandEyeSolver solver;
+    solver.setOutlierFactor(opt_outlier_factor);
+    std::vector<unsigned int> pairs;
+    for (unsigned int i=0; i < filenames.size(); i++) {
+      const vpGridDetector::vpDetection &detection = detections[i];
+      if (detection.valid) {
+        solver.addPair(tMe[i], detection.cMo);
+        pairs.push_back(i);
+      }
+      else
+        std::cout << filenames[i] << ": rejected, " << detection.error << std::endl;
+    }
+    if (pairs.size() < 3) {
+      std::cerr << "Only " << pairs.size() << " valid images, at least 3 are needed" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    t = vpTime::measureTimeMs();
+    solver.solve();
+    std::cout << "eMc computed from " << solver.getNbUsed() << " of " << solver.getNbPairs() << " pairs in "
+              << vpTime::measureTimeMs() - t << " ms, " << solver.getNbIterations() << " iterations" << std::endl;
+
+    std::cout << std::endl << "image                    dots  grid (px)  error (mm)  error (deg)" << std::endl;
+    std::cout.setf(std::ios::fixed, std::ios::floatfield);
+    for (unsigned int k=0; k < pairs.size(); k++) {
+      const vpGridDetector::vpDetection &detection = detections[pairs[k]];
+      std::cout << std::left << std::setw(24) << vpIoTools::getName(filenames[pairs[k]]) << std::right
+                << std::setw(5) << detection.nb_dots
+                << std::setprecision(3) << std::setw(11) << detection.residual
+                << std::setprecision(2) << std::setw(12) << 1000. * solver.getTranslationError(k)
+                << std::setw(13) << vpMath::deg(solver.getRotationError(k))
+                << (solver.isUsed(k) ? "" : "  rejected") << std::endl;
+    }
+    std::cout.unsetf(std::ios::floatfield);
+
+    vpHomogeneousMatrix eMc = solver.get_eMc();
+    vpTranslationVector e_t_c;
+    vpRotationMatrix e_R_c;
+    vpRxyzVector e_r_c;
+    eMc.extract(e_t_c);
+    eMc.extract(e_R_c);
+    e_r_c.buildFrom(e_R_c);
+    std::cout << std::endl << "eMc:" << std::endl << eMc << std::endl;
+    std::cout << "Translation (m): " << e_t_c[0] << " " << e_t_c[1] << " " << e_t_c[2] << std::endl;
+    std::cout << "Rotation Rxyz (deg): " << vpMath::deg(e_r_c[0]) << " " << vpMath::deg(e_r_c[1]) << " "
+              << vpMath::deg(e_r_c[2]) << std::endl;
+
+    if (parser.save(eMc, opt_output, "eMc") != vpXmlParserHomogeneousMatrix::SEQUENCE_OK) {
+      std::cerr << "Cannot save eMc in " << opt_output << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::cout << "eMc saved in " << opt_output << std::endl;
+  }
+  catch(const vpException &e) {
+    std::cerr << "Caught exception: " << e.getMessage() << std::endl;
+    vpXmlParser::cleanup();
+    return EXIT_FAILURE;
+  }
+
+  vpXmlParser::cleanup();
+  return EXIT_SUCCESS;
+}
@@ -57,8 +57,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
+#include <vector>
 
 #include <visp/vpImage.h>
 #include <visp/vpImageIo.h>
@@ -77,9 +79,12 @@
 #include <visp/vpMeterPixelConversion.h>
 #include <visp/vpXmlParserCamera.h>
 #include <visp/vpXmlParserHomogeneousMatrix.h>
+#include <visp/vpTime.h>
+
+#include <vpGridDetector.h>
 
 // List of allowed command line options
-#define GETOPTARGS  "di:p:m:hf:g:n:s:c:w:x:z:"
+#define GETOPTARGS  "bdi:k:o:p:m:hf:g:n:r:s:t:c:w:x:z:"
 
 /*!
 
@@ -100,7 +105,8 @@
 void usage(const char *name, const char *badparam, std::string ipath,
            std::string &ppath, std::string &xml_ipath, std::string &camera_name,
 	   std::string &gridname,
-           double gray, double shapePrecision, double sizePrecision, unsigned first, unsigned nimages, unsigned step, double lambda)
+           double gray, double shapePrecision, double sizePrecision, unsigned first, unsigned nimages, unsigned step, double lambda,
+           std::string &germs, double max_residual, unsigned threads, std::string &xml_opath)
 {
   fprintf(stdout, "\n\
   Read images of a calibration pattern from the disk and \n\
@@ -113,6 +119,8 @@ SYNOPSIS\n\
      [-m <calibration grid name>] \n\
      [-g <gray level precision>] [-z <size precision>] [-w <shape precision>] [-f <first image>] \n\
      [-n <number of images>] [-s <step>] [-l lambda] \n\
+     [-b] [-k <germs file>] [-r <max residual>] [-t <threads>] \n\
+     [-o <xml calibration file name in output>] \n\
      [-c] [-d] [-h] \n\
  ", name);
 
@@ -184,11 +192,37 @@ SYNOPSIS\n\
      Disable the image display. This can be usefull \n\
      for automatic tests using crontab under Unix or \n\
      using the task manager under Windows.\n\
+\n\
+  -b                                             \n\
+     Batch mode: calibrate without display nor click.\n\
+     The dots of the images are extracted in parallel\n\
+     from germs, the positions of the 5 dots that are\n\
+     clicked in the interactive mode, read in the file\n\
+     \"<image>.txt\" saved by the interactive mode when\n\
+     a pose is validated, or in the file given with -k.\n\
+     The images whose reprojection residual is too\n\
+     large are rejected.\n\
+\n\
+  -k <germs file>                                      %s\n\
+     Batch mode: germs used for the images without\n\
+     their own \"<image>.txt\" file, one line \"u v\" per dot.\n\
+\n\
+  -r <max residual>                                    %f\n\
+     Batch mode: largest RMS reprojection error in\n\
+     pixels of an accepted image.\n\
+\n\
+  -t <threads>                                         %u\n\
+     Batch mode: number of threads, 0 for all the cores.\n\
+\n\
+  -o <xml calibration file name in output>             %s\n\
+     Batch mode: save the camera parameters with the\n\
+     name set with \"-c <camera name>\" option.\n\
 \n\
   -h\n\
      Print the help.\n\n",
 	 ipath.c_str(),ppath.c_str(), xml_ipath.c_str(), 
-	 camera_name.c_str(), gridname.c_str(), gray, shapePrecision, sizePrecision, first, nimages, step, lambda);
+	 camera_name.c_str(), gridname.c_str(), gray, shapePrecision, sizePrecision, first, nimages, step, lambda,
+	 germs.c_str(), max_residual, threads, xml_opath.c_str());
 
   if (badparam)
     fprintf(stdout, "\nERROR: Bad parameter [%s]\n", badparam);
@@ -219,14 +253,20 @@ bool getOptions(int argc, const char **argv, std::string &ipath, std::string &pp
                 std::string &xml_ipath, std::string &camera_name,
                 std::string &gridname, double &gray, double &shapePrecision, double &sizePrecision, unsigned &first,
                 unsigned &nimages, unsigned &step,
-                double &lambda, bool &display)
+                double &lambda, bool &display, bool &batch, std::string &germs,
+                double &max_residual, unsigned &threads, std::string &xml_opath)
 {
   const char *optarg;
   int c;
   while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg)) > 1) {
 
     switch (c) {
+    case 'b': batch = true; break;
     case 'd': display = false; break;
+    case 'k': germs = optarg; break;
+    case 'o': xml_opath = optarg; break;
+    case 'r': max_residual = atof(optarg); break;
+    case 't': threads = (unsigned) atoi(optarg); break;
     case 'i': ipath = optarg; break;
     case 'p': ppath = optarg; break;
     case 'x': xml_ipath = optarg; break;
@@ -240,12 +280,14 @@ bool getOptions(int argc, const char **argv, std::string &ipath, std::string &pp
     case 's': step = (unsigned) atoi(optarg); break;
     case 'l': lambda = atof(optarg); break;
     case 'h': usage(argv[0], NULL, ipath, ppath, xml_ipath, camera_name,
-                    gridname, gray, shapePrecision, sizePrecision, first, nimages, step, lambda);
+                    gridname, gray, shapePrecision, sizePrecision, first, nimages, step, lambda,
+                    germs, max_residual, threads, xml_opath);
       return false; break;
 
     default:
       usage(argv[0], optarg, ipath, ppath, xml_ipath, camera_name,
-            gridname, gray, shapePrecision, sizePrecision, first, nimages, step, lambda);
+            gridname, gray, shapePrecision, sizePrecision, first, nimages, step, lambda,
+            germs, max_residual, threads, xml_opath);
       return false; break;
     }
   }
@@ -253,7 +295,8 @@ bool getOptions(int argc, const char **argv, std::string &ipath, std::string &pp
   if ((c == 1) || (c == -1)) {
     // standalone param or error
     usage(argv[0], NULL, ipath, ppath, xml_ipath, camera_name,
-          gridname, gray, shapePrecision, sizePrecision, first, nimages, step, lambda);
+          gridname, gray, shapePrecision, sizePrecision, first, nimages, step, lambda,
+          germs, max_residual, threads, xml_opath);
     std::cerr << "ERROR: " << std::endl;
     std::cerr << "  Bad argument " << optarg << std::endl << std::endl;
     return false;
@@ -316,6 +359,173 @@ bool
   return(true);
 }
 
+/*!
+  Name of the image \e iter of the sequence: the ViSP calibration images in \e ipath, or the
+  images given with the -p option.
+*/
+std::string getImageFilename(const std::string &ipath, const std::string &ppath, unsigned iter)
+{
+  if (ppath.empty()) {
+    std::ostringstream s;
+    s << "grid36-" << std::setw(2) << std::setfill('0') << iter << ".pgm";
+    return ipath + vpIoTools::path("/ViSP-images/calibration/") + s.str();
+  }
+  char cfilename[FILENAME_MAX];
+  sprintf(cfilename, ppath.c_str(), iter);
+  return cfilename;
+}
+
+/*!
+  Calibrate without display nor click. The dots of all the images are extracted in parallel, the images
+  rejected by vpGridDetector are not used, and the images whose residual after the calibration is more
+  than 3 times the median residual are removed before a second calibration.
+*/
+int batchCalibration(const std::vector<std::string> &filenames, const vpGridDetector &detector,
+                     const std::string &germs_filename, const std::string &xml_ipath,
+                     const std::string &camera_name, const std::string &xml_opath,
+                     double lambda, unsigned threads)
+{
+  std::vector<vpImagePoint> germs;  // Germs of the images without their own file
+  if (! germs_filename.empty() && ! vpGridDetector::readGerms(germs_filename, germs)) {
+    std::cerr << "Cannot read germs file " << germs_filename << std::endl;
+    return(-1);
+  }
+
+  // Initial camera parameters from the size of the first image, or from a previous calibration
+  vpImage<unsigned char> I;
+  vpCameraParameters cam_init;
+  try {
+    vpImageIo::read(I, filenames[0]);
+  }
+  catch(...) {
+    std::cerr << "Cannot read " << filenames[0] << std::endl;
+    return(-1);
+  }
+  cam_init.initPersProjWithoutDistortion(600, 600, I.getWidth()/2, I.getHeight()/2);
+#ifdef VISP_HAVE_XML2
+  if (! xml_ipath.empty() && ! camera_name.empty()) {
+    vpXmlParserCamera p;
+    if (p.parse(cam_init, xml_ipath.c_str(), camera_name.c_str(), vpCameraParameters::perspectiveProjWithoutDistortion,
+                I.getWidth(), I.getHeight()) != vpXmlParserCamera::SEQUENCE_OK) {
+      std::cout << "Cannot find camera parameters of " << camera_name << " in " << xml_ipath << std::endl;
+      cam_init.initPersProjWithoutDistortion(600, 600, I.getWidth()/2, I.getHeight()/2);
+    }
+  }
+#endif
+  std::cout << "Initialise with camera parameters: " << cam_init << std::endl;
+
+  std::vector<vpGridDetector::vpDetection> detections;
+  double t = vpTime::measureTimeMs();
+  try {
+    detector.detect(filenames, germs, cam_init, threads, detections);
+  }
+  catch(const vpException &e) {
+    std::cerr << "Dot extraction failed: " << e.getMessage() << std::endl;
+    return(-1);
+  }
+  std::cout << "Dots extracted from " << filenames.size() << " images in " << vpTime::measureTimeMs() - t
+            << " ms" << std::endl;
+
+  std::vector<unsigned int> used;
+  for (unsigned int i=0; i < filenames.size(); i++) {
+    const vpGridDetector::vpDetection &detection = detections[i];
+    std::cout << filenames[i] << ": " << detection.nb_dots << " dots, " << detection.nb_outliers
+              << " outliers, residual " << detection.residual << " px";
+    if (detection.valid) {
+      used.push_back(i);
+      std::cout << std::endl;
+    }
+    else
+      std::cout << ", rejected: " << detection.error << std::endl;
+  }
+  if (used.empty()) {
+    std::cerr << "No image accepted" << std::endl;
+    return(-1);
+  }
+
+  vpCalibration::setLambda(lambda);
+  vpCameraParameters cam, cam_dist;
+  for (unsigned int pass=0; pass < 2; pass++) {
+    vpCalibration *table_cal = new vpCalibration[used.size()];
+    for (unsigned int i=0; i < used.size(); i++)
+      table_cal[i] = detections[used[i]].calib;
+    vpCameraParameters cam_tmp = cam_init;
+    t = vpTime::measureTimeMs();
+    vpCalibration::computeCalibrationMulti(vpCalibration::CALIB_VIRTUAL_VS_DIST, (unsigned int)used.size(),
+                                           table_cal, cam_tmp, false);
+    std::cout << "Calibration from " << used.size() << " images in " << vpTime::measureTimeMs() - t << " ms"
+              << std::endl;
+    cam = table_cal[0].cam;
+    cam_dist = table_cal[0].cam_dist;
+
+    std::vector<double> deviations(used.size());
+    for (unsigned int i=0; i < used.size(); i++) {
+      double deviation;
+      table_cal[i].computeStdDeviation(deviation, deviations[i]);
+      std::cout << "  " << filenames[used[i]] << ": deviation " << deviation << " px, with distortion "
+                << deviations[i] << " px" << std::endl;
+    }
+    delete [] table_cal;
+    if (pass == 1 || used.size() < 3)
+      break;
+
+    std::vector<double> sorted = deviations;
+    std::nth_element(sorted.begin(), sorted.begin() + sorted.size()/2, sorted.end());
+    double max_deviation = std::max(3 * sorted[sorted.size()/2], detector.getMaxResidual() / 2);
+    std::vector<unsigned int> kept;
+    for (unsigned int i=0; i < used.size(); i++) {
+      if (deviations[i] <= max_deviation)
+        kept.push_back(used[i]);
+      else
+        std::cout << "Reject " << filenames[used[i]] << ": deviation " << deviations[i] << " px" << std::endl;
+    }
+    if (kept.size() == used.size())
+      break;
+    used = kept;
+  }
+
+  std::cout << "Camera parameters for perspective projection without distortion:" << std::endl << cam << std::endl;
+  std::cout << "Camera parameters for perspective projection with distortion:" << std::endl << cam_dist << std::endl;
+
+#ifdef VISP_HAVE_XML2
+  if (! xml_opath.empty()) {
+    std::string name = camera_name.empty() ? "Camera" : camera_name;
+    vpXmlParserCamera parser;
+    parser.save(cam, xml_opath.c_str(), name, I.getWidth(), I.getHeight());
+    parser.save(cam_dist, xml_opath.c_str(), name, I.getWidth(), I.getHeight());
+    std::cout << "Camera parameters saved in " << xml_opath << std::endl;
+  }
+#endif
+  return 0;
+}
+
+/*!
+  Batch mode of both main(), with or without display: calibrate from the \e nimages images of the sequence
+  starting at \e first, see getImageFilename(), with the dots of the grid \e gridname.
+*/
+int batchCalibration(const std::string &ipath, const std::string &ppath, const std::string &gridname,
+                     double gray, double shapePrecision, double sizePrecision,
+                     unsigned first, unsigned nimages, unsigned step, double lambda,
+                     const std::string &germs_filename, double max_residual, unsigned threads,
+                     const std::string &xml_ipath, const std::string &camera_name, const std::string &xml_opath)
+{
+  try {
+    vpGridDetector detector;
+    detector.loadGrid(gridname);
+    detector.setDotPrecision(gray, shapePrecision, sizePrecision);
+    detector.setMaxResidual(max_residual);
+    std::vector<std::string> filenames;
+    for (unsigned i = 0; i < nimages; i++)
+      filenames.push_back(getImageFilename(ipath, ppath, first + i*step));
+    return batchCalibration(filenames, detector, germs_filename, xml_ipath, camera_name, xml_opath,
+                            lambda, threads);
+  }
+  catch(const vpException &e) {
+    std::cerr << e.getMessage() << std::endl;
+    return(-1);
+  }
+}
+
 #if (defined(VISP_HAVE_X11) || defined(VISP_HAVE_GTK) || defined(VISP_HAVE_GDI) || defined(VISP_HAVE_D3D9))
 
 typedef enum {
@@ -622,6 +832,11 @@ int main(int argc, const char ** argv)
   unsigned opt_step = 1;
   double opt_lambda = 0.5;
   bool opt_display = true;
+  bool opt_batch = false;
+  std::string opt_germs; // germs of the batch mode for the images without their own germs file
+  double opt_max_residual = 2.;
+  unsigned opt_threads = 0;
+  std::string opt_xml_opath;
   double dotSize;
 
   // Get the VISP_IMAGE_PATH environment variable value
@@ -637,7 +852,8 @@ int main(int argc, const char ** argv)
   if (getOptions(argc, argv, opt_ipath, opt_ppath, 
                  opt_xml_ipath, opt_camera_name,
                  opt_gridname, opt_gray, opt_shapePrecision, opt_sizePrecision,
-                 opt_first, opt_nimages, opt_step, opt_lambda, opt_display) == false) {
+                 opt_first, opt_nimages, opt_step, opt_lambda, opt_display,
+                 opt_batch, opt_germs, opt_max_residual, opt_threads, opt_xml_opath) == false) {
     return (-1);
   }
 
@@ -665,7 +881,7 @@ int main(int argc, const char ** argv)
   if (opt_ipath.empty() && env_ipath.empty() && opt_ppath.empty() ){
     usage(argv[0], NULL, ipath, opt_ppath, opt_xml_ipath, opt_camera_name,
           opt_gridname,opt_gray, opt_shapePrecision, opt_sizePrecision, opt_first,
-          opt_nimages, opt_step, opt_lambda);
+          opt_nimages, opt_step, opt_lambda, opt_germs, opt_max_residual, opt_threads, opt_xml_opath);
     std::cerr << std::endl
 	      << "ERROR:" << std::endl;
     std::cerr << "  Use -i <visp image path> option or set VISP_INPUT_IMAGE_PATH "
@@ -679,6 +895,11 @@ int main(int argc, const char ** argv)
     return(-1);
   }
 
+  if (opt_batch)
+    return batchCalibration(ipath, opt_ppath, opt_gridname, opt_gray, opt_shapePrecision, opt_sizePrecision,
+                            opt_first, opt_nimages, opt_step, opt_lambda, opt_germs, opt_max_residual, opt_threads,
+                            opt_xml_ipath, opt_camera_name, opt_xml_opath);
+
   // Declare an image, this is a gray level image (unsigned char)
   // it size is not defined yet, it will be defined when the image will
   // read on the disk
@@ -1181,6 +1402,18 @@ int main(int argc, const char ** argv)
 
       switch(state){
       case valid_pose :
+        {
+          // Germs for the batch mode
+          std::vector<vpImagePoint> germs;
+          for (unsigned int i=0 ; i < nptPose ; i++)
+            germs.push_back(d[i].getCog());
+          try {
+            vpGridDetector::saveGerms(filename_out, germs);
+          }
+          catch(...) {
+            std::cout << "Cannot save the germs in " << filename_out << std::endl;
+          }
+        }
         break;
       case dont_care : 
         table_use[niter] = false;
@@ -1462,9 +1695,34 @@ int main(int argc, const char ** argv)
 #else // (defined (VISP_HAVE_GTK) || defined(VISP_HAVE_GDI)...)
 
 int
-    main()
+    main(int argc, const char ** argv)
 {
-  vpTRACE("X11 or GTK or GDI or D3D functionnality is not available...") ;
-  return 0;
+  std::string ipath, opt_ipath, opt_ppath, opt_xml_ipath, opt_camera_name, opt_germs, opt_xml_opath;
+  std::string opt_gridname = "/tmp/mire3p.dat";
+  double opt_gray = 0.8, opt_shapePrecision = 0.65, opt_sizePrecision = 0.5, opt_lambda = 0.5;
+  double opt_max_residual = 2.;
+  unsigned opt_first = 1, opt_nimages = 4, opt_step = 1, opt_threads = 0;
+  bool opt_display = false, opt_batch = false;
+
+  char *ptenv = getenv("VISP_INPUT_IMAGE_PATH");
+  if (ptenv != NULL)
+    ipath = ptenv;
+  if (getOptions(argc, argv, opt_ipath, opt_ppath, opt_xml_ipath, opt_camera_name,
+                 opt_gridname, opt_gray, opt_shapePrecision, opt_sizePrecision,
+                 opt_first, opt_nimages, opt_step, opt_lambda, opt_display,
+                 opt_batch, opt_germs, opt_max_residual, opt_threads, opt_xml_opath) == false) {
+    return (-1);
+  }
+  if (!opt_ipath.empty())
+    ipath = opt_ipath;
+
+  // Only the batch mode is available without display
+  if (! opt_batch) {
+    vpTRACE("X11 or GTK or GDI or D3D functionnality is not available, use -b for the batch mode...") ;
+    return 0;
+  }
+  return batchCalibration(ipath, opt_ppath, opt_gridname, opt_gray, opt_shapePrecision, opt_sizePrecision,
+                          opt_first, opt_nimages, opt_step, opt_lambda, opt_germs, opt_max_residual, opt_threads,
+                          opt_xml_ipath, opt_camera_name, opt_xml_opath);
 }
 #endif // (defined (VISP_HAVE_GTK) || defined(VISP_HAVE_GDI)...)
@@ -0,0 +1,84 @@
+/**
+ *
+ * Consumer of the frame bus: track a QR code in the frames published by frame_bus_producer, processing them
+ * in place in the shared memory, and print the tracking rate and the number of frames skipped because the
+ * tracker was slower than the camera. Several consumers can run at the same time on the same bus.
+ *
+ * Usage: ./frame_bus_consumer [--name <shared memory name>] [--qrcode-size <size in m>] [--duration <s>]
+ *
+ */
+
+#include <stdlib.h>
+#include <iostream>
+#include <string>
+
+#include <visp/vpImage.h>
+#include <visp/vpPoseVector.h>
+#include <visp/vpTime.h>
+
+#include <vpFrameBus.h>
+#include <vpQRCodeTracker.h>
+
+
+int main(int argc, const char* argv[])
+{
+  std::string opt_name = "/romeo_tk_frames";
+  double opt_qrcode_size = 0.045;
+  double opt_duration = 0;
+
+  for (int i=1; i < argc; i++) {
+    if (std::string(argv[i]) == "--name" && i+1 < argc)
+      opt_name = argv[++i];
+    else if (std::string(argv[i]) == "--qrcode-size" && i+1 < argc)
+      opt_qrcode_size = atof(argv[++i]);
+    else if (std::string(argv[i]) == "--duration" && i+1 < argc)
+      opt_duration = atof(argv[++i]);
+    else if (std::string(argv[i]) == "--help") {
+      std::cout << "Usage: " << argv[0] << " [--name <shared memory name>] [--qrcode-size <size in m>]"
+                << " [--duration <s>] [--help]" << std::endl;
+      return 0;
+    }
+  }
+
+  try {
+    vpFrameBus bus;
+    bus.open(opt_name);
+    std::cout << "Reading " << bus.getWidth() << "x" << bus.getHeight() << "x" << bus.getChannels()
+              << " frames from " << opt_name << std::endl;
+
+    vpQRCodeTracker qrcode_tracker;
+    qrcode_tracker.setCameraParameters(bus.getCameraParameters());
+    qrcode_tracker.setQRCodeSize(opt_qrcode_size);
+
+    vpImage<unsigned char> I;
+    double t_start = vpTime::measureTimeMs();
+    while (opt_duration <= 0 || vpTime::measureTimeMs() - t_start < 1000. * opt_duration) {
+      if (! bus.beginRead(1000.)) {
+        double heartbeat_age = (vpTime::measureTimeMicros() - (double)bus.getHeartbeat()) / 1000.;
+        std::cout << "No frame from the producer since " << heartbeat_age << " ms" << std::endl;
+        continue;
+      }
+      bus.getImage(I);
+      qrcode_tracker.setTimestamp(bus.getTimestamp());
+      bool found = qrcode_tracker.track(I);
+      if (! bus.endRead())
+        continue; // The producer reused the slot during the tracking: the result is not reliable
+
+      if (bus.getNbRead() % 30 == 0) {
+        std::cout << "Frame " << bus.getFrameNumber() << ": ";
+        if (found)
+          std::cout << "cMo " << vpPoseVector(qrcode_tracker.get_cMo()).t() << std::endl;
+        else
+          std::cout << "no QR code" << std::endl;
+        std::cout << "  " << 1000. * bus.getNbRead() / (vpTime::measureTimeMs() - t_start) << " fps, "
+                  << bus.getNbSkipped() << " skipped, " << bus.getNbOverwritten() << " overwritten" << std::endl;
+      }
+    }
+  }
+  catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
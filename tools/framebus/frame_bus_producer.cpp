@@ -0,0 +1,116 @@
+/**
+ *
+ * Producer of the frame bus: acquire the images of one camera and publish them in a ring of shared memory
+ * slots, that any number of consumer processes read with vpFrameBus (see frame_bus_consumer). The image is
+ * converted once, directly in the slot, whatever the number of consumers.
+ *
+ * Without robot, a sequence recorded with record_sequence is replayed in loop at its recorded speed.
+ *
+ * Usage: ./frame_bus_producer [--ip <robot ip>] [--camera <camera id>] [--input <sequence file>]
+ *                             [--name <shared memory name>] [--slots <number of slots>] [--gray]
+ *                             [--frames <number of frames>]
+ *
+ * Stop it with Ctrl-C: the shared memory segment is then removed.
+ *
+ */
+
+#include <signal.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string>
+
+#include <alerror/alerror.h>
+
+#include <opencv2/core/core.hpp>
+
+#include <visp/vpTime.h>
+
+#include <vpFrameBus.h>
+#include <vpPerceptionSource.h>
+
+static volatile sig_atomic_t s_stop = 0;
+
+void stopHandler(int)
+{
+  s_stop = 1;
+}
+
+int main(int argc, const char* argv[])
+{
+  std::string opt_ip = "198.18.0.1";
+  int opt_camera = 0;
+  std::string opt_input;
+  std::string opt_name = "/romeo_tk_frames";
+  unsigned int opt_slots = 4;
+  bool opt_gray = false;
+  unsigned long opt_frames = 0;
+
+  for (int i=1; i < argc; i++) {
+    if (std::string(argv[i]) == "--ip" && i+1 < argc)
+      opt_ip = argv[++i];
+    else if (std::string(argv[i]) == "--camera" && i+1 < argc)
+      opt_camera = atoi(argv[++i]);
+    else if (std::string(argv[i]) == "--input" && i+1 < argc)
+      opt_input = argv[++i];
+    else if (std::string(argv[i]) == "--name" && i+1 < argc)
+      opt_name = argv[++i];
+    else if (std::string(argv[i]) == "--slots" && i+1 < argc)
+      opt_slots = (unsigned int)atoi(argv[++i]);
+    else if (std::string(argv[i]) == "--gray")
+      opt_gray = true;
+    else if (std::string(argv[i]) == "--frames" && i+1 < argc)
+      opt_frames = (unsigned long)atol(argv[++i]);
+    else if (std::string(argv[i]) == "--help") {
+      std::cout << "Usage: " << argv[0] << " [--ip <robot ip>] [--camera <camera id>] [--input <sequence file>]" << std::endl;
+      std::cout << "       [--name <shared memory name>] [--slots <number of slots>] [--gray] [--frames <number of frames>] [--help]" << std::endl;
+      std::cout << "Without --input the images come from the robot. With --gray only the gray images are published." << std::endl;
+      std::cout << "Stop with Ctrl-C." << std::endl;
+      return 0;
+    }
+  }
+
+  try {
+    vpPerceptionSource source(opt_ip, opt_camera, opt_input);
+    vpCameraParameters cam_without = source.getCameraParameters(vpCameraParameters::perspectiveProjWithoutDistortion);
+    vpCameraParameters cam_with = source.getCameraParameters(vpCameraParameters::perspectiveProjWithDistortion);
+    unsigned int width = source.getWidth();
+    unsigned int height = source.getHeight();
+    unsigned int channels = source.getChannels();
+    if (opt_gray)
+      channels = 1;
+
+    vpFrameBus bus;
+    bus.create(opt_name, width, height, channels, opt_slots, cam_without, cam_with);
+    signal(SIGINT, stopHandler);
+    signal(SIGTERM, stopHandler);
+    std::cout << "Publishing " << width << "x" << height << "x" << channels << " frames in " << opt_name
+              << " (" << bus.getNbSlots() << " slots)" << std::endl;
+
+    cv::Mat cvI;
+    unsigned long frame = 0;
+    double t_start = vpTime::measureTimeMs();
+    while (! s_stop && (opt_frames == 0 || frame < opt_frames)) {
+      double timestamp;
+      if (! source.acquire(cvI, timestamp))
+        break;
+      // The only conversion of the frame, written in place in the next slot
+      bus.write(cvI, timestamp);
+      frame ++;
+
+      if (frame % 300 == 0)
+        std::cout << frame << " frames, " << 1000. * frame / (vpTime::measureTimeMs() - t_start) << " fps" << std::endl;
+    }
+    bus.close();
+    std::cout << "Published " << frame << " frames" << std::endl;
+  }
+  catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+  catch (const AL::ALError &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
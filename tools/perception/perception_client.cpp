@@ -0,0 +1,95 @@
+/**
+ *
+ * Client of perception_daemon: print the latest results published in the shared memory segment, with their
+ * age, i.e. the time elapsed since the capture of the frame they were computed on.
+ *
+ * Usage: ./perception_client [--name <shared memory name>] [--target <face|qrcode|blobs|box>] [--rate <Hz>]
+ *                            [--duration <s>]
+ *
+ */
+
+#include <stdlib.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <visp/vpPoseVector.h>
+#include <visp/vpTime.h>
+
+#include <vpPerceptionResults.h>
+
+
+int main(int argc, const char* argv[])
+{
+  std::string opt_name = "/romeo_tk_perception";
+  std::vector<vpPerceptionResults::target_t> opt_targets;
+  double opt_rate = 10;
+  double opt_duration = 0;
+
+  for (int i=1; i < argc; i++) {
+    if (std::string(argv[i]) == "--name" && i+1 < argc)
+      opt_name = argv[++i];
+    else if (std::string(argv[i]) == "--target" && i+1 < argc) {
+      std::string name = argv[++i];
+      for (int t=0; t < vpPerceptionResults::nbTargets; t++)
+        if (name == vpPerceptionResults::getTargetName((vpPerceptionResults::target_t)t))
+          opt_targets.push_back((vpPerceptionResults::target_t)t);
+    }
+    else if (std::string(argv[i]) == "--rate" && i+1 < argc)
+      opt_rate = atof(argv[++i]);
+    else if (std::string(argv[i]) == "--duration" && i+1 < argc)
+      opt_duration = atof(argv[++i]);
+    else if (std::string(argv[i]) == "--help") {
+      std::cout << "Usage: " << argv[0] << " [--name <shared memory name>] [--target <face|qrcode|blobs|box>]"
+                << " [--rate <Hz>] [--duration <s>] [--help]" << std::endl;
+      return 0;
+    }
+  }
+  if (opt_targets.empty())
+    for (int t=0; t < vpPerceptionResults::nbTargets; t++)
+      opt_targets.push_back((vpPerceptionResults::target_t)t);
+  if (opt_rate <= 0)
+    opt_rate = 10;
+
+  try {
+    vpPerceptionResults results;
+    results.open(opt_name);
+    std::cout << "Reading " << opt_name << " published by process " << results.getPublisherPid() << std::endl;
+
+    std::vector<unsigned long> sequence_prev(vpPerceptionResults::nbTargets, 0);
+    vpPerceptionResults::vpResult result;
+    double t_start = vpTime::measureTimeMs();
+    while (opt_duration <= 0 || vpTime::measureTimeMs() - t_start < 1000. * opt_duration) {
+      double t = vpTime::measureTimeMs();
+
+      double heartbeat_age = (vpTime::measureTimeMicros() - (double)results.getHeartbeat()) / 1000.;
+      if (heartbeat_age > 1000.)
+        std::cout << "No update from the daemon since " << heartbeat_age << " ms" << std::endl;
+
+      for (size_t i=0; i < opt_targets.size(); i++) {
+        vpPerceptionResults::target_t target = opt_targets[i];
+        unsigned long sequence;
+        if (! results.read(target, result, sequence) || sequence == sequence_prev[target])
+          continue;
+        sequence_prev[target] = sequence;
+
+        std::cout << vpPerceptionResults::getTargetName(target) << " frame " << result.frame
+                  << " age " << 1000. * (vpTime::measureTimeSecond() - result.timestamp) << " ms: ";
+        if (! result.found)
+          std::cout << "not found" << std::endl;
+        else if (target == vpPerceptionResults::face)
+          std::cout << "bbox " << result.bbox[0] << " " << result.bbox[1] << " " << result.bbox[2] << " " << result.bbox[3] << std::endl;
+        else
+          std::cout << "cMo " << vpPoseVector(vpPerceptionResults::get_cMo(result)).t() << std::endl;
+      }
+      vpTime::wait(t, 1000. / opt_rate);
+    }
+    std::cout << results.getNbRetries() << " read(s) retried while the daemon was writing" << std::endl;
+  }
+  catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,236 @@
+/**
+ *
+ * Perception service: open the camera once, keep the trackers of romeo_tk loaded and publish their latest
+ * results (face bounding box, QR code pose, blob target pose, box pose) in a shared memory segment, that
+ * any number of client processes can read with vpPerceptionResults (see perception_client).
+ *
+ * Without robot, a sequence recorded with record_sequence is replayed in loop at its recorded speed.
+ *
+ * Usage: ./perception_daemon [--ip <robot ip>] [--camera <camera id>] [--input <sequence file>]
+ *                            [--name <shared memory name>] [--data-folder <folder>] [--frames <number of frames>]
+ *                            [--face] [--qrcode] [--qrcode-size <size in m>] [--blobs <chain name>] [--box <box name>]
+ *
+ * Stop it with Ctrl-C: the shared memory segment is then removed.
+ *
+ */
+
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <alerror/alerror.h>
+
+#include <opencv2/core/core.hpp>
+
+#include <visp/vpImage.h>
+#include <visp/vpPoint.h>
+#include <visp/vpTime.h>
+
+#include <vpBlobsTargetTracker.h>
+#include <vpFaceTracker.h>
+#include <vpMbLocalization.h>
+#include <vpPerceptionResults.h>
+#include <vpPerceptionSource.h>
+#include <vpQRCodeTracker.h>
+#include <vpRomeoTkConfig.h>
+
+static volatile sig_atomic_t s_stop = 0;
+
+void stopHandler(int)
+{
+  s_stop = 1;
+}
+
+/*!
+  Clear the result of a target before its tracking, so that no field of another target or of a previous frame
+  is published with it.
+ */
+void resetResult(vpPerceptionResults::vpResult &result, unsigned long frame, double timestamp)
+{
+  memset(&result, 0, sizeof(result));
+  result.frame = frame;
+  result.timestamp = timestamp;
+}
+
+int main(int argc, const char* argv[])
+{
+  std::string opt_ip = "198.18.0.1";
+  int opt_camera = 0;
+  std::string opt_input;
+  std::string opt_name = "/romeo_tk_perception";
+  std::string opt_data_folder = std::string(ROMEOTK_DATA_FOLDER);
+  unsigned long opt_frames = 0;
+  bool opt_face = false;
+  bool opt_qrcode = false;
+  double opt_qrcode_size = 0.045;
+  std::string opt_blobs;
+  std::string opt_box;
+
+  for (int i=1; i < argc; i++) {
+    if (std::string(argv[i]) == "--ip" && i+1 < argc)
+      opt_ip = argv[++i];
+    else if (std::string(argv[i]) == "--camera" && i+1 < argc)
+      opt_camera = atoi(argv[++i]);
+    else if (std::string(argv[i]) == "--input" && i+1 < argc)
+      opt_input = argv[++i];
+    else if (std::string(argv[i]) == "--name" && i+1 < argc)
+      opt_name = argv[++i];
+    else if (std::string(argv[i]) == "--data-folder" && i+1 < argc)
+      opt_data_folder = argv[++i];
+    else if (std::string(argv[i]) == "--frames" && i+1 < argc)
+      opt_frames = (unsigned long)atol(argv[++i]);
+    else if (std::string(argv[i]) == "--face")
+      opt_face = true;
+    else if (std::string(argv[i]) == "--qrcode")
+      opt_qrcode = true;
+    else if (std::string(argv[i]) == "--qrcode-size" && i+1 < argc)
+      opt_qrcode_size = atof(argv[++i]);
+    else if (std::string(argv[i]) == "--blobs" && i+1 < argc)
+      opt_blobs = argv[++i];
+    else if (std::string(argv[i]) == "--box" && i+1 < argc)
+      opt_box = argv[++i];
+    else if (std::string(argv[i]) == "--help") {
+      std::cout << "Usage: " << argv[0] << " [--ip <robot ip>] [--camera <camera id>] [--input <sequence file>]" << std::endl;
+      std::cout << "       [--name <shared memory name>] [--data-folder <folder>] [--frames <number of frames>]" << std::endl;
+      std::cout << "       [--face] [--qrcode] [--qrcode-size <size in m>] [--blobs <chain name>] [--box <box name>] [--help]" << std::endl;
+      std::cout << "Without --input the images come from the robot. Stop with Ctrl-C." << std::endl;
+      return 0;
+    }
+  }
+
+  if (! opt_face && ! opt_qrcode && opt_blobs.empty() && opt_box.empty()) {
+    std::cout << "No tracker enabled: use --face, --qrcode, --blobs <chain name> or --box <box name>" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  vpFaceTracker *face_tracker = NULL;
+  vpQRCodeTracker *qrcode_tracker = NULL;
+  vpBlobsTargetTracker *blobs_tracker = NULL;
+  vpMbLocalization *box_tracker = NULL;
+  int status = EXIT_SUCCESS;
+
+  try {
+    vpPerceptionSource source(opt_ip, opt_camera, opt_input);
+    vpCameraParameters cam = source.getCameraParameters();
+    vpImage<unsigned char> I(source.getHeight(), source.getWidth());
+    cv::Mat cvI;
+
+    // Load all the models once
+    double t_load = vpTime::measureTimeMs();
+    if (opt_face) {
+      face_tracker = new vpFaceTracker;
+      face_tracker->setFaceCascade(opt_data_folder + "/face/haarcascade_frontalface_alt.xml");
+    }
+    if (opt_qrcode) {
+      qrcode_tracker = new vpQRCodeTracker;
+      qrcode_tracker->setCameraParameters(cam);
+      qrcode_tracker->setQRCodeSize(opt_qrcode_size);
+    }
+    if (! opt_blobs.empty()) {
+      if (! source.hasColor())
+        throw vpException(vpException::badValue, "The blob tracker needs color images");
+      const double L = 0.025/2;
+      std::vector<vpPoint> points(4);
+      points[2].setWorldCoordinates(-L, -L, 0);
+      points[1].setWorldCoordinates(-L,  L, 0);
+      points[0].setWorldCoordinates( L,  L, 0);
+      points[3].setWorldCoordinates( L, -L, 0);
+      blobs_tracker = new vpBlobsTargetTracker;
+      blobs_tracker->setName(opt_blobs);
+      blobs_tracker->setCameraParameters(cam);
+      blobs_tracker->setPoints(points);
+      blobs_tracker->getOverlay().setMode(vpOverlay::headless);
+      std::string filename = opt_data_folder + "/target/" + opt_blobs + "/color.txt";
+      if (! blobs_tracker->loadHSV(filename))
+        throw vpException(vpException::ioError, "Cannot load %s", filename.c_str());
+    }
+    if (! opt_box.empty()) {
+      std::string box_folder = opt_data_folder + "/objects/" + opt_box + "/";
+      box_tracker = new vpMbLocalization(box_folder + "model/" + opt_box, box_folder + "detection/", cam);
+      box_tracker->initDetection(box_folder + "detection/learning/20/learning_data.bin");
+      box_tracker->getOverlay().setMode(vpOverlay::headless);
+    }
+    std::cout << "Trackers loaded in " << vpTime::measureTimeMs() - t_load << " ms" << std::endl;
+
+    vpPerceptionResults results;
+    results.create(opt_name);
+    signal(SIGINT, stopHandler);
+    signal(SIGTERM, stopHandler);
+    std::cout << "Publishing in " << opt_name << std::endl;
+
+    vpPerceptionResults::vpResult result;
+    unsigned long frame = 0;
+    double t_start = vpTime::measureTimeMs();
+    while (! s_stop && (opt_frames == 0 || frame < opt_frames)) {
+      double timestamp;
+      if (! source.acquire(cvI, I, timestamp))
+        break;
+      frame ++;
+
+      if (face_tracker) {
+        resetResult(result, frame, timestamp);
+        face_tracker->setTimestamp(timestamp);
+        result.found = face_tracker->track(I) ? 1 : 0;
+        if (result.found) {
+          vpRect face = face_tracker->getFace();
+          vpPerceptionResults::setBBox(result, face);
+          vpPerceptionResults::setCog(result, face.getCenter());
+        }
+        results.publish(vpPerceptionResults::face, result);
+      }
+      if (qrcode_tracker) {
+        resetResult(result, frame, timestamp);
+        qrcode_tracker->setTimestamp(timestamp);
+        result.found = qrcode_tracker->track(I) ? 1 : 0;
+        if (result.found) {
+          vpPerceptionResults::set_cMo(result, qrcode_tracker->get_cMo());
+          vpPerceptionResults::setCog(result, qrcode_tracker->getCog());
+        }
+        results.publish(vpPerceptionResults::qrcode, result);
+      }
+      if (blobs_tracker) {
+        resetResult(result, frame, timestamp);
+        blobs_tracker->setTimestamp(timestamp);
+        result.found = blobs_tracker->track(cvI, I) ? 1 : 0;
+        if (result.found) {
+          vpPerceptionResults::set_cMo(result, blobs_tracker->get_cMo());
+          vpPerceptionResults::setCog(result, blobs_tracker->getCog());
+        }
+        results.publish(vpPerceptionResults::blobs, result);
+      }
+      if (box_tracker) {
+        resetResult(result, frame, timestamp);
+        box_tracker->setTimestamp(timestamp);
+        result.found = box_tracker->track(I) ? 1 : 0;
+        if (result.found) {
+          vpPerceptionResults::set_cMo(result, box_tracker->get_cMo());
+          vpPerceptionResults::setCog(result, box_tracker->get_cog());
+        }
+        results.publish(vpPerceptionResults::box, result);
+      }
+      results.heartbeat();
+
+      if (frame % 300 == 0)
+        std::cout << frame << " frames, " << 1000. * frame / (vpTime::measureTimeMs() - t_start) << " fps" << std::endl;
+    }
+    results.close();
+    std::cout << "Published the results of " << frame << " frames" << std::endl;
+  }
+  catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    status = EXIT_FAILURE;
+  }
+  catch (const AL::ALError &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    status = EXIT_FAILURE;
+  }
+
+  delete face_tracker;
+  delete qrcode_tracker;
+  delete blobs_tracker;
+  delete box_tracker;
+  return status;
+}
@@ -0,0 +1,121 @@
+/**
+ *
+ * Record a sequence from a camera of the robot, with the capture timestamps, the camera parameters, eMc and
+ * the joint positions of a chain. The sequence can then be replayed with vpReplayGrabber, for example with
+ * replay_sequence, to run the trackers without a robot.
+ *
+ * Usage: ./record_sequence [--ip <robot ip>] [--camera <camera id>] [--chain <chain name>] [--color]
+ *                          [--frames <number of frames>] [--output <sequence file>] [--no-display]
+ *
+ */
+
+#include <stdlib.h>
+#include <iostream>
+#include <string>
+
+#include <alerror/alerror.h>
+
+#include <visp/vpDisplayX.h>
+#include <visp/vpImageConvert.h>
+
+#include <visp_naoqi/vpNaoqiGrabber.h>
+#include <visp_naoqi/vpNaoqiRobot.h>
+
+#include <vpSequenceRecorder.h>
+
+
+int main(int argc, const char* argv[])
+{
+  std::string opt_ip = "198.18.0.1";
+  std::string opt_chain = "Head";
+  std::string opt_output = "sequence.bin";
+  int opt_camera = 0;
+  unsigned int opt_frames = 0;
+  bool opt_color = false;
+  bool opt_display = true;
+
+  for (int i=1; i < argc; i++) {
+    if (std::string(argv[i]) == "--ip" && i+1 < argc)
+      opt_ip = argv[++i];
+    else if (std::string(argv[i]) == "--camera" && i+1 < argc)
+      opt_camera = atoi(argv[++i]);
+    else if (std::string(argv[i]) == "--chain" && i+1 < argc)
+      opt_chain = argv[++i];
+    else if (std::string(argv[i]) == "--frames" && i+1 < argc)
+      opt_frames = (unsigned int)atoi(argv[++i]);
+    else if (std::string(argv[i]) == "--output" && i+1 < argc)
+      opt_output = argv[++i];
+    else if (std::string(argv[i]) == "--color")
+      opt_color = true;
+    else if (std::string(argv[i]) == "--no-display")
+      opt_display = false;
+    else if (std::string(argv[i]) == "--help") {
+      std::cout << "Usage: " << argv[0] << " [--ip <robot ip>] [--camera <camera id>] [--chain <chain name>] [--color]"
+                << " [--frames <number of frames>] [--output <sequence file>] [--no-display] [--help]" << std::endl;
+      std::cout << "Records until the number of frames is reached or a click in the image." << std::endl;
+      return 0;
+    }
+  }
+
+  try {
+    vpNaoqiGrabber g;
+    g.setRobotIp(opt_ip);
+    g.setCamera(opt_camera);
+    g.open();
+
+    vpNaoqiRobot robot;
+    robot.setRobotIp(opt_ip);
+    robot.open();
+
+    vpSequenceRecorder recorder;
+    recorder.setJointNames(robot.getBodyNames(opt_chain));
+    recorder.open(opt_output, g.getWidth(), g.getHeight(), opt_color ? 3 : 1,
+                  g.getCameraParameters(vpCameraParameters::perspectiveProjWithDistortion),
+                  g.get_eMc(vpCameraParameters::perspectiveProjWithoutDistortion),
+                  g.get_eMc(vpCameraParameters::perspectiveProjWithDistortion));
+
+    vpImage<unsigned char> I(g.getHeight(), g.getWidth());
+    cv::Mat cvI;
+    vpDisplayX d;
+    if (opt_display) {
+      d.init(I);
+      vpDisplay::setTitle(I, "Recording");
+    }
+
+    while (opt_frames == 0 || recorder.getNbFrames() < opt_frames) {
+      double t;
+      if (opt_color) {
+        g.acquire(cvI);
+        t = vpTime::measureTimeSecond();
+        recorder.record(cvI, t, robot.getPosition(recorder.getJointNames()));
+        if (opt_display)
+          vpImageConvert::convert(cvI, I);
+      }
+      else {
+        g.acquire(I);
+        t = vpTime::measureTimeSecond();
+        recorder.record(I, t, robot.getPosition(recorder.getJointNames()));
+      }
+
+      if (opt_display) {
+        vpDisplay::display(I);
+        vpDisplay::displayText(I, 10, 10, "Click to stop recording", vpColor::red);
+        vpDisplay::flush(I);
+        if (vpDisplay::getClick(I, false))
+          break;
+      }
+    }
+    recorder.close();
+    std::cout << "Recorded " << recorder.getNbFrames() << " frames in " << opt_output << std::endl;
+  }
+  catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+  catch (const AL::ALError &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,86 @@
+/**
+ *
+ * Replay a sequence recorded with record_sequence and track a QR code in it, printing the tracking rate.
+ * By default the frames are replayed at the recorded speed, use --fast to replay them as fast as possible.
+ *
+ * Usage: ./replay_sequence [--input <sequence file>] [--fast] [--loop] [--no-display]
+ *
+ */
+
+#include <stdlib.h>
+#include <iostream>
+#include <string>
+
+#include <visp/vpDisplayX.h>
+
+#include <vpQRCodeTracker.h>
+#include <vpReplayGrabber.h>
+
+
+int main(int argc, const char* argv[])
+{
+  std::string opt_input = "sequence.bin";
+  bool opt_fast = false;
+  bool opt_loop = false;
+  bool opt_display = true;
+
+  for (int i=1; i < argc; i++) {
+    if (std::string(argv[i]) == "--input" && i+1 < argc)
+      opt_input = argv[++i];
+    else if (std::string(argv[i]) == "--fast")
+      opt_fast = true;
+    else if (std::string(argv[i]) == "--loop")
+      opt_loop = true;
+    else if (std::string(argv[i]) == "--no-display")
+      opt_display = false;
+    else if (std::string(argv[i]) == "--help") {
+      std::cout << "Usage: " << argv[0] << " [--input <sequence file>] [--fast] [--loop] [--no-display] [--help]" << std::endl;
+      return 0;
+    }
+  }
+
+  try {
+    vpReplayGrabber g;
+    g.open(opt_input);
+    g.setRealTime(! opt_fast);
+    g.setLoop(opt_loop);
+    std::cout << "Replay " << g.getNbFrames() << " frames of " << g.getWidth() << "x" << g.getHeight() << std::endl;
+
+    vpImage<unsigned char> I(g.getHeight(), g.getWidth());
+    vpDisplayX d;
+    vpQRCodeTracker qrcode_tracker;
+    qrcode_tracker.setCameraParameters(g.getCameraParameters(vpCameraParameters::perspectiveProjWithoutDistortion));
+    qrcode_tracker.setQRCodeSize(0.045);
+    if (opt_display) {
+      d.init(I);
+      vpDisplay::setTitle(I, "Replay");
+    }
+
+    unsigned int nb_frames = 0, nb_tracked = 0;
+    double t_start = vpTime::measureTimeMs();
+    while (g.acquire(I)) {
+      if (opt_display)
+        vpDisplay::display(I);
+
+      qrcode_tracker.setTimestamp(g.getTimestamp());
+      if (qrcode_tracker.track(I))
+        nb_tracked ++;
+      nb_frames ++;
+
+      if (opt_display) {
+        vpDisplay::flush(I);
+        if (vpDisplay::getClick(I, false))
+          break;
+      }
+    }
+    double t = vpTime::measureTimeMs() - t_start;
+    std::cout << nb_frames << " frames (" << nb_tracked << " tracked) in " << t << " ms: "
+              << 1000. * nb_frames / t << " frames/s" << std::endl;
+  }
+  catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
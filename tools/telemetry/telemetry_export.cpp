@@ -0,0 +1,129 @@
+/**
+ *
+ * Export to CSV or plot a telemetry file recorded with vpTelemetryRecorder.
+ *
+ */
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <visp/vpDisplay.h>
+#include <visp/vpPlot.h>
+
+#include <vpTelemetryLog.h>
+
+
+int main(int argc, const char* argv[])
+{
+  std::string opt_input;
+  std::string opt_output;
+  std::vector<std::string> opt_channels;
+  bool opt_plot = false;
+  bool opt_list = false;
+
+  for (int i=1; i<argc; i++) {
+    if (std::string(argv[i]) == "--input" && i+1 < argc)
+      opt_input = argv[++i];
+    else if (std::string(argv[i]) == "--output" && i+1 < argc)
+      opt_output = argv[++i];
+    else if (std::string(argv[i]) == "--channel" && i+1 < argc)
+      opt_channels.push_back(argv[++i]);
+    else if (std::string(argv[i]) == "--plot")
+      opt_plot = true;
+    else if (std::string(argv[i]) == "--list")
+      opt_list = true;
+    else if (std::string(argv[i]) == "--help") {
+      std::cout << "Usage: " << argv[0] << " --input <telemetry file> [--output <csv file>] [--channel <name>] [--plot] [--list] [--help]" << std::endl;
+      std::cout << "  Without --output and --plot, the CSV is written to the standard output." << std::endl;
+      std::cout << "  --channel can be repeated to select the exported or plotted channels (4 plotted channels at most)." << std::endl;
+      return 0;
+    }
+  }
+
+  if (opt_input.empty()) {
+    std::cout << "Error: use --input to give the telemetry file. Run \"" << argv[0] << " --help\" to get all the options." << std::endl;
+    return 0;
+  }
+
+  try {
+    vpTelemetryLog log;
+    log.open(opt_input);
+
+    if (opt_list) {
+      std::cout << log.getNbRecords() << " records" << std::endl;
+      for (unsigned int i=0; i < log.getNbChannels(); i++)
+        std::cout << "  " << log.getChannelName(i) << " (" << log.getChannelSize(i) << " values)" << std::endl;
+      return 0;
+    }
+
+    std::vector<unsigned int> channels;
+    for (size_t i=0; i < opt_channels.size(); i++) {
+      int ch = log.getChannel(opt_channels[i]);
+      if (ch < 0) {
+        std::cout << "Error: no channel named " << opt_channels[i] << " in " << opt_input << std::endl;
+        return 0;
+      }
+      channels.push_back((unsigned int)ch);
+    }
+
+    if (! opt_output.empty()) {
+      std::ofstream file(opt_output.c_str());
+      if (! file.is_open()) {
+        std::cout << "Error: cannot create " << opt_output << std::endl;
+        return 0;
+      }
+      log.saveCsv(file, channels);
+      std::cout << log.getNbRecords() << " records exported to " << opt_output << std::endl;
+    }
+    else if (! opt_plot)
+      log.saveCsv(std::cout, channels);
+
+    if (opt_plot) {
+      if (channels.empty())
+        for (unsigned int i=0; i < log.getNbChannels() && i < 4; i++)
+          channels.push_back(i);
+      if (channels.size() > 4) {
+        std::cout << "Only the first 4 channels are plotted" << std::endl;
+        channels.resize(4);
+      }
+      if (channels.empty() || log.getNbRecords() == 0) {
+        std::cout << "Nothing to plot" << std::endl;
+        return 0;
+      }
+
+      vpPlot plotter((unsigned int)channels.size(), 700, 700, 100, 100, opt_input.c_str());
+      for (unsigned int g=0; g < channels.size(); g++) {
+        unsigned int size = log.getChannelSize(channels[g]);
+        plotter.initGraph(g, size);
+        plotter.setTitle(g, log.getChannelName(channels[g]).c_str());
+        for (unsigned int j=0; j < size; j++) {
+          std::stringstream ss;
+          ss << log.getChannelName(channels[g]) << "_" << j;
+          plotter.setLegend(g, j, ss.str().c_str());
+        }
+      }
+
+      double t0 = log.getTimestamp(0);
+      for (unsigned long r=0; r < log.getNbRecords(); r++) {
+        double t = log.getTimestamp(r) - t0;
+        for (unsigned int g=0; g < channels.size(); g++) {
+          if (! log.hasValues(r, channels[g]))
+            continue;
+          for (unsigned int j=0; j < log.getChannelSize(channels[g]); j++)
+            plotter.plot(g, j, t, log.getValue(r, channels[g], j));
+        }
+      }
+
+      std::cout << "Click in the plot to quit" << std::endl;
+      vpDisplay::getClick(plotter.I);
+    }
+  }
+  catch(vpException &e) {
+    std::cout << e.getMessage() << std::endl;
+  }
+
+  return 0;
+}